@@ -38,6 +38,13 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct LRUCacheOptions, low_pri_pool_ratio),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"numa_aware",
+         {offsetof(struct LRUCacheOptions, numa_aware), OptionType::kBoolean,
+          OptionVerificationType::kNormal, OptionTypeFlags::kNone}},
+        {"numa_replicate_entries",
+         {offsetof(struct LRUCacheOptions, numa_replicate_entries),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -66,6 +73,26 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionTypeFlags::kMutable}},
 };
 
+static std::unordered_map<std::string, OptionTypeInfo>
+    flash_sec_cache_options_type_info = {
+        {"path",
+         {offsetof(struct FlashSecondaryCacheOptions, path),
+          OptionType::kString, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"capacity",
+         {offsetof(struct FlashSecondaryCacheOptions, capacity),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"segment_size",
+         {offsetof(struct FlashSecondaryCacheOptions, segment_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"use_async_io",
+         {offsetof(struct FlashSecondaryCacheOptions, use_async_io),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
 namespace {
 static void NoopDelete(Cache::ObjectPtr /*obj*/,
                        MemoryAllocator* /*allocator*/) {
@@ -119,6 +146,22 @@ Status SecondaryCache::CreateFromString(
     }
 
 
+    if (status.ok()) {
+      result->swap(sec_cache);
+    }
+    return status;
+  } else if (value.find("flash_secondary_cache://") == 0) {
+    std::string args = value;
+    args.erase(0, std::strlen("flash_secondary_cache://"));
+    std::shared_ptr<SecondaryCache> sec_cache;
+
+    FlashSecondaryCacheOptions sec_cache_opts;
+    Status status = OptionTypeInfo::ParseStruct(
+        config_options, "", &flash_sec_cache_options_type_info, "", args,
+        &sec_cache_opts);
+    if (status.ok()) {
+      status = NewFlashSecondaryCache(sec_cache_opts, &sec_cache);
+    }
     if (status.ok()) {
       result->swap(sec_cache);
     }
@@ -0,0 +1,565 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/flash_secondary_cache.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+const std::string kSegmentFileSuffix = ".flashcache";
+
+// Bounds the number of keys remembered for admission on second eviction.
+constexpr size_t kMinSeenKeys = 1024;
+}  // namespace
+
+FlashSecondaryCache::ResultHandle::~ResultHandle() {
+  if (io_handle_ != nullptr) {
+    if (!read_done_) {
+      // The handle must not be destroyed while pending, but don't let the
+      // read complete into freed memory anyway.
+      assert(false);
+      std::vector<void*> io_handles{io_handle_};
+      cache_->fs_->AbortIO(io_handles).PermitUncheckedError();
+    }
+    if (del_fn_) {
+      del_fn_(io_handle_);
+    }
+  }
+}
+
+void FlashSecondaryCache::ResultHandle::OnReadDone(FSReadRequest& req,
+                                                   void* arg) {
+  ResultHandle* handle = static_cast<ResultHandle*>(arg);
+  handle->read_req_.status = req.status;
+  handle->read_req_.result = req.result;
+  handle->read_done_ = true;
+}
+
+void FlashSecondaryCache::ResultHandle::Complete(const Slice& record) {
+  Slice data;
+  CompressionType type;
+  CacheTier source;
+  if (DecodeRecord(key_, record, &data, &type, &source)) {
+    Status s = helper_->create_cb(data, type, source, create_context_,
+                                  /*allocator=*/nullptr, &value_, &size_);
+    if (!s.ok()) {
+      value_ = nullptr;
+    }
+  }
+  // Otherwise, the record is corrupted or belongs to another key with the
+  // same hash. Either way it is a miss.
+  ready_ = true;
+}
+
+void FlashSecondaryCache::ResultHandle::FinishRead() {
+  assert(read_done_);
+  if (read_req_.status.ok() && read_req_.result.size() == read_req_.len) {
+    Complete(read_req_.result);
+  } else {
+    read_req_.status.PermitUncheckedError();
+    ready_ = true;
+  }
+  segment_.reset();
+  scratch_.reset();
+}
+
+FlashSecondaryCache::FlashSecondaryCache(const FlashSecondaryCacheOptions& opts)
+    : opts_(opts),
+      fs_(opts.fs ? opts.fs : FileSystem::Default()),
+      cv_(&mutex_),
+      capacity_(opts.capacity) {
+  segments_.push_back(std::make_shared<Segment>(next_segment_id_++));
+}
+
+FlashSecondaryCache::~FlashSecondaryCache() {
+  {
+    MutexLock l(&mutex_);
+    shutting_down_ = true;
+    cv_.SignalAll();
+  }
+  if (background_thread_.joinable()) {
+    background_thread_.join();
+  }
+  // Full segments still waiting in write_queue_ have no file
+  std::vector<std::string> files = std::move(files_to_delete_);
+  for (const auto& segment : segments_) {
+    if (segment->file) {
+      files.push_back(SegmentFileName(segment->id));
+    }
+  }
+  DeleteFiles(files);
+}
+
+Status FlashSecondaryCache::Open() {
+  if (opts_.path.empty()) {
+    return Status::InvalidArgument("FlashSecondaryCache needs a path");
+  }
+  if (opts_.segment_size <= kRecordHeaderSize ||
+      opts_.segment_size > std::numeric_limits<uint32_t>::max()) {
+    return Status::InvalidArgument("Invalid FlashSecondaryCache segment_size");
+  }
+  IOStatus s = fs_->CreateDirIfMissing(opts_.path, IOOptions(), nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> children;
+  s = fs_->GetChildren(opts_.path, IOOptions(), &children, nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  for (const auto& child : children) {
+    if (EndsWith(child, kSegmentFileSuffix)) {
+      s = fs_->DeleteFile(opts_.path + "/" + child, IOOptions(), nullptr);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+  background_thread_ = port::Thread([this] { BackgroundWork(); });
+  return Status::OK();
+}
+
+std::string FlashSecondaryCache::SegmentFileName(uint32_t id) const {
+  char buf[20];
+  snprintf(buf, sizeof(buf), "%06" PRIu32, id);
+  return opts_.path + "/" + buf + kSegmentFileSuffix;
+}
+
+bool FlashSecondaryCache::StartRecord(const Slice& key, size_t data_size,
+                                      CompressionType type, CacheTier source,
+                                      std::string* record) const {
+  const size_t record_size = kRecordHeaderSize + key.size() + data_size;
+  if (record_size > opts_.segment_size) {
+    return false;
+  }
+  record->resize(record_size);
+  char* p = &(*record)[0];
+  EncodeFixed32(p + 4, static_cast<uint32_t>(key.size()));
+  p[8] = static_cast<char>(type);
+  p[9] = static_cast<char>(source);
+  memcpy(p + kRecordHeaderSize, key.data(), key.size());
+  return true;
+}
+
+void FlashSecondaryCache::FinishRecord(std::string* record) {
+  char* p = &(*record)[0];
+  EncodeFixed32(
+      p, crc32c::Mask(crc32c::Value(p + 4, record->size() - sizeof(uint32_t))));
+}
+
+bool FlashSecondaryCache::DecodeRecord(const Slice& key, const Slice& record,
+                                       Slice* data, CompressionType* type,
+                                       CacheTier* source) {
+  if (record.size() < kRecordHeaderSize) {
+    return false;
+  }
+  const char* p = record.data();
+  const uint32_t checksum = crc32c::Unmask(DecodeFixed32(p));
+  if (checksum != crc32c::Value(p + 4, record.size() - sizeof(uint32_t))) {
+    return false;
+  }
+  const uint32_t key_size = DecodeFixed32(p + 4);
+  if (key_size > record.size() - kRecordHeaderSize ||
+      Slice(p + kRecordHeaderSize, key_size) != key) {
+    return false;
+  }
+  *type = static_cast<CompressionType>(p[8]);
+  *source = static_cast<CacheTier>(p[9]);
+  *data = Slice(p + kRecordHeaderSize + key_size,
+                record.size() - kRecordHeaderSize - key_size);
+  return true;
+}
+
+Status FlashSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                   const Cache::CacheItemHelper* helper,
+                                   bool force_insert) {
+  assert(helper && helper->IsSecondaryCacheCompatible());
+  const uint64_t hash = GetSliceHash64(key);
+  {
+    MutexLock l(&mutex_);
+    if (index_.find(hash) != index_.end()) {
+      // Still cached from an earlier insertion
+      return Status::OK();
+    }
+    if (!force_insert && !SeenBefore(hash)) {
+      return Status::OK();
+    }
+  }
+
+  const size_t data_size = helper->size_cb(value);
+  std::string record;
+  if (!StartRecord(key, data_size, kNoCompression, CacheTier::kVolatileTier,
+                   &record)) {
+    return Status::OK();
+  }
+  Status s = helper->saveto_cb(value, 0, data_size,
+                               &record[record.size() - data_size]);
+  if (!s.ok()) {
+    return s;
+  }
+  FinishRecord(&record);
+  AppendRecord(hash, record);
+  return Status::OK();
+}
+
+Status FlashSecondaryCache::InsertSaved(const Slice& key, const Slice& saved,
+                                        CompressionType type,
+                                        CacheTier source) {
+  std::string record;
+  if (!StartRecord(key, saved.size(), type, source, &record)) {
+    return Status::OK();
+  }
+  memcpy(&record[record.size() - saved.size()], saved.data(), saved.size());
+  FinishRecord(&record);
+  AppendRecord(GetSliceHash64(key), record);
+  return Status::OK();
+}
+
+void FlashSecondaryCache::AppendRecord(uint64_t hash,
+                                       const std::string& record) {
+  MutexLock l(&mutex_);
+  Segment* active = segments_.back().get();
+  if (active->buffer.size() + record.size() > opts_.segment_size) {
+    if (num_unwritten_segments_ >= kMaxUnwrittenSegments) {
+      // Flash is not keeping up. Rather than wait for it or use more memory,
+      // don't cache the entry.
+      return;
+    }
+    segments_.back()->writing = true;
+    write_queue_.push_back(segments_.back());
+    ++num_unwritten_segments_;
+    segments_.push_back(std::make_shared<Segment>(next_segment_id_++));
+    active = segments_.back().get();
+    EvictSegments(&files_to_delete_);
+    cv_.SignalAll();
+  }
+  if (active->buffer.empty()) {
+    active->buffer.reserve(opts_.segment_size);
+  }
+  index_[hash] = Location{active->id,
+                          static_cast<uint32_t>(active->buffer.size()),
+                          static_cast<uint32_t>(record.size())};
+  active->buffer.append(record);
+  active->hashes.push_back(hash);
+}
+
+void FlashSecondaryCache::BackgroundWork() {
+  MutexLock l(&mutex_);
+  while (!shutting_down_) {
+    if (!files_to_delete_.empty()) {
+      std::vector<std::string> files;
+      files.swap(files_to_delete_);
+      background_work_running_ = true;
+      mutex_.Unlock();
+      DeleteFiles(files);
+      mutex_.Lock();
+    } else if (!write_queue_.empty()) {
+      std::shared_ptr<Segment> segment = std::move(write_queue_.front());
+      write_queue_.pop_front();
+      // No need to write a segment that was evicted while in the queue
+      const bool write = !segment->dropped;
+      IOStatus s;
+      std::unique_ptr<FSRandomAccessFile> reader;
+      if (write) {
+        background_work_running_ = true;
+        mutex_.Unlock();
+        s = WriteSegment(*segment, &reader);
+        mutex_.Lock();
+      }
+      segment->writing = false;
+      --num_unwritten_segments_;
+      if (!s.ok() && !segment->dropped) {
+        // Give up on the entries of the segment
+        DropSegment(segment.get(), nullptr);
+      }
+      if (!segment->dropped) {
+        segment->file = std::move(reader);
+      } else if (write) {
+        files_to_delete_.push_back(SegmentFileName(segment->id));
+      }
+      std::string().swap(segment->buffer);
+      s.PermitUncheckedError();
+    } else {
+      cv_.Wait();
+      continue;
+    }
+    background_work_running_ = false;
+    cv_.SignalAll();
+  }
+}
+
+IOStatus FlashSecondaryCache::WriteSegment(
+    const Segment& segment, std::unique_ptr<FSRandomAccessFile>* reader) {
+  // The buffer of a full segment is no longer modified until the segment is
+  // marked as written, so it can be read without the mutex.
+  TEST_SYNC_POINT("FlashSecondaryCache::WriteSegment");
+  const std::string fname = SegmentFileName(segment.id);
+  std::unique_ptr<FSWritableFile> writer;
+  IOStatus s = fs_->NewWritableFile(fname, FileOptions(), &writer, nullptr);
+  if (s.ok()) {
+    s = writer->Append(segment.buffer, IOOptions(), nullptr);
+    if (s.ok()) {
+      s = writer->Close(IOOptions(), nullptr);
+    } else {
+      writer->Close(IOOptions(), nullptr).PermitUncheckedError();
+    }
+  }
+  if (s.ok()) {
+    s = fs_->NewRandomAccessFile(fname, FileOptions(), reader, nullptr);
+  }
+  return s;
+}
+
+void FlashSecondaryCache::EvictSegments(
+    std::vector<std::string>* obsolete_files) {
+  mutex_.AssertHeld();
+  // The active segment is not on flash yet and does not count
+  const size_t max_segments =
+      std::max<size_t>(capacity_ / opts_.segment_size, 1) + 1;
+  while (segments_.size() > max_segments) {
+    DropSegment(segments_.front().get(), obsolete_files);
+    segments_.pop_front();
+  }
+}
+
+void FlashSecondaryCache::DropSegment(
+    Segment* segment, std::vector<std::string>* obsolete_files) {
+  mutex_.AssertHeld();
+  if (segment->dropped) {
+    return;
+  }
+  for (uint64_t hash : segment->hashes) {
+    auto it = index_.find(hash);
+    if (it != index_.end() && it->second.segment_id == segment->id) {
+      index_.erase(it);
+    }
+  }
+  std::vector<uint64_t>().swap(segment->hashes);
+  segment->dropped = true;
+  // A segment being written is cleaned up by its writer. Lookups still
+  // holding the segment keep the file open.
+  if (!segment->writing) {
+    std::string().swap(segment->buffer);
+    if (segment->file && obsolete_files != nullptr) {
+      obsolete_files->push_back(SegmentFileName(segment->id));
+    }
+  }
+}
+
+std::shared_ptr<FlashSecondaryCache::Segment> FlashSecondaryCache::FindSegment(
+    uint32_t id) const {
+  mutex_.AssertHeld();
+  // Segment ids are consecutive from the front to the back
+  const uint32_t first_id = segments_.front()->id;
+  if (id < first_id || id - first_id >= segments_.size()) {
+    return nullptr;
+  }
+  return segments_[id - first_id];
+}
+
+void FlashSecondaryCache::DeleteFiles(const std::vector<std::string>& files) {
+  for (const auto& fname : files) {
+    fs_->DeleteFile(fname, IOOptions(), nullptr).PermitUncheckedError();
+  }
+}
+
+bool FlashSecondaryCache::SeenBefore(uint64_t hash) {
+  mutex_.AssertHeld();
+  if (seen_.erase(hash) > 0) {
+    return true;
+  }
+  seen_.insert(hash);
+  seen_order_.push_back(hash);
+  const size_t max_seen = std::max(index_.size(), kMinSeenKeys);
+  while (seen_order_.size() > max_seen) {
+    seen_.erase(seen_order_.front());
+    seen_order_.pop_front();
+  }
+  return false;
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> FlashSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool /*advise_erase*/,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  assert(helper);
+  kept_in_sec_cache = false;
+  const uint64_t hash = GetSliceHash64(key);
+  std::unique_ptr<ResultHandle> handle(
+      new ResultHandle(this, key, helper, create_context));
+  std::shared_ptr<Segment> segment;
+  Location loc;
+  bool in_memory = false;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(hash);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    loc = it->second;
+    segment = FindSegment(loc.segment_id);
+    if (segment == nullptr) {
+      assert(false);
+      return nullptr;
+    }
+    handle->scratch_.reset(new char[loc.size]);
+    if (segment->file == nullptr) {
+      // Not on flash yet
+      assert(loc.offset + loc.size <= segment->buffer.size());
+      memcpy(handle->scratch_.get(), segment->buffer.data() + loc.offset,
+             loc.size);
+      in_memory = true;
+    }
+  }
+
+  if (in_memory) {
+    handle->Complete(Slice(handle->scratch_.get(), loc.size));
+    handle->scratch_.reset();
+  } else {
+    handle->segment_ = segment;
+    FSReadRequest& req = handle->read_req_;
+    req.offset = loc.offset;
+    req.len = loc.size;
+    req.scratch = handle->scratch_.get();
+    IOStatus s = IOStatus::NotSupported();
+    if (!wait && opts_.use_async_io) {
+      s = segment->file->ReadAsync(req, IOOptions(), &ResultHandle::OnReadDone,
+                                   handle.get(), &handle->io_handle_,
+                                   &handle->del_fn_, nullptr);
+    }
+    if (!s.ok()) {
+      s.PermitUncheckedError();
+      req.status = segment->file->Read(req.offset, req.len, IOOptions(),
+                                       &req.result, req.scratch, nullptr);
+      handle->read_done_ = true;
+    }
+    if (handle->read_done_) {
+      handle->FinishRead();
+    }
+  }
+
+  if (handle->ready_ && handle->value_ == nullptr) {
+    return nullptr;
+  }
+  kept_in_sec_cache = true;
+  return std::unique_ptr<SecondaryCacheResultHandle>(handle.release());
+}
+
+void FlashSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<ResultHandle*> pending;
+  std::vector<void*> io_handles;
+  for (SecondaryCacheResultHandle* h : handles) {
+    ResultHandle* handle = static_cast<ResultHandle*>(h);
+    if (handle->ready_) {
+      continue;
+    }
+    pending.push_back(handle);
+    if (!handle->read_done_) {
+      io_handles.push_back(handle->io_handle_);
+    }
+  }
+  if (!io_handles.empty()) {
+    fs_->Poll(io_handles, io_handles.size()).PermitUncheckedError();
+  }
+  for (ResultHandle* handle : pending) {
+    if (!handle->read_done_) {
+      // Polling failed. Read synchronously instead.
+      std::vector<void*> io_handle{handle->io_handle_};
+      fs_->AbortIO(io_handle).PermitUncheckedError();
+      FSReadRequest& req = handle->read_req_;
+      req.status = handle->segment_->file->Read(
+          req.offset, req.len, IOOptions(), &req.result, req.scratch, nullptr);
+      handle->read_done_ = true;
+    }
+    handle->FinishRead();
+  }
+}
+
+void FlashSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  index_.erase(GetSliceHash64(key));
+}
+
+Status FlashSecondaryCache::SetCapacity(size_t capacity) {
+  std::vector<std::string> obsolete_files;
+  {
+    MutexLock l(&mutex_);
+    capacity_ = capacity;
+    EvictSegments(&obsolete_files);
+  }
+  DeleteFiles(obsolete_files);
+  return Status::OK();
+}
+
+Status FlashSecondaryCache::GetCapacity(size_t& capacity) {
+  MutexLock l(&mutex_);
+  capacity = capacity_;
+  return Status::OK();
+}
+
+std::string FlashSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  const int kBufferSize{200};
+  char buffer[kBufferSize];
+  ret.append("    path : ");
+  ret.append(opts_.path);
+  ret.append("\n");
+  {
+    MutexLock l(&mutex_);
+    snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+             capacity_);
+  }
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    segment_size : %" ROCKSDB_PRIszt "\n",
+           opts_.segment_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    use_async_io : %d\n",
+           opts_.use_async_io);
+  ret.append(buffer);
+  return ret;
+}
+
+size_t FlashSecondaryCache::TEST_NumEntries() {
+  MutexLock l(&mutex_);
+  return index_.size();
+}
+
+size_t FlashSecondaryCache::TEST_NumSegments() {
+  MutexLock l(&mutex_);
+  return segments_.size();
+}
+
+void FlashSecondaryCache::TEST_WaitForBackgroundWork() {
+  MutexLock l(&mutex_);
+  while (!write_queue_.empty() || !files_to_delete_.empty() ||
+         background_work_running_) {
+    cv_.Wait();
+  }
+}
+
+Status NewFlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                              std::shared_ptr<SecondaryCache>* cache) {
+  auto flash_cache = std::make_shared<FlashSecondaryCache>(opts);
+  Status s = flash_cache->Open();
+  if (s.ok()) {
+    *cache = std::move(flash_cache);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,241 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A SecondaryCache on local flash. See FlashSecondaryCacheOptions for the
+// public description.
+//
+// Each entry is stored as a record in a segment:
+//   checksum: fixed32, masked crc32c of the rest of the record
+//   key_size: fixed32
+//   type: char, CompressionType of the data
+//   source: char, CacheTier that is responsible for uncompressing the data
+//   key: char[key_size]
+//   data: the rest of the record
+// Records are appended to the active segment, which is kept in memory until
+// it is full. Then it is handed to a background thread, which writes it to its
+// own file as a whole, and a new active segment is started. Lookups read a
+// segment from memory until its file is written. Segment files are never
+// modified afterwards, only deleted, which happens to the oldest one when the
+// segments exceed the capacity. The background thread also deletes the files
+// of the segments dropped by insertions, so that Insert() never does I/O.
+//
+// The index maps the 64-bit hash of each key to the location of its latest
+// record. A hash collision is treated as a miss, after comparing the key in
+// the record.
+//
+// Admission:
+// - InsertSaved() always admits, as it is used by TieredSecondaryCache to
+//   warm this tier up with the blocks that missed in all tiers.
+// - Insert() of an entry evicted from the primary cache admits on the second
+//   eviction of a key, unless force_insert is set, like the placeholder policy
+//   of CompressedSecondaryCache.
+// - Neither admits while the active segment is full and
+//   kMaxUnwrittenSegments full segments are waiting for the background
+//   thread, which bounds the memory used when flash cannot keep up.
+// - Lookup() keeps the entry, whether or not advise_erase is set, so a block
+//   promoted to memory need not be read from the SST file again once it is
+//   evicted from memory. The space on flash is cheap and is reclaimed when its
+//   segment is dropped anyway.
+class FlashSecondaryCache : public SecondaryCache {
+ public:
+  explicit FlashSecondaryCache(const FlashSecondaryCacheOptions& opts);
+  ~FlashSecondaryCache() override;
+
+  // Creates the directory and deletes segment files left over in it.
+  Status Open();
+
+  const char* Name() const override { return "FlashSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved, CompressionType type,
+                     CacheTier source) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status SetCapacity(size_t capacity) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  size_t TEST_NumEntries();
+  size_t TEST_NumSegments();
+  // Waits until the background thread is idle
+  void TEST_WaitForBackgroundWork();
+
+  static constexpr size_t kMaxUnwrittenSegments = 8;
+
+ private:
+  static constexpr size_t kRecordHeaderSize = 10;
+
+  struct Segment {
+    explicit Segment(uint32_t _id) : id(_id) {}
+
+    const uint32_t id;
+    // Contents of the segment until its file is written
+    std::string buffer;
+    // Set once the file is written
+    std::unique_ptr<FSRandomAccessFile> file;
+    // Hashes of the keys indexed to this segment, to drop them with it
+    std::vector<uint64_t> hashes;
+    // Full and waiting for its file to be written
+    bool writing = false;
+    bool dropped = false;
+  };
+
+  struct Location {
+    uint32_t segment_id;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  class ResultHandle : public SecondaryCacheResultHandle {
+   public:
+    ResultHandle(FlashSecondaryCache* cache, const Slice& key,
+                 const Cache::CacheItemHelper* helper,
+                 Cache::CreateContext* create_context)
+        : cache_(cache),
+          key_(key.ToString()),
+          helper_(helper),
+          create_context_(create_context) {}
+    ~ResultHandle() override;
+
+    bool IsReady() override { return ready_; }
+
+    void Wait() override { cache_->WaitAll({this}); }
+
+    Cache::ObjectPtr Value() override {
+      assert(ready_);
+      return value_;
+    }
+
+    size_t Size() override { return value_ ? size_ : 0; }
+
+   private:
+    friend class FlashSecondaryCache;
+
+    static void OnReadDone(FSReadRequest& req, void* arg);
+
+    // Creates the value from the record that was read.
+    void Complete(const Slice& record);
+
+    // Completes the handle once the read from flash is done.
+    void FinishRead();
+
+    FlashSecondaryCache* const cache_;
+    const std::string key_;
+    const Cache::CacheItemHelper* const helper_;
+    Cache::CreateContext* const create_context_;
+    Cache::ObjectPtr value_ = nullptr;
+    size_t size_ = 0;
+    bool ready_ = false;
+
+    // State of a read in flight
+    std::shared_ptr<Segment> segment_;
+    std::unique_ptr<char[]> scratch_;
+    FSReadRequest read_req_;
+    void* io_handle_ = nullptr;
+    IOHandleDeleter del_fn_;
+    bool read_done_ = false;
+  };
+
+  std::string SegmentFileName(uint32_t id) const;
+
+  // Lays out a record with room for `data_size` bytes of data at its end, or
+  // returns false if it would not fit in a segment. FinishRecord() sets the
+  // checksum once the data is filled in.
+  bool StartRecord(const Slice& key, size_t data_size, CompressionType type,
+                   CacheTier source, std::string* record) const;
+  static void FinishRecord(std::string* record);
+
+  // Returns the data of `record` if it is intact and has the given key,
+  // along with its compression type and source tier.
+  static bool DecodeRecord(const Slice& key, const Slice& record, Slice* data,
+                           CompressionType* type, CacheTier* source);
+
+  // Appends a record to the active segment and indexes it.
+  void AppendRecord(uint64_t hash, const std::string& record);
+
+  // Body of the background thread. Writes full segments to their files and
+  // deletes obsolete files until the cache is destroyed.
+  void BackgroundWork();
+
+  // Writes the buffer of a full segment to its file and opens it for reads.
+  // REQUIRES: mutex_ not held
+  IOStatus WriteSegment(const Segment& segment,
+                        std::unique_ptr<FSRandomAccessFile>* reader);
+
+  // Drops the oldest segments until the segments fit in the capacity.
+  // REQUIRES: mutex_ held
+  void EvictSegments(std::vector<std::string>* obsolete_files);
+
+  // REQUIRES: mutex_ held
+  void DropSegment(Segment* segment,
+                   std::vector<std::string>* obsolete_files);
+
+  // REQUIRES: mutex_ held
+  std::shared_ptr<Segment> FindSegment(uint32_t id) const;
+
+  void DeleteFiles(const std::vector<std::string>& files);
+
+  // Whether a key evicted from the primary cache was evicted recently
+  // before, to admit it this time.
+  // REQUIRES: mutex_ held
+  bool SeenBefore(uint64_t hash);
+
+  const FlashSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+
+  mutable port::Mutex mutex_;
+  port::CondVar cv_;
+  size_t capacity_;
+  std::unordered_map<uint64_t, Location> index_;
+  // The oldest segment is at the front, the active one at the back
+  std::deque<std::shared_ptr<Segment>> segments_;
+  uint32_t next_segment_id_ = 0;
+  // Hashes of the keys whose first eviction was not admitted, and the order
+  // to forget them in
+  std::unordered_set<uint64_t> seen_;
+  std::deque<uint64_t> seen_order_;
+
+  // Work for the background thread
+  std::deque<std::shared_ptr<Segment>> write_queue_;
+  std::vector<std::string> files_to_delete_;
+  // Segments in write_queue_ or being written
+  size_t num_unwritten_segments_ = 0;
+  bool background_work_running_ = false;
+  bool shutting_down_ = false;
+  port::Thread background_thread_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
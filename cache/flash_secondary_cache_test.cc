@@ -0,0 +1,362 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/flash_secondary_cache.h"
+
+#include <memory>
+
+#include "db/db_test_util.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/convenience.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::WithCacheType;
+
+class FlashSecondaryCacheTest : public testing::Test, public WithCacheType {
+ public:
+  FlashSecondaryCacheTest() {
+    path_ = test::PerThreadDBPath(Env::Default(), "flash_secondary_cache");
+    EXPECT_OK(DestroyDir(Env::Default(), path_));
+  }
+  ~FlashSecondaryCacheTest() override {
+    EXPECT_OK(DestroyDir(Env::Default(), path_));
+  }
+
+  const std::string& Type() const override {
+    static const std::string kType = kLRU;
+    return kType;
+  }
+
+ protected:
+  std::shared_ptr<FlashSecondaryCache> NewFlashCache(size_t capacity,
+                                                     size_t segment_size,
+                                                     bool use_async_io) {
+    FlashSecondaryCacheOptions opts;
+    opts.path = path_;
+    opts.capacity = capacity;
+    opts.segment_size = segment_size;
+    opts.use_async_io = use_async_io;
+    std::shared_ptr<SecondaryCache> sec_cache;
+    EXPECT_OK(NewFlashSecondaryCache(opts, &sec_cache));
+    return std::static_pointer_cast<FlashSecondaryCache>(sec_cache);
+  }
+
+  // Returns the value of `key`, or an empty string on a miss.
+  std::string Lookup(SecondaryCache* sec_cache, const std::string& key,
+                     bool wait) {
+    bool kept_in_sec_cache = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup(key, GetHelper(), this, wait,
+                          /*advise_erase=*/true, /*stats=*/nullptr,
+                          kept_in_sec_cache);
+    if (handle == nullptr) {
+      return "";
+    }
+    EXPECT_TRUE(kept_in_sec_cache);
+    if (!handle->IsReady()) {
+      EXPECT_FALSE(wait);
+      sec_cache->WaitAll({handle.get()});
+    }
+    EXPECT_TRUE(handle->IsReady());
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    return item ? item->ToString() : "";
+  }
+
+  size_t CountSegmentFiles() {
+    std::vector<std::string> files;
+    EXPECT_OK(Env::Default()->GetChildren(path_, &files));
+    size_t count = 0;
+    for (const auto& f : files) {
+      if (EndsWith(f, ".flashcache")) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  std::string path_;
+};
+
+TEST_F(FlashSecondaryCacheTest, Basic) {
+  std::shared_ptr<FlashSecondaryCache> sec_cache =
+      NewFlashCache(64 << 10, 16 << 10, /*use_async_io=*/true);
+  Random rnd(301);
+  ASSERT_EQ(Lookup(sec_cache.get(), "key0", /*wait=*/true), "");
+
+  // InsertSaved always admits.
+  std::string value1 = rnd.RandomString(1000);
+  ASSERT_OK(sec_cache->InsertSaved("key1", value1, kNoCompression,
+                                   CacheTier::kVolatileTier));
+  ASSERT_EQ(Lookup(sec_cache.get(), "key1", /*wait=*/true), value1);
+
+  // Insert admits on the second eviction from the primary cache, or when
+  // forced.
+  std::string value2 = rnd.RandomString(1000);
+  TestItem item2(value2.data(), value2.size());
+  ASSERT_OK(sec_cache->Insert("key2", &item2, GetHelper(),
+                              /*force_insert=*/false));
+  ASSERT_EQ(Lookup(sec_cache.get(), "key2", /*wait=*/true), "");
+  ASSERT_OK(sec_cache->Insert("key2", &item2, GetHelper(),
+                              /*force_insert=*/false));
+  ASSERT_EQ(Lookup(sec_cache.get(), "key2", /*wait=*/true), value2);
+
+  std::string value3 = rnd.RandomString(1000);
+  TestItem item3(value3.data(), value3.size());
+  ASSERT_OK(sec_cache->Insert("key3", &item3, GetHelper(),
+                              /*force_insert=*/true));
+  ASSERT_EQ(Lookup(sec_cache.get(), "key3", /*wait=*/true), value3);
+
+  // Entries stay cached after a lookup, even if erasure is advised.
+  ASSERT_EQ(Lookup(sec_cache.get(), "key1", /*wait=*/true), value1);
+  ASSERT_EQ(sec_cache->TEST_NumEntries(), 3);
+
+  sec_cache->Erase("key1");
+  ASSERT_EQ(Lookup(sec_cache.get(), "key1", /*wait=*/true), "");
+
+  // Too large for a segment
+  ASSERT_OK(sec_cache->InsertSaved("key4", rnd.RandomString(20 << 10),
+                                   kNoCompression, CacheTier::kVolatileTier));
+  ASSERT_EQ(Lookup(sec_cache.get(), "key4", /*wait=*/true), "");
+}
+
+TEST_F(FlashSecondaryCacheTest, LookupFromFlash) {
+  for (bool use_async_io : {false, true}) {
+    std::shared_ptr<FlashSecondaryCache> sec_cache =
+        NewFlashCache(1 << 20, 16 << 10, use_async_io);
+    Random rnd(301);
+    std::vector<std::string> values;
+    // Fill several segments, so most entries are read from segment files
+    for (int i = 0; i < 100; ++i) {
+      values.push_back(rnd.RandomString(1000));
+      ASSERT_OK(sec_cache->InsertSaved("key" + std::to_string(i), values[i],
+                                       kNoCompression,
+                                       CacheTier::kVolatileTier));
+    }
+    ASSERT_GT(sec_cache->TEST_NumSegments(), 5);
+    sec_cache->TEST_WaitForBackgroundWork();
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_EQ(Lookup(sec_cache.get(), "key" + std::to_string(i),
+                       /*wait=*/(i % 2) == 0),
+                values[i]);
+    }
+
+    // A batch of lookups waited for together
+    std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+    std::vector<SecondaryCacheResultHandle*> pending;
+    for (int i = 0; i < 100; i += 7) {
+      bool kept_in_sec_cache = false;
+      handles.push_back(sec_cache->Lookup("key" + std::to_string(i),
+                                          GetHelper(), this, /*wait=*/false,
+                                          /*advise_erase=*/false,
+                                          /*stats=*/nullptr, kept_in_sec_cache));
+      ASSERT_NE(handles.back(), nullptr);
+      if (!handles.back()->IsReady()) {
+        pending.push_back(handles.back().get());
+      }
+    }
+    sec_cache->WaitAll(pending);
+    for (size_t j = 0; j < handles.size(); ++j) {
+      ASSERT_TRUE(handles[j]->IsReady());
+      std::unique_ptr<TestItem> item(
+          static_cast<TestItem*>(handles[j]->Value()));
+      ASSERT_NE(item, nullptr);
+      ASSERT_EQ(item->ToString(), values[j * 7]);
+    }
+  }
+}
+
+TEST_F(FlashSecondaryCacheTest, EvictSegments) {
+  // Room for 4 segments on flash
+  std::shared_ptr<FlashSecondaryCache> sec_cache =
+      NewFlashCache(64 << 10, 16 << 10, /*use_async_io=*/true);
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(sec_cache->InsertSaved("key" + std::to_string(i), values[i],
+                                     kNoCompression,
+                                     CacheTier::kVolatileTier));
+    // Otherwise more than kMaxUnwrittenSegments segments may be queued, and
+    // the records added meanwhile dropped
+    sec_cache->TEST_WaitForBackgroundWork();
+  }
+  // Plus the active segment in memory
+  ASSERT_EQ(sec_cache->TEST_NumSegments(), 5);
+  sec_cache->TEST_WaitForBackgroundWork();
+  ASSERT_EQ(CountSegmentFiles(), 4);
+
+  // The oldest entries are gone, the newest are still there
+  ASSERT_EQ(Lookup(sec_cache.get(), "key0", /*wait=*/true), "");
+  ASSERT_EQ(Lookup(sec_cache.get(), "key199", /*wait=*/true), values[199]);
+  ASSERT_LT(sec_cache->TEST_NumEntries(), 100);
+
+  ASSERT_OK(sec_cache->SetCapacity(16 << 10));
+  ASSERT_EQ(sec_cache->TEST_NumSegments(), 2);
+  ASSERT_EQ(Lookup(sec_cache.get(), "key199", /*wait=*/true), values[199]);
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, 16 << 10);
+
+  // Segment files are removed with the cache
+  sec_cache.reset();
+  ASSERT_EQ(CountSegmentFiles(), 0);
+}
+
+TEST_F(FlashSecondaryCacheTest, BackgroundWrites) {
+  std::shared_ptr<FlashSecondaryCache> sec_cache =
+      NewFlashCache(1 << 20, 16 << 10, /*use_async_io=*/false);
+  // Hold the background thread in its first segment write
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"FlashSecondaryCacheTest::BackgroundWrites:Resume",
+        "FlashSecondaryCache::WriteSegment"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Fill the active segment and the maximum of full segments waiting to be
+  // written, without waiting for flash.
+  Random rnd(301);
+  std::vector<std::string> values;
+  const int kNumKeys =
+      static_cast<int>(FlashSecondaryCache::kMaxUnwrittenSegments + 1) * 16;
+  for (int i = 0; i < kNumKeys; ++i) {
+    values.push_back(rnd.RandomString(1000));
+    ASSERT_OK(sec_cache->InsertSaved("key" + std::to_string(i), values[i],
+                                     kNoCompression,
+                                     CacheTier::kVolatileTier));
+  }
+  ASSERT_EQ(sec_cache->TEST_NumSegments(),
+            FlashSecondaryCache::kMaxUnwrittenSegments + 1);
+  ASSERT_EQ(CountSegmentFiles(), 0);
+  // Unwritten segments are read from memory
+  ASSERT_EQ(Lookup(sec_cache.get(), "key0", /*wait=*/true), values[0]);
+
+  // With the active segment full as well, new entries are not cached
+  ASSERT_OK(sec_cache->InsertSaved("overflow", rnd.RandomString(1000),
+                                   kNoCompression, CacheTier::kVolatileTier));
+  ASSERT_EQ(Lookup(sec_cache.get(), "overflow", /*wait=*/true), "");
+
+  TEST_SYNC_POINT("FlashSecondaryCacheTest::BackgroundWrites:Resume");
+  sec_cache->TEST_WaitForBackgroundWork();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearTrace();
+  ASSERT_EQ(CountSegmentFiles(), FlashSecondaryCache::kMaxUnwrittenSegments);
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_EQ(Lookup(sec_cache.get(), "key" + std::to_string(i),
+                     /*wait=*/true),
+              values[i]);
+  }
+}
+
+TEST_F(FlashSecondaryCacheTest, CreateFromString) {
+  ConfigOptions config_options;
+  std::shared_ptr<SecondaryCache> sec_cache;
+  ASSERT_OK(SecondaryCache::CreateFromString(
+      config_options,
+      "flash_secondary_cache://path=" + path_ +
+          ";capacity=1048576;segment_size=65536;use_async_io=false",
+      &sec_cache));
+  ASSERT_NE(sec_cache, nullptr);
+  ASSERT_STREQ(sec_cache->Name(), "FlashSecondaryCache");
+  size_t capacity = 0;
+  ASSERT_OK(sec_cache->GetCapacity(capacity));
+  ASSERT_EQ(capacity, 1048576);
+
+  ASSERT_TRUE(SecondaryCache::CreateFromString(
+                  config_options, "flash_secondary_cache://capacity=1048576",
+                  &sec_cache)
+                  .IsInvalidArgument());
+}
+
+class DBFlashSecondaryCacheTest : public DBTestBase {
+ public:
+  DBFlashSecondaryCacheTest()
+      : DBTestBase("db_flash_secondary_cache_test", /*env_do_fsync=*/true) {}
+};
+
+TEST_F(DBFlashSecondaryCacheTest, TieredCache) {
+  if (!LZ4_Supported()) {
+    ROCKSDB_GTEST_SKIP("This test requires LZ4 support.");
+    return;
+  }
+  // A small primary and compressed secondary cache over the flash cache, as
+  // the bottom tier of a tiered cache.
+  FlashSecondaryCacheOptions flash_opts;
+  flash_opts.path = dbname_ + "_flash_cache";
+  flash_opts.capacity = 4 << 20;
+  flash_opts.segment_size = 64 << 10;
+  std::shared_ptr<SecondaryCache> flash_cache;
+  ASSERT_OK(NewFlashSecondaryCache(flash_opts, &flash_cache));
+
+  LRUCacheOptions lru_opts;
+  lru_opts.num_shard_bits = 0;
+  lru_opts.high_pri_pool_ratio = 0;
+  TieredCacheOptions tiered_opts;
+  tiered_opts.cache_opts = &lru_opts;
+  tiered_opts.cache_type = PrimaryCacheType::kCacheTypeLRU;
+  tiered_opts.adm_policy = TieredAdmissionPolicy::kAdmPolicyThreeQueue;
+  tiered_opts.comp_cache_opts.num_shard_bits = 0;
+  tiered_opts.total_capacity = 256 << 10;
+  tiered_opts.compressed_secondary_ratio = 0.5;
+  tiered_opts.nvm_sec_cache = flash_cache;
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewTieredCache(tiered_opts);
+  table_options.block_size = 4 << 10;
+  table_options.cache_index_and_filter_blocks = false;
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  // The tiered cache warms the flash tier up with compressed blocks
+  options.compression = kLZ4Compression;
+  options.paranoid_file_checks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  const int kNumKeys = 1024;
+  std::vector<std::string> values;
+  for (int i = 0; i < kNumKeys; ++i) {
+    std::string value;
+    test::CompressibleString(&rnd, 0.5, 1000, &value);
+    values.push_back(value);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  // The working set is larger than memory, so the later passes are served
+  // from the flash cache.
+  for (int pass = 0; pass < 3; ++pass) {
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_EQ(Get(Key(i)), values[i]);
+    }
+    std::vector<std::string> keys;
+    for (int i = 0; i < kNumKeys; i += 3) {
+      keys.push_back(Key(i));
+    }
+    std::vector<std::string> results = MultiGet(keys, nullptr);
+    for (size_t j = 0; j < keys.size(); ++j) {
+      ASSERT_EQ(results[j], values[j * 3]);
+    }
+  }
+  ASSERT_GT(
+      static_cast<FlashSecondaryCache*>(flash_cache.get())->TEST_NumEntries(),
+      0);
+
+  Close();
+  table_options.block_cache.reset();
+  flash_cache.reset();
+  ASSERT_OK(DestroyDir(env_, flash_opts.path));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
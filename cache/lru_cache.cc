@@ -19,6 +19,7 @@
 #include "monitoring/statistics_impl.h"
 #include "port/lang.h"
 #include "util/distributed_mutex.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 namespace lru_cache {
@@ -649,15 +650,19 @@ void LRUCacheShard::AppendPrintableOptions(std::string& str) const {
   str.append(buffer);
 }
 
-LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
+LRUCache::LRUCache(const LRUCacheOptions& opts)
+    : ShardedCache(opts, opts.numa_aware) {
+  replicate_across_shard_groups_ = opts.numa_replicate_entries;
   size_t per_shard = GetPerShardCapacity();
   MemoryAllocator* alloc = memory_allocator();
+  // The shard group is tagged into the hash bits above the shard bits
+  int max_upper_hash_bits =
+      32 - opts.num_shard_bits - BitsSetToOne(shard_group_mask_);
   InitShards([&](LRUCacheShard* cs) {
     new (cs) LRUCacheShard(per_shard, opts.strict_capacity_limit,
                            opts.high_pri_pool_ratio, opts.low_pri_pool_ratio,
                            opts.use_adaptive_mutex, opts.metadata_charge_policy,
-                           /* max_upper_hash_bits */ 32 - opts.num_shard_bits,
-                           alloc, &eviction_callback_);
+                           max_upper_hash_bits, alloc, &eviction_callback_);
   });
 }
 
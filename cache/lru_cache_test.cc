@@ -2723,6 +2723,73 @@ TEST_F(LRUCacheTest, InsertAfterReducingCapacity) {
   Insert("aaa", Cache::Priority::LOW, /*charge=*/3);
 }
 
+TEST(LRUCacheNumaTest, ShardGroups) {
+  // Simulate two NUMA nodes, with CPU 0 on the first and CPU 1 on the second
+  int caller_cpu = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "ShardedCacheBase::DetermineShardGroups", [](void* arg) {
+        *static_cast<std::vector<uint32_t>*>(arg) = {0, 1};
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "ShardedCacheBase::GetCallerShardGroup:Cpu",
+      [&](void* arg) { *static_cast<int*>(arg) = caller_cpu; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (bool replicate : {true, false}) {
+    SCOPED_TRACE("replicate=" + std::to_string(replicate));
+    LRUCacheOptions opts;
+    opts.capacity = 1 << 20;
+    opts.num_shard_bits = 2;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    opts.numa_aware = true;
+    opts.numa_replicate_entries = replicate;
+    std::shared_ptr<Cache> cache = opts.MakeSharedCache();
+    auto lru = static_cast<LRUCache*>(cache.get());
+    ASSERT_EQ(lru->GetNumShardGroups(), 2U);
+    ASSERT_EQ(lru->GetNumShards(), 8U);
+    ASSERT_EQ(lru->GetNumShardBits(), 2);
+
+    caller_cpu = 0;
+    ASSERT_OK(cache->Insert("k1", nullptr, &kNoopCacheItemHelper, 10));
+    Cache::Handle* h = cache->Lookup("k1");
+    ASSERT_NE(h, nullptr);
+
+    // Lookup from the other node
+    caller_cpu = 1;
+    Cache::Handle* h2 = cache->Lookup("k1");
+    if (replicate) {
+      ASSERT_EQ(h2, nullptr);
+      ASSERT_OK(cache->Insert("k1", nullptr, &kNoopCacheItemHelper, 10, &h2));
+      ASSERT_NE(h2, h);
+      ASSERT_EQ(cache->GetUsage(), 20U);
+    } else {
+      ASSERT_EQ(h2, h);
+      ASSERT_EQ(cache->GetUsage(), 10U);
+    }
+    // Handles are released to the shard that owns them, from any node
+    cache->Release(h);
+    cache->Release(h2);
+    ASSERT_EQ(cache->GetPinnedUsage(), 0U);
+
+    // Erase removes the entry from all nodes
+    cache->Erase("k1");
+    ASSERT_EQ(cache->GetUsage(), 0U);
+    caller_cpu = 0;
+    ASSERT_EQ(cache->Lookup("k1"), nullptr);
+
+    // CPUs with unknown nodes use the first shard group
+    caller_cpu = 100;
+    ASSERT_OK(cache->Insert("k2", nullptr, &kNoopCacheItemHelper, 10));
+    caller_cpu = 0;
+    h = cache->Lookup("k2");
+    ASSERT_NE(h, nullptr);
+    cache->Release(h);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
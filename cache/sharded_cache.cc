@@ -9,12 +9,19 @@
 
 #include "cache/sharded_cache.h"
 
+#ifdef NUMA
+#include <numa.h>
+#include <sched.h>
+#endif
+
 #include <algorithm>
 #include <cstdint>
+#include <map>
 #include <memory>
 
 #include "env/unique_id_gen.h"
 #include "rocksdb/env.h"
+#include "test_util/sync_point.h"
 #include "util/hash.h"
 #include "util/math.h"
 #include "util/mutexlock.h"
@@ -55,13 +62,65 @@ uint32_t DetermineSeed(int32_t hash_seed_option) {
     return val & kSeedMask;
   }
 }
+
+// Fills `cpu_to_group` with a dense shard group number for the NUMA node of
+// each CPU, and `group_to_node` with the node of each group, and returns the
+// number of groups. Returns 1 (and leaves both empty) if there is no more
+// than one NUMA node with CPUs, or NUMA support is not available.
+uint32_t DetermineShardGroups(bool numa_aware,
+                              std::vector<uint32_t>* cpu_to_group,
+                              std::vector<int>* group_to_node) {
+  cpu_to_group->clear();
+  group_to_node->clear();
+  if (!numa_aware) {
+    return 1;
+  }
+#ifdef NUMA
+  if (numa_available() != -1) {
+    std::map<int, uint32_t> node_to_group;
+    int num_cpus = numa_num_configured_cpus();
+    for (int cpu = 0; cpu < num_cpus; ++cpu) {
+      int node = numa_node_of_cpu(cpu);
+      if (node < 0) {
+        node = 0;
+      }
+      auto it = node_to_group
+                    .emplace(node, static_cast<uint32_t>(node_to_group.size()))
+                    .first;
+      if (it->second == group_to_node->size()) {
+        group_to_node->push_back(node);
+      }
+      cpu_to_group->push_back(it->second);
+    }
+  }
+#endif  // NUMA
+  // For testing multiple shard groups on any host
+  TEST_SYNC_POINT_CALLBACK("ShardedCacheBase::DetermineShardGroups",
+                           cpu_to_group);
+  uint32_t num_groups = 1;
+  for (uint32_t group : *cpu_to_group) {
+    num_groups = std::max(num_groups, group + 1);
+  }
+  if (num_groups == 1) {
+    cpu_to_group->clear();
+    group_to_node->clear();
+  }
+  return num_groups;
+}
 }  // namespace
 
-ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts)
+ShardedCacheBase::ShardedCacheBase(const ShardedCacheOptions& opts,
+                                   bool numa_aware)
     : Cache(opts.memory_allocator),
       last_id_(1),
       shard_mask_((uint32_t{1} << opts.num_shard_bits) - 1),
       hash_seed_(DetermineSeed(opts.hash_seed)),
+      num_shard_groups_(DetermineShardGroups(numa_aware, &cpu_to_shard_group_,
+                                             &shard_group_to_node_)),
+      shard_group_mask_(
+          ((uint32_t{1} << FloorLog2((num_shard_groups_ << 1) - 1)) - 1)
+          << opts.num_shard_bits),
+      shard_index_mask_(shard_mask_ | shard_group_mask_),
       strict_capacity_limit_(opts.strict_capacity_limit),
       capacity_(opts.capacity) {}
 
@@ -74,6 +133,62 @@ size_t ShardedCacheBase::GetPerShardCapacity() const {
   return ComputePerShardCapacity(GetCapacity());
 }
 
+uint32_t ShardedCacheBase::GetCallerShardGroup() const {
+#ifdef NUMA
+  int cpu = sched_getcpu();
+#else
+  int cpu = port::PhysicalCoreID();
+#endif
+  TEST_SYNC_POINT_CALLBACK("ShardedCacheBase::GetCallerShardGroup:Cpu", &cpu);
+  if (cpu < 0 || static_cast<size_t>(cpu) >= cpu_to_shard_group_.size()) {
+    return 0;
+  }
+  return cpu_to_shard_group_[cpu];
+}
+
+void* ShardedCacheBase::AllocateShards(size_t size) {
+#ifdef NUMA
+  if (!shard_group_to_node_.empty()) {
+    // Fresh pages, placed on first touch by RunOnShardGroupNode()
+    void* shards = numa_alloc(size);
+    if (shards != nullptr) {
+      shards_numa_alloc_size_ = size;
+      return shards;
+    }
+  }
+#endif  // NUMA
+  return port::cacheline_aligned_alloc(size);
+}
+
+void ShardedCacheBase::FreeShards(void* shards) {
+  if (shards_numa_alloc_size_ > 0) {
+#ifdef NUMA
+    numa_free(shards, shards_numa_alloc_size_);
+#endif  // NUMA
+    return;
+  }
+  port::cacheline_aligned_free(shards);
+}
+
+void ShardedCacheBase::RunOnShardGroupNode(
+    uint32_t group, const std::function<void()>& fn) const {
+#ifdef NUMA
+  if (group < shard_group_to_node_.size()) {
+    const int node = shard_group_to_node_[group];
+    port::Thread thread([node, &fn]() {
+      // Failing to bind only costs locality
+      numa_run_on_node(node);
+      numa_set_preferred(node);
+      fn();
+    });
+    thread.join();
+    return;
+  }
+#endif  // NUMA
+  (void)group;
+  fn();
+}
+
 uint64_t ShardedCacheBase::NewId() {
   return last_id_.fetch_add(1, std::memory_order_relaxed);
 }
@@ -115,6 +230,9 @@ std::string ShardedCacheBase::GetPrintableOptions() const {
     snprintf(buffer, kBufferSize, "    num_shard_bits : %d\n",
              GetNumShardBits());
     ret.append(buffer);
+    snprintf(buffer, kBufferSize, "    num_shard_groups : %u\n",
+             num_shard_groups_);
+    ret.append(buffer);
     snprintf(buffer, kBufferSize, "    strict_capacity_limit : %d\n",
              strict_capacity_limit_);
     ret.append(buffer);
@@ -142,6 +260,8 @@ int ShardedCacheBase::GetNumShardBits() const {
   return BitsSetToOne(shard_mask_);
 }
 
-uint32_t ShardedCacheBase::GetNumShards() const { return shard_mask_ + 1; }
+uint32_t ShardedCacheBase::GetNumShards() const {
+  return (shard_mask_ + 1) * num_shard_groups_;
+}
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -11,7 +11,10 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "port/lang.h"
 #include "port/port.h"
@@ -89,11 +92,18 @@ class CacheShardBase {
 // Portions of ShardedCache that do not depend on the template parameter
 class ShardedCacheBase : public Cache {
  public:
-  explicit ShardedCacheBase(const ShardedCacheOptions& opts);
+  // With `numa_aware`, and more than one NUMA node with CPUs available to the
+  // process, a separate group of 2^num_shard_bits shards is kept for each
+  // node. See ShardedCache.
+  explicit ShardedCacheBase(const ShardedCacheOptions& opts,
+                            bool numa_aware = false);
   virtual ~ShardedCacheBase() = default;
 
+  // Number of shard bits within each shard group
   int GetNumShardBits() const;
+  // Total number of shards across all shard groups
   uint32_t GetNumShards() const;
+  uint32_t GetNumShardGroups() const { return num_shard_groups_; }
 
   uint64_t NewId() override;
 
@@ -112,16 +122,41 @@ class ShardedCacheBase : public Cache {
   virtual void AppendPrintableOptions(std::string& str) const = 0;
   size_t GetPerShardCapacity() const;
   size_t ComputePerShardCapacity(size_t capacity) const;
+  // Shard group of the NUMA node the calling thread is running on
+  uint32_t GetCallerShardGroup() const;
+  // Allocate and free the memory for the shards. With multiple shard groups
+  // in a NUMA build, the pages are left untouched, so that each group's
+  // shards are placed on the node of the thread constructing them.
+  void* AllocateShards(size_t size);
+  void FreeShards(void* shards);
+  // Runs `fn` on a thread bound to the NUMA node of shard group `group`, or
+  // on the calling thread without NUMA support, and waits for it to finish.
+  void RunOnShardGroupNode(uint32_t group,
+                           const std::function<void()>& fn) const;
 
  protected:                        // data
   std::atomic<uint64_t> last_id_;  // For NewId
   const uint32_t shard_mask_;
   const uint32_t hash_seed_;
+  // Maps CPU number to shard group, empty with a single shard group
+  std::vector<uint32_t> cpu_to_shard_group_;
+  // Maps shard group to NUMA node, empty without NUMA support
+  std::vector<int> shard_group_to_node_;
+  const uint32_t num_shard_groups_;
+  // The shard group is tagged into the sharding piece of the hash, in the
+  // bits just above the shard bits, so that handles can be mapped back to
+  // their shard regardless of the thread releasing them.
+  const uint32_t shard_group_mask_;
+  const uint32_t shard_index_mask_;
 
   // Dynamic configuration parameters, guarded by config_mutex_
   bool strict_capacity_limit_;
   size_t capacity_;
   mutable port::Mutex config_mutex_;
+
+ private:
+  // Size of the shards allocation if it came from libnuma, or 0
+  size_t shards_numa_alloc_size_ = 0;
 };
 
 // Generic cache interface that shards cache by hash of keys. 2^num_shard_bits
@@ -130,6 +165,12 @@ class ShardedCacheBase : public Cache {
 // so that the upper bits of the hash value can keep a stable ordering of
 // table entries even as the table grows (using more upper hash bits).
 // See CacheShardBase above for what is expected of the CacheShard parameter.
+//
+// In NUMA-aware mode there is one group of 2^num_shard_bits shards per NUMA
+// node. Inserts and lookups go to the shards of the calling thread's node, and
+// erases go to all groups. Only supported for integer HashVal whose sharding
+// piece is its lower 32 bits, and where the hash is not needed to identify the
+// key, because the group is tagged into the hash.
 template <class CacheShard>
 class ShardedCache : public ShardedCacheBase {
  public:
@@ -137,25 +178,28 @@ class ShardedCache : public ShardedCacheBase {
   using HashCref = typename CacheShard::HashCref;
   using HandleImpl = typename CacheShard::HandleImpl;
 
-  explicit ShardedCache(const ShardedCacheOptions& opts)
-      : ShardedCacheBase(opts),
-        shards_(static_cast<CacheShard*>(port::cacheline_aligned_alloc(
-            sizeof(CacheShard) * GetNumShards()))),
-        destroy_shards_in_dtor_(false) {}
+  explicit ShardedCache(const ShardedCacheOptions& opts,
+                        bool numa_aware = false)
+      : ShardedCacheBase(opts, numa_aware),
+        shards_(static_cast<CacheShard*>(
+            AllocateShards(sizeof(CacheShard) * GetNumShards()))),
+        destroy_shards_in_dtor_(false) {
+    assert(num_shard_groups_ == 1 || std::is_integral_v<HashVal>);
+  }
 
   virtual ~ShardedCache() {
     if (destroy_shards_in_dtor_) {
       ForEachShard([](CacheShard* cs) { cs->~CacheShard(); });
     }
-    port::cacheline_aligned_free(shards_);
+    FreeShards(shards_);
   }
 
   CacheShard& GetShard(HashCref hash) {
-    return shards_[CacheShard::HashPieceForSharding(hash) & shard_mask_];
+    return shards_[CacheShard::HashPieceForSharding(hash) & shard_index_mask_];
   }
 
   const CacheShard& GetShard(HashCref hash) const {
-    return shards_[CacheShard::HashPieceForSharding(hash) & shard_mask_];
+    return shards_[CacheShard::HashPieceForSharding(hash) & shard_index_mask_];
   }
 
   void SetCapacity(size_t capacity) override {
@@ -179,7 +223,7 @@ class ShardedCache : public ShardedCacheBase {
       const Slice& /*compressed_value*/ = Slice(),
       CompressionType /*type*/ = CompressionType::kNoCompression) override {
     assert(helper);
-    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    HashVal hash = ComputeCallerHash(key);
     auto h_out = reinterpret_cast<HandleImpl**>(handle);
     return GetShard(hash).Insert(key, hash, obj, helper, charge, h_out,
                                  priority);
@@ -189,7 +233,7 @@ class ShardedCache : public ShardedCacheBase {
                            const CacheItemHelper* helper, size_t charge,
                            bool allow_uncharged) override {
     assert(helper);
-    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    HashVal hash = ComputeCallerHash(key);
     HandleImpl* result = GetShard(hash).CreateStandalone(
         key, hash, obj, helper, charge, allow_uncharged);
     return static_cast<Handle*>(result);
@@ -199,15 +243,36 @@ class ShardedCache : public ShardedCacheBase {
                  CreateContext* create_context = nullptr,
                  Priority priority = Priority::LOW,
                  Statistics* stats = nullptr) override {
-    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    HashVal hash = ComputeCallerHash(key);
     HandleImpl* result = GetShard(hash).Lookup(key, hash, helper,
                                                create_context, priority, stats);
+    if (result == nullptr && !replicate_across_shard_groups_) {
+      // Look for an entry inserted from another NUMA node before reporting
+      // a miss, so that each entry is normally only cached once.
+      for (uint32_t group = 0; group < num_shard_groups_; ++group) {
+        HashVal other = SetShardGroup(hash, group);
+        if (other != hash) {
+          result = GetShard(other).Lookup(key, other, helper, create_context,
+                                          priority, stats);
+          if (result != nullptr) {
+            break;
+          }
+        }
+      }
+    }
     return static_cast<Handle*>(result);
   }
 
   void Erase(const Slice& key) override {
     HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
-    GetShard(hash).Erase(key, hash);
+    if (num_shard_groups_ == 1) {
+      GetShard(hash).Erase(key, hash);
+      return;
+    }
+    for (uint32_t group = 0; group < num_shard_groups_; ++group) {
+      HashVal tagged = SetShardGroup(hash, group);
+      GetShard(tagged).Erase(key, tagged);
+    }
   }
 
   bool Release(Handle* handle, bool useful,
@@ -271,6 +336,27 @@ class ShardedCache : public ShardedCacheBase {
   }
 
  protected:
+  // Computes the hash of `key`, tagged with the calling thread's shard group
+  // if there are multiple shard groups.
+  inline HashVal ComputeCallerHash(const Slice& key) const {
+    HashVal hash = CacheShard::ComputeHash(key, hash_seed_);
+    if (num_shard_groups_ > 1) {
+      hash = SetShardGroup(hash, GetCallerShardGroup());
+    }
+    return hash;
+  }
+
+  inline HashVal SetShardGroup(HashCref hash, uint32_t group) const {
+    if constexpr (std::is_integral_v<HashVal>) {
+      int shift = GetNumShardBits();
+      return static_cast<HashVal>((hash & ~HashVal{shard_group_mask_}) |
+                                  (HashVal{group} << shift));
+    } else {
+      assert(group == 0);
+      return hash;
+    }
+  }
+
   inline void ForEachShard(const std::function<void(CacheShard*)>& fn) {
     uint32_t num_shards = GetNumShards();
     for (uint32_t i = 0; i < num_shards; i++) {
@@ -302,10 +388,28 @@ class ShardedCache : public ShardedCacheBase {
 
   // Must be called exactly once by derived class constructor
   void InitShards(const std::function<void(CacheShard*)>& placement_new) {
-    ForEachShard(placement_new);
+    if (num_shard_groups_ == 1) {
+      ForEachShard(placement_new);
+    } else {
+      // Construct each group's shards, and so touch their pages and allocate
+      // their initial hash tables, from the group's own node. Only a page
+      // straddling two groups is shared.
+      const uint32_t shards_per_group = shard_mask_ + 1;
+      for (uint32_t group = 0; group < num_shard_groups_; ++group) {
+        RunOnShardGroupNode(group, [&]() {
+          for (uint32_t i = 0; i < shards_per_group; ++i) {
+            placement_new(shards_ + group * shards_per_group + i);
+          }
+        });
+      }
+    }
     destroy_shards_in_dtor_ = true;
   }
 
+  // If false, a Lookup missing in the calling thread's shard group also
+  // checks the other shard groups. Set by derived class constructor.
+  bool replicate_across_shard_groups_ = true;
+
   void AppendPrintableOptions(std::string& str) const override {
     shards_[0].AppendPrintableOptions(str);
   }
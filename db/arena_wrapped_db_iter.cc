@@ -27,12 +27,62 @@ inline static SequenceNumber GetSeqNum(const DBImpl* db, const Snapshot* s) {
   }
 }
 
+bool DBIterTree::CanReuse(Env* env, const ImmutableOptions& ioptions,
+                          const ReadOptions& other) const {
+  // Fields only relevant to point lookups are not compared. async_io and
+  // total_order_seek are compared as adjusted by ArenaWrappedDBIter::Init().
+  const bool async_io =
+      other.async_io && CheckFSFeatureSupport(env->GetFileSystem().get(),
+                                              FSSupportedOps::kAsyncIO);
+  const bool total_order_seek =
+      other.total_order_seek || ioptions.prefix_seek_opt_in_only;
+  const ReadOptions& ro = read_options;
+  return !ro.table_filter && !other.table_filter &&
+         ro.timestamp == other.timestamp &&
+         ro.iter_start_ts == other.iter_start_ts &&
+         ro.deadline == other.deadline && ro.io_timeout == other.io_timeout &&
+         ro.read_tier == other.read_tier &&
+         ro.rate_limiter_priority == other.rate_limiter_priority &&
+         ro.verify_checksums == other.verify_checksums &&
+         ro.fill_cache == other.fill_cache &&
+         ro.ignore_range_deletions == other.ignore_range_deletions &&
+         ro.async_io == async_io && ro.readahead_size == other.readahead_size &&
+         ro.max_skippable_internal_keys == other.max_skippable_internal_keys &&
+         ro.iterate_lower_bound == other.iterate_lower_bound &&
+         ro.iterate_upper_bound == other.iterate_upper_bound &&
+         ro.tailing == other.tailing &&
+         ro.total_order_seek == total_order_seek &&
+         ro.auto_prefix_mode == other.auto_prefix_mode &&
+         ro.prefix_same_as_start == other.prefix_same_as_start &&
+         ro.pin_data == other.pin_data &&
+         ro.adaptive_readahead == other.adaptive_readahead &&
+         ro.background_purge_on_iterator_cleanup ==
+             other.background_purge_on_iterator_cleanup &&
+         ro.auto_readahead_size == other.auto_readahead_size &&
+         ro.allow_unprepared_value == other.allow_unprepared_value &&
+         ro.recycle_iterator == other.recycle_iterator &&
+         ro.io_activity == other.io_activity;
+}
+
+ArenaWrappedDBIter::~ArenaWrappedDBIter() {
+  if (db_iter_ == nullptr) {
+    assert(false);
+    return;
+  }
+  if (recycle_cfd_ != nullptr) {
+    db_iter_->PrepareForReuse();
+    if (recycle_cfd_->RecycleIterTree(tree_.get())) {
+      tree_.release();
+    }
+  }
+}
+
 Status ArenaWrappedDBIter::GetProperty(std::string prop_name,
                                        std::string* prop) {
   if (prop_name == "rocksdb.iterator.super-version-number") {
     // First try to pass the value returned from inner iterator.
     if (!db_iter_->GetProperty(prop_name, prop).ok()) {
-      *prop = std::to_string(sv_number_);
+      *prop = std::to_string(tree_->sv_number);
     }
     return Status::OK();
   }
@@ -45,23 +95,29 @@ void ArenaWrappedDBIter::Init(
     const SequenceNumber& sequence, uint64_t max_sequential_skip_in_iteration,
     uint64_t version_number, ReadCallback* read_callback,
     ColumnFamilyHandleImpl* cfh, bool expose_blob_index, bool allow_refresh) {
-  read_options_ = read_options;
+  if (tree_ == nullptr) {
+    tree_.reset(new DBIterTree());
+  }
+  tree_->read_options = read_options;
   if (!CheckFSFeatureSupport(env->GetFileSystem().get(),
                              FSSupportedOps::kAsyncIO)) {
-    read_options_.async_io = false;
+    tree_->read_options.async_io = false;
   }
-  read_options_.total_order_seek |= ioptions.prefix_seek_opt_in_only;
+  tree_->read_options.total_order_seek |= ioptions.prefix_seek_opt_in_only;
 
-  auto mem = arena_.AllocateAligned(sizeof(DBIter));
-  db_iter_ = new (mem) DBIter(env, read_options_, ioptions, mutable_cf_options,
-                              ioptions.user_comparator,
-                              /* iter */ nullptr, version, sequence, true,
-                              max_sequential_skip_in_iteration, read_callback,
-                              cfh, expose_blob_index);
+  auto mem = tree_->arena.AllocateAligned(sizeof(DBIter));
+  db_iter_ = new (mem)
+      DBIter(env, tree_->read_options, ioptions, mutable_cf_options,
+             ioptions.user_comparator,
+             /* iter */ nullptr, version, sequence, true,
+             max_sequential_skip_in_iteration, read_callback, cfh,
+             expose_blob_index);
+  tree_->db_iter = db_iter_;
+  tree_->cfh = cfh;
 
-  sv_number_ = version_number;
+  tree_->sv_number = version_number;
   allow_refresh_ = allow_refresh;
-  memtable_range_tombstone_iter_ = nullptr;
+  tree_->memtable_range_tombstone_iter = nullptr;
 }
 
 Status ArenaWrappedDBIter::Refresh() { return Refresh(nullptr); }
@@ -79,17 +135,18 @@ Status ArenaWrappedDBIter::Refresh(const Snapshot* snapshot) {
   // here for the case of WritePreparedTxnDB.
   uint64_t cur_sv_number = cfd->GetSuperVersionNumber();
   // If we recreate a new internal iterator below (NewInternalIterator()),
-  // we will pass in read_options_. We need to make sure it
+  // we will pass in tree_->read_options. We need to make sure it
   // has the right snapshot.
-  read_options_.snapshot = snapshot;
+  tree_->read_options.snapshot = snapshot;
   TEST_SYNC_POINT("ArenaWrappedDBIter::Refresh:1");
   TEST_SYNC_POINT("ArenaWrappedDBIter::Refresh:2");
 
   auto reinit_internal_iter = [&]() {
     Env* env = db_iter_->env();
     db_iter_->~DBIter();
-    arena_.~Arena();
-    new (&arena_) Arena();
+    tree_->db_iter = nullptr;
+    tree_->arena.~Arena();
+    new (&tree_->arena) Arena();
 
     SuperVersion* sv = cfd->GetReferencedSuperVersion(db_impl);
     assert(sv->version_number >= cur_sv_number);
@@ -97,43 +154,43 @@ Status ArenaWrappedDBIter::Refresh(const Snapshot* snapshot) {
     if (read_callback_) {
       read_callback_->Refresh(read_seq);
     }
-    Init(env, read_options_, *(cfd->ioptions()), sv->mutable_cf_options,
+    Init(env, tree_->read_options, *(cfd->ioptions()), sv->mutable_cf_options,
          sv->current, read_seq,
          sv->mutable_cf_options.max_sequential_skip_in_iterations,
          sv->version_number, read_callback_, cfh_, expose_blob_index_,
          allow_refresh_);
 
     InternalIterator* internal_iter = db_impl->NewInternalIterator(
-        read_options_, cfd, sv, &arena_, read_seq,
+        tree_->read_options, cfd, sv, &tree_->arena, read_seq,
         /* allow_unprepared_value */ true, /* db_iter */ this);
     SetIterUnderDBIter(internal_iter);
   };
   while (true) {
-    if (sv_number_ != cur_sv_number) {
+    if (tree_->sv_number != cur_sv_number) {
       reinit_internal_iter();
       break;
     } else {
       SequenceNumber read_seq = GetSeqNum(db_impl, snapshot);
       // Refresh range-tombstones in MemTable
-      if (!read_options_.ignore_range_deletions) {
+      if (!tree_->read_options.ignore_range_deletions) {
         SuperVersion* sv = cfd->GetThreadLocalSuperVersion(db_impl);
         TEST_SYNC_POINT_CALLBACK("ArenaWrappedDBIter::Refresh:SV", nullptr);
         auto t = sv->mem->NewRangeTombstoneIterator(
-            read_options_, read_seq, false /* immutable_memtable */);
+            tree_->read_options, read_seq, false /* immutable_memtable */);
         if (!t || t->empty()) {
-          // If memtable_range_tombstone_iter_ points to a non-empty tombstone
+          // If memtable_range_tombstone_iter points to a non-empty tombstone
           // iterator, then it means sv->mem is not the memtable that
-          // memtable_range_tombstone_iter_ points to, so SV must have changed
-          // after the sv_number_ != cur_sv_number check above. We will fall
+          // memtable_range_tombstone_iter points to, so SV must have changed
+          // after the sv_number != cur_sv_number check above. We will fall
           // back to re-init the InternalIterator, and the tombstone iterator
           // will be freed during db_iter destruction there.
-          if (memtable_range_tombstone_iter_) {
-            assert(!*memtable_range_tombstone_iter_ ||
-                   sv_number_ != cfd->GetSuperVersionNumber());
+          if (tree_->memtable_range_tombstone_iter) {
+            assert(!*tree_->memtable_range_tombstone_iter ||
+                   tree_->sv_number != cfd->GetSuperVersionNumber());
           }
           delete t;
         } else {  // current mutable memtable has range tombstones
-          if (!memtable_range_tombstone_iter_) {
+          if (!tree_->memtable_range_tombstone_iter) {
             delete t;
             db_impl->ReturnAndCleanupSuperVersion(cfd, sv);
             // The memtable under DBIter did not have range tombstone before
@@ -141,7 +198,7 @@ Status ArenaWrappedDBIter::Refresh(const Snapshot* snapshot) {
             reinit_internal_iter();
             break;
           } else {
-            *memtable_range_tombstone_iter_ =
+            *tree_->memtable_range_tombstone_iter =
                 std::make_unique<TruncatedRangeDelIterator>(
                     std::unique_ptr<FragmentedRangeTombstoneIterator>(t),
                     &cfd->internal_comparator(), nullptr, nullptr);
@@ -165,6 +222,29 @@ Status ArenaWrappedDBIter::Refresh(const Snapshot* snapshot) {
   return Status::OK();
 }
 
+ArenaWrappedDBIter* ArenaWrappedDBIter::NewFromRecycled(
+    Env* env, const ReadOptions& read_options, ColumnFamilyHandleImpl* cfh) {
+  ColumnFamilyData* cfd = cfh->cfd();
+  std::unique_ptr<DBIterTree> tree(cfd->TakeRecycledIterTree());
+  if (tree == nullptr || tree->cfh != cfh ||
+      tree->sv_number != cfd->GetSuperVersionNumber() ||
+      !tree->CanReuse(env, *cfd->ioptions(), read_options)) {
+    return nullptr;
+  }
+  ArenaWrappedDBIter* iter = new ArenaWrappedDBIter();
+  iter->db_iter_ = tree->db_iter;
+  iter->tree_ = std::move(tree);
+  iter->StoreRefreshInfo(cfh, /*read_callback=*/nullptr,
+                         /*expose_blob_index=*/false);
+  iter->SetRecycleOnDestruction(cfd);
+  // Takes the new snapshot or latest sequence number, and falls back to
+  // rebuilding the tree if the SuperVersion changed meanwhile.
+  Status s = iter->Refresh(read_options.snapshot);
+  assert(s.ok());
+  s.PermitUncheckedError();
+  return iter;
+}
+
 ArenaWrappedDBIter* NewArenaWrappedDbIterator(
     Env* env, const ReadOptions& read_options, const ImmutableOptions& ioptions,
     const MutableCFOptions& mutable_cf_options, const Version* version,
@@ -26,6 +26,39 @@ namespace ROCKSDB_NAMESPACE {
 class Arena;
 class Version;
 
+// The iterator tree of an ArenaWrappedDBIter: the DBIter and its children,
+// allocated in the arena, and the ReadOptions they refer to. It is kept apart
+// from the ArenaWrappedDBIter so that it can outlive it and be picked up by
+// the next iterator created on the same thread and column family (see
+// ReadOptions::recycle_iterator and ColumnFamilyData::RecycleIterTree()).
+struct DBIterTree {
+  ~DBIterTree() {
+    if (db_iter != nullptr) {
+      db_iter->~DBIter();
+    }
+  }
+
+  // Returns true if an iterator created with `read_options` can use this tree
+  // instead of building a new one. The snapshot is not compared, as it is
+  // applied when the tree is reused.
+  bool CanReuse(Env* env, const ImmutableOptions& ioptions,
+                const ReadOptions& read_options) const;
+
+  Arena arena;
+  ReadOptions read_options;
+  DBIter* db_iter = nullptr;
+  uint64_t sv_number = 0;
+  // If this is nullptr, it means the mutable memtable does not contain range
+  // tombstone when added under this DBIter.
+  std::unique_ptr<TruncatedRangeDelIterator>* memtable_range_tombstone_iter =
+      nullptr;
+  // Column family handle the DBIter was created with
+  ColumnFamilyHandleImpl* cfh = nullptr;
+  // Column family the tree was recycled for, set while it is not owned by an
+  // ArenaWrappedDBIter.
+  ColumnFamilyData* cfd = nullptr;
+};
+
 // A wrapper iterator which wraps DB Iterator and the arena, with which the DB
 // iterator is supposed to be allocated. This class is used as an entry point of
 // a iterator hierarchy whose memory can be allocated inline. In that way,
@@ -35,19 +68,13 @@ class Version;
 // the same as the inner DBIter.
 class ArenaWrappedDBIter : public Iterator {
  public:
-  ~ArenaWrappedDBIter() override {
-    if (db_iter_ != nullptr) {
-      db_iter_->~DBIter();
-    } else {
-      assert(false);
-    }
-  }
+  ~ArenaWrappedDBIter() override;
 
   // Get the arena to be used to allocate memory for DBIter to be wrapped,
   // as well as child iterators in it.
-  virtual Arena* GetArena() { return &arena_; }
+  virtual Arena* GetArena() { return &tree_->arena; }
 
-  const ReadOptions& GetReadOptions() { return read_options_; }
+  const ReadOptions& GetReadOptions() { return tree_->read_options; }
 
   // Set the internal iterator wrapped inside the DB Iterator. Usually it is
   // a merging iterator.
@@ -57,7 +84,7 @@ class ArenaWrappedDBIter : public Iterator {
 
   void SetMemtableRangetombstoneIter(
       std::unique_ptr<TruncatedRangeDelIterator>* iter) {
-    memtable_range_tombstone_iter_ = iter;
+    tree_->memtable_range_tombstone_iter = iter;
   }
 
   bool Valid() const override { return db_iter_->Valid(); }
@@ -102,19 +129,27 @@ class ArenaWrappedDBIter : public Iterator {
     expose_blob_index_ = expose_blob_index;
   }
 
+  // Hand the iterator tree over to the thread local cache of `cfd` on
+  // destruction, instead of freeing it.
+  void SetRecycleOnDestruction(ColumnFamilyData* cfd) { recycle_cfd_ = cfd; }
+
+  // Return an iterator over the tree recycled on this thread for the column
+  // family of `cfh`, refreshed to `read_options.snapshot`, or nullptr if
+  // there is no such tree, the SuperVersion changed since it was recycled, or
+  // it was created with incompatible ReadOptions.
+  static ArenaWrappedDBIter* NewFromRecycled(Env* env,
+                                             const ReadOptions& read_options,
+                                             ColumnFamilyHandleImpl* cfh);
+
  private:
+  // Same as tree_->db_iter, kept here to avoid an indirection per operation.
   DBIter* db_iter_ = nullptr;
-  Arena arena_;
-  uint64_t sv_number_;
+  std::unique_ptr<DBIterTree> tree_;
   ColumnFamilyHandleImpl* cfh_ = nullptr;
-  ReadOptions read_options_;
   ReadCallback* read_callback_;
   bool expose_blob_index_ = false;
   bool allow_refresh_ = true;
-  // If this is nullptr, it means the mutable memtable does not contain range
-  // tombstone when added under this DBIter.
-  std::unique_ptr<TruncatedRangeDelIterator>* memtable_range_tombstone_iter_ =
-      nullptr;
+  ColumnFamilyData* recycle_cfd_ = nullptr;
 };
 
 // Generate the arena wrapped iterator class.
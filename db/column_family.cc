@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 
+#include "db/arena_wrapped_db_iter.h"
 #include "db/blob/blob_file_cache.h"
 #include "db/blob/blob_source.h"
 #include "db/compaction/compaction_picker.h"
@@ -509,6 +510,15 @@ void SuperVersionUnrefHandle(void* ptr) {
   // SuperVersionUnrefHandle is called with locked ThreadLocalPtr mutex.
   assert(!was_last_ref);
 }
+
+void IterTreeUnrefHandle(void* ptr) {
+  // Called when a thread exits or a ThreadLocalPtr gets destroyed, with the
+  // ThreadLocalPtr mutex held. Freeing the tree may need the DB mutex, so it
+  // is left to the column family instead.
+  DBIterTree* tree = static_cast<DBIterTree*>(ptr);
+  assert(tree->cfd != nullptr);
+  tree->cfd->RecycleOrphanedIterTree(tree);
+}
 }  // anonymous namespace
 
 std::vector<std::string> ColumnFamilyData::GetDbPaths() const {
@@ -553,6 +563,7 @@ ColumnFamilyData::ColumnFamilyData(
       super_version_(nullptr),
       super_version_number_(0),
       local_sv_(new ThreadLocalPtr(&SuperVersionUnrefHandle)),
+      local_iter_tree_(new ThreadLocalPtr(&IterTreeUnrefHandle)),
       next_(nullptr),
       prev_(nullptr),
       log_number_(0),
@@ -681,6 +692,8 @@ ColumnFamilyData::~ColumnFamilyData() {
   assert(!queued_for_flush_);
   assert(!queued_for_compaction_);
   assert(super_version_ == nullptr);
+  // Recycled iterator trees hold references to this column family
+  assert(orphaned_iter_trees_.empty());
 
   if (dummy_versions_ != nullptr) {
     // List must be empty
@@ -1157,15 +1170,16 @@ uint64_t ColumnFamilyData::GetLiveSstFilesSize() const {
 MemTable* ColumnFamilyData::ConstructNewMemtable(
     const MutableCFOptions& mutable_cf_options, SequenceNumber earliest_seq) {
   return new MemTable(internal_comparator_, ioptions_, mutable_cf_options,
-                      write_buffer_manager_, earliest_seq, id_);
+                      write_buffer_manager_, earliest_seq, id_, mem_);
 }
 
 void ColumnFamilyData::CreateNewMemtable(
     const MutableCFOptions& mutable_cf_options, SequenceNumber earliest_seq) {
+  MemTable* new_mem = ConstructNewMemtable(mutable_cf_options, earliest_seq);
   if (mem_ != nullptr) {
     delete mem_->Unref();
   }
-  SetMemtable(ConstructNewMemtable(mutable_cf_options, earliest_seq));
+  SetMemtable(new_mem);
   mem_->Ref();
 }
 
@@ -1338,6 +1352,68 @@ bool ColumnFamilyData::ReturnThreadLocalSuperVersion(SuperVersion* sv) {
   return false;
 }
 
+DBIterTree* ColumnFamilyData::TakeRecycledIterTree() {
+  if (HasOrphanedIterTrees()) {
+    FreeOrphanedIterTrees();
+  }
+  DBIterTree* tree = static_cast<DBIterTree*>(local_iter_tree_->Swap(nullptr));
+  if (tree != nullptr) {
+    tree->cfd = nullptr;
+  }
+  return tree;
+}
+
+bool ColumnFamilyData::RecycleIterTree(DBIterTree* tree) {
+  assert(tree != nullptr);
+  if (IsDropped() || tree->sv_number != GetSuperVersionNumber()) {
+    return false;
+  }
+  tree->cfd = this;
+  iter_trees_recycled_.store(true);
+  void* expected = nullptr;
+  if (!local_iter_tree_->CompareAndSwap(tree, expected)) {
+    tree->cfd = nullptr;
+    return false;
+  }
+  // ReleaseRecycledIterTrees() is called after the column family is marked
+  // dropped, and InstallSuperVersion() orphans the recycled trees after
+  // bumping the SuperVersion number, so recheck in case either missed the
+  // tree stored above. If the tree is gone, it was taken over by them.
+  if ((IsDropped() || tree->sv_number != GetSuperVersionNumber()) &&
+      local_iter_tree_->Swap(nullptr) != nullptr) {
+    tree->cfd = nullptr;
+    return false;
+  }
+  return true;
+}
+
+void ColumnFamilyData::RecycleOrphanedIterTree(DBIterTree* tree) {
+  std::lock_guard<std::mutex> lock(orphaned_iter_trees_mutex_);
+  orphaned_iter_trees_.push_back(tree);
+  has_orphaned_iter_trees_.store(true, std::memory_order_relaxed);
+}
+
+void ColumnFamilyData::FreeOrphanedIterTrees() {
+  std::vector<DBIterTree*> trees;
+  {
+    std::lock_guard<std::mutex> lock(orphaned_iter_trees_mutex_);
+    trees.swap(orphaned_iter_trees_);
+    has_orphaned_iter_trees_.store(false, std::memory_order_relaxed);
+  }
+  for (DBIterTree* tree : trees) {
+    delete tree;
+  }
+}
+
+void ColumnFamilyData::ReleaseRecycledIterTrees() {
+  autovector<void*> trees;
+  local_iter_tree_->Scrape(&trees, nullptr);
+  for (void* tree : trees) {
+    delete static_cast<DBIterTree*>(tree);
+  }
+  FreeOrphanedIterTrees();
+}
+
 void ColumnFamilyData::InstallSuperVersion(SuperVersionContext* sv_context,
                                            InstrumentedMutex* db_mutex) {
   db_mutex->AssertHeld();
@@ -1393,6 +1469,20 @@ void ColumnFamilyData::InstallSuperVersion(
   }
   ++super_version_number_;
   super_version_->version_number = super_version_number_;
+  if (iter_trees_recycled_.load()) {
+    // The recycled trees hold the replaced SuperVersion, and with it obsolete
+    // memtables and files. Hand them over to be freed without the DB mutex,
+    // see DBImpl::InstallSuperVersionAndScheduleWork().
+    autovector<void*> trees;
+    local_iter_tree_->Scrape(&trees, nullptr);
+    if (!trees.empty()) {
+      std::lock_guard<std::mutex> lock(orphaned_iter_trees_mutex_);
+      for (void* tree : trees) {
+        orphaned_iter_trees_.push_back(static_cast<DBIterTree*>(tree));
+      }
+      has_orphaned_iter_trees_.store(true, std::memory_order_relaxed);
+    }
+  }
 }
 
 void ColumnFamilyData::ResetThreadLocalSuperVersions() {
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -50,6 +51,7 @@ class InstrumentedMutexLock;
 struct SuperVersionContext;
 class BlobFileCache;
 class BlobSource;
+struct DBIterTree;
 
 extern const double kIncSlowdownRatio;
 // This file contains a list of data structures for managing column family
@@ -395,7 +397,8 @@ class ColumnFamilyData {
   // calculate the oldest log needed for the durability of this column family
   uint64_t OldestLogToKeep();
 
-  // See Memtable constructor for explanation of earliest_seq param.
+  // See Memtable constructor for explanation of earliest_seq param. The
+  // current mutable memtable, if any, is passed as the predecessor.
   MemTable* ConstructNewMemtable(const MutableCFOptions& mutable_cf_options,
                                  SequenceNumber earliest_seq);
   void CreateNewMemtable(const MutableCFOptions& mutable_cf_options,
@@ -489,6 +492,32 @@ class ColumnFamilyData {
 
   void ResetThreadLocalSuperVersions();
 
+  // thread-safe
+  // Iterator trees recycled through ReadOptions::recycle_iterator. Each thread
+  // keeps at most one tree per column family. A recycled tree holds a
+  // reference to its SuperVersion, and is only reused while that is current.
+  //
+  // Take the tree recycled by this thread, if any. Also frees the trees left
+  // behind by exited threads.
+  DBIterTree* TakeRecycledIterTree();
+  // Store `tree` for reuse by this thread. Returns false, leaving the
+  // ownership with the caller, if the tree is not current or this thread
+  // already has a recycled tree.
+  bool RecycleIterTree(DBIterTree* tree);
+  // Keep the tree of an exited thread until it can be freed.
+  void RecycleOrphanedIterTree(DBIterTree* tree);
+  // Whether there are trees of exited threads, or trees whose SuperVersion was
+  // replaced, to free with FreeOrphanedIterTrees().
+  bool HasOrphanedIterTrees() const {
+    return has_orphaned_iter_trees_.load(std::memory_order_relaxed);
+  }
+  // Free the trees of exited threads and the trees whose SuperVersion was
+  // replaced. Must not be called with the DB mutex held, since freeing a tree
+  // may release the last reference to a SuperVersion.
+  void FreeOrphanedIterTrees();
+  // Free all recycled trees. Must not be called with the DB mutex held.
+  void ReleaseRecycledIterTrees();
+
   // Protected by DB mutex
   void set_queued_for_flush(bool value) { queued_for_flush_ = value; }
   void set_queued_for_compaction(bool value) { queued_for_compaction_ = value; }
@@ -641,6 +670,18 @@ class ColumnFamilyData {
   // This needs to be destructed before mutex_
   std::unique_ptr<ThreadLocalPtr> local_sv_;
 
+  // Thread's recycled iterator tree. Trees of exited threads are moved to
+  // orphaned_iter_trees_, since they cannot be freed under the ThreadLocalPtr
+  // mutex, and so are the trees of all threads when a new SuperVersion is
+  // installed, since they cannot be freed under the DB mutex.
+  std::mutex orphaned_iter_trees_mutex_;
+  std::vector<DBIterTree*> orphaned_iter_trees_;
+  std::atomic<bool> has_orphaned_iter_trees_{false};
+  // Set once a tree has been recycled, to skip scraping local_iter_tree_ on
+  // each SuperVersion change otherwise
+  std::atomic<bool> iter_trees_recycled_{false};
+  std::unique_ptr<ThreadLocalPtr> local_iter_tree_;
+
   // pointers for a circular linked list. we use it to support iterations over
   // all column families that are alive (note: dropped column families can also
   // be alive as long as client holds a reference)
@@ -1568,6 +1568,47 @@ TEST_F(CompactionPickerTest, CompactionPriMinOverlapping4) {
   ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
 }
 
+TEST_F(CompactionPickerTest, CompactionPriReadHotRangesFirst) {
+  for (auto compaction_pri : {kMinOverlappingRatio, kReadHotRangesFirst}) {
+    NewVersionStorage(6, kCompactionStyleLevel);
+    ioptions_.compaction_pri = compaction_pri;
+    mutable_cf_options_.max_bytes_for_level_base = 10000000;
+    mutable_cf_options_.max_bytes_for_level_multiplier = 10;
+
+    Add(2, 6U, "150", "179", 50000000U);  // Overlaps with file 26
+    Add(2, 7U, "180", "220", 50000000U);  // Overlaps with file 27
+    Add(2, 8U, "321", "400", 50000000U);  // Overlaps with file 28
+
+    Add(3, 26U, "150", "179", 100000000U);
+    Add(3, 27U, "180", "220", 200000000U);
+    Add(3, 28U, "321", "400", 250000000U);
+    // Only the range of file 7 is read. Its boost of 1 + 3 outweighs its
+    // overlapping ratio being twice that of file 6.
+    file_map_[7U].first->stats.num_reads_sampled = 30000;
+    UpdateVersionStorageInfo();
+    LevelCompactionPicker local_level_compaction_picker =
+        LevelCompactionPicker(ioptions_, &icmp_);
+    std::unique_ptr<Compaction> compaction(
+        local_level_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+            vstorage_.get(), &log_buffer_));
+    ASSERT_TRUE(compaction.get() != nullptr);
+    ASSERT_EQ(1U, compaction->num_input_files(0));
+    if (compaction_pri == kMinOverlappingRatio) {
+      ASSERT_EQ(6U, compaction->input(0, 0)->fd.GetNumber());
+    } else {
+      ASSERT_EQ(7U, compaction->input(0, 0)->fd.GetNumber());
+    }
+    // Cold file 8 is deferred either way.
+    const auto& files_by_pri = vstorage_->FilesByCompactionPri(2);
+    ASSERT_EQ(3U, files_by_pri.size());
+    ASSERT_EQ(8U, vstorage_->LevelFiles(2)[files_by_pri[2]]->fd.GetNumber());
+    // release the version storage
+    DeleteVersionStorage();
+  }
+}
+
 TEST_F(CompactionPickerTest, CompactionPriRoundRobin) {
   std::vector<InternalKey> test_cursors = {InternalKey("249", 100, kTypeValue),
                                            InternalKey("600", 100, kTypeValue),
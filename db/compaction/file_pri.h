@@ -6,6 +6,7 @@
 
 #pragma once
 #include <algorithm>
+#include <vector>
 
 #include "db/version_edit.h"
 
@@ -91,4 +92,59 @@ class FileTtlBooster {
   uint64_t boost_age_start_;
   uint64_t boost_step_;
 };
+
+// Used by kReadHotRangesFirst to boost files whose key range is read more
+// often than the rest of the level. A file's read heat is its sampled read
+// count (FileSampledStats::num_reads_sampled) per second of file age, and
+// its boost is 1 + heat / average heat of the level. A file with the average
+// heat is compacted as if it overlapped half as much of the next level,
+// while files that are never read keep the kMinOverlappingRatio order and so
+// are deferred, letting writes to them accumulate into larger compactions.
+//
+// If the creation time of any file in the level is unknown, the raw sampled
+// read counts are compared instead so that files stay comparable.
+class FileReadHeatBooster {
+ public:
+  FileReadHeatBooster(uint64_t current_time,
+                      const std::vector<FileMetaData*>& files)
+      : current_time_(current_time), use_file_age_(current_time != 0) {
+    for (auto* f : files) {
+      uint64_t creation_time = f->TryGetFileCreationTime();
+      if (creation_time == kUnknownFileCreationTime) {
+        use_file_age_ = false;
+        break;
+      }
+    }
+    double total_heat = 0;
+    for (auto* f : files) {
+      total_heat += GetReadHeat(f);
+    }
+    avg_heat_ = files.empty() ? 0 : total_heat / files.size();
+  }
+
+  double GetBoostScore(FileMetaData* f) {
+    if (avg_heat_ <= 0) {
+      return 1;
+    }
+    return 1 + GetReadHeat(f) / avg_heat_;
+  }
+
+ private:
+  double GetReadHeat(FileMetaData* f) {
+    double reads = static_cast<double>(
+        f->stats.num_reads_sampled.load(std::memory_order_relaxed));
+    if (!use_file_age_) {
+      return reads;
+    }
+    uint64_t creation_time = f->TryGetFileCreationTime();
+    uint64_t age = current_time_ > creation_time
+                       ? current_time_ - creation_time
+                       : uint64_t{1};
+    return reads / static_cast<double>(age);
+  }
+
+  uint64_t current_time_;
+  bool use_file_age_;
+  double avg_heat_;
+};
 }  // namespace ROCKSDB_NAMESPACE
@@ -511,6 +511,61 @@ TEST_F(DBBasicTest, GetFromVersions) {
   } while (ChangeOptions());
 }
 
+TEST_F(DBBasicTest, GetPinnedMemTableValue) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  // Room for the immutable memtable made by TEST_SwitchMemtable() below, so
+  // that the manual flush does not wait for it to be flushed first.
+  options.max_write_buffer_number = 4;
+  DestroyAndReopen(options);
+
+  const std::string large_value(1000, 'a');
+  ASSERT_OK(Put("large", large_value));
+  ASSERT_OK(Put("small", "v"));
+  ASSERT_OK(Put("merged", large_value));
+  ASSERT_OK(Merge("merged", "b"));
+
+  ReadOptions ro;
+  ro.min_memtable_value_size_to_pin = 100;
+  PinnableSlice large;
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "large", &large));
+  ASSERT_TRUE(large.IsPinned());
+  ASSERT_EQ(large_value, large);
+
+  PinnableSlice small;
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "small", &small));
+  ASSERT_FALSE(small.IsPinned());
+  ASSERT_EQ("v", small);
+
+  PinnableSlice merged;
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "merged", &merged));
+  ASSERT_FALSE(merged.IsPinned());
+  ASSERT_EQ(large_value + ",b", merged);
+
+  // Also pinned when found in an immutable memtable.
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  PinnableSlice large_imm;
+  ASSERT_OK(db_->Get(ro, db_->DefaultColumnFamily(), "large", &large_imm));
+  ASSERT_TRUE(large_imm.IsPinned());
+  ASSERT_EQ(large_value, large_imm);
+
+  // Pinned values outlive overwrites and the flush of their memtables.
+  ASSERT_OK(Put("large", "new"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(large_value, large);
+  ASSERT_EQ(large_value, large_imm);
+  large.Reset();
+  large_imm.Reset();
+  ASSERT_EQ("new", Get("large"));
+
+  // Disabled by default.
+  ASSERT_OK(Put("large", large_value));
+  ASSERT_OK(db_->Get(ReadOptions(), db_->DefaultColumnFamily(), "large",
+                     &large));
+  ASSERT_FALSE(large.IsPinned());
+  ASSERT_EQ(large_value, large);
+}
+
 TEST_F(DBBasicTest, GetSnapshot) {
   anon::OptionsOverride options_override;
   options_override.skip_policy = kSkipNoSnapshot;
@@ -1965,6 +2020,102 @@ TEST_P(DBMultiGetTestWithParam, MultiGetBatchedMultiLevel) {
   }
 }
 
+TEST_F(DBBasicTest, MultiGetPrefetchAcrossLevels) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  for (int i = 0; i < 128; ++i) {
+    ASSERT_OK(Put(Key(i), "val_l2_" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  for (int i = 0; i < 128; i += 3) {
+    ASSERT_OK(Put(Key(i), "val_l1_" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  for (int i = 0; i < 128; i += 5) {
+    ASSERT_OK(Put(Key(i), "val_l0_" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  // Start with an empty block cache
+  Reopen(options);
+
+  std::atomic<size_t> num_prefetched{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTable::MultiGetPrefetch:NumBlocks",
+      [&](void* arg) { num_prefetched += *static_cast<size_t*>(arg); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<std::string> key_strs;
+  for (int i = 32; i < 96; i += 2) {
+    key_strs.push_back(Key(i));
+  }
+  std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+  std::vector<PinnableSlice> values(keys.size());
+  std::vector<Status> statuses(keys.size());
+
+  ReadOptions ro;
+  ro.prefetch_multiget_across_levels = true;
+  db_->MultiGet(ro, db_->DefaultColumnFamily(), keys.size(), keys.data(),
+                values.data(), statuses.data());
+  ASSERT_GT(num_prefetched.load(), 0);
+  for (size_t j = 0; j < keys.size(); ++j) {
+    ASSERT_OK(statuses[j]);
+    int key = static_cast<int>(j) * 2 + 32;
+    if (key % 5 == 0) {
+      ASSERT_EQ(values[j], "val_l0_" + std::to_string(key));
+    } else if (key % 3 == 0) {
+      ASSERT_EQ(values[j], "val_l1_" + std::to_string(key));
+    } else {
+      ASSERT_EQ(values[j], "val_l2_" + std::to_string(key));
+    }
+  }
+
+  // The blocks are now in the block cache, so no readahead is needed
+  num_prefetched = 0;
+  for (auto& value : values) {
+    value.Reset();
+  }
+  db_->MultiGet(ro, db_->DefaultColumnFamily(), keys.size(), keys.data(),
+                values.data(), statuses.data());
+  ASSERT_EQ(num_prefetched.load(), 0);
+  for (size_t j = 0; j < keys.size(); ++j) {
+    ASSERT_OK(statuses[j]);
+  }
+
+  // Probing the filters and the block cache for the prefetch is not counted
+  auto multiget_counts = [&](bool prefetch) {
+    ro.prefetch_multiget_across_levels = prefetch;
+    for (auto& value : values) {
+      value.Reset();
+    }
+    get_perf_context()->Reset();
+    const uint64_t data_hits =
+        TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT);
+    db_->MultiGet(ro, db_->DefaultColumnFamily(), keys.size(), keys.data(),
+                  values.data(), statuses.data());
+    return std::make_tuple(
+        get_perf_context()->bloom_sst_hit_count,
+        get_perf_context()->bloom_sst_miss_count,
+        TestGetTickerCount(options, BLOCK_CACHE_DATA_HIT) - data_hits);
+  };
+  SetPerfLevel(PerfLevel::kEnableCount);
+  auto counts_without_prefetch = multiget_counts(false);
+  ASSERT_GT(std::get<0>(counts_without_prefetch), 0);
+  ASSERT_EQ(counts_without_prefetch, multiget_counts(true));
+  SetPerfLevel(PerfLevel::kDisable);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 TEST_P(DBMultiGetTestWithParam, MultiGetDuplicatesEmptyLevel) {
 #ifndef USE_COROUTINES
   if (std::get<1>(GetParam())) {
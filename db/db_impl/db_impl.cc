@@ -52,6 +52,7 @@
 #include "db/range_tombstone_fragmenter.h"
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
+#include "db/table_tail_snapshot.h"
 #include "db/transaction_log_impl.h"
 #include "db/version_set.h"
 #include "db/write_batch_internal.h"
@@ -161,6 +162,22 @@ void DumpSupportInfo(Logger* logger) {
 #endif
   ROCKS_LOG_HEADER(logger, "Jemalloc supported: %d", jemalloc_supported);
 }
+
+// Returns InvalidArgument unless ReadOptions::projected_columns is unset, or
+// sorted bytewise and free of duplicates
+Status ValidateProjectedColumns(const ReadOptions& read_options) {
+  const std::vector<Slice>* const columns = read_options.projected_columns;
+  if (columns != nullptr &&
+      std::adjacent_find(columns->cbegin(), columns->cend(),
+                         [](const Slice& lhs, const Slice& rhs) {
+                           return lhs.compare(rhs) >= 0;
+                         }) != columns->cend()) {
+    return Status::InvalidArgument(
+        "`ReadOptions::projected_columns` has to be sorted and free of "
+        "duplicates");
+  }
+  return Status::OK();
+}
 }  // namespace
 
 DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
@@ -219,6 +236,7 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
       bg_purge_scheduled_(0),
+      bg_table_tail_snapshot_scheduled_(false),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
       delete_obsolete_files_last_run_(immutable_db_options_.clock->NowMicros()),
@@ -287,6 +305,9 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       PeriodicTaskType::kRecordSeqnoTime, [this]() {
         this->RecordSeqnoToTimeMapping(/*populate_historical_seconds=*/0);
       });
+  periodic_task_functions_.emplace(
+      PeriodicTaskType::kWriteTableTailSnapshot,
+      [this]() { this->ScheduleWriteTableTailSnapshot(); });
 
   versions_.reset(new VersionSet(
       dbname_, &immutable_db_options_, file_options_, table_cache_.get(),
@@ -307,6 +328,13 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   if (write_buffer_manager_) {
     wbm_stall_.reset(new WBMStallInterface());
   }
+  if (immutable_db_options_.large_batch_memtable_insert_threads > 1 &&
+      immutable_db_options_.allow_concurrent_memtable_write &&
+      !seq_per_batch_) {
+    // The leader inserts one part of a batch itself
+    large_batch_insert_pool_.reset(NewThreadPool(
+        immutable_db_options_.large_batch_memtable_insert_threads - 1));
+  }
 }
 
 Status DBImpl::Resume() {
@@ -535,6 +563,24 @@ void DBImpl::UntrackDataFiles() {
                       /*track=*/false);
 }
 
+void DBImpl::ReleaseRecycledIterators() {
+  autovector<ColumnFamilyData*> cfds;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      cfd->Ref();
+      cfds.push_back(cfd);
+    }
+  }
+  for (auto cfd : cfds) {
+    cfd->ReleaseRecycledIterTrees();
+  }
+  InstrumentedMutexLock l(&mutex_);
+  for (auto cfd : cfds) {
+    cfd->UnrefAndTryDelete();
+  }
+}
+
 Status DBImpl::CloseHelper() {
   // Guarantee that there is no background error recovery in progress before
   // continuing with the shutdown
@@ -551,6 +597,11 @@ Status DBImpl::CloseHelper() {
   // reached.
   error_handler_.GetRecoveryError().PermitUncheckedError();
 
+  // Free the iterators recycled through ReadOptions::recycle_iterator, which
+  // hold SuperVersion references. This may need the DB mutex, and must be
+  // done before waiting for the purges it may schedule.
+  ReleaseRecycledIterators();
+
   // CancelAllBackgroundWork called with false means we just set the shutdown
   // marker. After this we do a variant of the waiting and unschedule work
   // (to consider: moving all the waiting into CancelAllBackgroundWork(true))
@@ -573,11 +624,25 @@ Status DBImpl::CloseHelper() {
   // Wait for background work to finish
   while (bg_bottom_compaction_scheduled_ || bg_compaction_scheduled_ ||
          bg_flush_scheduled_ || bg_purge_scheduled_ ||
-         pending_purge_obsolete_files_ ||
+         bg_table_tail_snapshot_scheduled_ || pending_purge_obsolete_files_ ||
          error_handler_.IsRecoveryInProgress()) {
     TEST_SYNC_POINT("DBImpl::~DBImpl:WaitJob");
     bg_cv_.Wait();
   }
+  if (table_tail_snapshot_ && opened_successfully_) {
+    // The periodic writes were cancelled above, and no more table files
+    // change
+    mutex_.Unlock();
+    WriteTableTailSnapshot();
+    mutex_.Lock();
+  }
+  if (large_batch_insert_pool_) {
+    // No writes are in progress, so the remaining jobs, if any, have nothing
+    // left to insert
+    mutex_.Unlock();
+    large_batch_insert_pool_->JoinAllThreads();
+    mutex_.Lock();
+  }
   TEST_SYNC_POINT_CALLBACK("DBImpl::CloseHelper:PendingPurgeFinished",
                            &files_grabbed_for_purge_);
   EraseThreadStatusDbInfo();
@@ -833,6 +898,17 @@ Status DBImpl::StartPeriodicTaskScheduler() {
     }
   }
 
+  if (table_tail_snapshot_ &&
+      immutable_db_options_.table_tail_snapshot_period_sec > 0) {
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kWriteTableTailSnapshot,
+        periodic_task_functions_.at(PeriodicTaskType::kWriteTableTailSnapshot),
+        immutable_db_options_.table_tail_snapshot_period_sec);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
   Status s = periodic_task_scheduler_.Register(
       PeriodicTaskType::kFlushInfoLog,
       periodic_task_functions_.at(PeriodicTaskType::kFlushInfoLog));
@@ -1226,6 +1302,72 @@ void DBImpl::FlushInfoLog() {
   LogFlush(immutable_db_options_.info_log);
 }
 
+void DBImpl::ScheduleWriteTableTailSnapshot() {
+  InstrumentedMutexLock l(&mutex_);
+  // Written by CloseHelper() once shutting down
+  if (shutdown_initiated_ || bg_table_tail_snapshot_scheduled_) {
+    return;
+  }
+  bg_table_tail_snapshot_scheduled_ = true;
+  env_->Schedule(&DBImpl::BGWorkWriteTableTailSnapshot, this,
+                 Env::Priority::LOW, nullptr);
+}
+
+void DBImpl::BGWorkWriteTableTailSnapshot(void* db) {
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+  DBImpl* db_impl = static_cast<DBImpl*>(db);
+  db_impl->WriteTableTailSnapshot();
+  TEST_SYNC_POINT("DBImpl::BGWorkWriteTableTailSnapshot:Done");
+
+  db_impl->mutex_.Lock();
+  db_impl->bg_table_tail_snapshot_scheduled_ = false;
+  db_impl->bg_cv_.SignalAll();
+  // IMPORTANT: there should be no code after calling SignalAll. This call may
+  // signal the DB destructor that it's OK to proceed with destruction.
+  db_impl->mutex_.Unlock();
+}
+
+void DBImpl::WriteTableTailSnapshot() {
+  assert(table_tail_snapshot_);
+  std::vector<TableTailSnapshot::LiveTable> live_tables;
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped()) {
+        continue;
+      }
+      const VersionStorageInfo* vstorage = cfd->current()->storage_info();
+      for (int level = 0; level < vstorage->num_levels(); ++level) {
+        for (const FileMetaData* f : vstorage->LevelFiles(level)) {
+          // Without these, the tail could not be told apart from a stale one
+          if (f->tail_size == 0 || f->unique_id == kNullUniqueId64x2) {
+            continue;
+          }
+          TableTailSnapshot::LiveTable table;
+          table.path = TableFileName(cfd->ioptions()->cf_paths,
+                                     f->fd.GetNumber(), f->fd.GetPathId());
+          table.file_number = f->fd.GetNumber();
+          table.file_size = f->fd.GetFileSize();
+          table.tail_size = f->tail_size;
+          table.unique_id = f->unique_id;
+          live_tables.push_back(std::move(table));
+        }
+      }
+    }
+  }
+  Status s = table_tail_snapshot_->Write(
+      fs_.get(), TableTailSnapshotFileName(dbname_), live_tables);
+  if (s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Wrote table tail snapshot of %" ROCKSDB_PRIszt " files",
+                   table_tail_snapshot_->NumEntries());
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to write table tail snapshot: %s",
+                   s.ToString().c_str());
+  }
+}
+
 Status DBImpl::TablesRangeTombstoneSummary(ColumnFamilyHandle* column_family,
                                            int max_entries_to_print,
                                            std::string* out_str) {
@@ -1968,6 +2110,24 @@ void DBImpl::BackgroundCallPurge() {
     delete sv;
     mutex_.Lock();
   }
+  if (free_orphaned_iter_trees_scheduled_) {
+    free_orphaned_iter_trees_scheduled_ = false;
+    autovector<ColumnFamilyData*> cfds;
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->HasOrphanedIterTrees()) {
+        cfd->Ref();
+        cfds.push_back(cfd);
+      }
+    }
+    mutex_.Unlock();
+    for (auto cfd : cfds) {
+      cfd->FreeOrphanedIterTrees();
+    }
+    mutex_.Lock();
+    for (auto cfd : cfds) {
+      cfd->UnrefAndTryDelete();
+    }
+  }
 
   assert(bg_purge_scheduled_ > 0);
 
@@ -2082,7 +2242,8 @@ InternalIterator* DBImpl::NewInternalIterator(
       // FIXME? It's not clear what interpretation of prefix seek is needed
       // here, and no unit test cares about the value provided here.
       !read_options.total_order_seek && prefix_extractor != nullptr,
-      read_options.iterate_upper_bound);
+      read_options.iterate_upper_bound,
+      cfd->ioptions()->merge_with_tournament_tree);
   // Collect iterator for mutable memtable
   auto mem_iter = super_version->mem->NewIterator(
       read_options, super_version->GetSeqnoToTimeMapping(), arena,
@@ -2202,12 +2363,19 @@ Status DBImpl::GetEntity(const ReadOptions& _read_options,
         "Can only call GetEntity with `ReadOptions::io_activity` set to "
         "`Env::IOActivity::kUnknown` or `Env::IOActivity::kGetEntity`");
   }
+  Status s = ValidateProjectedColumns(_read_options);
+  if (!s.ok()) {
+    return s;
+  }
   ReadOptions read_options(_read_options);
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kGetEntity;
   }
   columns->Reset();
 
+  columns->SetProjection(read_options.projected_columns);
+  Defer clear_projection([columns]() { columns->SetProjection(nullptr); });
+
   GetImplOptions get_impl_options;
   get_impl_options.column_family = column_family;
   get_impl_options.columns = columns;
@@ -2228,6 +2396,10 @@ Status DBImpl::GetEntity(const ReadOptions& _read_options, const Slice& key,
     s = Status::InvalidArgument(
         "Can only call GetEntity with `ReadOptions::io_activity` set to "
         "`Env::IOActivity::kUnknown` or `Env::IOActivity::kGetEntity`");
+  } else {
+    s = ValidateProjectedColumns(_read_options);
+  }
+  if (!s.ok()) {
     for (size_t i = 0; i < num_column_families; ++i) {
       (*result)[i].SetStatus(s);
     }
@@ -2448,6 +2620,30 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   bool done = false;
   std::string* timestamp =
       ucmp->timestamp_size() > 0 ? get_impl_options.timestamp : nullptr;
+  // A value found in a memtable is either copied into `value`, or pinned by
+  // handing a reference to `sv` over to `value` when it is large enough.
+  Slice pinned_memtable_value(nullptr, 0);
+  Slice* pinned_value = get_impl_options.value != nullptr &&
+                                read_options.min_memtable_value_size_to_pin > 0
+                            ? &pinned_memtable_value
+                            : nullptr;
+  auto pin_memtable_value = [&]() {
+    PinnableSlice* value = get_impl_options.value;
+    if (pinned_memtable_value.data() == nullptr) {
+      value->PinSelf();
+    } else if (pinned_memtable_value.size() <
+               read_options.min_memtable_value_size_to_pin) {
+      value->PinSelf(pinned_memtable_value);
+    } else {
+      sv->Ref();
+      SuperVersionHandle* sv_handle = new SuperVersionHandle(
+          this, &mutex_, sv,
+          read_options.background_purge_on_iterator_cleanup ||
+              immutable_db_options_.avoid_unnecessary_blocking_io);
+      value->PinSlice(pinned_memtable_value, CleanupSuperVersionHandle,
+                      sv_handle, nullptr);
+    }
+  };
   if (!skip_memtable) {
     // Get value associated with key
     if (get_impl_options.get_value) {
@@ -2458,11 +2654,12 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
               get_impl_options.columns, timestamp, &s, &merge_context,
               &max_covering_tombstone_seq, read_options,
               false /* immutable_memtable */, get_impl_options.callback,
-              get_impl_options.is_blob_index)) {
+              get_impl_options.is_blob_index, true /* do_merge */,
+              pinned_value)) {
         done = true;
 
         if (get_impl_options.value) {
-          get_impl_options.value->PinSelf();
+          pin_memtable_value();
         }
 
         RecordTick(stats_, MEMTABLE_HIT);
@@ -2474,11 +2671,11 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
                               get_impl_options.columns, timestamp, &s,
                               &merge_context, &max_covering_tombstone_seq,
                               read_options, get_impl_options.callback,
-                              get_impl_options.is_blob_index)) {
+                              get_impl_options.is_blob_index, pinned_value)) {
         done = true;
 
         if (get_impl_options.value) {
-          get_impl_options.value->PinSelf();
+          pin_memtable_value();
         }
 
         RecordTick(stats_, MEMTABLE_HIT);
@@ -2869,12 +3066,20 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
 
       col = &columns[i];
       col->Reset();
+      col->SetProjection(read_options.projected_columns);
     }
 
     key_context.emplace_back(column_families[i], keys[i], val, col,
                              timestamps ? &timestamps[i] : nullptr,
                              &statuses[i]);
   }
+  Defer clear_projections([&]() {
+    if (columns && read_options.projected_columns) {
+      for (size_t i = 0; i < num_keys; ++i) {
+        columns[i].SetProjection(nullptr);
+      }
+    }
+  });
   for (size_t i = 0; i < num_keys; ++i) {
     sorted_keys[i] = &key_context[i];
   }
@@ -3059,12 +3264,20 @@ void DBImpl::MultiGetCommon(const ReadOptions& read_options,
 
       col = &columns[i];
       col->Reset();
+      col->SetProjection(read_options.projected_columns);
     }
 
     key_context.emplace_back(column_family, keys[i], val, col,
                              timestamps ? &timestamps[i] : nullptr,
                              &statuses[i]);
   }
+  Defer clear_projections([&]() {
+    if (columns && read_options.projected_columns) {
+      for (size_t i = 0; i < num_keys; ++i) {
+        columns[i].SetProjection(nullptr);
+      }
+    }
+  });
   for (size_t i = 0; i < num_keys; ++i) {
     sorted_keys[i] = &key_context[i];
   }
@@ -3333,6 +3546,17 @@ void DBImpl::MultiGetEntity(const ReadOptions& _read_options, size_t num_keys,
     return;
   }
 
+  {
+    const Status s = ValidateProjectedColumns(_read_options);
+    if (!s.ok()) {
+      for (size_t i = 0; i < num_keys; ++i) {
+        statuses[i] = s;
+      }
+
+      return;
+    }
+  }
+
   ReadOptions read_options(_read_options);
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kMultiGetEntity;
@@ -3390,6 +3614,17 @@ void DBImpl::MultiGetEntity(const ReadOptions& _read_options,
     return;
   }
 
+  {
+    const Status s = ValidateProjectedColumns(_read_options);
+    if (!s.ok()) {
+      for (size_t i = 0; i < num_keys; ++i) {
+        statuses[i] = s;
+      }
+
+      return;
+    }
+  }
+
   ReadOptions read_options(_read_options);
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kMultiGetEntity;
@@ -3431,6 +3666,19 @@ void DBImpl::MultiGetEntity(const ReadOptions& _read_options, size_t num_keys,
     return;
   }
 
+  {
+    const Status s = ValidateProjectedColumns(_read_options);
+    if (!s.ok()) {
+      for (size_t i = 0; i < num_keys; ++i) {
+        for (size_t j = 0; j < results[i].size(); ++j) {
+          results[i][j].SetStatus(s);
+        }
+      }
+
+      return;
+    }
+  }
+
   ReadOptions read_options(_read_options);
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kMultiGetEntity;
@@ -3770,6 +4018,9 @@ Status DBImpl::DropColumnFamilyImpl(ColumnFamilyHandle* column_family) {
     // cfd before its ref-count goes to zero to avoid having to erase cf_info
     // later inside db_mutex.
     EraseThreadStatusCfInfo(cfd);
+    // Recycled iterators are not reused once the column family is dropped,
+    // and would otherwise keep its files until the DB is closed.
+    cfd->ReleaseRecycledIterTrees();
     assert(cfd->IsDropped());
     ROCKS_LOG_INFO(immutable_db_options_.info_log,
                    "Dropped column family with id %u\n", cfd->GetID());
@@ -3819,6 +4070,12 @@ Iterator* DBImpl::NewIterator(const ReadOptions& _read_options,
         "Can only call NewIterator with `ReadOptions::io_activity` is "
         "`Env::IOActivity::kUnknown` or `Env::IOActivity::kDBIterator`"));
   }
+  {
+    const Status s = ValidateProjectedColumns(_read_options);
+    if (!s.ok()) {
+      return NewErrorIterator(s);
+    }
+  }
   ReadOptions read_options(_read_options);
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kDBIterator;
@@ -3852,6 +4109,17 @@ Iterator* DBImpl::NewIterator(const ReadOptions& _read_options,
   assert(cfh != nullptr);
   ColumnFamilyData* cfd = cfh->cfd();
   assert(cfd != nullptr);
+  const bool recycle = read_options.recycle_iterator &&
+                       !read_options.tailing && !read_options.timestamp &&
+                       !read_options.table_filter &&
+                       !read_options.projected_columns;
+  if (recycle) {
+    ArenaWrappedDBIter* db_iter =
+        ArenaWrappedDBIter::NewFromRecycled(env_, read_options, cfh);
+    if (db_iter != nullptr) {
+      return db_iter;
+    }
+  }
   SuperVersion* sv = cfd->GetReferencedSuperVersion(this);
   if (read_options.timestamp && read_options.timestamp->size() > 0) {
     const Status s =
@@ -3876,11 +4144,16 @@ Iterator* DBImpl::NewIterator(const ReadOptions& _read_options,
     // Note: no need to consider the special case of
     // last_seq_same_as_publish_seq_==false since NewIterator is overridden in
     // WritePreparedTxnDB
-    result = NewIteratorImpl(read_options, cfh, sv,
-                             (read_options.snapshot != nullptr)
-                                 ? read_options.snapshot->GetSequenceNumber()
-                                 : kMaxSequenceNumber,
-                             nullptr /* read_callback */);
+    ArenaWrappedDBIter* db_iter =
+        NewIteratorImpl(read_options, cfh, sv,
+                        (read_options.snapshot != nullptr)
+                            ? read_options.snapshot->GetSequenceNumber()
+                            : kMaxSequenceNumber,
+                        nullptr /* read_callback */);
+    if (recycle) {
+      db_iter->SetRecycleOnDestruction(cfd);
+    }
+    result = db_iter;
   }
   return result;
 }
@@ -4030,6 +4303,12 @@ Status DBImpl::NewIterators(
         "Can only call NewIterators with `ReadOptions::io_activity` is "
         "`Env::IOActivity::kUnknown` or `Env::IOActivity::kDBIterator`");
   }
+  {
+    const Status s = ValidateProjectedColumns(_read_options);
+    if (!s.ok()) {
+      return s;
+    }
+  }
   ReadOptions read_options(_read_options);
   if (read_options.io_activity == Env::IOActivity::kUnknown) {
     read_options.io_activity = Env::IOActivity::kDBIterator;
@@ -5355,6 +5634,9 @@ Status DestroyDB(const std::string& dbname, const Options& options,
     uint64_t number;
     FileType type;
     InfoLogPrefix info_log_prefix(!soptions.db_log_dir.empty(), dbname);
+    // Not a numbered DB file
+    const std::string table_tail_snapshot_fname =
+        TableTailSnapshotFileName(dbname);
     for (const auto& fname : filenames) {
       if (ParseFileName(fname, &number, info_log_prefix.prefix, &type) &&
           type != kDBLockFile) {  // Lock file will be deleted at end
@@ -5373,6 +5655,12 @@ Status DestroyDB(const std::string& dbname, const Options& options,
         if (!del.ok() && result.ok()) {
           result = del;
         }
+      } else if (dbname + "/" + fname == table_tail_snapshot_fname ||
+                 dbname + "/" + fname == table_tail_snapshot_fname + ".tmp") {
+        Status del = env->DeleteFile(dbname + "/" + fname);
+        if (!del.ok() && result.ok()) {
+          result = del;
+        }
       }
     }
     paths_to_delete.insert(dbname);
@@ -56,6 +56,7 @@
 #include "rocksdb/env.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/status.h"
+#include "rocksdb/threadpool.h"
 #include "rocksdb/trace_reader_writer.h"
 #include "rocksdb/transaction_log.h"
 #include "rocksdb/user_write_callback.h"
@@ -76,6 +77,7 @@ class InMemoryStatsHistoryIterator;
 class MemTable;
 class PersistentStatsHistoryIterator;
 class TableCache;
+class TableTailSnapshot;
 class TaskLimiterToken;
 class Version;
 class VersionEdit;
@@ -1256,6 +1258,17 @@ class DBImpl : public DB {
   // flush LOG out of application buffer
   void FlushInfoLog();
 
+  // Writes the tails of the live table files to the table tail snapshot
+  // file, see DBOptions::use_table_tail_snapshot. Must not run concurrently
+  // with itself.
+  // REQUIRES: mutex_ not held
+  void WriteTableTailSnapshot();
+
+  // Schedules WriteTableTailSnapshot() in the LOW pool, unless it is already
+  // scheduled or the DB is shutting down.
+  // REQUIRES: mutex_ not held
+  void ScheduleWriteTableTailSnapshot();
+
   // record current sequence number to time mapping. If
   // populate_historical_seconds > 0 then pre-populate all the
   // sequence numbers from [1, last] to map to [now minus
@@ -1544,6 +1557,15 @@ class DBImpl : public DB {
                                 uint64_t log_ref, SequenceNumber seq,
                                 const size_t sub_batch_cnt);
 
+  // If the writer is eligible (see DBOptions::
+  // large_batch_memtable_insert_threads), inserts its batch into the memtables
+  // with multiple threads, setting w->status, and returns true. Otherwise
+  // returns false without doing anything. Must be called by the leader of a
+  // write group consisting of only `w`.
+  bool InsertLargeBatchInParallel(const WriteOptions& write_options,
+                                  WriteThread::Writer* w,
+                                  SequenceNumber sequence);
+
   // Whether the batch requires to be assigned with an order
   enum AssignOrder : bool { kDontAssignOrder, kDoAssignOrder };
   // Whether it requires publishing last sequence or not
@@ -1848,6 +1870,26 @@ class DBImpl : public DB {
     Env::Priority thread_pri_;
   };
 
+  // Memtable flushes run in the background by RecoverLogFiles() with
+  // DBOptions::enable_pipelined_wal_recovery. Protected by mutex_.
+  struct RecoveryFlushes {
+    // Column families with a flush running. The flushes of a column family
+    // run one at a time so that its files get increasing epoch numbers.
+    std::unordered_set<uint32_t> running_cfs;
+    // The first error of a finished flush
+    Status status;
+  };
+
+  // Argument passed to a recovery flush thread.
+  struct RecoveryFlushArg {
+    DBImpl* db_;
+    RecoveryFlushes* flushes_;
+    int job_id_;
+    ColumnFamilyData* cfd_;
+    MemTable* mem_;
+    VersionEdit* edit_;
+  };
+
   // Information for a manual compaction
   struct ManualCompactionState {
     ManualCompactionState(ColumnFamilyData* _cfd, int _input_level,
@@ -2020,6 +2062,20 @@ class DBImpl : public DB {
   Status WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                                      MemTable* mem, VersionEdit* edit);
 
+  // Switches `cfd` to a new memtable and flushes the old one to an L0 file on
+  // the HIGH priority pool, adding it to `edit`. Waits for a previous flush of
+  // `cfd` and for the number of running flushes to go below the size of the
+  // pool first.
+  // REQUIRES: mutex_ held
+  void ScheduleRecoveryFlush(RecoveryFlushes* flushes, int job_id,
+                             ColumnFamilyData* cfd, VersionEdit* edit,
+                             SequenceNumber earliest_seq);
+
+  // Waits for the recovery flushes of `cfd`, or of all column families if
+  // `cfd` is nullptr, to finish.
+  // REQUIRES: mutex_ held
+  void WaitForRecoveryFlushes(RecoveryFlushes* flushes, ColumnFamilyData* cfd);
+
   // Get the size of a log file and, if truncate is true, truncate the
   // log file to its actual size, thereby freeing preallocated space.
   // Return success even if truncate fails
@@ -2191,6 +2247,17 @@ class DBImpl : public DB {
                                 uint64_t* log_used,
                                 SequenceNumber* last_sequence, size_t seq_inc);
 
+  // Waits for in-flight WAL syncs and marks all logs as getting synced, so
+  // that they can be synced by the caller after writing to the WAL.
+  // REQUIRES: log_write_mutex_ held
+  void PrepareLogsForSync();
+
+  // Used by PipelinedWriteImpl with enable_pipelined_wal_sync. If any writer
+  // in `write_group` asked for sync and no completed sync covers
+  // `write_group.last_sequence` yet, syncs the WAL up to everything appended
+  // so far. Safe to call concurrently with WAL appends.
+  IOStatus PipelinedSyncWAL(const WriteThread::WriteGroup& write_group);
+
   // Used by WriteImpl to update bg_error_ if paranoid check is enabled.
   // Caller must hold mutex_.
   void WriteStatusCheckOnLocked(const Status& status);
@@ -2275,6 +2342,8 @@ class DBImpl : public DB {
   static void BGWorkBottomCompaction(void* arg);
   static void BGWorkFlush(void* arg);
   static void BGWorkPurge(void* arg);
+  static void BGWorkRecoveryFlush(void* arg);
+  static void BGWorkWriteTableTailSnapshot(void* arg);
   static void UnscheduleCompactionCallback(void* arg);
   static void UnscheduleFlushCallback(void* arg);
   void BackgroundCallCompaction(PrepickedCompaction* prepicked_compaction,
@@ -2376,6 +2445,10 @@ class DBImpl : public DB {
 
   Status CloseHelper();
 
+  // Free the iterator trees recycled in all column families. REQUIRES: DB
+  // mutex not held.
+  void ReleaseRecycledIterators();
+
   void WaitForBackgroundWork();
 
   // Background threads call this function, which is just a wrapper around
@@ -2587,6 +2660,7 @@ class DBImpl : public DB {
   // * whenever a compaction made any progress
   // * whenever bg_flush_scheduled_ or bg_purge_scheduled_ value decreases
   // (i.e. whenever a flush is done, even if it didn't make any progress)
+  // * whenever a WriteTableTailSnapshot() job is done
   // * whenever there is an error in background purge, flush or compaction
   // * whenever num_running_ingest_file_ goes to 0.
   // * whenever pending_purge_obsolete_files_ goes to 0.
@@ -2752,6 +2826,12 @@ class DBImpl : public DB {
   // to the WAL its size need not to be included in this.
   uint64_t last_batch_group_size_;
 
+  // Only used with enable_pipelined_wal_sync. The last sequence number
+  // appended to the WAL by a WAL writer group, and the last sequence number
+  // covered by a completed WAL sync.
+  std::atomic<SequenceNumber> pipelined_wal_appended_seq_{0};
+  std::atomic<SequenceNumber> pipelined_wal_synced_seq_{0};
+
   FlushScheduler flush_scheduler_;
 
   TrimHistoryScheduler trim_history_scheduler_;
@@ -2813,6 +2893,10 @@ class DBImpl : public DB {
 
   std::deque<SuperVersion*> superversions_to_free_queue_;
 
+  // Set while a purge job is scheduled to free the iterator trees recycled
+  // with an obsolete SuperVersion, see ReadOptions::recycle_iterator
+  bool free_orphaned_iter_trees_scheduled_ = false;
+
   int unscheduled_flushes_;
 
   int unscheduled_compactions_;
@@ -2836,6 +2920,9 @@ class DBImpl : public DB {
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
+  // whether a WriteTableTailSnapshot() job is submitted to the LOW pool
+  bool bg_table_tail_snapshot_scheduled_;
+
   std::deque<ManualCompactionState*> manual_compaction_dequeue_;
 
   // shall we disable deletion of obsolete files
@@ -2920,6 +3007,15 @@ class DBImpl : public DB {
   // It contains the implementations for each periodic task.
   std::map<PeriodicTaskType, const PeriodicTaskFunc> periodic_task_functions_;
 
+  // Set with use_table_tail_snapshot, unless the DB is opened read-only.
+  // Shared with the table caches of the column families.
+  std::shared_ptr<TableTailSnapshot> table_tail_snapshot_;
+
+  // The threads helping the leader of a write group with the memtable insert
+  // of a large batch, see InsertLargeBatchInParallel(). Only set when
+  // large_batch_memtable_insert_threads can take effect.
+  std::unique_ptr<ThreadPool> large_batch_insert_pool_;
+
   // When set, we use a separate queue for writes that don't write to memtable.
   // In 2PC these are the writes at Prepare phase.
   const bool two_write_queues_;
@@ -4300,6 +4300,14 @@ void DBImpl::InstallSuperVersionAndScheduleWork(
   }
   cfd->InstallSuperVersion(sv_context, mutable_cf_options);
 
+  // Free the recycled iterator trees that pin the replaced SuperVersion
+  // promptly, rather than when their threads create the next iterator.
+  if (cfd->HasOrphanedIterTrees() && !free_orphaned_iter_trees_scheduled_ &&
+      opened_successfully_) {
+    free_orphaned_iter_trees_scheduled_ = true;
+    SchedulePurge();
+  }
+
   // There may be a small data race here. The snapshot tricking bottommost
   // compaction may already be released here. But assuming there will always be
   // newer snapshot created and released frequently, the compaction will be
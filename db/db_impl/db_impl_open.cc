@@ -7,17 +7,22 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 #include "db/builder.h"
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
 #include "db/periodic_task_scheduler.h"
+#include "db/table_tail_snapshot.h"
 #include "env/composite_env_wrapper.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
 #include "file/sst_file_manager_impl.h"
 #include "file/writable_file_writer.h"
 #include "logging/logging.h"
+#include "monitoring/iostats_context_imp.h"
 #include "monitoring/persistent_stats_history.h"
 #include "monitoring/thread_status_util.h"
 #include "options/options_helper.h"
@@ -25,6 +30,7 @@
 #include "rocksdb/table.h"
 #include "rocksdb/wal_filter.h"
 #include "test_util/sync_point.h"
+#include "util/defer.h"
 #include "util/rate_limiter_impl.h"
 #include "util/string_util.h"
 #include "util/udt_util.h"
@@ -526,6 +532,28 @@ Status DBImpl::Recover(
     assert(s.ok());
   }
   assert(is_new_db || db_id_.empty());
+  std::shared_ptr<TableTailSnapshot> tail_snapshot;
+  if (immutable_db_options_.use_table_tail_snapshot) {
+    Status snapshot_s = TableTailSnapshot::Read(
+        fs_.get(), TableTailSnapshotFileName(dbname_), &tail_snapshot);
+    if (!snapshot_s.ok()) {
+      // Only slows down opening the table files
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Ignoring table tail snapshot: %s",
+                     snapshot_s.ToString().c_str());
+    }
+    if (!read_only) {
+      table_tail_snapshot_ = tail_snapshot;
+    }
+    versions_->SetTableTailSnapshot(tail_snapshot);
+  }
+  // The tails are only needed to open the table readers of the recovered
+  // version
+  Defer release_tails([&tail_snapshot]() {
+    if (tail_snapshot) {
+      tail_snapshot->ReleaseTails();
+    }
+  });
   Status s;
   bool missing_table_file = false;
   if (!immutable_db_options_.best_efforts_recovery) {
@@ -1103,6 +1131,291 @@ bool DBImpl::InvokeWalFilterIfNeededOnWalRecord(uint64_t wal_number,
   return true;
 }
 
+namespace {
+// A WAL record decoded into a write batch, ready to be inserted into the
+// memtables
+struct RecoveredWalBatch {
+  // Size of the record in the WAL
+  size_t record_size = 0;
+  // The record is too small to be a write batch
+  bool too_small = false;
+  // Non-ok if the write batch could not be decoded
+  Status status;
+  WriteBatch batch;
+  // Set if the timestamp sizes of the batch needed to be reconciled with the
+  // running column families, in which case it replaces `batch`
+  std::unique_ptr<WriteBatch> new_batch;
+
+  WriteBatch* GetBatch() {
+    return new_batch != nullptr ? new_batch.get() : &batch;
+  }
+};
+
+// Reads the next record of the WAL into `wal_batch`, verifying its checksum
+// and decoding it. Returns false at the end of the WAL.
+bool ReadWalBatch(log::Reader* reader, WALRecoveryMode wal_recovery_mode,
+                  const UnorderedMap<uint32_t, size_t>& running_ts_sz,
+                  std::string* scratch, RecoveredWalBatch* wal_batch) {
+  Slice record;
+  uint64_t record_checksum;
+  if (!reader->ReadRecord(&record, scratch, wal_recovery_mode,
+                          &record_checksum)) {
+    return false;
+  }
+  wal_batch->record_size = record.size();
+  wal_batch->too_small = record.size() < WriteBatchInternal::kHeader;
+  wal_batch->new_batch.reset();
+  Status& status = wal_batch->status;
+  status = Status::OK();
+  if (wal_batch->too_small) {
+    return true;
+  }
+  // We start from a new batch and initialize it with a valid prot_info_ to
+  // store the data checksums
+  wal_batch->batch = WriteBatch();
+  status = WriteBatchInternal::SetContents(&wal_batch->batch, record);
+  if (!status.ok()) {
+    return true;
+  }
+
+  const UnorderedMap<uint32_t, size_t>& record_ts_sz =
+      reader->GetRecordedTimestampSize();
+  status = HandleWriteBatchTimestampSizeDifference(
+      &wal_batch->batch, running_ts_sz, record_ts_sz,
+      TimestampSizeConsistencyMode::kReconcileInconsistency,
+      &wal_batch->new_batch);
+  if (!status.ok()) {
+    return true;
+  }
+
+  bool batch_updated = wal_batch->new_batch != nullptr;
+  WriteBatch* batch_to_use = wal_batch->GetBatch();
+  TEST_SYNC_POINT_CALLBACK(
+      "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:batch",
+      batch_to_use);
+  TEST_SYNC_POINT_CALLBACK(
+      "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:checksum",
+      &record_checksum);
+  status = WriteBatchInternal::UpdateProtectionInfo(
+      batch_to_use, 8 /* bytes_per_key */,
+      batch_updated ? nullptr : &record_checksum);
+  return true;
+}
+
+// With DBOptions::enable_pipelined_wal_recovery, reads the records of a WAL
+// on a separate thread, so that reading, checksumming and decoding them
+// overlaps with inserting the previously read ones into the memtables.
+// Corruptions found while reading are reported to `read_status` and
+// `read_old_log_record`, the reporter of the log::Reader, and are handed over
+// to the recovery thread along with the record they precede, so that the
+// records are processed in the same order as if they were read inline.
+class WalBatchPrefetcher {
+ public:
+  WalBatchPrefetcher(log::Reader* reader, WALRecoveryMode wal_recovery_mode,
+                     const UnorderedMap<uint32_t, size_t>* running_ts_sz,
+                     const Status* read_status, const bool* read_old_log_record)
+      : reader_(reader),
+        wal_recovery_mode_(wal_recovery_mode),
+        running_ts_sz_(running_ts_sz),
+        read_status_(read_status),
+        read_old_log_record_(read_old_log_record) {
+    thread_ = port::Thread([this]() { Run(); });
+  }
+
+  ~WalBatchPrefetcher() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  // Returns the next batch of the WAL in `wal_batch`, or false once the end
+  // of the WAL is reached or reading it failed. Corruptions reported while
+  // reading up to this point are merged into `status` and `old_log_record`.
+  bool Next(std::unique_ptr<RecoveredWalBatch>* wal_batch, Status* status,
+            bool* old_log_record) {
+    Item item;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this]() { return !items_.empty(); });
+      item = std::move(items_.front());
+      items_.pop_front();
+      if (item.batch != nullptr) {
+        buffered_bytes_ -= item.batch->record_size;
+      }
+    }
+    cv_.notify_all();
+    if (!item.read_status.ok() && status->ok()) {
+      *status = item.read_status;
+    }
+    *old_log_record = *old_log_record || item.old_log_record;
+    *wal_batch = std::move(item.batch);
+    return *wal_batch != nullptr;
+  }
+
+ private:
+  struct Item {
+    // nullptr marks the end of the WAL
+    std::unique_ptr<RecoveredWalBatch> batch;
+    Status read_status;
+    bool old_log_record = false;
+  };
+
+  // Upper bound on the size of the records read ahead of the recovery thread.
+  // A larger record is still read once the recovery thread caught up.
+  static constexpr size_t kMaxBufferedBytes = 4 << 20;
+
+  void Run() {
+    std::string scratch;
+    bool more = true;
+    while (more) {
+      auto wal_batch = std::make_unique<RecoveredWalBatch>();
+      // Mirrors the inline recovery loop, which stops as soon as reading the
+      // WAL reports a corruption and does not process the record returned
+      // along with it.
+      more = ReadWalBatch(reader_, wal_recovery_mode_, *running_ts_sz_,
+                          &scratch, wal_batch.get()) &&
+             read_status_->ok();
+      Item item;
+      if (more) {
+        // Recovery fails on a batch that cannot be decoded, no need to read
+        // further
+        more = wal_batch->status.ok();
+        item.batch = std::move(wal_batch);
+      }
+      item.read_status = *read_status_;
+      item.old_log_record = *read_old_log_record_;
+      if (!Push(std::move(item))) {
+        return;
+      }
+    }
+  }
+
+  // Returns false if the recovery thread stopped reading the WAL
+  bool Push(Item&& item) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      size_t record_size =
+          item.batch != nullptr ? item.batch->record_size : 0;
+      cv_.wait(lock, [&]() {
+        return stopped_ || buffered_bytes_ == 0 ||
+               buffered_bytes_ + record_size <= kMaxBufferedBytes;
+      });
+      if (stopped_) {
+        return false;
+      }
+      buffered_bytes_ += record_size;
+      items_.push_back(std::move(item));
+    }
+    cv_.notify_all();
+    return true;
+  }
+
+  log::Reader* const reader_;
+  const WALRecoveryMode wal_recovery_mode_;
+  const UnorderedMap<uint32_t, size_t>* const running_ts_sz_;
+  const Status* const read_status_;
+  const bool* const read_old_log_record_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Item> items_;
+  size_t buffered_bytes_ = 0;
+  bool stopped_ = false;
+  port::Thread thread_;
+};
+
+// Upper bound on the size of the records inserted into the memtables at once
+// with DBOptions::enable_pipelined_wal_recovery. Bounds how much a memtable
+// can grow past its write buffer size before it is flushed.
+constexpr size_t kMaxInsertGroupBytes = 1 << 20;
+
+// Only finds the column families assigned to one of the threads inserting
+// recovered write batches, so that each memtable is written by a single
+// thread. Updates to the other column families are skipped like those to a
+// dropped one, which still advances the sequence number.
+class PartitionedColumnFamilyMemTables : public ColumnFamilyMemTablesImpl {
+ public:
+  PartitionedColumnFamilyMemTables(ColumnFamilySet* column_family_set,
+                                   const std::vector<size_t>* cf_partitions,
+                                   size_t partition)
+      : ColumnFamilyMemTablesImpl(column_family_set),
+        cf_partitions_(cf_partitions),
+        partition_(partition) {}
+
+  bool Seek(uint32_t column_family_id) override {
+    return column_family_id < cf_partitions_->size() &&
+           (*cf_partitions_)[column_family_id] == partition_ &&
+           ColumnFamilyMemTablesImpl::Seek(column_family_id);
+  }
+
+ private:
+  const std::vector<size_t>* const cf_partitions_;
+  const size_t partition_;
+};
+
+// Inserts `batches` of WAL `wal_number` into the memtables on
+// `num_partitions` threads, the column family with ID `i` being written by
+// thread `cf_partitions[i]`. The indexes of the batches that failed to be
+// inserted are returned in `errors` in ascending order. Unless
+// `continue_on_error`, a thread stops inserting at its first failure.
+void InsertWalBatches(
+    const std::vector<std::unique_ptr<RecoveredWalBatch>>& batches,
+    const std::vector<size_t>& cf_partitions, size_t num_partitions,
+    ColumnFamilySet* column_family_set, FlushScheduler* flush_scheduler,
+    TrimHistoryScheduler* trim_history_scheduler, uint64_t wal_number,
+    DB* db, bool continue_on_error, bool* has_valid_writes,
+    std::vector<std::pair<size_t, Status>>* errors) {
+  struct PartitionResult {
+    bool has_valid_writes = false;
+    std::vector<std::pair<size_t, Status>> errors;
+  };
+  std::vector<PartitionResult> results(num_partitions);
+  auto insert = [&](size_t partition) {
+    PartitionedColumnFamilyMemTables memtables(column_family_set,
+                                               &cf_partitions, partition);
+    PartitionResult* result = &results[partition];
+    for (size_t i = 0; i < batches.size(); ++i) {
+      Status s = WriteBatchInternal::InsertInto(
+          batches[i]->GetBatch(), &memtables, flush_scheduler,
+          trim_history_scheduler, true /* ignore_missing_column_families */,
+          wal_number, db, false /* concurrent_memtable_writes */,
+          nullptr /* next_seq */, &result->has_valid_writes,
+          false /* seq_per_batch */, true /* batch_per_txn */);
+      if (!s.ok()) {
+        result->errors.emplace_back(i, s);
+        if (!continue_on_error) {
+          break;
+        }
+      }
+    }
+  };
+  std::vector<port::Thread> threads;
+  threads.reserve(num_partitions - 1);
+  for (size_t partition = 1; partition < num_partitions; ++partition) {
+    threads.emplace_back(insert, partition);
+  }
+  insert(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& result : results) {
+    *has_valid_writes = *has_valid_writes || result.has_valid_writes;
+    for (auto& error : result.errors) {
+      errors->push_back(std::move(error));
+    }
+  }
+  std::stable_sort(errors->begin(), errors->end(),
+                   [](const std::pair<size_t, Status>& a,
+                      const std::pair<size_t, Status>& b) {
+                     return a.first < b.first;
+                   });
+}
+}  // namespace
+
 // REQUIRES: wal_numbers are sorted in ascending order
 Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
                                SequenceNumber* next_sequence, bool read_only,
@@ -1161,6 +1474,36 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
   bool stop_replay_by_wal_filter = false;
   bool stop_replay_for_corruption = false;
   bool flushed = false;
+
+  // With pipelined recovery, the write batches of different column families
+  // are inserted in parallel, and full memtables are flushed in the
+  // background. Two-phase commit and seq_per_batch_ need every batch to be
+  // inserted as a whole in WAL order, to rebuild the prepared transactions
+  // and to assign sequence numbers.
+  const bool parallel_insert =
+      immutable_db_options_.enable_pipelined_wal_recovery && !allow_2pc() &&
+      !seq_per_batch_;
+  size_t num_insert_threads = 1;
+  // Thread inserting the updates of each column family, by ID
+  std::vector<size_t> cf_partitions;
+  if (parallel_insert) {
+    ColumnFamilySet* column_family_set = versions_->GetColumnFamilySet();
+    num_insert_threads = std::max<size_t>(
+        1, std::min<size_t>(column_family_set->NumberOfColumnFamilies(),
+                            port::Thread::hardware_concurrency()));
+    size_t next_partition = 0;
+    for (auto cfd : *column_family_set) {
+      if (cfd->GetID() >= cf_partitions.size()) {
+        cf_partitions.resize(cfd->GetID() + 1, num_insert_threads);
+      }
+      cf_partitions[cfd->GetID()] = next_partition;
+      next_partition = (next_partition + 1) % num_insert_threads;
+    }
+  }
+  RecoveryFlushes recovery_flushes;
+  // The background flushes refer to `version_edits`
+  Defer wait_for_recovery_flushes(
+      [&]() { WaitForRecoveryFlushes(&recovery_flushes, nullptr); });
   uint64_t corrupted_wal_number = kMaxSequenceNumber;
   uint64_t min_wal_number = MinLogNumberToKeep();
   if (!allow_2pc()) {
@@ -1233,72 +1576,122 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
     } else {
       reporter.status = &status;
     }
+    // When the WAL is read on a separate thread, corruptions found by the
+    // log::Reader are recorded separately and merged in by the prefetcher.
+    const bool pipelined = immutable_db_options_.enable_pipelined_wal_recovery;
+    Status read_status;
+    bool read_old_log_record = false;
+    LogReporter read_reporter = reporter;
+    if (pipelined) {
+      read_reporter.old_log_record = &read_old_log_record;
+      if (reporter.status != nullptr) {
+        read_reporter.status = &read_status;
+      }
+    }
     // We intentially make log::Reader do checksumming even if
     // paranoid_checks==false so that corruptions cause entire commits
     // to be skipped instead of propagating bad information (like overly
     // large sequence numbers).
     log::Reader reader(immutable_db_options_.info_log, std::move(file_reader),
-                       &reporter, true /*checksum*/, wal_number);
+                       &read_reporter, true /*checksum*/, wal_number);
 
     // Determine if we should tolerate incomplete records at the tail end of the
     // Read all the records and add to a memtable
     std::string scratch;
-    Slice record;
 
     const UnorderedMap<uint32_t, size_t>& running_ts_sz =
         versions_->GetRunningColumnFamiliesTimestampSize();
 
     TEST_SYNC_POINT_CALLBACK("DBImpl::RecoverLogFiles:BeforeReadWal",
                              /*arg=*/nullptr);
-    uint64_t record_checksum;
-    while (!stop_replay_by_wal_filter &&
-           reader.ReadRecord(&record, &scratch,
-                             immutable_db_options_.wal_recovery_mode,
-                             &record_checksum) &&
-           status.ok()) {
-      if (record.size() < WriteBatchInternal::kHeader) {
-        reporter.Corruption(record.size(),
-                            Status::Corruption("log record too small"));
-        continue;
+    std::unique_ptr<WalBatchPrefetcher> prefetcher;
+    if (pipelined) {
+      prefetcher.reset(new WalBatchPrefetcher(
+          &reader, immutable_db_options_.wal_recovery_mode, &running_ts_sz,
+          &read_status, &read_old_log_record));
+    }
+    RecoveredWalBatch inline_batch;
+    std::unique_ptr<RecoveredWalBatch> prefetched_batch;
+    // Batches read from the WAL, to be inserted into the memtables at once
+    // with parallel_insert
+    std::vector<std::unique_ptr<RecoveredWalBatch>> insert_group;
+    size_t insert_group_bytes = 0;
+    // Inserts `insert_group` and schedules the flushes of the memtables that
+    // became full. Since the updates to the other column families of later
+    // batches may already be inserted, a batch that fails to be inserted
+    // fails recovery unless such records are to be skipped.
+    auto insert_group_batches = [&]() {
+      bool has_valid_writes = false;
+      std::vector<std::pair<size_t, Status>> errors;
+      mutex_.Unlock();
+      TEST_SYNC_POINT("DBImpl::RecoverLogFiles:InsertGroup");
+      InsertWalBatches(insert_group, cf_partitions, num_insert_threads,
+                       versions_->GetColumnFamilySet(), &flush_scheduler_,
+                       &trim_history_scheduler_, wal_number, this,
+                       reporter.status == nullptr ||
+                           !immutable_db_options_.paranoid_checks,
+                       &has_valid_writes, &errors);
+      mutex_.Lock();
+      Status s;
+      for (auto& error : errors) {
+        MaybeIgnoreError(&error.second);
+        if (!error.second.ok()) {
+          reporter.Corruption(insert_group[error.first]->record_size,
+                              error.second);
+          if (reporter.status != nullptr && s.ok()) {
+            s = error.second;
+          }
+        }
       }
-      // We create a new batch and initialize with a valid prot_info_ to store
-      // the data checksums
-      WriteBatch batch;
-      std::unique_ptr<WriteBatch> new_batch;
-
-      status = WriteBatchInternal::SetContents(&batch, record);
-      if (!status.ok()) {
-        return status;
+      insert_group.clear();
+      insert_group_bytes = 0;
+      if (!s.ok()) {
+        return s;
       }
-
-      const UnorderedMap<uint32_t, size_t>& record_ts_sz =
-          reader.GetRecordedTimestampSize();
-      status = HandleWriteBatchTimestampSizeDifference(
-          &batch, running_ts_sz, record_ts_sz,
-          TimestampSizeConsistencyMode::kReconcileInconsistency, &new_batch);
-      if (!status.ok()) {
-        return status;
+      if (has_valid_writes && !read_only) {
+        ColumnFamilyData* cfd;
+        while ((cfd = flush_scheduler_.TakeNextColumnFamily()) != nullptr) {
+          cfd->UnrefAndTryDelete();
+          assert(cfd->GetLogNumber() <= wal_number);
+          auto iter = version_edits.find(cfd->GetID());
+          assert(iter != version_edits.end());
+          ScheduleRecoveryFlush(&recovery_flushes, job_id, cfd, &iter->second,
+                                *next_sequence - 1);
+          flushed = true;
+        }
       }
-
-      bool batch_updated = new_batch != nullptr;
-      WriteBatch* batch_to_use = batch_updated ? new_batch.get() : &batch;
-      TEST_SYNC_POINT_CALLBACK(
-          "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:batch",
-          batch_to_use);
-      TEST_SYNC_POINT_CALLBACK(
-          "DBImpl::RecoverLogFiles:BeforeUpdateProtectionInfo:checksum",
-          &record_checksum);
-      status = WriteBatchInternal::UpdateProtectionInfo(
-          batch_to_use, 8 /* bytes_per_key */,
-          batch_updated ? nullptr : &record_checksum);
+      // Reflect errors of the flushes immediately, like when flushing
+      // synchronously
+      return recovery_flushes.status;
+    };
+    RecoveredWalBatch* wal_batch = &inline_batch;
+    auto read_next_batch = [&]() {
+      if (prefetcher == nullptr) {
+        return ReadWalBatch(&reader, immutable_db_options_.wal_recovery_mode,
+                            running_ts_sz, &scratch, &inline_batch);
+      }
+      if (!prefetcher->Next(&prefetched_batch, &status, &old_log_record)) {
+        return false;
+      }
+      wal_batch = prefetched_batch.get();
+      return true;
+    };
+    while (!stop_replay_by_wal_filter && read_next_batch() && status.ok()) {
+      if (wal_batch->too_small) {
+        reporter.Corruption(wal_batch->record_size,
+                            Status::Corruption("log record too small"));
+        continue;
+      }
+      status = wal_batch->status;
       if (!status.ok()) {
         return status;
       }
 
+      WriteBatch* batch_to_use = wal_batch->GetBatch();
       SequenceNumber sequence = WriteBatchInternal::Sequence(batch_to_use);
       if (sequence > kMaxSequenceNumber) {
         reporter.Corruption(
-            record.size(),
+            wal_batch->record_size,
             Status::Corruption("sequence " + std::to_string(sequence) +
                                " is too large"));
         continue;
@@ -1327,6 +1720,20 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
         continue;
       }
 
+      if (parallel_insert) {
+        // Without seq_per_batch_, every update takes a sequence number
+        *next_sequence = sequence + WriteBatchInternal::Count(batch_to_use);
+        insert_group_bytes += wal_batch->record_size;
+        insert_group.push_back(std::move(prefetched_batch));
+        if (insert_group_bytes >= kMaxInsertGroupBytes) {
+          status = insert_group_batches();
+          if (!status.ok()) {
+            return status;
+          }
+        }
+        continue;
+      }
+
       // If column family was not found, it might mean that the WAL write
       // batch references to the column family that was dropped after the
       // insert. We don't want to fail the whole write batch in that case --
@@ -1342,7 +1749,7 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       if (!status.ok()) {
         // We are treating this as a failure while reading since we read valid
         // blocks that do not form coherent data
-        reporter.Corruption(record.size(), status);
+        reporter.Corruption(wal_batch->record_size, status);
         continue;
       }
 
@@ -1373,6 +1780,14 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       }
     }
 
+    if (!insert_group.empty()) {
+      // The batches read before the replay stopped
+      Status s = insert_group_batches();
+      if (!s.ok()) {
+        return s;
+      }
+    }
+
     if (!status.ok() || old_log_record) {
       if (status.IsNotSupported()) {
         // We should not treat NotSupported as corruption. It is rather a clear
@@ -1427,6 +1842,11 @@ Status DBImpl::RecoverLogFiles(const std::vector<uint64_t>& wal_numbers,
       versions_->SetLastSequence(last_sequence);
     }
   }
+  WaitForRecoveryFlushes(&recovery_flushes, nullptr);
+  if (!recovery_flushes.status.ok()) {
+    return recovery_flushes.status;
+  }
+
   // Compare the corrupted log number to all columnfamily's current log number.
   // Abort Open() if any column family's log number is greater than
   // the corrupted log number, which means CF contains data beyond the point of
@@ -1845,6 +2265,58 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
   return s;
 }
 
+void DBImpl::ScheduleRecoveryFlush(RecoveryFlushes* flushes, int job_id,
+                                   ColumnFamilyData* cfd, VersionEdit* edit,
+                                   SequenceNumber earliest_seq) {
+  mutex_.AssertHeld();
+  WaitForRecoveryFlushes(flushes, cfd);
+  const size_t max_running_flushes = static_cast<size_t>(
+      std::max(1, env_->GetBackgroundThreads(Env::Priority::HIGH)));
+  while (flushes->running_cfs.size() >= max_running_flushes) {
+    bg_cv_.Wait();
+  }
+
+  // The flush holds references to the memtable and the column family until
+  // it finishes
+  MemTable* mem = cfd->mem();
+  mem->Ref();
+  cfd->Ref();
+  cfd->CreateNewMemtable(*cfd->GetLatestMutableCFOptions(), earliest_seq);
+  flushes->running_cfs.insert(cfd->GetID());
+  RecoveryFlushArg* rfa =
+      new RecoveryFlushArg{this, flushes, job_id, cfd, mem, edit};
+  env_->Schedule(&DBImpl::BGWorkRecoveryFlush, rfa, Env::Priority::HIGH,
+                 nullptr);
+}
+
+void DBImpl::WaitForRecoveryFlushes(RecoveryFlushes* flushes,
+                                    ColumnFamilyData* cfd) {
+  mutex_.AssertHeld();
+  while (cfd != nullptr ? flushes->running_cfs.count(cfd->GetID()) > 0
+                        : !flushes->running_cfs.empty()) {
+    bg_cv_.Wait();
+  }
+}
+
+void DBImpl::BGWorkRecoveryFlush(void* arg) {
+  RecoveryFlushArg rfa = *(static_cast<RecoveryFlushArg*>(arg));
+  delete static_cast<RecoveryFlushArg*>(arg);
+
+  IOSTATS_SET_THREAD_POOL_ID(Env::Priority::HIGH);
+  TEST_SYNC_POINT("DBImpl::BGWorkRecoveryFlush");
+  DBImpl* db = rfa.db_;
+  InstrumentedMutexLock l(&db->mutex_);
+  Status s = db->WriteLevel0TableForRecovery(rfa.job_id_, rfa.cfd_, rfa.mem_,
+                                             rfa.edit_);
+  if (!s.ok() && rfa.flushes_->status.ok()) {
+    rfa.flushes_->status = s;
+  }
+  delete rfa.mem_->Unref();
+  rfa.flushes_->running_cfs.erase(rfa.cfd_->GetID());
+  rfa.cfd_->UnrefAndTryDelete();
+  db->bg_cv_.SignalAll();
+}
+
 Status DB::Open(const Options& options, const std::string& dbname, DB** dbptr) {
   DBOptions db_options(options);
   ColumnFamilyOptions cf_options(options);
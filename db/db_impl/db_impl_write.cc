@@ -16,6 +16,7 @@
 #include "options/options_helper.h"
 #include "test_util/sync_point.h"
 #include "util/cast_util.h"
+#include "util/mutexlock.h"
 
 namespace ROCKSDB_NAMESPACE {
 // Convenience methods
@@ -620,13 +621,18 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
       PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
 
       if (!parallel) {
-        // w.sequence will be set inside InsertInto
-        w.status = WriteBatchInternal::InsertInto(
-            write_group, current_sequence, column_family_memtables_.get(),
-            &flush_scheduler_, &trim_history_scheduler_,
-            write_options.ignore_missing_column_families,
-            0 /*recovery_log_number*/, this, parallel, seq_per_batch_,
-            batch_per_txn_);
+        if (write_group.size == 1 &&
+            InsertLargeBatchInParallel(write_options, &w, current_sequence)) {
+          assert(w.sequence == current_sequence);
+        } else {
+          // w.sequence will be set inside InsertInto
+          w.status = WriteBatchInternal::InsertInto(
+              write_group, current_sequence, column_family_memtables_.get(),
+              &flush_scheduler_, &trim_history_scheduler_,
+              write_options.ignore_missing_column_families,
+              0 /*recovery_log_number*/, this, parallel, seq_per_batch_,
+              batch_per_txn_);
+        }
       } else {
         write_group.last_sequence = last_sequence;
         write_thread_.LaunchParallelMemTableWriters(&write_group);
@@ -720,7 +726,14 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     if (w.callback && !w.callback->AllowWriteBatching()) {
       write_thread_.WaitForMemTableWriters();
     }
-    LogContext log_context(!write_options.disableWAL && write_options.sync);
+    const bool need_wal_sync = !write_options.disableWAL && write_options.sync;
+    // With enable_pipelined_wal_sync, the sync is left to the memtable writer
+    // stage (see PipelinedSyncWAL()) so that the next WAL writer group can
+    // append while it is in flight.
+    bool defer_wal_sync = need_wal_sync &&
+                          immutable_db_options_.enable_pipelined_wal_sync &&
+                          !manual_wal_flush_;
+    LogContext log_context(need_wal_sync && !defer_wal_sync);
     // PreprocessWrite does its own perf timing.
     PERF_TIMER_STOP(write_pre_and_post_process_time);
     w.status = PreprocessWrite(write_options, &log_context, &write_context);
@@ -729,6 +742,27 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     // This can set non-OK status if callback fail.
     last_batch_group_size_ =
         write_thread_.EnterAsBatchGroupLeader(&w, &wal_write_group);
+
+    if (w.status.ok() && defer_wal_sync) {
+      // Writers that skip the memtable are completed as soon as the WAL
+      // writer stage ends, and a sync concurrent with WAL appends needs
+      // thread-safe sync support. Otherwise sync in this stage as usual.
+      bool sync_in_wal_stage =
+          !log_context.writer->file()->writable_file()->IsSyncThreadSafe();
+      for (auto* writer : wal_write_group) {
+        if (writer->disable_memtable) {
+          sync_in_wal_stage = true;
+          break;
+        }
+      }
+      if (sync_in_wal_stage) {
+        defer_wal_sync = false;
+        InstrumentedMutexLock l(&log_write_mutex_);
+        PrepareLogsForSync();
+        log_context.need_log_sync = true;
+        log_context.need_log_dir_sync = !log_dir_synced_;
+      }
+    }
     const SequenceNumber current_sequence =
         write_thread_.UpdateLastSequence(versions_->LastSequence()) + 1;
     size_t total_count = 0;
@@ -802,6 +836,19 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
       w.status = io_s;
     }
 
+    if (w.status.ok() && immutable_db_options_.enable_pipelined_wal_sync) {
+      // Every sequence number of this group is now in the WAL (or has WAL
+      // disabled), and if we synced above, so is everything before it.
+      const SequenceNumber wal_last_sequence =
+          current_sequence + total_count - 1;
+      pipelined_wal_appended_seq_.store(wal_last_sequence,
+                                        std::memory_order_release);
+      if (log_context.need_log_sync) {
+        pipelined_wal_synced_seq_.store(wal_last_sequence,
+                                        std::memory_order_release);
+      }
+    }
+
     if (!io_s.ok()) {
       // Check WriteToWAL status
       WALIOStatusCheck(io_s);
@@ -838,8 +885,19 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
     PERF_TIMER_FOR_WAIT_GUARD(write_memtable_time);
     assert(w.ShouldWriteToMemtable());
     write_thread_.EnterAsMemTableWriter(&w, &memtable_write_group);
-    if (memtable_write_group.size > 1 &&
-        immutable_db_options_.allow_concurrent_memtable_write) {
+    IOStatus sync_s;
+    if (immutable_db_options_.enable_pipelined_wal_sync) {
+      PERF_TIMER_GUARD(write_wal_time);
+      sync_s = PipelinedSyncWAL(memtable_write_group);
+    }
+    if (!sync_s.ok()) {
+      // Nothing in this group was synced, or the synced WALs could not be
+      // recorded in the MANIFEST, so none of it is inserted. The error has
+      // already been recorded as a background error.
+      memtable_write_group.status = sync_s;
+      write_thread_.ExitAsMemTableWriter(&w, memtable_write_group);
+    } else if (memtable_write_group.size > 1 &&
+               immutable_db_options_.allow_concurrent_memtable_write) {
       write_thread_.LaunchParallelMemTableWriters(&memtable_write_group);
     } else {
       memtable_write_group.status = WriteBatchInternal::InsertInto(
@@ -889,6 +947,92 @@ Status DBImpl::PipelinedWriteImpl(const WriteOptions& write_options,
   return w.FinalStatus();
 }
 
+bool DBImpl::InsertLargeBatchInParallel(const WriteOptions& write_options,
+                                        WriteThread::Writer* w,
+                                        SequenceNumber sequence) {
+  // See the comment on allow_concurrent_memtable_write in WriteImpl() for the
+  // requirements of concurrent memtable inserts. With seq_per_batch_, a batch
+  // consumes one sequence number per sub-batch, a sub-batch ending before a
+  // key that repeats within it. The sequence number of each part would thus
+  // depend on the keys of all the preceding parts, so the parts could not be
+  // inserted independently. large_batch_insert_pool_ is not created then.
+  if (large_batch_insert_pool_ == nullptr || w->CallbackFailed() ||
+      !w->ShouldWriteToMemtable() ||
+      WriteBatchInternal::Count(w->batch) <
+          immutable_db_options_.large_batch_memtable_insert_min_entries) {
+    return false;
+  }
+  assert(!seq_per_batch_);
+
+  std::vector<WriteBatchInternal::Part> parts;
+  if (!WriteBatchInternal::SplitForParallelInsert(
+          w->batch,
+          static_cast<size_t>(
+              immutable_db_options_.large_batch_memtable_insert_threads),
+          &parts)) {
+    return false;
+  }
+  size_t num_parts = parts.size();
+  TEST_SYNC_POINT_CALLBACK("DBImpl::InsertLargeBatchInParallel:NumParts",
+                           &num_parts);
+
+  w->sequence = sequence;
+  WriteBatchInternal::SetSequence(w->batch, sequence);
+
+  // The parts are claimed by the leader and the pool threads alike, so the
+  // leader finishes the batch by itself when the pool threads are busy
+  // helping another write, and the pool threads that come late find nothing
+  // left to do. The state outlives this call for those.
+  struct ParallelInsert {
+    std::atomic<size_t> next_part{0};
+    port::Mutex mutex;
+    port::CondVar cv{&mutex};
+    size_t num_inserted = 0;
+    std::vector<Status> statuses;
+  };
+  auto state = std::make_shared<ParallelInsert>();
+  state->statuses.resize(num_parts);
+  auto insert_parts = [this, &write_options, w, &parts, sequence,
+                       num_parts](ParallelInsert* insert) {
+    for (size_t i = insert->next_part.fetch_add(1, std::memory_order_relaxed);
+         i < num_parts;
+         i = insert->next_part.fetch_add(1, std::memory_order_relaxed)) {
+      // Each thread needs its own ColumnFamilyMemTables
+      ColumnFamilyMemTablesImpl column_family_memtables(
+          versions_->GetColumnFamilySet());
+      Status s = WriteBatchInternal::InsertPartInto(
+          w->batch, parts[i], sequence, &column_family_memtables,
+          &flush_scheduler_, &trim_history_scheduler_,
+          write_options.ignore_missing_column_families, w->log_ref, this);
+      MutexLock l(&insert->mutex);
+      insert->statuses[i] = std::move(s);
+      if (++insert->num_inserted == num_parts) {
+        insert->cv.SignalAll();
+      }
+    }
+  };
+
+  for (size_t i = 1; i < num_parts; ++i) {
+    // The references captured by insert_parts are only used while there are
+    // parts left, that is before this function returns
+    large_batch_insert_pool_->SubmitJob(
+        [state, insert_parts]() { insert_parts(state.get()); });
+  }
+  insert_parts(state.get());
+
+  MutexLock l(&state->mutex);
+  while (state->num_inserted < num_parts) {
+    state->cv.Wait();
+  }
+  w->status = Status::OK();
+  for (const Status& s : state->statuses) {
+    if (!s.ok() && w->status.ok()) {
+      w->status = s;
+    }
+  }
+  return true;
+}
+
 Status DBImpl::UnorderedWriteMemtable(const WriteOptions& write_options,
                                       WriteBatch* my_batch,
                                       WriteCallback* callback, uint64_t log_ref,
@@ -1300,24 +1444,7 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
   }
   InstrumentedMutexLock l(&log_write_mutex_);
   if (status.ok() && log_context->need_log_sync) {
-    // Wait until the parallel syncs are finished. Any sync process has to sync
-    // the front log too so it is enough to check the status of front()
-    // We do a while loop since log_sync_cv_ is signalled when any sync is
-    // finished
-    // Note: there does not seem to be a reason to wait for parallel sync at
-    // this early step but it is not important since parallel sync (SyncWAL) and
-    // need_log_sync are usually not used together.
-    while (logs_.front().IsSyncing()) {
-      log_sync_cv_.Wait();
-    }
-    for (auto& log : logs_) {
-      // This is just to prevent the logs to be synced by a parallel SyncWAL
-      // call. We will do the actual syncing later after we will write to the
-      // WAL.
-      // Note: there does not seem to be a reason to set this early before we
-      // actually write to the WAL
-      log.PrepareForSync();
-    }
+    PrepareLogsForSync();
   } else {
     log_context->need_log_sync = false;
   }
@@ -1329,6 +1456,85 @@ Status DBImpl::PreprocessWrite(const WriteOptions& write_options,
   return status;
 }
 
+void DBImpl::PrepareLogsForSync() {
+  log_write_mutex_.AssertHeld();
+  // Wait until the parallel syncs are finished. Any sync process has to sync
+  // the front log too so it is enough to check the status of front()
+  // We do a while loop since log_sync_cv_ is signalled when any sync is
+  // finished
+  // Note: there does not seem to be a reason to wait for parallel sync at
+  // this early step but it is not important since parallel sync (SyncWAL) and
+  // need_log_sync are usually not used together.
+  while (logs_.front().IsSyncing()) {
+    log_sync_cv_.Wait();
+  }
+  for (auto& log : logs_) {
+    // This is just to prevent the logs to be synced by a parallel SyncWAL
+    // call. We will do the actual syncing later after we will write to the
+    // WAL.
+    // Note: there does not seem to be a reason to set this early before we
+    // actually write to the WAL
+    log.PrepareForSync();
+  }
+}
+
+IOStatus DBImpl::PipelinedSyncWAL(const WriteThread::WriteGroup& write_group) {
+  bool need_sync = false;
+  for (auto* writer : write_group) {
+    if (writer->sync) {
+      need_sync = true;
+      break;
+    }
+  }
+  if (!need_sync || pipelined_wal_synced_seq_.load(std::memory_order_acquire) >=
+                        write_group.last_sequence) {
+    return IOStatus::OK();
+  }
+
+  TEST_SYNC_POINT("DBImpl::PipelinedSyncWAL:BeforeSync");
+  // Everything up to this sequence number has been appended and flushed to
+  // the WAL file by now, so the sync below covers it, including groups that
+  // finished their WAL write after `write_group`.
+  const SequenceNumber up_to =
+      pipelined_wal_appended_seq_.load(std::memory_order_acquire);
+  assert(up_to >= write_group.last_sequence);
+
+  // TODO: plumb Env::IOActivity, Env::IOPriority
+  const WriteOptions write_options;
+  VersionEdit synced_wals;
+  IOStatus io_s;
+  {
+    StopWatch sw(immutable_db_options_.clock, stats_, WAL_FILE_SYNC_MICROS);
+    io_s = SyncWalImpl(/*include_current_wal=*/true, write_options,
+                       /*job_context=*/nullptr, &synced_wals,
+                       /*error_recovery_in_prog=*/false);
+  }
+  if (io_s.ok() && synced_wals.IsWalAddition()) {
+    InstrumentedMutexLock l(&mutex_);
+    // TODO: plumb Env::IOActivity, Env::IOPriority
+    const ReadOptions read_options;
+    io_s = status_to_io_status(
+        ApplyWALToManifest(read_options, write_options, &synced_wals));
+    if (!io_s.ok() && immutable_db_options_.paranoid_checks &&
+        error_handler_.GetBGError().ok()) {
+      // The WAL is synced, but the writers of this group fail and their
+      // records are not inserted into the memtables. Stop further writes as
+      // for a failed sync, see WALIOStatusCheck().
+      error_handler_.SetBGError(io_s, BackgroundErrorReason::kManifestWrite);
+    }
+  }
+  if (io_s.ok()) {
+    default_cf_internal_stats_->AddDBStats(
+        InternalStats::kIntStatsWalFileSynced, 1, true /* concurrent */);
+    SequenceNumber synced =
+        pipelined_wal_synced_seq_.load(std::memory_order_relaxed);
+    while (synced < up_to && !pipelined_wal_synced_seq_.compare_exchange_weak(
+                                 synced, up_to, std::memory_order_acq_rel)) {
+    }
+  }
+  return io_s;
+}
+
 Status DBImpl::MergeBatch(const WriteThread::WriteGroup& write_group,
                           WriteBatch* tmp_batch, WriteBatch** merged_batch,
                           size_t* write_with_wal,
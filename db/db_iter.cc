@@ -88,6 +88,21 @@ DBIter::DBIter(Env* _env, const ReadOptions& read_options,
   if (iter_.iter()) {
     iter_.iter()->SetPinnedItersMgr(&pinned_iters_mgr_);
   }
+  if (read_options.projected_columns) {
+    const std::vector<Slice>& columns = *read_options.projected_columns;
+    project_default_column_ =
+        !columns.empty() && columns.front() == kDefaultWideColumnName;
+    if (project_default_column_) {
+      projected_columns_ = &columns;
+    } else {
+      projected_columns_with_default_.reserve(columns.size() + 1);
+      projected_columns_with_default_.emplace_back(kDefaultWideColumnName);
+      projected_columns_with_default_.insert(
+          projected_columns_with_default_.end(), columns.begin(),
+          columns.end());
+      projected_columns_ = &projected_columns_with_default_;
+    }
+  }
   status_.PermitUncheckedError();
   assert(timestamp_size_ ==
          user_comparator_.user_comparator()->timestamp_size());
@@ -264,7 +279,11 @@ bool DBIter::SetValueAndColumnsFromEntity(Slice slice) {
   assert(value_.empty());
   assert(wide_columns_.empty());
 
-  const Status s = WideColumnSerialization::Deserialize(slice, wide_columns_);
+  const Status s =
+      projected_columns_
+          ? WideColumnSerialization::DeserializeColumns(
+                slice, *projected_columns_, wide_columns_)
+          : WideColumnSerialization::Deserialize(slice, wide_columns_);
 
   if (!s.ok()) {
     status_ = s;
@@ -275,6 +294,9 @@ bool DBIter::SetValueAndColumnsFromEntity(Slice slice) {
 
   if (WideColumnsHelper::HasDefaultColumn(wide_columns_)) {
     value_ = WideColumnsHelper::GetDefaultColumn(wide_columns_);
+    if (!project_default_column_) {
+      wide_columns_.erase(wide_columns_.begin());
+    }
   }
 
   return true;
@@ -218,6 +218,19 @@ class DBIter final : public Iterator {
   }
   void set_valid(bool v) { valid_ = v; }
 
+  // Release the data pinned for the user and publish the local statistics,
+  // as on destruction, so that the iterator can be reused after Refresh().
+  void PrepareForReuse() {
+    if (pin_thru_lifetime_ && pinned_iters_mgr_.PinningEnabled()) {
+      pinned_iters_mgr_.ReleasePinnedData();
+      pinned_iters_mgr_.StartPinning();
+    }
+    ResetInternalKeysSkippedCounter();
+    local_stats_.BumpGlobalStatistics(statistics_);
+    valid_ = false;
+    status_ = Status::OK();
+  }
+
   bool PrepareValue() override;
 
  private:
@@ -331,7 +344,9 @@ class DBIter final : public Iterator {
     assert(wide_columns_.empty());
 
     value_ = slice;
-    wide_columns_.emplace_back(kDefaultWideColumnName, slice);
+    if (project_default_column_) {
+      wide_columns_.emplace_back(kDefaultWideColumnName, slice);
+    }
   }
 
   bool SetValueAndColumnsFromBlobImpl(const Slice& user_key,
@@ -410,6 +425,12 @@ class DBIter final : public Iterator {
   Slice value_;
   // All columns (i.e. name-value pairs)
   WideColumns wide_columns_;
+  // The columns deserialized from entities if ReadOptions::projected_columns is
+  // set. They always include the default column, which backs value(), but it
+  // is dropped from wide_columns_ unless it was requested.
+  const std::vector<Slice>* projected_columns_ = nullptr;
+  std::vector<Slice> projected_columns_with_default_;
+  bool project_default_column_ = true;
   Statistics* statistics_;
   uint64_t max_skip_;
   uint64_t max_skippable_internal_keys_;
@@ -3685,6 +3685,157 @@ TEST_F(DBIteratorTest, IteratorsConsistentViewExplicitSnapshot) {
   }
 }
 
+TEST_F(DBIteratorBaseTest, RecycleIterator) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+  ASSERT_OK(Put("a", "v1"));
+  ASSERT_OK(Put("b", "v1"));
+
+  ReadOptions ro;
+  ro.recycle_iterator = true;
+  auto count_keys = [&](const ReadOptions& read_options) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    EXPECT_OK(iter->status());
+    return count;
+  };
+  ASSERT_EQ(2, count_keys(ro));
+  uint64_t created = options.statistics->getTickerCount(NO_ITERATOR_CREATED);
+
+  // Same SuperVersion: the tree is reused and sees new memtable writes.
+  ASSERT_OK(Put("c", "v1"));
+  ASSERT_EQ(3, count_keys(ro));
+  ASSERT_EQ(created,
+            options.statistics->getTickerCount(NO_ITERATOR_CREATED));
+
+  // An older snapshot is honored by the reused tree.
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("d", "v1"));
+  ASSERT_OK(Delete("a"));
+  ro.snapshot = snapshot;
+  ASSERT_EQ(3, count_keys(ro));
+  ro.snapshot = nullptr;
+  ASSERT_EQ(3, count_keys(ro));
+  ASSERT_EQ(created,
+            options.statistics->getTickerCount(NO_ITERATOR_CREATED));
+  db_->ReleaseSnapshot(snapshot);
+
+  // Range tombstones written after the tree was built are visible.
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "c",
+                             "d"));
+  ASSERT_EQ(2, count_keys(ro));
+
+  // A new SuperVersion forces a rebuild.
+  ASSERT_OK(Flush());
+  created = options.statistics->getTickerCount(NO_ITERATOR_CREATED);
+  ASSERT_EQ(2, count_keys(ro));
+  ASSERT_EQ(created + 1,
+            options.statistics->getTickerCount(NO_ITERATOR_CREATED));
+  ASSERT_EQ(2, count_keys(ro));
+  ASSERT_EQ(created + 1,
+            options.statistics->getTickerCount(NO_ITERATOR_CREATED));
+
+  // Different iterate bounds are not reused.
+  std::string upper = "c";
+  Slice upper_bound(upper);
+  ro.iterate_upper_bound = &upper_bound;
+  ASSERT_EQ(1, count_keys(ro));
+  ASSERT_EQ(created + 2,
+            options.statistics->getTickerCount(NO_ITERATOR_CREATED));
+
+  // Iterators without the option are never recycled.
+  ReadOptions plain_ro;
+  ASSERT_EQ(2, count_keys(plain_ro));
+  ASSERT_EQ(2, count_keys(plain_ro));
+  ASSERT_EQ(created + 4,
+            options.statistics->getTickerCount(NO_ITERATOR_CREATED));
+  Close();
+}
+
+TEST_F(DBIteratorBaseTest, RecycleIteratorThreadExitAndDrop) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"pikachu"}, options);
+  ASSERT_OK(Put(0, "a", "v1"));
+  ASSERT_OK(Put(1, "a", "v1"));
+  ASSERT_OK(Flush(0));
+  ASSERT_OK(Flush(1));
+
+  ReadOptions ro;
+  ro.recycle_iterator = true;
+  auto scan = [&](ColumnFamilyHandle* cfh) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro, cfh));
+    iter->SeekToFirst();
+    EXPECT_TRUE(iter->Valid());
+    EXPECT_OK(iter->status());
+  };
+
+  // Trees parked by exited threads are freed later, and the files they
+  // pinned stay readable in the meantime.
+  for (int i = 0; i < 4; ++i) {
+    port::Thread t([&]() {
+      scan(handles_[0]);
+      scan(handles_[1]);
+    });
+    t.join();
+  }
+  scan(handles_[0]);
+  scan(handles_[1]);
+
+  // Dropping a column family releases its parked tree.
+  ASSERT_OK(db_->DropColumnFamily(handles_[1]));
+  ASSERT_OK(db_->DestroyColumnFamilyHandle(handles_[1]));
+  handles_.pop_back();
+
+  // A tree built on an older SuperVersion is not reused after compaction,
+  // and Close() releases the one still parked.
+  ASSERT_OK(Put(0, "b", "v1"));
+  ASSERT_OK(Flush(0));
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  scan(handles_[0]);
+  Close();
+}
+
+TEST_F(DBIteratorBaseTest, RecycleIteratorReleasedOnNewSuperVersion) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+  // Overlapping files, so that compaction rewrites them rather than moving
+  // them
+  ASSERT_OK(Put("a", "v1"));
+  ASSERT_OK(Put("c", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b", "v1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(2, GetSstFileCount(dbname_));
+
+  ReadOptions ro;
+  ro.recycle_iterator = true;
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+  }
+
+  // The tree parked by this thread must not keep the compacted files alive
+  // until the thread creates another iterator.
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_OK(dbfull()->TEST_WaitForPurge());
+  ASSERT_EQ(1, GetSstFileCount(dbname_));
+
+  std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+  iter->SeekToFirst();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("a", iter->key());
+  iter.reset();
+  Close();
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -339,6 +339,102 @@ TEST_F(DBMemTableTest, ColumnFamilyId) {
   }
 }
 
+TEST_F(DBMemTableTest, AdaptiveSkipListFactory) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.memtable_factory.reset(new AdaptiveSkipListFactory());
+  DestroyAndReopen(options);
+
+  std::vector<bool> deferred_history;
+  SyncPoint::GetInstance()->SetCallBack(
+      "AdaptiveSkipListFactory::CreateMemTableRep", [&](void* arg) {
+        deferred_history.push_back(*static_cast<bool*>(arg));
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  const int kNumKeys = 1000;
+  std::vector<int> order(kNumKeys);
+  for (int i = 0; i < kNumKeys; ++i) {
+    order[i] = i;
+  }
+  auto write_keys = [&](const std::string& value_prefix) {
+    RandomShuffle(order.begin(), order.end(), rnd.Next());
+    for (int i : order) {
+      ASSERT_OK(Put(Key(i), value_prefix + std::to_string(i)));
+    }
+  };
+  auto verify_keys = [&](const std::string& value_prefix) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+      ASSERT_EQ(Key(i), iter->key().ToString());
+      ASSERT_EQ(value_prefix + std::to_string(i), iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, i);
+  };
+
+  // The first memtable is not read while mutable, so the next one defers
+  // indexing. Flushing the deferred memtable sorts it.
+  write_keys("a");
+  ASSERT_OK(Flush());
+  ASSERT_EQ(std::vector<bool>({true}), deferred_history);
+  write_keys("b");
+  ASSERT_OK(Flush());
+  ASSERT_EQ(std::vector<bool>({true, true}), deferred_history);
+  verify_keys("b");
+
+  // Reads of a deferred memtable index it on the fly, and switch the next
+  // memtable back to regular mode. The memtable above was already read by
+  // verify_keys() while empty.
+  write_keys("c");
+  ASSERT_EQ("c7", Get(Key(7)));
+  write_keys("d");
+  verify_keys("d");
+  ASSERT_OK(Flush());
+  ASSERT_EQ(std::vector<bool>({true, true, false}), deferred_history);
+  write_keys("e");
+  // Gets skip an empty memtable, so this must follow the writes
+  ASSERT_EQ("e7", Get(Key(7)));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(std::vector<bool>({true, true, false, false}), deferred_history);
+
+  // Back to deferred mode once writes stop being interleaved with reads.
+  write_keys("f");
+  ASSERT_OK(Flush());
+  ASSERT_EQ(std::vector<bool>({true, true, false, false, true}),
+            deferred_history);
+  verify_keys("f");
+
+  // Internal calls that need the skip list do not count as reads. The
+  // memtable above was read by verify_keys().
+  write_keys("g");
+  ASSERT_OK(Flush());
+  write_keys("h");
+  std::string start = Key(0);
+  std::string limit = Key(kNumKeys);
+  uint64_t count = 0;
+  uint64_t size = 0;
+  db_->GetApproximateMemTableStats(Range(start, limit), &count, &size);
+  ASSERT_GT(count, 0);
+  ASSERT_OK(Flush());
+  ASSERT_EQ(
+      std::vector<bool>({true, true, false, false, true, false, true}),
+      deferred_history);
+  verify_keys("h");
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::unique_ptr<MemTableRepFactory> factory;
+  ConfigOptions config_options;
+  ASSERT_OK(MemTableRepFactory::CreateFromString(
+      config_options, "adaptive_skip_list:4", &factory));
+  ASSERT_STREQ(AdaptiveSkipListFactory::kClassName(), factory->Name());
+  ASSERT_EQ("AdaptiveSkipListFactory:4", factory->GetId());
+}
+
 TEST_F(DBMemTableTest, IntegrityChecks) {
   // We insert keys key000000, key000001 and key000002 into skiplist at fixed
   // height 1 (smallest height). Then we corrupt the second key to aey000001 to
@@ -3825,6 +3825,72 @@ TEST_F(DBRangeDelTest, RowCache) {
   // and should not turn db into read-only mdoe.
   ASSERT_OK(Put(Key(5), "foo"));
 }
+
+TEST_F(DBRangeDelTest, TournamentTreeMerge) {
+  // Reads and compacts point keys and range tombstones spread over several
+  // levels with merge_with_tournament_tree, and checks the results against
+  // the expected contents.
+  Options options = CurrentOptions();
+  options.merge_with_tournament_tree = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 7;
+  DestroyAndReopen(options);
+
+  std::map<std::string, std::string> expected;
+  Random rnd(301);
+  for (int level = 6; level >= 0; --level) {
+    for (int i = 0; i < 20; ++i) {
+      int k = static_cast<int>(rnd.Uniform(100));
+      std::string value = rnd.RandomString(10);
+      ASSERT_OK(Put(Key(k), value));
+      expected[Key(k)] = value;
+    }
+    int begin = static_cast<int>(rnd.Uniform(100));
+    int end = begin + 1 + static_cast<int>(rnd.Uniform(10));
+    ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                               Key(begin), Key(end)));
+    expected.erase(expected.lower_bound(Key(begin)),
+                   expected.lower_bound(Key(end)));
+    if (level > 0) {
+      ASSERT_OK(Flush());
+      MoveFilesToLevel(level);
+    }
+  }
+
+  auto verify = [&]() {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    auto expected_iter = expected.begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_iter) {
+      ASSERT_TRUE(expected_iter != expected.end());
+      ASSERT_EQ(expected_iter->first, iter->key());
+      ASSERT_EQ(expected_iter->second, iter->value());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(expected_iter == expected.end());
+
+    auto expected_riter = expected.rbegin();
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev(), ++expected_riter) {
+      ASSERT_TRUE(expected_riter != expected.rend());
+      ASSERT_EQ(expected_riter->first, iter->key());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_TRUE(expected_riter == expected.rend());
+
+    for (int k = 0; k < 100; k += 7) {
+      iter->Seek(Key(k));
+      auto it = expected.lower_bound(Key(k));
+      ASSERT_EQ(it != expected.end(), iter->Valid());
+      if (it != expected.end()) {
+        ASSERT_EQ(it->first, iter->key());
+      }
+    }
+    ASSERT_OK(iter->status());
+  };
+
+  verify();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  verify();
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
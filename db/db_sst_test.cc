@@ -150,6 +150,93 @@ TEST_F(DBSSTTest, SkipCheckingSSTFileSizesOnDBOpen) {
   ASSERT_EQ("choo", Get("pika"));
 }
 
+TEST_F(DBSSTTest, TableTailSnapshot) {
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.use_table_tail_snapshot = true;
+  options.max_open_files = -1;
+  options.disable_auto_compactions = true;
+  options.statistics = CreateDBStatistics();
+  // So that every read of a data block goes to its file
+  BlockBasedTableOptions table_options;
+  table_options.no_block_cache = true;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      ASSERT_OK(Put(Key(i * 10 + j), "v" + std::to_string(i * 10 + j)));
+    }
+    ASSERT_OK(Flush());
+  }
+  Close();
+  const std::string snapshot_fname = TableTailSnapshotFileName(dbname_);
+  ASSERT_OK(env_->FileExists(snapshot_fname));
+
+  // The table readers are opened from the snapshot, and each file only on
+  // its first read
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+  ASSERT_EQ("NOT_FOUND", Get(Key(5) + "x"));
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+  ASSERT_EQ("v5", Get(Key(5)));
+  ASSERT_EQ(1, TestGetTickerCount(options, NO_FILE_OPENS));
+  ASSERT_EQ("v6", Get(Key(6)));
+  ASSERT_EQ(1, TestGetTickerCount(options, NO_FILE_OPENS));
+
+  // The tails of the unchanged files are copied from the previous snapshot,
+  // and the tail of the new file is read from it
+  for (int j = 0; j < 10; ++j) {
+    ASSERT_OK(Put(Key(40 + j), "v" + std::to_string(40 + j)));
+  }
+  ASSERT_OK(Flush());
+  Close();
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+  ASSERT_EQ("NOT_FOUND", Get(Key(45) + "x"));
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+
+  // The files replaced by a compaction leave the snapshot, and the new ones
+  // join it, when it is written again
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  Close();
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+  for (int k = 0; k < 50; ++k) {
+    ASSERT_EQ("v" + std::to_string(k), Get(Key(k)));
+  }
+  ASSERT_GT(TestGetTickerCount(options, NO_FILE_OPENS), 0);
+
+  // A corrupt snapshot is ignored
+  Close();
+  std::string contents;
+  ASSERT_OK(ReadFileToString(env_, snapshot_fname, &contents));
+  contents[contents.size() / 2] ^= 0x5a;
+  ASSERT_OK(WriteStringToFile(env_, contents, snapshot_fname));
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  ASSERT_GT(TestGetTickerCount(options, NO_FILE_OPENS), 0);
+  for (int k = 0; k < 50; ++k) {
+    ASSERT_EQ("v" + std::to_string(k), Get(Key(k)));
+  }
+
+  // and replaced by one read from the table files
+  Close();
+  options.statistics = CreateDBStatistics();
+  Reopen(options);
+  ASSERT_EQ(0, TestGetTickerCount(options, NO_FILE_OPENS));
+
+  // The snapshot is removed along with the DB
+  Close();
+  ASSERT_OK(env_->FileExists(snapshot_fname));
+  ASSERT_OK(DestroyDB(dbname_, options));
+  ASSERT_TRUE(env_->FileExists(snapshot_fname).IsNotFound());
+}
+
 TEST_F(DBSSTTest, DontDeleteMovedFile) {
   // This test triggers move compaction and verifies that the file is not
   // deleted when it's part of move compaction
@@ -9,6 +9,7 @@
 #include "db/write_batch_internal.h"
 #include "monitoring/thread_status_util.h"
 #include "port/stack_trace.h"
+#include "rocksdb/compressor.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "util/random.h"
@@ -133,6 +134,169 @@ TEST_F(DBStatisticsTest, CompressionStatsTest) {
   }
 }
 
+namespace {
+// Stores every other data block uncompressed and compresses the rest with
+// `other_type`
+class AlternatingCompressor : public Compressor {
+ public:
+  explicit AlternatingCompressor(CompressionType other_type)
+      : other_type_(other_type) {}
+
+  static const char* kClassName() { return "AlternatingCompressor"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<BlockCompressor> NewBlockCompressor(
+      const Context& context) const override {
+    EXPECT_EQ(context.level, 0);
+    EXPECT_EQ(context.reason, TableFileCreationReason::kFlush);
+    return std::make_unique<Alternating>(this, other_type_);
+  }
+
+  mutable std::atomic<int> num_compressed{0};
+
+ private:
+  class Alternating : public BlockCompressor {
+   public:
+    Alternating(const AlternatingCompressor* parent, CompressionType type)
+        : parent_(parent), type_(type) {}
+
+    CompressionType SelectCompressionType(const Slice& /*uncompressed_block*/,
+                                          bool is_data_block) override {
+      EXPECT_TRUE(is_data_block);
+      return (num_blocks_++ % 2 == 0) ? kNoCompression : type_;
+    }
+
+    void OnBlockCompressed(const Slice& uncompressed_block,
+                           bool /*is_data_block*/, CompressionType type,
+                           size_t compressed_size) override {
+      EXPECT_EQ(type, type_);
+      EXPECT_LT(compressed_size, uncompressed_block.size());
+      parent_->num_compressed++;
+    }
+
+   private:
+    const AlternatingCompressor* parent_;
+    const CompressionType type_;
+    int num_blocks_ = 0;
+  };
+
+  const CompressionType other_type_;
+};
+}  // namespace
+
+TEST_F(DBStatisticsTest, CompressorSelectsCompressionPerBlock) {
+  std::vector<CompressionType> types;
+  for (CompressionType type : GetSupportedCompressions()) {
+    if (type != kNoCompression && type != kBZip2Compression) {
+      types.push_back(type);
+    }
+  }
+  if (types.empty()) {
+    ROCKSDB_GTEST_SKIP("No compression support");
+    return;
+  }
+  // Configure one compression type and let the compressor use another one
+  // when possible
+  CompressionType configured_type = types.front();
+  CompressionType other_type = types.back();
+
+  Options options = CurrentOptions();
+  options.compression = configured_type;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  BlockBasedTableOptions bbto;
+  bbto.enable_index_compression = false;
+  auto compressor = std::make_shared<AlternatingCompressor>(other_type);
+  bbto.compressor = compressor;
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  const int kNumKeysWritten = 100;
+  // About three KVs per block
+  const int len = static_cast<int>(BlockBasedTableOptions().block_size / 3);
+  Random rnd(301);
+  std::vector<std::string> values(kNumKeysWritten);
+  for (int i = 0; i < kNumKeysWritten; ++i) {
+    test::CompressibleString(&rnd, 0.5, len, &values[i]);
+    ASSERT_OK(Put(Key(i), values[i]));
+  }
+  ASSERT_OK(Flush());
+
+  EXPECT_EQ(17, compressor->num_compressed.load());
+  EXPECT_EQ(17, options.statistics->getTickerCount(NUMBER_BLOCK_COMPRESSED));
+  EXPECT_EQ(17, options.statistics->getTickerCount(
+                    NUMBER_BLOCK_COMPRESSION_BYPASSED));
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1U, props.size());
+  const TableProperties& tp = *props.begin()->second;
+  EXPECT_EQ(AlternatingCompressor::kClassName(), tp.compressor_name);
+  std::string expected_compression_name =
+      CompressionTypeToString(configured_type);
+  if (other_type != configured_type) {
+    expected_compression_name += "," + CompressionTypeToString(other_type);
+  }
+  EXPECT_EQ(expected_compression_name, tp.compression_name);
+
+  // Every block is readable with the codec it was written with
+  Reopen(options);
+  for (int i = 0; i < kNumKeysWritten; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+  EXPECT_EQ(17, options.statistics->getTickerCount(NUMBER_BLOCK_DECOMPRESSED));
+}
+
+TEST_F(DBStatisticsTest, AutoSkipCompressor) {
+  CompressionType type = kNoCompression;
+  for (CompressionType t : GetSupportedCompressions()) {
+    if (t != kNoCompression && t != kBZip2Compression) {
+      type = t;
+      break;
+    }
+  }
+  if (type == kNoCompression) {
+    ROCKSDB_GTEST_SKIP("No compression support");
+    return;
+  }
+
+  Options options = CurrentOptions();
+  options.compression = type;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  BlockBasedTableOptions bbto;
+  bbto.enable_index_compression = false;
+  ConfigOptions config_options;
+  ASSERT_OK(Compressor::CreateFromString(
+      config_options, "id=AutoSkipCompressor;max_skipped_blocks=8",
+      &bbto.compressor));
+  ASSERT_NE(bbto.compressor, nullptr);
+  options.table_factory.reset(NewBlockBasedTableFactory(bbto));
+  DestroyAndReopen(options);
+
+  const int kNumKeysWritten = 100;
+  const int len = static_cast<int>(BlockBasedTableOptions().block_size / 3);
+  Random rnd(301);
+  for (int i = 0; i < kNumKeysWritten; ++i) {
+    ASSERT_OK(Put(Key(i), rnd.RandomBinaryString(len)));
+  }
+  ASSERT_OK(Flush());
+
+  // Of the 34 incompressible data blocks, compression is attempted on blocks
+  // 1, 3, 6, 11, 20 and 29, after skipping 1, 2, 4, 8 and 8 blocks.
+  EXPECT_EQ(6, options.statistics->getTickerCount(
+                   NUMBER_BLOCK_COMPRESSION_REJECTED));
+  EXPECT_EQ(28, options.statistics->getTickerCount(
+                    NUMBER_BLOCK_COMPRESSION_BYPASSED));
+  EXPECT_EQ(0, options.statistics->getTickerCount(NUMBER_BLOCK_COMPRESSED));
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1U, props.size());
+  EXPECT_EQ(AutoSkipCompressor::kClassName(),
+            props.begin()->second->compressor_name);
+  EXPECT_EQ(CompressionTypeToString(type),
+            props.begin()->second->compression_name);
+}
+
 TEST_F(DBStatisticsTest, MutexWaitStatsDisabledByDefault) {
   Options options = CurrentOptions();
   options.create_if_missing = true;
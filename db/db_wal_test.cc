@@ -2243,6 +2243,121 @@ TEST_P(DBWALTestWithParams, kSkipAnyCorruptedRecords) {
   }
 }
 
+// Test scope:
+// - Pipelined WAL recovery recovers the same data as inline recovery, for
+// every recovery mode and corruption style
+TEST_F(DBWALTest, PipelinedWalRecoveryCorruption) {
+  const size_t maxkeys =
+      RecoveryTestHelper::kWALFilesCount * RecoveryTestHelper::kKeysPerWALFile;
+  for (auto mode : {WALRecoveryMode::kTolerateCorruptedTailRecords,
+                    WALRecoveryMode::kAbsoluteConsistency,
+                    WALRecoveryMode::kPointInTimeRecovery,
+                    WALRecoveryMode::kSkipAnyCorruptedRecords}) {
+    for (bool trunc : {false, true}) {
+      SCOPED_TRACE("mode=" + std::to_string(static_cast<int>(mode)) +
+                   " trunc=" + std::to_string(trunc));
+      bool opened[2];
+      std::vector<bool> found[2];
+      for (bool pipelined : {false, true}) {
+        Options options = CurrentOptions();
+        RecoveryTestHelper::FillData(this, &options);
+        RecoveryTestHelper::CorruptWAL(
+            this, options, /*off=*/.3, /*len%=*/.1,
+            RecoveryTestHelper::kWALFileOffset + 4, trunc);
+
+        options.wal_recovery_mode = mode;
+        options.create_if_missing = false;
+        options.enable_pipelined_wal_recovery = pipelined;
+        opened[pipelined] = TryReopen(options).ok();
+        if (opened[pipelined]) {
+          for (size_t k = 0; k < maxkeys; ++k) {
+            found[pipelined].push_back(Get("key" + std::to_string(k)) !=
+                                       "NOT_FOUND");
+          }
+        }
+      }
+      ASSERT_EQ(opened[0], opened[1]);
+      ASSERT_EQ(found[0], found[1]);
+    }
+  }
+}
+
+TEST_F(DBWALTest, PipelinedWalRecoveryMultipleCF) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  CreateAndReopenWithCF({"one", "two"}, options);
+  const int kNumKeys = 12000;
+  auto value = [this](int cf) {
+    return DummyString(100, static_cast<char>('a' + cf));
+  };
+  for (int i = 0; i < kNumKeys; i++) {
+    WriteBatch batch;
+    for (int cf = 0; cf < 3; cf++) {
+      ASSERT_OK(batch.Put(handles_[cf], Key(i), value(cf)));
+    }
+    ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+  }
+  ASSERT_OK(Delete(1, Key(0)));
+  // Overwritten after the first memtables of the recovery got flushed
+  ASSERT_OK(Put(2, Key(1), "new"));
+
+  // Memtables fill up during recovery and get flushed in the background in
+  // the middle of it.
+  options.write_buffer_size = 64 * 1024;
+  options.enable_pipelined_wal_recovery = true;
+  std::atomic<int> insert_groups{0};
+  std::atomic<int> background_flushes{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::RecoverLogFiles:InsertGroup",
+      [&](void* /*arg*/) { insert_groups++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BGWorkRecoveryFlush",
+      [&](void* /*arg*/) { background_flushes++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+  ReopenWithColumnFamilies({"default", "one", "two"}, options);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(insert_groups.load(), 1);
+  ASSERT_GE(background_flushes.load(), 3 * (insert_groups.load() - 1));
+  for (int cf = 0; cf < 3; cf++) {
+    ASSERT_GT(NumTableFilesAtLevel(0, cf), 1);
+    for (int i = 0; i < kNumKeys; i++) {
+      if (cf == 1 && i == 0) {
+        ASSERT_EQ("NOT_FOUND", Get(cf, Key(i)));
+      } else if (cf == 2 && i == 1) {
+        ASSERT_EQ("new", Get(cf, Key(i)));
+      } else {
+        ASSERT_EQ(value(cf), Get(cf, Key(i)));
+      }
+    }
+  }
+}
+
+// Test scope:
+// - With pipelined recovery, a write batch that cannot be inserted fails
+// recovery even in point-in-time recovery mode, since later updates to other
+// column families may already be inserted
+TEST_F(DBWALTest, PipelinedWalRecoveryInsertFailure) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  CreateAndReopenWithCF({"one"}, options);
+  ASSERT_OK(Put(0, "key", "value"));
+  ASSERT_OK(Merge(1, "key", "operand"));
+  ASSERT_OK(Put(0, "key2", "value2"));
+
+  options.merge_operator = nullptr;
+  options.wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
+  options.enable_pipelined_wal_recovery = true;
+  ASSERT_NOK(TryReopenWithColumnFamilies({"default", "one"}, options));
+
+  // Recovers up to the failed batch without pipelining
+  options.enable_pipelined_wal_recovery = false;
+  ASSERT_OK(TryReopenWithColumnFamilies({"default", "one"}, options));
+  ASSERT_EQ("value", Get(0, "key"));
+  ASSERT_EQ("NOT_FOUND", Get(0, "key2"));
+}
+
 TEST_F(DBWALTest, AvoidFlushDuringRecovery) {
   Options options = CurrentOptions();
   options.disable_auto_compactions = true;
@@ -3,9 +3,11 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -20,6 +22,7 @@
 #include "util/string_util.h"
 #include "utilities/fault_injection_env.h"
 #include "utilities/fault_injection_fs.h"
+#include "utilities/merge_operators.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -493,6 +496,123 @@ TEST_F(DBWriteTestUnparameterized, PipelinedWriteRace) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
 }
 
+TEST_F(DBWriteTestUnparameterized, PipelinedWalSync) {
+  std::unique_ptr<FaultInjectionTestEnv> mock_env(
+      new FaultInjectionTestEnv(env_));
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.env = mock_env.get();
+  options.enable_pipelined_write = true;
+  options.enable_pipelined_wal_sync = true;
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+  ASSERT_OK(options.statistics->Reset());
+
+  // The first writer's sync is held until a second sync writer has appended
+  // to the WAL, which must not wait for the first sync to finish. The first
+  // sync then covers both writes, so the second writer does not sync again.
+  std::atomic<bool> first_sync_started{false};
+  std::atomic<int> wal_groups_done{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "WriteThread::ExitAsBatchGroupLeader:Start",
+      [&](void* /*arg*/) { wal_groups_done++; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::PipelinedSyncWAL:BeforeSync", [&](void* /*arg*/) {
+        if (!first_sync_started.exchange(true)) {
+          while (wal_groups_done.load() < 2) {
+            // wait for the second writer to finish its WAL write
+            std::this_thread::yield();
+          }
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  WriteOptions wo;
+  wo.sync = true;
+  port::Thread first([&]() { ASSERT_OK(dbfull()->Put(wo, "a", "va")); });
+  while (!first_sync_started.load()) {
+    // wait for the first writer to reach its sync
+    std::this_thread::yield();
+  }
+  port::Thread second([&]() { ASSERT_OK(dbfull()->Put(wo, "b", "vb")); });
+  first.join();
+  second.join();
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(1, options.statistics->getTickerCount(WAL_FILE_SYNCED));
+
+  // Both writes must have been made durable.
+  ASSERT_OK(mock_env->DropUnsyncedFileData());
+  Reopen(options);
+  ASSERT_EQ("va", Get("a"));
+  ASSERT_EQ("vb", Get("b"));
+  Close();
+}
+
+TEST_F(DBWriteTestUnparameterized, PipelinedWalSyncError) {
+  std::unique_ptr<FaultInjectionTestEnv> mock_env(
+      new FaultInjectionTestEnv(env_));
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.env = mock_env.get();
+  options.enable_pipelined_write = true;
+  options.enable_pipelined_wal_sync = true;
+  DestroyAndReopen(options);
+
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::PipelinedSyncWAL:BeforeSync",
+      [&](void* /*arg*/) { mock_env->SetFilesystemActive(false); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  WriteOptions wo;
+  wo.sync = true;
+  ASSERT_NOK(dbfull()->Put(wo, "a", "va"));
+  // A failed sync write is not inserted into the memtable.
+  ASSERT_EQ("NOT_FOUND", Get("a"));
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  mock_env->SetFilesystemActive(true);
+  dbfull()->Resume().PermitUncheckedError();
+  Close();
+}
+
+TEST_F(DBWriteTestUnparameterized, PipelinedWalSyncManifestError) {
+  std::unique_ptr<FaultInjectionTestEnv> mock_env(
+      new FaultInjectionTestEnv(env_));
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.env = mock_env.get();
+  options.enable_pipelined_write = true;
+  options.enable_pipelined_wal_sync = true;
+  options.track_and_verify_wals_in_manifest = true;
+  DestroyAndReopen(options);
+
+  // Syncing a closed WAL records it in the MANIFEST, whose write fails
+  ASSERT_OK(Put("a", "va"));
+  ASSERT_OK(dbfull()->TEST_SwitchMemtable());
+  SyncPoint::GetInstance()->SetCallBack(
+      "VersionSet::LogAndApply:WriteManifestStart",
+      [&](void* /*arg*/) { mock_env->SetFilesystemActive(false); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  WriteOptions wo;
+  wo.sync = true;
+  ASSERT_NOK(dbfull()->Put(wo, "b", "vb"));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  mock_env->SetFilesystemActive(true);
+
+  // The failed write is not inserted, and the background error stops
+  // further writes until the DB is resumed.
+  ASSERT_EQ("NOT_FOUND", Get("b"));
+  ASSERT_NOK(dbfull()->TEST_GetBGError());
+  ASSERT_NOK(Put("c", "vc"));
+  dbfull()->Resume().PermitUncheckedError();
+  Close();
+}
+
 TEST_P(DBWriteTest, ManualWalFlushInEffect) {
   Options options = GetOptions();
   Reopen(options);
@@ -1000,6 +1120,94 @@ TEST_P(DBWriteTest, RecycleLogToggleTest) {
   ASSERT_EQ(Get(Key(1)), "val2");
 }
 
+TEST_F(DBWriteTestUnparameterized, ParallelInsertLargeBatch) {
+  Options options = CurrentOptions();
+  options.large_batch_memtable_insert_threads = 4;
+  options.large_batch_memtable_insert_min_entries = 16;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  std::atomic<size_t> num_parallel_inserts{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::InsertLargeBatchInParallel:NumParts", [&](void* arg) {
+        ASSERT_EQ(*static_cast<size_t*>(arg), size_t{4});
+        ++num_parallel_inserts;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Expected contents of both column families
+  std::array<std::map<std::string, std::string>, 2> expected;
+
+  WriteBatch batch(0 /* reserved_bytes */, 0 /* max_bytes */,
+                   8 /* protection_bytes_per_key */, 0 /* default_cf_ts_sz */);
+  for (int i = 0; i < 1000; ++i) {
+    const int cf = i % 2;
+    const std::string value = "v" + std::to_string(i);
+    if (i % 7 == 0) {
+      ASSERT_OK(batch.PutEntity(handles_[cf], Key(i),
+                                {{kDefaultWideColumnName, value},
+                                 {"attr", "foo"}}));
+    } else {
+      ASSERT_OK(batch.Put(handles_[cf], Key(i), value));
+    }
+    expected[cf][Key(i)] = value;
+    if (i % 10 == 9) {
+      ASSERT_OK(batch.Delete(handles_[cf], Key(i - 4)));
+      expected[cf].erase(Key(i - 4));
+      ASSERT_OK(batch.PutLogData("log data"));
+    }
+  }
+  ASSERT_OK(batch.DeleteRange(handles_[0], Key(100), Key(200)));
+  expected[0].erase(expected[0].lower_bound(Key(100)),
+                    expected[0].lower_bound(Key(200)));
+  // Overwrites a key of the first part in the last one
+  ASSERT_OK(batch.Put(handles_[0], Key(0), "overwritten"));
+  expected[0][Key(0)] = "overwritten";
+
+  const SequenceNumber seq = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(num_parallel_inserts.load(), size_t{1});
+  ASSERT_EQ(db_->GetLatestSequenceNumber(),
+            seq + WriteBatchInternal::Count(&batch));
+
+  auto verify = [&]() {
+    for (int cf = 0; cf < 2; ++cf) {
+      std::unique_ptr<Iterator> iter(
+          db_->NewIterator(ReadOptions(), handles_[cf]));
+      auto expected_it = expected[cf].begin();
+      for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++expected_it) {
+        ASSERT_NE(expected_it, expected[cf].end());
+        ASSERT_EQ(iter->key(), expected_it->first);
+        ASSERT_EQ(iter->value(), expected_it->second);
+      }
+      ASSERT_OK(iter->status());
+      ASSERT_EQ(expected_it, expected[cf].end());
+    }
+  };
+  verify();
+
+  // Batches with Merge operations and small batches use one thread
+  WriteBatch merge_batch;
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(merge_batch.Merge(handles_[1], Key(i), "m"));
+    auto& value = expected[1][Key(i)];
+    value = value.empty() ? "m" : value + ",m";
+  }
+  ASSERT_OK(db_->Write(WriteOptions(), &merge_batch));
+  ASSERT_OK(Put(0, Key(0), "small"));
+  expected[0][Key(0)] = "small";
+  ASSERT_EQ(num_parallel_inserts.load(), size_t{1});
+  verify();
+
+  // Recovery from the WAL inserts with one thread and gets the same result
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  verify();
+  ASSERT_EQ(num_parallel_inserts.load(), size_t{1});
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
 INSTANTIATE_TEST_CASE_P(DBWriteTestInstance, DBWriteTest,
                         testing::Values(DBTestBase::kDefault,
                                         DBTestBase::kConcurrentWALWrites,
@@ -1769,6 +1769,112 @@ TEST_F(ExternalSSTFileTest, SstFileWriterNonSharedKeys) {
   ASSERT_OK(DeprecatedAddFile({file_path}));
 }
 
+TEST_F(ExternalSSTFileTest, BulkLoaderUnsortedInput) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  // Files must not span two prefixes, "key000" to "key004"
+  options.sst_partitioner_factory = NewSstPartitionerFixedPrefixFactory(6);
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 5000;
+  std::vector<int> order;
+  for (int i = 0; i < kNumKeys; i++) {
+    order.push_back(i);
+  }
+
+  SstFileBulkLoaderOptions loader_options;
+  loader_options.output_dir = sst_files_dir_;
+  // Spill many runs and build many files in parallel
+  loader_options.sort_buffer_size = 16 << 10;
+  loader_options.target_file_size = 8 << 10;
+  loader_options.num_threads = 4;
+  SstFileBulkLoader loader(EnvOptions(), options, loader_options);
+  // Every key is added twice, in different runs, and the second value wins
+  for (const char* version : {"old", "new"}) {
+    RandomShuffle(order.begin(), order.end(), 301);
+    for (int i : order) {
+      ASSERT_OK(loader.Put(Key(i), version + std::to_string(i)));
+    }
+  }
+  std::vector<ExternalSstFileInfo> files;
+  ASSERT_OK(loader.Finish(&files));
+  ASSERT_TRUE(loader.Put(Key(0), "v").IsInvalidArgument());
+
+  ASSERT_GT(files.size(), 5U);
+  uint64_t num_entries = 0;
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < files.size(); i++) {
+    ASSERT_EQ(files[i].smallest_key.substr(0, 6),
+              files[i].largest_key.substr(0, 6));
+    if (i > 0) {
+      ASSERT_LT(files[i - 1].largest_key, files[i].smallest_key);
+    }
+    num_entries += files[i].num_entries;
+    paths.push_back(files[i].file_path);
+  }
+  ASSERT_EQ(num_entries, static_cast<uint64_t>(kNumKeys));
+
+  // The runs are gone, only the output files are left
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(sst_files_dir_, &children));
+  ASSERT_EQ(children.size(), files.size());
+
+  ASSERT_OK(db_->IngestExternalFile(paths, IngestExternalFileOptions()));
+  ASSERT_EQ(NumTableFilesAtLevel(options.num_levels - 1),
+            static_cast<int>(files.size()));
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_EQ(Get(Key(i)), "new" + std::to_string(i));
+  }
+
+  // Nothing to load
+  SstFileBulkLoader empty_loader(EnvOptions(), options, loader_options);
+  ASSERT_OK(empty_loader.Finish(&files));
+  ASSERT_TRUE(files.empty());
+}
+
+TEST_F(ExternalSSTFileTest, BulkLoaderFailure) {
+  Options options = CurrentOptions();
+  SstFileBulkLoaderOptions loader_options;
+  loader_options.output_dir = sst_files_dir_;
+  loader_options.sort_buffer_size = 16 << 10;
+  loader_options.target_file_size = 8 << 10;
+  loader_options.num_threads = 4;
+
+  // Two loaders sharing the directories, of which the second fails while
+  // building its output files
+  SstFileBulkLoader loader1(EnvOptions(), options, loader_options);
+  SstFileBulkLoader loader2(EnvOptions(), options, loader_options);
+  for (int i = 0; i < 2000; i++) {
+    ASSERT_OK(loader1.Put(Key(i), "v1"));
+    ASSERT_OK(loader2.Put(Key(i), "v2"));
+  }
+  std::vector<ExternalSstFileInfo> files1;
+  ASSERT_OK(loader1.Finish(&files1));
+  ASSERT_GT(files1.size(), 1U);
+
+  std::atomic<int> num_puts{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "SstFileBulkLoader::BuildRange:Put", [&](void* arg) {
+        if (num_puts.fetch_add(1) == 1500) {
+          *static_cast<Status*>(arg) = Status::IOError("Injected");
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+  std::vector<ExternalSstFileInfo> files2;
+  ASSERT_TRUE(loader2.Finish(&files2).IsIOError());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_TRUE(files2.empty());
+
+  // Only the output files of the first loader are left
+  std::vector<std::string> children;
+  ASSERT_OK(env_->GetChildren(sst_files_dir_, &children));
+  ASSERT_EQ(children.size(), files1.size());
+  for (const auto& file : files1) {
+    ASSERT_OK(env_->FileExists(file.file_path));
+  }
+}
+
 TEST_F(ExternalSSTFileTest, WithUnorderedWrite) {
   SyncPoint::GetInstance()->DisableProcessing();
   SyncPoint::GetInstance()->LoadDependency(
@@ -460,6 +460,11 @@ void ForwardIterator::SeekInternal(const Slice& internal_key,
           continue;
         }
         l0_iters_[i]->Seek(internal_key);
+        // The second call completes the seek, even if the iterator needs more
+        // than one round of asynchronous reads.
+        while (seek_after_async_io && l0_iters_[i]->status().IsTryAgain()) {
+          l0_iters_[i]->Seek(internal_key);
+        }
       }
 
       if (l0_iters_[i]->status().IsTryAgain()) {
@@ -505,6 +510,10 @@ void ForwardIterator::SeekInternal(const Slice& internal_key,
         }
         seek_to_first ? level_iters_[level - 1]->SeekToFirst()
                       : level_iters_[level - 1]->Seek(internal_key);
+        while (seek_after_async_io &&
+               level_iters_[level - 1]->status().IsTryAgain()) {
+          level_iters_[level - 1]->Seek(internal_key);
+        }
 
         if (level_iters_[level - 1]->status().IsTryAgain()) {
           assert(!seek_after_async_io);
@@ -76,7 +76,8 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
                    const ImmutableOptions& ioptions,
                    const MutableCFOptions& mutable_cf_options,
                    WriteBufferManager* write_buffer_manager,
-                   SequenceNumber latest_seq, uint32_t column_family_id)
+                   SequenceNumber latest_seq, uint32_t column_family_id,
+                   const MemTable* predecessor)
     : comparator_(cmp),
       moptions_(ioptions, mutable_cf_options),
       kArenaBlockSize(Arena::OptimizeBlockSize(moptions_.arena_block_size)),
@@ -90,7 +91,8 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
              mutable_cf_options.memtable_huge_page_size),
       table_(ioptions.memtable_factory->CreateMemTableRep(
           comparator_, &arena_, mutable_cf_options.prefix_extractor.get(),
-          ioptions.logger, column_family_id)),
+          ioptions.logger, column_family_id,
+          predecessor != nullptr ? predecessor->table_.get() : nullptr)),
       range_del_table_(SkipListFactory().CreateMemTableRep(
           comparator_, &arena_, nullptr /* transform */, ioptions.logger,
           column_family_id)),
@@ -1090,6 +1092,7 @@ struct Saver {
   bool* found_final_value;  // Is value set correctly? Used by KeyMayExist
   bool* merge_in_progress;
   std::string* value;
+  Slice* pinned_value;
   PinnableWideColumns* columns;
   SequenceNumber seq;
   std::string* timestamp;
@@ -1280,6 +1283,8 @@ static bool SaveValue(void* arg, const char* entry) {
                 /* update_num_ops_stats */ true, /* op_failure_scope */ nullptr,
                 s->value, s->columns);
           }
+        } else if (s->value && s->pinned_value) {
+          *(s->pinned_value) = v;
         } else if (s->value) {
           s->value->assign(v.data(), v.size());
         } else if (s->columns) {
@@ -1439,7 +1444,7 @@ bool MemTable::Get(const LookupKey& key, std::string* value,
                    SequenceNumber* max_covering_tombstone_seq,
                    SequenceNumber* seq, const ReadOptions& read_opts,
                    bool immutable_memtable, ReadCallback* callback,
-                   bool* is_blob_index, bool do_merge) {
+                   bool* is_blob_index, bool do_merge, Slice* pinned_value) {
   // The sequence number is updated synchronously in version_set.h
   if (IsEmpty()) {
     // Avoiding recording stats for speed.
@@ -1497,7 +1502,7 @@ bool MemTable::Get(const LookupKey& key, std::string* value,
     }
     GetFromTable(key, *max_covering_tombstone_seq, do_merge, callback,
                  is_blob_index, value, columns, timestamp, s, merge_context,
-                 seq, &found_final_value, &merge_in_progress);
+                 seq, &found_final_value, &merge_in_progress, pinned_value);
   }
 
   // No change to value, since we have not yet found a Put/Delete
@@ -1520,13 +1525,17 @@ void MemTable::GetFromTable(const LookupKey& key,
                             PinnableWideColumns* columns,
                             std::string* timestamp, Status* s,
                             MergeContext* merge_context, SequenceNumber* seq,
-                            bool* found_final_value, bool* merge_in_progress) {
+                            bool* found_final_value, bool* merge_in_progress,
+                            Slice* pinned_value) {
   Saver saver;
   saver.status = s;
   saver.found_final_value = found_final_value;
   saver.merge_in_progress = merge_in_progress;
   saver.key = &key;
   saver.value = value;
+  // Values may be overwritten in place under inplace_update_support.
+  saver.pinned_value =
+      moptions_.inplace_update_support ? nullptr : pinned_value;
   saver.columns = columns;
   saver.timestamp = timestamp;
   saver.seq = kMaxSequenceNumber;
@@ -1626,7 +1635,8 @@ void MemTable::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
                  callback, &iter->is_blob_index,
                  iter->value ? iter->value->GetSelf() : nullptr, iter->columns,
                  iter->timestamp, iter->s, &(iter->merge_context), &dummy_seq,
-                 &found_final_value, &merge_in_progress);
+                 &found_final_value, &merge_in_progress,
+                 /*pinned_value=*/nullptr);
 
     if (!found_final_value && merge_in_progress) {
       if (iter->s->ok()) {
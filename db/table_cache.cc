@@ -12,6 +12,7 @@
 #include "db/dbformat.h"
 #include "db/range_tombstone_fragmenter.h"
 #include "db/snapshot_impl.h"
+#include "db/table_tail_snapshot.h"
 #include "db/version_edit.h"
 #include "file/file_util.h"
 #include "file/filename.h"
@@ -103,12 +104,24 @@ Status TableCache::GetTableReader(
   Status s = PrepareIOFromReadOptions(ro, ioptions_.clock, fopts.io_options);
   TEST_SYNC_POINT_CALLBACK("TableCache::GetTableReader:BeforeOpenFile",
                            const_cast<Status*>(&s));
-  if (s.ok()) {
+  std::shared_ptr<const std::string> tail;
+  if (s.ok() && tail_snapshot_ && !fopts.use_direct_reads) {
+    tail = tail_snapshot_->GetTail(
+        file_meta.fd.GetNumber(), file_meta.fd.GetFileSize(),
+        file_meta.tail_size, file_meta.unique_id);
+  }
+  if (tail) {
+    // The file itself is only opened on the first read outside of its tail
+    file = NewTailServedTableFile(ioptions_.fs, fname, fopts,
+                                  file_meta.fd.GetFileSize(), std::move(tail),
+                                  ioptions_.stats);
+  } else if (s.ok()) {
     s = ioptions_.fs->NewRandomAccessFile(fname, fopts, &file, nullptr);
+    if (s.ok()) {
+      RecordTick(ioptions_.stats, NO_FILE_OPENS);
+    }
   }
-  if (s.ok()) {
-    RecordTick(ioptions_.stats, NO_FILE_OPENS);
-  } else if (s.IsPathNotFound()) {
+  if (s.IsPathNotFound()) {
     fname = Rocks2LevelTableFileName(fname);
     // If this file is also not found, we want to use the error message
     // that contains the table file name which is less confusing.
@@ -593,6 +606,38 @@ Status TableCache::MultiGetFilter(
   return s;
 }
 
+Status TableCache::MultiGetPrefetch(
+    const ReadOptions& options,
+    const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, const MutableCFOptions& mutable_cf_options,
+    HistogramImpl* file_read_hist, int level,
+    MultiGetContext::Range* mget_range) {
+  auto& fd = file_meta.fd;
+  Status s;
+  TableReader* t = fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(options, file_options_, internal_comparator, file_meta,
+                  &handle, mutable_cf_options,
+                  options.read_tier == kBlockCacheTier /* no_io */,
+                  file_read_hist,
+                  /*skip_filters=*/false, level,
+                  true /* prefetch_index_and_filter_in_cache */,
+                  /*max_file_size_for_l0_meta_pin=*/0, file_meta.temperature);
+    if (s.ok()) {
+      t = cache_.Value(handle);
+    }
+  }
+  if (s.ok()) {
+    s = t->MultiGetPrefetch(options, mutable_cf_options.prefix_extractor.get(),
+                            mget_range);
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
 Status TableCache::GetTableProperties(
     const FileOptions& file_options, const ReadOptions& read_options,
     const InternalKeyComparator& internal_comparator,
@@ -34,6 +34,7 @@ class Arena;
 struct FileDescriptor;
 class GetContext;
 class HistogramImpl;
+class TableTailSnapshot;
 
 // Manages caching for TableReader objects for a column family. The actual
 // cache is allocated separately and passed to the constructor. TableCache
@@ -140,6 +141,17 @@ class TableCache {
                         MultiGetContext::Range* mget_range,
                         TypedHandle** table_handle);
 
+  // Call table reader's MultiGetPrefetch to issue readahead hints for the data
+  // blocks of the keys in mget_range that pass the filter. mget_range is
+  // updated to skip the keys filtered out. Opens the table if necessary and
+  // releases it again before returning.
+  Status MultiGetPrefetch(const ReadOptions& options,
+                          const InternalKeyComparator& internal_comparator,
+                          const FileMetaData& file_meta,
+                          const MutableCFOptions& mutable_cf_options,
+                          HistogramImpl* file_read_hist, int level,
+                          MultiGetContext::Range* mget_range);
+
   // If a seek to internal key "k" in specified file finds an entry,
   // call get_context->SaveValue() repeatedly until
   // it returns false. As a side effect, it will insert the TableReader
@@ -241,6 +253,13 @@ class TableCache {
     }
   }
 
+  // The table readers opened with this TableCache will be served from the
+  // tails in `snapshot` where possible, see DBOptions::use_table_tail_snapshot.
+  // Must be called before any table is opened.
+  void SetTailSnapshot(std::shared_ptr<TableTailSnapshot> snapshot) {
+    tail_snapshot_ = std::move(snapshot);
+  }
+
  private:
   // Build a table reader
   Status GetTableReader(const ReadOptions& ro, const FileOptions& file_options,
@@ -285,6 +304,7 @@ class TableCache {
   Striped<CacheAlignedWrapper<port::Mutex>> loader_mutex_;
   std::shared_ptr<IOTracer> io_tracer_;
   std::string db_session_id_;
+  std::shared_ptr<TableTailSnapshot> tail_snapshot_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,490 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/table_tail_snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "monitoring/statistics_impl.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr size_t kEntryHeaderSize = 5 * sizeof(uint64_t);
+constexpr size_t kChecksumSize = sizeof(uint32_t);
+constexpr size_t kFooterSize = 2 * sizeof(uint64_t);
+
+// Reads exactly `n` bytes at `offset` of `file` into `scratch`
+IOStatus ReadFully(FSRandomAccessFile* file, const std::string& fname,
+                   uint64_t offset, size_t n, char* scratch) {
+  Slice result;
+  IOStatus s =
+      file->Read(offset, n, IOOptions(), &result, scratch, nullptr /* dbg */);
+  if (!s.ok()) {
+    return s;
+  }
+  if (result.size() != n) {
+    return IOStatus::Corruption("Truncated file", fname);
+  }
+  if (result.data() != scratch) {
+    memcpy(scratch, result.data(), n);
+  }
+  return IOStatus::OK();
+}
+
+void EncodeEntryHeader(uint64_t file_number, uint64_t file_size,
+                       const UniqueId64x2& unique_id, uint64_t tail_size,
+                       std::string* dst) {
+  PutFixed64(dst, file_number);
+  PutFixed64(dst, file_size);
+  PutFixed64(dst, unique_id[0]);
+  PutFixed64(dst, unique_id[1]);
+  PutFixed64(dst, tail_size);
+}
+
+// Appends the entry of `table` to `entry`, reading its tail from the table
+// file
+IOStatus ReadEntryFromTable(FileSystem* fs,
+                            const TableTailSnapshot::LiveTable& table,
+                            std::string* entry) {
+  std::unique_ptr<FSRandomAccessFile> file;
+  IOStatus s = fs->NewRandomAccessFile(table.path, FileOptions(), &file,
+                                       nullptr /* dbg */);
+  if (!s.ok()) {
+    return s;
+  }
+  EncodeEntryHeader(table.file_number, table.file_size, table.unique_id,
+                    table.tail_size, entry);
+  const size_t tail_size = static_cast<size_t>(table.tail_size);
+  entry->resize(kEntryHeaderSize + tail_size);
+  s = ReadFully(file.get(), table.path, table.file_size - table.tail_size,
+                tail_size, &(*entry)[kEntryHeaderSize]);
+  if (!s.ok()) {
+    return s;
+  }
+  PutFixed32(entry, crc32c::Mask(crc32c::Value(entry->data(), entry->size())));
+  return IOStatus::OK();
+}
+
+// Appends the entry of `table` at `offset` of the snapshot file `file` to
+// `entry`
+IOStatus CopyEntry(FSRandomAccessFile* file, const std::string& fname,
+                   const TableTailSnapshot::LiveTable& table, uint64_t offset,
+                   std::string* entry) {
+  const size_t size = kEntryHeaderSize +
+                      static_cast<size_t>(table.tail_size) + kChecksumSize;
+  entry->resize(size);
+  IOStatus s = ReadFully(file, fname, offset, size, &(*entry)[0]);
+  if (!s.ok()) {
+    return s;
+  }
+  const size_t data_size = size - kChecksumSize;
+  if (DecodeFixed64(entry->data()) != table.file_number ||
+      crc32c::Unmask(DecodeFixed32(entry->data() + data_size)) !=
+          crc32c::Value(entry->data(), data_size)) {
+    return IOStatus::Corruption("Bad table tail snapshot entry", fname);
+  }
+  return IOStatus::OK();
+}
+
+}  // namespace
+
+Status TableTailSnapshot::Read(FileSystem* fs, const std::string& fname,
+                               std::shared_ptr<TableTailSnapshot>* snapshot) {
+  snapshot->reset(new TableTailSnapshot());
+  // Each tail is read into its own buffer, and only the tails are kept
+  std::unique_ptr<FSRandomAccessFile> file;
+  IOStatus s =
+      fs->NewRandomAccessFile(fname, FileOptions(), &file, nullptr /* dbg */);
+  if (s.IsNotFound() || s.IsPathNotFound()) {
+    return Status::OK();
+  }
+  uint64_t file_size = 0;
+  if (s.ok()) {
+    s = fs->GetFileSize(fname, IOOptions(), &file_size, nullptr /* dbg */);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+  std::unordered_map<uint64_t, Entry> entries;
+  std::unordered_map<uint64_t, Location> locations;
+  Status st = Decode(file.get(), fname, file_size, &entries, &locations);
+  if (st.ok()) {
+    (*snapshot)->entries_.swap(entries);
+    (*snapshot)->locations_.swap(locations);
+  }
+  return st;
+}
+
+Status TableTailSnapshot::Decode(
+    FSRandomAccessFile* file, const std::string& fname, uint64_t file_size,
+    std::unordered_map<uint64_t, Entry>* entries,
+    std::unordered_map<uint64_t, Location>* locations) {
+  if (file_size < kHeaderSize + kFooterSize) {
+    return Status::Corruption("Table tail snapshot too short");
+  }
+  char buf[kEntryHeaderSize];
+  IOStatus s = ReadFully(file, fname, 0, kHeaderSize, buf);
+  if (!s.ok()) {
+    return s;
+  }
+  if (DecodeFixed64(buf) != kMagicNumber) {
+    return Status::Corruption("Bad table tail snapshot magic number");
+  }
+  if (DecodeFixed32(buf + sizeof(uint64_t)) != kVersion) {
+    return Status::NotSupported("Unknown table tail snapshot version");
+  }
+  const uint64_t end = file_size - kFooterSize;
+  s = ReadFully(file, fname, end, kFooterSize, buf);
+  if (!s.ok()) {
+    return s;
+  }
+  const uint64_t num_entries = DecodeFixed64(buf);
+  if (DecodeFixed64(buf + sizeof(uint64_t)) != kMagicNumber) {
+    return Status::Corruption("Bad table tail snapshot footer");
+  }
+
+  uint64_t offset = kHeaderSize;
+  for (uint64_t i = 0; i < num_entries; ++i) {
+    if (end - offset < kEntryHeaderSize + kChecksumSize) {
+      return Status::Corruption("Bad table tail snapshot entry");
+    }
+    s = ReadFully(file, fname, offset, kEntryHeaderSize, buf);
+    if (!s.ok()) {
+      return s;
+    }
+    const uint64_t file_number = DecodeFixed64(buf);
+    Location location;
+    location.file_size = DecodeFixed64(buf + 8);
+    location.unique_id[0] = DecodeFixed64(buf + 16);
+    location.unique_id[1] = DecodeFixed64(buf + 24);
+    location.tail_size = DecodeFixed64(buf + 32);
+    location.offset = offset;
+    if (location.tail_size > end - offset - kEntryHeaderSize - kChecksumSize) {
+      return Status::Corruption("Bad table tail snapshot entry");
+    }
+    const size_t tail_size = static_cast<size_t>(location.tail_size);
+    auto tail = std::make_shared<std::string>();
+    tail->resize(tail_size + kChecksumSize);
+    s = ReadFully(file, fname, offset + kEntryHeaderSize, tail->size(),
+                  &(*tail)[0]);
+    if (!s.ok()) {
+      return s;
+    }
+    const uint32_t checksum =
+        crc32c::Extend(crc32c::Value(buf, kEntryHeaderSize), tail->data(),
+                       tail_size);
+    if (crc32c::Unmask(DecodeFixed32(tail->data() + tail_size)) != checksum) {
+      return Status::Corruption("Table tail snapshot checksum mismatch");
+    }
+    tail->resize(tail_size);
+    offset += kEntryHeaderSize + tail_size + kChecksumSize;
+
+    Entry& entry = (*entries)[file_number];
+    entry.file_size = location.file_size;
+    entry.unique_id = location.unique_id;
+    entry.tail = std::move(tail);
+    (*locations)[file_number] = location;
+  }
+  if (offset != end) {
+    return Status::Corruption("Trailing data in table tail snapshot");
+  }
+  return Status::OK();
+}
+
+std::shared_ptr<const std::string> TableTailSnapshot::GetTail(
+    uint64_t file_number, uint64_t file_size, uint64_t tail_size,
+    const UniqueId64x2& unique_id) const {
+  MutexLock l(&mutex_);
+  auto it = entries_.find(file_number);
+  if (it == entries_.end() || it->second.file_size != file_size ||
+      it->second.unique_id != unique_id ||
+      it->second.tail->size() != tail_size) {
+    return nullptr;
+  }
+  return it->second.tail;
+}
+
+void TableTailSnapshot::ReleaseTails() {
+  std::unordered_map<uint64_t, Entry> entries;
+  MutexLock l(&mutex_);
+  entries_.swap(entries);
+}
+
+Status TableTailSnapshot::Write(FileSystem* fs, const std::string& fname,
+                                const std::vector<LiveTable>& live_tables) {
+  // The current snapshot file, to copy the unchanged tails from
+  std::unique_ptr<FSRandomAccessFile> old_file;
+  if (!locations_.empty() &&
+      !fs->NewRandomAccessFile(fname, FileOptions(), &old_file,
+                               nullptr /* dbg */)
+           .ok()) {
+    old_file.reset();
+  }
+
+  // Replace the file atomically, so that a crash leaves either snapshot
+  const std::string tmp_fname = fname + ".tmp";
+  std::unique_ptr<FSWritableFile> file;
+  IOStatus s =
+      fs->NewWritableFile(tmp_fname, FileOptions(), &file, nullptr /* dbg */);
+  if (!s.ok()) {
+    return s;
+  }
+  std::string buf;
+  PutFixed64(&buf, kMagicNumber);
+  PutFixed32(&buf, kVersion);
+  s = file->Append(buf, IOOptions(), nullptr /* dbg */);
+  uint64_t offset = buf.size();
+
+  std::unordered_map<uint64_t, Location> locations;
+  for (size_t i = 0; s.ok() && i < live_tables.size(); ++i) {
+    const LiveTable& table = live_tables[i];
+    buf.clear();
+    auto it = locations_.find(table.file_number);
+    bool copied = false;
+    if (old_file && it != locations_.end() &&
+        it->second.file_size == table.file_size &&
+        it->second.unique_id == table.unique_id &&
+        it->second.tail_size == table.tail_size) {
+      copied = CopyEntry(old_file.get(), fname, table, it->second.offset, &buf)
+                   .ok();
+    }
+    if (!copied) {
+      buf.clear();
+      if (!ReadEntryFromTable(fs, table, &buf).ok()) {
+        // Likely deleted by a compaction since the list was taken
+        continue;
+      }
+    }
+    s = file->Append(buf, IOOptions(), nullptr /* dbg */);
+    Location& location = locations[table.file_number];
+    location.file_size = table.file_size;
+    location.unique_id = table.unique_id;
+    location.tail_size = table.tail_size;
+    location.offset = offset;
+    offset += buf.size();
+  }
+  old_file.reset();
+
+  if (s.ok()) {
+    buf.clear();
+    PutFixed64(&buf, locations.size());
+    PutFixed64(&buf, kMagicNumber);
+    s = file->Append(buf, IOOptions(), nullptr /* dbg */);
+  }
+  if (s.ok()) {
+    s = file->Sync(IOOptions(), nullptr /* dbg */);
+  }
+  if (s.ok()) {
+    s = file->Close(IOOptions(), nullptr /* dbg */);
+  } else {
+    file->Close(IOOptions(), nullptr /* dbg */).PermitUncheckedError();
+  }
+  file.reset();
+  if (s.ok()) {
+    s = fs->RenameFile(tmp_fname, fname, IOOptions(), nullptr /* dbg */);
+  }
+  if (!s.ok()) {
+    fs->DeleteFile(tmp_fname, IOOptions(), nullptr /* dbg */)
+        .PermitUncheckedError();
+    return s;
+  }
+  locations_.swap(locations);
+  return s;
+}
+
+namespace {
+
+class TailServedTableFile : public FSRandomAccessFile {
+ public:
+  TailServedTableFile(const std::shared_ptr<FileSystem>& fs,
+                      const std::string& fname, const FileOptions& file_opts,
+                      uint64_t file_size,
+                      std::shared_ptr<const std::string> tail,
+                      Statistics* stats)
+      : fs_(fs),
+        fname_(fname),
+        file_opts_(file_opts),
+        file_size_(file_size),
+        tail_offset_(file_size - tail->size()),
+        tail_(tail),
+        stats_(stats) {
+    assert(tail->size() <= file_size);
+  }
+
+  IOStatus Read(uint64_t offset, size_t n, const IOOptions& options,
+                Slice* result, char* scratch,
+                IODebugContext* dbg) const override {
+    if (InTail(offset) && scratch != nullptr) {
+      std::shared_ptr<const std::string> tail = tail_.lock();
+      if (tail) {
+        ReadTail(*tail, offset, n, result, scratch);
+        return IOStatus::OK();
+      }
+    }
+    IOStatus s = OpenFile();
+    if (!s.ok()) {
+      return s;
+    }
+    return file_->Read(offset, n, options, result, scratch, dbg);
+  }
+
+  IOStatus MultiRead(FSReadRequest* reqs, size_t num_reqs,
+                     const IOOptions& options, IODebugContext* dbg) override {
+    std::shared_ptr<const std::string> tail = tail_.lock();
+    bool all_in_tail = tail != nullptr;
+    for (size_t i = 0; all_in_tail && i < num_reqs; ++i) {
+      if (!InTail(reqs[i].offset) || reqs[i].scratch == nullptr) {
+        all_in_tail = false;
+      }
+    }
+    if (all_in_tail) {
+      for (size_t i = 0; i < num_reqs; ++i) {
+        ReadTail(*tail, reqs[i].offset, reqs[i].len, &reqs[i].result,
+                 reqs[i].scratch);
+        reqs[i].status = IOStatus::OK();
+      }
+      return IOStatus::OK();
+    }
+    IOStatus s = OpenFile();
+    if (!s.ok()) {
+      return s;
+    }
+    return file_->MultiRead(reqs, num_reqs, options, dbg);
+  }
+
+  IOStatus Prefetch(uint64_t offset, size_t n, const IOOptions& options,
+                    IODebugContext* dbg) override {
+    if (InTail(offset) && !tail_.expired()) {
+      // Makes the table reader read the tail through Read() instead
+      return IOStatus::NotSupported("Served from the table tail snapshot");
+    }
+    IOStatus s = OpenFile();
+    if (!s.ok()) {
+      return s;
+    }
+    return file_->Prefetch(offset, n, options, dbg);
+  }
+
+  IOStatus ReadAsync(FSReadRequest& req, const IOOptions& opts,
+                     std::function<void(FSReadRequest&, void*)> cb,
+                     void* cb_arg, void** io_handle, IOHandleDeleter* del_fn,
+                     IODebugContext* dbg) override {
+    if (InTail(req.offset) && !tail_.expired()) {
+      // Served synchronously through Read()
+      return FSRandomAccessFile::ReadAsync(req, opts, cb, cb_arg, io_handle,
+                                           del_fn, dbg);
+    }
+    IOStatus s = OpenFile();
+    if (!s.ok()) {
+      return s;
+    }
+    return file_->ReadAsync(req, opts, cb, cb_arg, io_handle, del_fn, dbg);
+  }
+
+  // Never used with direct reads, see TableCache::GetTableReader(). A larger
+  // alignment would make FilePrefetchBuffer extend reads of the tail to
+  // before it, and thereby open the file.
+  size_t GetRequiredBufferAlignment() const override { return 1; }
+
+  size_t GetUniqueId(char* id, size_t max_size) const override {
+    return opened_.load(std::memory_order_acquire)
+               ? file_->GetUniqueId(id, max_size)
+               : 0;
+  }
+
+  void Hint(AccessPattern pattern) override {
+    MutexLock l(&mutex_);
+    hint_ = pattern;
+    has_hint_ = true;
+    if (file_) {
+      file_->Hint(pattern);
+    }
+  }
+
+  IOStatus InvalidateCache(size_t offset, size_t length) override {
+    if (!opened_.load(std::memory_order_acquire)) {
+      return IOStatus::OK();
+    }
+    return file_->InvalidateCache(offset, length);
+  }
+
+  Temperature GetTemperature() const override {
+    return opened_.load(std::memory_order_acquire) ? file_->GetTemperature()
+                                                   : file_opts_.temperature;
+  }
+
+ private:
+  bool InTail(uint64_t offset) const {
+    return offset >= tail_offset_ && offset <= file_size_;
+  }
+
+  // Like a read of the file, a read past its end returns fewer bytes. The
+  // result is always copied to `scratch`, as the tail may be freed once the
+  // read returns.
+  void ReadTail(const std::string& tail, uint64_t offset, size_t n,
+                Slice* result, char* scratch) const {
+    const size_t pos = static_cast<size_t>(offset - tail_offset_);
+    n = std::min(n, tail.size() - pos);
+    memcpy(scratch, tail.data() + pos, n);
+    *result = Slice(scratch, n);
+  }
+
+  IOStatus OpenFile() const {
+    if (opened_.load(std::memory_order_acquire)) {
+      return IOStatus::OK();
+    }
+    MutexLock l(&mutex_);
+    if (file_) {
+      return IOStatus::OK();
+    }
+    IOStatus s =
+        fs_->NewRandomAccessFile(fname_, file_opts_, &file_, nullptr /* dbg */);
+    if (!s.ok()) {
+      return s;
+    }
+    RecordTick(stats_, NO_FILE_OPENS);
+    if (has_hint_) {
+      file_->Hint(hint_);
+    }
+    opened_.store(true, std::memory_order_release);
+    return s;
+  }
+
+  const std::shared_ptr<FileSystem> fs_;
+  const std::string fname_;
+  const FileOptions file_opts_;
+  const uint64_t file_size_;
+  const uint64_t tail_offset_;
+  // Owned by the TableTailSnapshot, until it releases its tails
+  const std::weak_ptr<const std::string> tail_;
+  Statistics* const stats_;
+
+  mutable port::Mutex mutex_;
+  // Set once file_ is opened, file_ is not modified afterwards
+  mutable std::atomic<bool> opened_{false};
+  mutable std::unique_ptr<FSRandomAccessFile> file_;
+  AccessPattern hint_ = kNormal;
+  bool has_hint_ = false;
+};
+
+}  // namespace
+
+std::unique_ptr<FSRandomAccessFile> NewTailServedTableFile(
+    const std::shared_ptr<FileSystem>& fs, const std::string& fname,
+    const FileOptions& file_opts, uint64_t file_size,
+    std::shared_ptr<const std::string> tail, Statistics* stats) {
+  return std::make_unique<TailServedTableFile>(fs, fname, file_opts, file_size,
+                                               std::move(tail), stats);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
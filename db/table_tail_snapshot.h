@@ -0,0 +1,123 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/statistics.h"
+#include "table/unique_id_impl.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The tails of the live table files, that is the bytes from the first
+// metadata block to the end of each file: index, filter, properties and the
+// other meta blocks, the metaindex and the footer. See
+// DBOptions::use_table_tail_snapshot.
+//
+// With the tails at hand, a table reader can be opened without touching the
+// table file, see NewTailServedTableFile(). The tails are read from the
+// snapshot file when the DB is opened, and freed once the table readers are
+// opened. The snapshot file is written back periodically and when the DB is
+// closed, one tail at a time.
+//
+// File format:
+//   magic: fixed64
+//   version: fixed32
+//   entries, each:
+//     file_number: fixed64
+//     file_size: fixed64
+//     unique_id: fixed64 x 2
+//     tail_size: fixed64
+//     tail: tail_size bytes
+//     checksum: fixed32, masked crc32c of the entry before it
+//   num_entries: fixed64
+//   magic: fixed64
+//
+// An entry is only used for the table file with the same number, size and
+// unique id, so a stale snapshot is harmless.
+class TableTailSnapshot {
+ public:
+  // A live table file to write the snapshot for
+  struct LiveTable {
+    std::string path;
+    uint64_t file_number = 0;
+    uint64_t file_size = 0;
+    uint64_t tail_size = 0;
+    UniqueId64x2 unique_id{};
+  };
+
+  // Reads the snapshot from `fname`. A missing file results in an empty
+  // snapshot.
+  static Status Read(FileSystem* fs, const std::string& fname,
+                     std::shared_ptr<TableTailSnapshot>* snapshot);
+
+  // Returns the tail of the given table file, or nullptr if there is none in
+  // the snapshot or the tails were released.
+  std::shared_ptr<const std::string> GetTail(
+      uint64_t file_number, uint64_t file_size, uint64_t tail_size,
+      const UniqueId64x2& unique_id) const;
+
+  // Frees the tails read from the snapshot file. The table files opened from
+  // them read their tails from the files afterwards.
+  void ReleaseTails();
+
+  // Writes the tails of `live_tables` to `fname`. The tails of the files
+  // already in the snapshot file are copied from it, the others are read from
+  // the table files. A table file that cannot be read, e.g. because it was
+  // deleted in the meantime, is left out. Only one Write() may run at a time.
+  Status Write(FileSystem* fs, const std::string& fname,
+               const std::vector<LiveTable>& live_tables);
+
+  // Returns the number of table files in the snapshot file. Must not run
+  // concurrently with Write().
+  size_t NumEntries() const { return locations_.size(); }
+
+ private:
+  static constexpr uint64_t kMagicNumber = 0x7e3a5f1d4c9b2a81ull;
+  static constexpr uint32_t kVersion = 1;
+
+  struct Entry {
+    uint64_t file_size = 0;
+    UniqueId64x2 unique_id{};
+    std::shared_ptr<const std::string> tail;
+  };
+
+  // Where the tail of a table file is in the snapshot file
+  struct Location {
+    uint64_t file_size = 0;
+    UniqueId64x2 unique_id{};
+    uint64_t tail_size = 0;
+    uint64_t offset = 0;
+  };
+
+  static Status Decode(FSRandomAccessFile* file, const std::string& fname,
+                       uint64_t file_size,
+                       std::unordered_map<uint64_t, Entry>* entries,
+                       std::unordered_map<uint64_t, Location>* locations);
+
+  mutable port::Mutex mutex_;
+  // Until ReleaseTails()
+  std::unordered_map<uint64_t, Entry> entries_;
+  // Only used by Write(), which does not run concurrently with itself
+  std::unordered_map<uint64_t, Location> locations_;
+};
+
+// Returns a table file that serves reads of its last `tail->size()` bytes
+// from `tail`, and only opens `fname` on the first read of any other part, or
+// of the tail once it is freed. The returned file does not keep `tail` alive.
+// `file_size` must be the size of the table file. Opening the table file is
+// counted in NO_FILE_OPENS of `stats`, when it happens.
+std::unique_ptr<FSRandomAccessFile> NewTailServedTableFile(
+    const std::shared_ptr<FileSystem>& fs, const std::string& fname,
+    const FileOptions& file_opts, uint64_t file_size,
+    std::shared_ptr<const std::string> tail, Statistics* stats);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -2625,6 +2625,10 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
   } else
 #endif  // USE_COROUTINES
   {
+    if (read_options.prefetch_multiget_across_levels &&
+        read_options.read_tier != kBlockCacheTier) {
+      MultiGetPrefetchAcrossLevels(read_options, *range);
+    }
     MultiGetRange file_picker_range(*range, range->begin(), range->end());
     FilePickerMultiGet fp(&file_picker_range, &storage_info_.level_files_brief_,
                           storage_info_.num_non_empty_levels_,
@@ -3060,6 +3064,41 @@ Status Version::MultiGetAsync(
 }
 #endif
 
+void Version::MultiGetPrefetchAcrossLevels(const ReadOptions& read_options,
+                                           const MultiGetRange& range) {
+  MultiGetRange plan_range(range, range.begin(), range.end());
+  FilePickerMultiGet fp(&plan_range, &storage_info_.level_files_brief_,
+                        storage_info_.num_non_empty_levels_,
+                        &storage_info_.file_indexer_, user_comparator(),
+                        internal_comparator());
+  while (!fp.IsSearchEnded()) {
+    FdWithKeyRange* f = fp.GetNextFileInLevel();
+    if (f == nullptr) {
+      fp.PrepareNextLevelForSearch();
+      continue;
+    }
+    MultiGetRange file_range = fp.CurrentFileRange();
+    const int level = static_cast<int>(fp.GetHitFileLevel());
+    Status s = table_cache_->MultiGetPrefetch(
+        read_options, *internal_comparator(), *f->file_metadata,
+        mutable_cf_options_, cfd_->internal_stats()->GetFileReadHist(level),
+        level, &file_range);
+    if (s.ok()) {
+      // Keys that passed the filter are likely found in this file, so stop
+      // planning them for the next levels.
+      for (auto iter = file_range.begin(); iter != file_range.end(); ++iter) {
+        fp.GetRange().SkipKey(iter);
+      }
+      if (fp.GetRange().empty()) {
+        break;
+      }
+    } else {
+      // The real lookup will surface the error, if it persists
+      s.PermitUncheckedError();
+    }
+  }
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
@@ -3933,12 +3972,14 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
+// Sort `temp` based on ratio of overlapping size over file size. With
+// `boost_read_hot_files`, the ratio is further divided by the file's
+// FileReadHeatBooster score.
 void SortFileByOverlappingRatio(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
     const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
     int level, int num_non_empty_levels, uint64_t ttl,
-    std::vector<Fsize>* temp) {
+    bool boost_read_hot_files, std::vector<Fsize>* temp) {
   std::unordered_map<uint64_t, uint64_t> file_to_order;
   auto next_level_it = next_level_files.begin();
 
@@ -3951,6 +3992,8 @@ void SortFileByOverlappingRatio(
 
   FileTtlBooster ttl_booster(static_cast<uint64_t>(curr_time), ttl,
                              num_non_empty_levels, level);
+  FileReadHeatBooster read_heat_booster(
+      status.ok() ? static_cast<uint64_t>(curr_time) : 0, files);
 
   for (auto& file : files) {
     uint64_t overlapping_bytes = 0;
@@ -3974,9 +4017,13 @@ void SortFileByOverlappingRatio(
     uint64_t ttl_boost_score = (ttl > 0) ? ttl_booster.GetBoostScore(file) : 1;
     assert(ttl_boost_score > 0);
     assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] = overlapping_bytes * 1024U /
-                                          file->compensated_file_size /
-                                          ttl_boost_score;
+    uint64_t order = overlapping_bytes * 1024U / file->compensated_file_size /
+                     ttl_boost_score;
+    if (boost_read_hot_files) {
+      order = static_cast<uint64_t>(static_cast<double>(order) /
+                                    read_heat_booster.GetBoostScore(file));
+    }
+    file_to_order[file->fd.GetNumber()] = order;
   }
 
   size_t num_to_sort = temp->size() > VersionStorageInfo::kNumberFilesToSort
@@ -4107,9 +4154,11 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
                   });
         break;
       case kMinOverlappingRatio:
-        SortFileByOverlappingRatio(*internal_comparator_, files_[level],
-                                   files_[level + 1], ioptions.clock, level,
-                                   num_non_empty_levels_, options.ttl, &temp);
+      case kReadHotRangesFirst:
+        SortFileByOverlappingRatio(
+            *internal_comparator_, files_[level], files_[level + 1],
+            ioptions.clock, level, num_non_empty_levels_, options.ttl,
+            ioptions.compaction_pri == kReadHotRangesFirst, &temp);
         break;
       case kRoundRobin:
         SortFileByRoundRobin(*internal_comparator_, &compact_cursor_,
@@ -7150,7 +7199,8 @@ InternalIterator* VersionSet::MakeInputIterator(
   assert(num <= space);
   InternalIterator* result = NewCompactionMergingIterator(
       &c->column_family_data()->internal_comparator(), list,
-      static_cast<int>(num), range_tombstones);
+      static_cast<int>(num), range_tombstones, nullptr /* arena */,
+      c->immutable_options()->merge_with_tournament_tree);
   delete[] list;
   return result;
 }
@@ -7296,6 +7346,9 @@ ColumnFamilyData* VersionSet::CreateColumnFamily(
   auto new_cfd = column_family_set_->CreateColumnFamily(
       edit->GetColumnFamilyName(), edit->GetColumnFamily(), dummy_versions,
       cf_options);
+  if (table_tail_snapshot_) {
+    new_cfd->table_cache()->SetTailSnapshot(table_tail_snapshot_);
+  }
 
   Version* v = new Version(new_cfd, this, file_options_,
                            *new_cfd->GetLatestMutableCFOptions(), io_tracer_,
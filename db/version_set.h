@@ -85,6 +85,7 @@ class MergeIteratorBuilder;
 class SystemClock;
 class ManifestTailer;
 class FilePickerMultiGet;
+class TableTailSnapshot;
 
 // VersionEdit is always supposed to be valid and it is used to point at
 // entries in Manifest. Ideally it should not be used as a container to
@@ -1092,6 +1093,15 @@ class Version {
   // This accumulated stats will be used in compaction.
   void UpdateAccumulatedStats(const ReadOptions& read_options);
 
+  // Walk the files that may contain the keys in range, from the newest level
+  // to the oldest, and issue readahead hints for the data blocks of keys that
+  // pass each file's filter. A key that passes a filter is assumed to be found
+  // there, and is not planned in the older levels. This lets the subsequent
+  // level by level lookup find the blocks in the OS page cache instead of
+  // waiting on one round of reads per level.
+  void MultiGetPrefetchAcrossLevels(const ReadOptions& read_options,
+                                    const MultiGetRange& range);
+
   DECLARE_SYNC_AND_ASYNC(
       /* ret_type */ Status, /* func_name */ MultiGetFromSST,
       const ReadOptions& read_options, MultiGetRange file_range,
@@ -1348,6 +1358,12 @@ class VersionSet {
 
   const std::string& DbSessionId() const { return db_session_id_; }
 
+  // The column families created afterwards open their table readers from
+  // the tails in `snapshot` where possible.
+  void SetTableTailSnapshot(std::shared_ptr<TableTailSnapshot> snapshot) {
+    table_tail_snapshot_ = std::move(snapshot);
+  }
+
   // Return the current manifest file number
   uint64_t manifest_file_number() const { return manifest_file_number_; }
 
@@ -1721,6 +1737,8 @@ class VersionSet {
 
   std::string db_session_id_;
 
+  std::shared_ptr<TableTailSnapshot> table_tail_snapshot_;
+
   // Off-peak time option used for compaction scoring
   OffpeakTimeOption offpeak_time_option_;
 
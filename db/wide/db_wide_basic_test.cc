@@ -1794,6 +1794,174 @@ TEST_F(DBWideBasicTest, PinnableWideColumnsMove) {
   test_move(/* fill_cache*/ true);
 }
 
+TEST_F(DBWideBasicTest, ProjectedColumns) {
+  constexpr char first_key[] = "first";
+  const WideColumns first_columns{{kDefaultWideColumnName, "hello"},
+                                  {"attr_a", "one"},
+                                  {"attr_b", "two"},
+                                  {"attr_c", "three"}};
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                           first_key, first_columns));
+
+  constexpr char second_key[] = "second";
+  constexpr char second_value[] = "baz";
+  ASSERT_OK(db_->Put(WriteOptions(), db_->DefaultColumnFamily(), second_key,
+                     second_value));
+
+  constexpr char third_key[] = "third";
+  const WideColumns third_columns{{"attr_b", "four"}, {"attr_d", "five"}};
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(),
+                           third_key, third_columns));
+
+  const std::vector<Slice> projection{"attr_a", "attr_c", "attr_z"};
+  const std::vector<Slice> projection_with_default{kDefaultWideColumnName,
+                                                   "attr_b"};
+
+  auto verify = [&]() {
+    ReadOptions read_options;
+
+    {
+      read_options.projected_columns = &projection;
+
+      PinnableWideColumns result;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               first_key, &result));
+      const WideColumns expected{{"attr_a", "one"}, {"attr_c", "three"}};
+      ASSERT_EQ(result.columns(), expected);
+
+      PinnableWideColumns move_target(std::move(result));
+      ASSERT_EQ(move_target.columns(), expected);
+
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               second_key, &result));
+      ASSERT_TRUE(result.columns().empty());
+
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               third_key, &result));
+      ASSERT_TRUE(result.columns().empty());
+
+      // The projection does not outlive the read
+      read_options.projected_columns = nullptr;
+      ASSERT_OK(db_->GetEntity(read_options, db_->DefaultColumnFamily(),
+                               first_key, &result));
+      ASSERT_EQ(result.columns(), first_columns);
+    }
+
+    {
+      read_options.projected_columns = &projection_with_default;
+
+      constexpr size_t num_keys = 3;
+      std::array<Slice, num_keys> keys{{first_key, second_key, third_key}};
+      std::array<PinnableWideColumns, num_keys> results;
+      std::array<Status, num_keys> statuses;
+
+      db_->MultiGetEntity(read_options, db_->DefaultColumnFamily(), num_keys,
+                          keys.data(), results.data(), statuses.data());
+
+      ASSERT_OK(statuses[0]);
+      ASSERT_EQ(results[0].columns(),
+                (WideColumns{{kDefaultWideColumnName, "hello"},
+                             {"attr_b", "two"}}));
+
+      ASSERT_OK(statuses[1]);
+      ASSERT_EQ(results[1].columns(),
+                (WideColumns{{kDefaultWideColumnName, second_value}}));
+
+      ASSERT_OK(statuses[2]);
+      ASSERT_EQ(results[2].columns(), (WideColumns{{"attr_b", "four"}}));
+
+      // Get() is not affected
+      PinnableSlice value;
+      ASSERT_OK(db_->Get(read_options, db_->DefaultColumnFamily(), first_key,
+                         &value));
+      ASSERT_EQ(value, "hello");
+    }
+
+    {
+      const std::vector<Slice> attr_b{"attr_b"};
+      read_options.projected_columns = &attr_b;
+
+      std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+
+      iter->SeekToFirst();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), first_key);
+      ASSERT_EQ(iter->value(), "hello");
+      ASSERT_EQ(iter->columns(), (WideColumns{{"attr_b", "two"}}));
+
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), second_key);
+      ASSERT_EQ(iter->value(), second_value);
+      ASSERT_TRUE(iter->columns().empty());
+
+      iter->Next();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), third_key);
+      ASSERT_TRUE(iter->value().empty());
+      ASSERT_EQ(iter->columns(), (WideColumns{{"attr_b", "four"}}));
+
+      iter->Prev();
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), second_key);
+      ASSERT_TRUE(iter->columns().empty());
+
+      iter->Next();
+      iter->Next();
+      ASSERT_FALSE(iter->Valid());
+      ASSERT_OK(iter->status());
+    }
+  };
+
+  // Memtable
+  verify();
+
+  // Block-based table
+  ASSERT_OK(Flush());
+  verify();
+}
+
+TEST_F(DBWideBasicTest, ProjectedColumnsInvalid) {
+  constexpr char key[] = "key";
+  ASSERT_OK(db_->PutEntity(WriteOptions(), db_->DefaultColumnFamily(), key,
+                           WideColumns{{"attr_a", "one"}, {"attr_b", "two"}}));
+
+  const std::vector<Slice> unsorted{"attr_b", "attr_a"};
+  const std::vector<Slice> duplicates{"attr_a", "attr_a"};
+
+  for (const auto* projection : {&unsorted, &duplicates}) {
+    ReadOptions read_options;
+    read_options.projected_columns = projection;
+
+    PinnableWideColumns result;
+    ASSERT_TRUE(
+        db_->GetEntity(read_options, db_->DefaultColumnFamily(), key, &result)
+            .IsInvalidArgument());
+
+    PinnableAttributeGroups attribute_groups;
+    attribute_groups.emplace_back(db_->DefaultColumnFamily());
+    ASSERT_TRUE(db_->GetEntity(read_options, key, &attribute_groups)
+                    .IsInvalidArgument());
+    ASSERT_TRUE(attribute_groups[0].status().IsInvalidArgument());
+
+    std::array<Slice, 1> keys{{key}};
+    std::array<PinnableWideColumns, 1> results;
+    std::array<Status, 1> statuses;
+    db_->MultiGetEntity(read_options, db_->DefaultColumnFamily(), keys.size(),
+                        keys.data(), results.data(), statuses.data());
+    ASSERT_TRUE(statuses[0].IsInvalidArgument());
+
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_TRUE(iter->status().IsInvalidArgument());
+
+    std::vector<Iterator*> iters;
+    ASSERT_TRUE(
+        db_->NewIterators(read_options, {db_->DefaultColumnFamily()}, &iters)
+            .IsInvalidArgument());
+  }
+}
+
 TEST_F(DBWideBasicTest, SanityChecks) {
   constexpr char foo[] = "foo";
   constexpr char bar[] = "bar";
@@ -8,14 +8,73 @@
 #include <algorithm>
 #include <cassert>
 #include <limits>
+#include <utility>
 
-#include "db/wide/wide_columns_helper.h"
 #include "rocksdb/slice.h"
 #include "util/autovector.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+
+// Parses the version, the number of columns, and the index of a serialized
+// entity, calling on_num_columns(num_columns) once the number of columns is
+// known, then on_column(name, value_offset, value_size) for each column,
+// where value_offset is relative to the start of the values. On success,
+// `input` points to the column values, which are checked to be complete.
+template <typename OnNumColumns, typename OnColumn>
+Status ParseIndex(Slice& input, OnNumColumns&& on_num_columns,
+                  OnColumn&& on_column) {
+  uint32_t version = 0;
+  if (!GetVarint32(&input, &version)) {
+    return Status::Corruption("Error decoding wide column version");
+  }
+
+  if (version > WideColumnSerialization::kCurrentVersion) {
+    return Status::NotSupported("Unsupported wide column version");
+  }
+
+  uint32_t num_columns = 0;
+  if (!GetVarint32(&input, &num_columns)) {
+    return Status::Corruption("Error decoding number of wide columns");
+  }
+
+  on_num_columns(num_columns);
+
+  Slice prev_name;
+  uint64_t value_offset = 0;
+
+  for (uint32_t i = 0; i < num_columns; ++i) {
+    Slice name;
+    if (!GetLengthPrefixedSlice(&input, &name)) {
+      return Status::Corruption("Error decoding wide column name");
+    }
+
+    if (i > 0 && prev_name.compare(name) >= 0) {
+      return Status::Corruption("Wide columns out of order");
+    }
+
+    uint32_t value_size = 0;
+    if (!GetVarint32(&input, &value_size)) {
+      return Status::Corruption("Error decoding wide column value size");
+    }
+
+    on_column(name, value_offset, value_size);
+
+    prev_name = name;
+    value_offset += value_size;
+  }
+
+  if (value_offset > input.size()) {
+    return Status::Corruption("Error decoding wide column value payload");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace
+
 Status WideColumnSerialization::Serialize(const WideColumns& columns,
                                           std::string& output) {
   const size_t num_columns = columns.size();
@@ -68,62 +127,69 @@ Status WideColumnSerialization::Deserialize(Slice& input,
                                             WideColumns& columns) {
   assert(columns.empty());
 
-  uint32_t version = 0;
-  if (!GetVarint32(&input, &version)) {
-    return Status::Corruption("Error decoding wide column version");
-  }
-
-  if (version > kCurrentVersion) {
-    return Status::NotSupported("Unsupported wide column version");
-  }
-
-  uint32_t num_columns = 0;
-  if (!GetVarint32(&input, &num_columns)) {
-    return Status::Corruption("Error decoding number of wide columns");
+  // Offsets and sizes of the values, which are filled in once the start of
+  // the values is known
+  autovector<std::pair<uint64_t, uint32_t>, 16> value_locations;
+
+  const Status s = ParseIndex(
+      input,
+      [&](uint32_t num_columns) {
+        columns.reserve(num_columns);
+        value_locations.reserve(num_columns);
+      },
+      [&](const Slice& name, uint64_t value_offset, uint32_t value_size) {
+        columns.emplace_back(name, Slice());
+        value_locations.emplace_back(value_offset, value_size);
+      });
+  if (!s.ok()) {
+    return s;
   }
 
-  if (!num_columns) {
-    return Status::OK();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const auto& location = value_locations[i];
+    columns[i].value() = Slice(input.data() + location.first, location.second);
   }
 
-  columns.reserve(num_columns);
-
-  autovector<uint32_t, 16> column_value_sizes;
-  column_value_sizes.reserve(num_columns);
-
-  for (uint32_t i = 0; i < num_columns; ++i) {
-    Slice name;
-    if (!GetLengthPrefixedSlice(&input, &name)) {
-      return Status::Corruption("Error decoding wide column name");
-    }
-
-    if (!columns.empty() && columns.back().name().compare(name) >= 0) {
-      return Status::Corruption("Wide columns out of order");
-    }
-
-    columns.emplace_back(name, Slice());
-
-    uint32_t value_size = 0;
-    if (!GetVarint32(&input, &value_size)) {
-      return Status::Corruption("Error decoding wide column value size");
-    }
+  return Status::OK();
+}
 
-    column_value_sizes.emplace_back(value_size);
+Status WideColumnSerialization::DeserializeColumns(
+    Slice& input, const std::vector<Slice>& column_names,
+    WideColumns& columns) {
+  assert(columns.empty());
+  assert(std::adjacent_find(column_names.cbegin(), column_names.cend(),
+                            [](const Slice& lhs, const Slice& rhs) {
+                              return lhs.compare(rhs) >= 0;
+                            }) == column_names.cend());
+
+  // Offsets and sizes of the requested values, which are filled in once the
+  // start of the values is known
+  autovector<std::pair<uint64_t, uint32_t>, 16> value_locations;
+  size_t next = 0;
+
+  const Status s = ParseIndex(
+      input, [](uint32_t /* num_columns */) {},
+      [&](const Slice& name, uint64_t value_offset, uint32_t value_size) {
+        // Both the index and the requested names are sorted, so a single
+        // forward pass over the requested names suffices.
+        while (next < column_names.size() &&
+               column_names[next].compare(name) < 0) {
+          ++next;
+        }
+
+        if (next < column_names.size() && column_names[next] == name) {
+          columns.emplace_back(name, Slice());
+          value_locations.emplace_back(value_offset, value_size);
+          ++next;
+        }
+      });
+  if (!s.ok()) {
+    return s;
   }
 
-  const Slice data(input);
-  size_t pos = 0;
-
-  for (uint32_t i = 0; i < num_columns; ++i) {
-    const uint32_t value_size = column_value_sizes[i];
-
-    if (pos + value_size > data.size()) {
-      return Status::Corruption("Error decoding wide column value payload");
-    }
-
-    columns[i].value() = Slice(data.data() + pos, value_size);
-
-    pos += value_size;
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const auto& location = value_locations[i];
+    columns[i].value() = Slice(input.data() + location.first, location.second);
   }
 
   return Status::OK();
@@ -146,19 +212,31 @@ WideColumns::const_iterator WideColumnSerialization::Find(
 
 Status WideColumnSerialization::GetValueOfDefaultColumn(Slice& input,
                                                         Slice& value) {
-  WideColumns columns;
-
-  const Status s = Deserialize(input, columns);
+  // The default column, if present, is the first one in the index, so there is
+  // no need to materialize the entity to find it.
+  bool has_default_column = false;
+  uint64_t default_value_offset = 0;
+  uint32_t default_value_size = 0;
+
+  const Status s = ParseIndex(
+      input, [](uint32_t /* num_columns */) {},
+      [&](const Slice& name, uint64_t value_offset, uint32_t value_size) {
+        if (name == kDefaultWideColumnName) {
+          has_default_column = true;
+          default_value_offset = value_offset;
+          default_value_size = value_size;
+        }
+      });
   if (!s.ok()) {
     return s;
   }
 
-  if (!WideColumnsHelper::HasDefaultColumn(columns)) {
+  if (!has_default_column) {
     value.clear();
     return Status::OK();
   }
 
-  value = WideColumnsHelper::GetDefaultColumn(columns);
+  value = Slice(input.data() + default_value_offset, default_value_size);
 
   return Status::OK();
 }
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/status.h"
@@ -20,9 +21,10 @@ class Slice;
 //
 // The two main parts of the layout are 1) a sorted index containing the column
 // names and column value sizes and 2) the column values themselves. Keeping the
-// index and the values separate will enable selectively reading column values
-// down the line. Note that currently the index has to be fully parsed in order
-// to find out the offset of each column value.
+// index and the values separate enables selectively reading column values (see
+// DeserializeColumns and GetValueOfDefaultColumn), which only materialize the
+// requested columns. Note that currently the index still has to be fully parsed
+// in order to find out the offset of each column value.
 //
 // Legend: cn = column name, cv = column value, cns = column name size, cvs =
 // column value size.
@@ -47,6 +49,14 @@ class WideColumnSerialization {
 
   static Status Deserialize(Slice& input, WideColumns& columns);
 
+  // Like Deserialize but only returns the columns named in `column_names`,
+  // which has to be sorted and free of duplicates. The requested columns that
+  // are present in the entity are added to `columns` in order; the rest of the
+  // entity is validated but not materialized.
+  static Status DeserializeColumns(Slice& input,
+                                   const std::vector<Slice>& column_names,
+                                   WideColumns& columns);
+
   static WideColumns::const_iterator Find(const WideColumns& columns,
                                           const Slice& column_name);
   static Status GetValueOfDefaultColumn(Slice& input, Slice& value);
@@ -124,6 +124,108 @@ TEST(WideColumnSerializationTest, SerializeDeserialize) {
   }
 }
 
+TEST(WideColumnSerializationTest, DeserializeColumns) {
+  WideColumns columns{{kDefaultWideColumnName, "baz"},
+                      {"foo", "bar"},
+                      {"hello", "world"},
+                      {"snafu", "fubar"}};
+  std::string output;
+
+  ASSERT_OK(WideColumnSerialization::Serialize(columns, output));
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeColumns(
+        input, {"a", "foo", "quux", "snafu", "zzz"}, deserialized_columns));
+    ASSERT_EQ(deserialized_columns,
+              (WideColumns{{"foo", "bar"}, {"snafu", "fubar"}}));
+  }
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeColumns(
+        input, {kDefaultWideColumnName, "foo", "hello", "snafu"},
+        deserialized_columns));
+    ASSERT_EQ(deserialized_columns, columns);
+  }
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeColumns(
+        input, {"quux"}, deserialized_columns));
+    ASSERT_TRUE(deserialized_columns.empty());
+  }
+
+  {
+    Slice input(output);
+    WideColumns deserialized_columns;
+
+    ASSERT_OK(WideColumnSerialization::DeserializeColumns(
+        input, {}, deserialized_columns));
+    ASSERT_TRUE(deserialized_columns.empty());
+  }
+
+  // Truncated payload is detected even if the requested columns are intact
+  {
+    Slice input(output.data(), output.size() - 1);
+    WideColumns deserialized_columns;
+
+    const Status s = WideColumnSerialization::DeserializeColumns(
+        input, {"foo"}, deserialized_columns);
+    ASSERT_TRUE(s.IsCorruption());
+    ASSERT_TRUE(std::strstr(s.getState(), "payload"));
+  }
+}
+
+TEST(WideColumnSerializationTest, GetValueOfDefaultColumn) {
+  {
+    WideColumns columns{{kDefaultWideColumnName, "baz"}, {"foo", "bar"}};
+    std::string output;
+
+    ASSERT_OK(WideColumnSerialization::Serialize(columns, output));
+
+    Slice input(output);
+    Slice value;
+
+    ASSERT_OK(WideColumnSerialization::GetValueOfDefaultColumn(input, value));
+    ASSERT_EQ(value, "baz");
+  }
+
+  {
+    WideColumns columns{{"foo", "bar"}, {"hello", "world"}};
+    std::string output;
+
+    ASSERT_OK(WideColumnSerialization::Serialize(columns, output));
+
+    Slice input(output);
+    Slice value("dummy");
+
+    ASSERT_OK(WideColumnSerialization::GetValueOfDefaultColumn(input, value));
+    ASSERT_TRUE(value.empty());
+  }
+
+  {
+    WideColumns columns{{kDefaultWideColumnName, "baz"}, {"foo", "bar"}};
+    std::string output;
+
+    ASSERT_OK(WideColumnSerialization::Serialize(columns, output));
+
+    Slice input(output.data(), output.size() - 1);
+    Slice value;
+
+    const Status s =
+        WideColumnSerialization::GetValueOfDefaultColumn(input, value);
+    ASSERT_TRUE(s.IsCorruption());
+    ASSERT_TRUE(std::strstr(s.getState(), "payload"));
+  }
+}
+
 TEST(WideColumnSerializationTest, SerializeDuplicateError) {
   WideColumns columns{{"foo", "bar"}, {"foo", "baz"}};
   std::string output;
@@ -16,6 +16,11 @@ Status PinnableWideColumns::CreateIndexForWideColumns() {
   columns_.clear();
 
   Slice value_copy = value_;
+  if (projection_) {
+    return WideColumnSerialization::DeserializeColumns(value_copy, *projection_,
+                                                       columns_);
+  }
+
   return WideColumnSerialization::Deserialize(value_copy, columns_);
 }
 
@@ -2129,9 +2129,12 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 
   void set_log_number_ref(uint64_t log) { log_number_ref_ = log; }
-  void set_prot_info(const WriteBatch::ProtectionInfo* prot_info) {
+  // `first_entry` is the index of the protection info of the next record,
+  // which is non-zero when only inserting a part of the batch.
+  void set_prot_info(const WriteBatch::ProtectionInfo* prot_info,
+                     size_t first_entry = 0) {
     prot_info_ = prot_info;
-    prot_info_idx_ = 0;
+    prot_info_idx_ = first_entry;
   }
 
   SequenceNumber sequence() const { return sequence_; }
@@ -3253,6 +3256,101 @@ Status WriteBatchInternal::InsertInto(
   return s;
 }
 
+bool WriteBatchInternal::SplitForParallelInsert(const WriteBatch* batch,
+                                                size_t max_parts,
+                                                std::vector<Part>* parts) {
+  assert(max_parts > 1);
+  assert(parts);
+  parts->clear();
+
+  const uint32_t count = Count(batch);
+  if (count < max_parts) {
+    return false;
+  }
+  const uint32_t records_per_part =
+      static_cast<uint32_t>((count + max_parts - 1) / max_parts);
+
+  const std::string& rep = batch->rep_;
+  if (rep.size() < kHeader) {
+    return false;
+  }
+  Slice input(rep.data() + kHeader, rep.size() - kHeader);
+
+  Part part{kHeader, kHeader, 0};
+  uint32_t num_records = 0;
+  Slice key, value, blob, xid;
+  uint64_t write_unix_time = 0;
+
+  while (!input.empty()) {
+    char tag = 0;
+    uint32_t column_family = 0;
+    const Status s =
+        ReadRecordFromWriteBatch(&input, &tag, &column_family, &key, &value,
+                                 &blob, &xid, &write_unix_time);
+    if (!s.ok()) {
+      return false;
+    }
+
+    switch (tag) {
+      case kTypeColumnFamilyValue:
+      case kTypeValue:
+      case kTypeColumnFamilyDeletion:
+      case kTypeDeletion:
+      case kTypeColumnFamilySingleDeletion:
+      case kTypeSingleDeletion:
+      case kTypeColumnFamilyRangeDeletion:
+      case kTypeRangeDeletion:
+      case kTypeColumnFamilyBlobIndex:
+      case kTypeBlobIndex:
+      case kTypeWideColumnEntity:
+      case kTypeColumnFamilyWideColumnEntity:
+      case kTypeValuePreferredSeqno:
+      case kTypeColumnFamilyValuePreferredSeqno:
+        ++num_records;
+        break;
+      case kTypeLogData:
+        break;
+      default:
+        // Merges cannot be inserted concurrently, and transaction markers
+        // change how records are sequenced.
+        return false;
+    }
+
+    if (num_records - part.first_record == records_per_part) {
+      part.end = rep.size() - input.size();
+      parts->push_back(part);
+      part = Part{part.end, part.end, num_records};
+    }
+  }
+
+  if (num_records != count) {
+    return false;
+  }
+  if (part.begin < rep.size()) {
+    part.end = rep.size();
+    parts->push_back(part);
+  }
+
+  return parts->size() > 1;
+}
+
+Status WriteBatchInternal::InsertPartInto(
+    const WriteBatch* batch, const Part& part, SequenceNumber sequence,
+    ColumnFamilyMemTables* memtables, FlushScheduler* flush_scheduler,
+    TrimHistoryScheduler* trim_history_scheduler,
+    bool ignore_missing_column_families, uint64_t log_number_ref, DB* db) {
+  MemTableInserter inserter(
+      sequence + part.first_record, memtables, flush_scheduler,
+      trim_history_scheduler, ignore_missing_column_families,
+      0 /* recovering_log_number */, db, true /* concurrent_memtable_writes */,
+      nullptr /* prot_info */);
+  inserter.set_log_number_ref(log_number_ref);
+  inserter.set_prot_info(batch->prot_info_.get(), part.first_record);
+  Status s = Iterate(batch, &inserter, part.begin, part.end);
+  inserter.PostProcess();
+  return s;
+}
+
 namespace {
 
 // This class updates protection info for a WriteBatch.
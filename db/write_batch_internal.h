@@ -208,6 +208,36 @@ class WriteBatchInternal {
                            bool batch_per_txn = true,
                            bool hint_per_batch = false);
 
+  // A contiguous range of records of a WriteBatch, as returned by
+  // SplitForParallelInsert().
+  struct Part {
+    // Offsets of the first record and one past the last record in the batch
+    size_t begin;
+    size_t end;
+    // Number of sequenced records (see Count()) in the batch before the part
+    uint32_t first_record;
+  };
+
+  // Splits `batch` at record boundaries into at most `max_parts` parts with
+  // about the same number of records, to be inserted into the memtables
+  // concurrently by InsertPartInto(). Returns false if the batch cannot be
+  // split that way, which is the case if it contains Merge operations or
+  // transaction markers, or if it has fewer records than `max_parts`.
+  static bool SplitForParallelInsert(const WriteBatch* batch, size_t max_parts,
+                                     std::vector<Part>* parts);
+
+  // Inserts the records of `part` into the memtables as a concurrent memtable
+  // writer, given that the first record of `batch` has sequence number
+  // `sequence`. Requires the DB to use one sequence number per key. The
+  // caller has to make sure `memtables` is only used by the calling thread.
+  static Status InsertPartInto(const WriteBatch* batch, const Part& part,
+                               SequenceNumber sequence,
+                               ColumnFamilyMemTables* memtables,
+                               FlushScheduler* flush_scheduler,
+                               TrimHistoryScheduler* trim_history_scheduler,
+                               bool ignore_missing_column_families,
+                               uint64_t log_number_ref, DB* db);
+
   // Appends src write batch to dst write batch and updates count in dst
   // write batch. Returns OK if the append is successful. Checks number of
   // checksum against count in dst and src write batches, and returns Corruption
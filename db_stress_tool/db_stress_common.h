@@ -97,6 +97,7 @@ DECLARE_int32(ttl);
 DECLARE_int32(value_size_mult);
 DECLARE_int32(compaction_readahead_size);
 DECLARE_bool(enable_pipelined_write);
+DECLARE_bool(enable_pipelined_wal_sync);
 DECLARE_bool(verify_before_write);
 DECLARE_bool(histogram);
 DECLARE_bool(destroy_db_initially);
@@ -163,6 +164,8 @@ DECLARE_bool(fifo_allow_compaction);
 DECLARE_bool(allow_concurrent_memtable_write);
 DECLARE_double(experimental_mempurge_threshold);
 DECLARE_bool(enable_write_thread_adaptive_yield);
+DECLARE_int32(large_batch_memtable_insert_threads);
+DECLARE_uint64(large_batch_memtable_insert_min_entries);
 DECLARE_int32(reopen);
 DECLARE_double(bloom_bits);
 DECLARE_int32(bloom_before_level);
@@ -174,6 +177,9 @@ DECLARE_uint32(sqfc_version);
 DECLARE_bool(use_sqfc_for_range_queries);
 DECLARE_int32(index_type);
 DECLARE_int32(data_block_index_type);
+DECLARE_bool(data_block_restart_key_prefixes);
+DECLARE_bool(piecewise_linear_index);
+DECLARE_uint32(range_filter_prefix_len);
 DECLARE_string(db);
 DECLARE_string(secondaries_base);
 DECLARE_bool(test_secondary);
@@ -262,6 +268,7 @@ DECLARE_bool(avoid_unnecessary_blocking_io);
 DECLARE_bool(write_dbid_to_manifest);
 DECLARE_bool(write_identity_file);
 DECLARE_bool(avoid_flush_during_recovery);
+DECLARE_bool(enable_pipelined_wal_recovery);
 DECLARE_uint64(max_write_batch_group_size_bytes);
 DECLARE_bool(level_compaction_dynamic_level_bytes);
 DECLARE_int32(verify_checksum_one_in);
@@ -321,6 +328,7 @@ DECLARE_int32(approximate_size_one_in);
 DECLARE_bool(best_efforts_recovery);
 DECLARE_bool(skip_verifydb);
 DECLARE_bool(paranoid_file_checks);
+DECLARE_bool(merge_with_tournament_tree);
 DECLARE_bool(fail_if_options_file_error);
 DECLARE_uint64(batch_protection_bytes_per_key);
 DECLARE_uint32(memtable_protection_bytes_per_key);
@@ -342,6 +350,7 @@ DECLARE_bool(adaptive_readahead);
 DECLARE_bool(async_io);
 DECLARE_string(wal_compression);
 DECLARE_bool(verify_sst_unique_id_in_manifest);
+DECLARE_bool(use_table_tail_snapshot);
 
 DECLARE_int32(create_timestamped_snapshot_one_in);
 
@@ -382,6 +391,8 @@ DECLARE_bool(strict_bytes_per_sync);
 DECLARE_bool(avoid_flush_during_shutdown);
 DECLARE_bool(fill_cache);
 DECLARE_bool(optimize_multiget_for_io);
+DECLARE_bool(prefetch_multiget_across_levels);
+DECLARE_uint64(min_memtable_value_size_to_pin);
 DECLARE_bool(memtable_insert_hint_per_batch);
 DECLARE_bool(dump_malloc_stats);
 DECLARE_uint64(stats_history_buffer_size);
@@ -436,7 +447,7 @@ extern enum ROCKSDB_NAMESPACE::CompressionType compression_type_e;
 extern enum ROCKSDB_NAMESPACE::CompressionType bottommost_compression_type_e;
 extern enum ROCKSDB_NAMESPACE::ChecksumType checksum_type_e;
 
-enum RepFactory { kSkipList, kHashSkipList, kVectorRep };
+enum RepFactory { kSkipList, kHashSkipList, kVectorRep, kAdaptiveSkipList };
 
 inline enum RepFactory StringToRepFactory(const char* ctype) {
   assert(ctype);
@@ -447,6 +458,8 @@ inline enum RepFactory StringToRepFactory(const char* ctype) {
     return kHashSkipList;
   else if (!strcasecmp(ctype, "vector"))
     return kVectorRep;
+  else if (!strcasecmp(ctype, "adaptive_skip_list"))
+    return kAdaptiveSkipList;
 
   fprintf(stdout, "Cannot parse memreptable %s\n", ctype);
   return kSkipList;
@@ -128,6 +128,10 @@ DEFINE_int32(compaction_readahead_size, 0, "Compaction readahead size");
 
 DEFINE_bool(enable_pipelined_write, false, "Pipeline WAL/memtable writes");
 
+DEFINE_bool(enable_pipelined_wal_sync, false,
+            "With enable_pipelined_write, sync the WAL in the memtable writer "
+            "stage");
+
 DEFINE_bool(verify_before_write, false, "Verify before write");
 
 DEFINE_bool(histogram, false, "Print histogram of operation timings");
@@ -432,6 +436,17 @@ DEFINE_bool(enable_write_thread_adaptive_yield,
             ROCKSDB_NAMESPACE::Options().enable_write_thread_adaptive_yield,
             "Use a yielding spin loop for brief writer thread waits.");
 
+DEFINE_int32(large_batch_memtable_insert_threads,
+             ROCKSDB_NAMESPACE::Options().large_batch_memtable_insert_threads,
+             "Maximum number of threads inserting a single large write batch "
+             "into the memtables.");
+
+DEFINE_uint64(
+    large_batch_memtable_insert_min_entries,
+    ROCKSDB_NAMESPACE::Options().large_batch_memtable_insert_min_entries,
+    "Minimum number of entries of a write batch for it to be inserted into "
+    "the memtables by multiple threads.");
+
 // Options for StackableDB-based BlobDB
 DEFINE_bool(use_blob_db, false, "[Stacked BlobDB] Use BlobDB.");
 
@@ -609,6 +624,23 @@ DEFINE_int32(
         ROCKSDB_NAMESPACE::BlockBasedTableOptions().data_block_index_type),
     "Index type for data blocks (see `enum DataBlockIndexType` in table.h)");
 
+DEFINE_bool(data_block_restart_key_prefixes,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_restart_key_prefixes,
+            "Build restart key prefix arrays for data blocks loaded into "
+            "memory (see BlockBasedTableOptions)");
+
+DEFINE_bool(piecewise_linear_index,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().piecewise_linear_index,
+            "Store a piecewise-linear model of the index keys to narrow index "
+            "lookups (see BlockBasedTableOptions)");
+
+DEFINE_uint32(
+    range_filter_prefix_len,
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions().range_filter_prefix_len,
+    "Length of the key prefixes in SST range filters, or 0 for no range "
+    "filters (see BlockBasedTableOptions)");
+
 DEFINE_string(db, "", "Use the db with the following name.");
 
 DEFINE_string(secondaries_base, "",
@@ -1005,6 +1037,12 @@ DEFINE_bool(avoid_flush_during_recovery,
             ROCKSDB_NAMESPACE::Options().avoid_flush_during_recovery,
             "Avoid flush during recovery");
 
+DEFINE_bool(enable_pipelined_wal_recovery,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_wal_recovery,
+            "Read and decode WAL records ahead of memtable insertion, insert "
+            "column families in parallel and flush memtables in the "
+            "background during recovery");
+
 DEFINE_uint64(max_write_batch_group_size_bytes,
               ROCKSDB_NAMESPACE::Options().max_write_batch_group_size_bytes,
               "Max write batch group size");
@@ -1081,6 +1119,11 @@ DEFINE_bool(paranoid_file_checks, true,
             "After writing every SST file, reopen it and read all the keys "
             "and validate checksums");
 
+DEFINE_bool(merge_with_tournament_tree,
+            ROCKSDB_NAMESPACE::Options().merge_with_tournament_tree,
+            "Merge iterator and compaction inputs with a tournament tree "
+            "instead of a binary heap.");
+
 DEFINE_bool(fail_if_options_file_error, false,
             "Fail operations that fail to detect or properly persist options "
             "file.");
@@ -1189,6 +1232,10 @@ DEFINE_bool(
     "DB-open try verifying the SST unique id between MANIFEST and SST "
     "properties.");
 
+DEFINE_bool(use_table_tail_snapshot,
+            ROCKSDB_NAMESPACE::Options().use_table_tail_snapshot,
+            "Enable DB options `use_table_tail_snapshot`.");
+
 DEFINE_int32(
     create_timestamped_snapshot_one_in, 0,
     "On non-zero, create timestamped snapshots upon transaction commits.");
@@ -1233,6 +1280,11 @@ DEFINE_bool(verification_only, false,
             "If true, tests will only execute verification step");
 extern "C" bool RocksDbIOUringEnable() { return true; }
 
+DEFINE_bool(io_uring_writes, false,
+            "If true, PosixWritableFile issues writes and syncs through "
+            "io_uring when the platform supports it.");
+extern "C" bool RocksDbIOUringWriteEnable() { return FLAGS_io_uring_writes; }
+
 DEFINE_uint32(memtable_max_range_deletions, 0,
               "If nonzero, RocksDB will try to flush the current memtable"
               "after the number of range deletions is >= this limit");
@@ -1298,6 +1350,14 @@ DEFINE_bool(optimize_multiget_for_io,
             ROCKSDB_NAMESPACE::ReadOptions().optimize_multiget_for_io,
             "ReadOptions.optimize_multiget_for_io");
 
+DEFINE_bool(prefetch_multiget_across_levels,
+            ROCKSDB_NAMESPACE::ReadOptions().prefetch_multiget_across_levels,
+            "ReadOptions.prefetch_multiget_across_levels");
+
+DEFINE_uint64(min_memtable_value_size_to_pin,
+              ROCKSDB_NAMESPACE::ReadOptions().min_memtable_value_size_to_pin,
+              "ReadOptions.min_memtable_value_size_to_pin");
+
 DEFINE_bool(memtable_insert_hint_per_batch,
             ROCKSDB_NAMESPACE::WriteOptions().memtable_insert_hint_per_batch,
             "WriteOptions.memtable_insert_hint_per_batch");
@@ -918,6 +918,10 @@ void StressTest::OperateDb(ThreadState* thread) {
   read_opts.auto_readahead_size = FLAGS_auto_readahead_size;
   read_opts.fill_cache = FLAGS_fill_cache;
   read_opts.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
+  read_opts.prefetch_multiget_across_levels =
+      FLAGS_prefetch_multiget_across_levels;
+  read_opts.min_memtable_value_size_to_pin =
+      FLAGS_min_memtable_value_size_to_pin;
   WriteOptions write_opts;
   if (FLAGS_rate_limit_auto_wal_flush) {
     write_opts.rate_limiter_priority = Env::IO_USER;
@@ -1598,6 +1602,7 @@ Status StressTest::TestIterateImpl(ThreadState* thread,
   std::string op_logs;
   ro.pin_data = thread->rand.OneIn(2);
   ro.background_purge_on_iterator_cleanup = thread->rand.OneIn(2);
+  ro.recycle_iterator = thread->rand.OneIn(2);
 
   bool expect_total_order = false;
   if (thread->rand.OneIn(16)) {
@@ -1897,6 +1902,7 @@ void StressTest::VerifyIterator(
   read_opt_oss << "pin_data: " << ro.pin_data
                << ", background_purge_on_iterator_cleanup: "
                << ro.background_purge_on_iterator_cleanup
+               << ", recycle_iterator: " << ro.recycle_iterator
                << ", total_order_seek: " << ro.total_order_seek
                << ", auto_prefix_mode: " << ro.auto_prefix_mode
                << ", iterate_upper_bound: "
@@ -3231,6 +3237,9 @@ void StressTest::PrintEnv() const {
     case kVectorRep:
       memtablerep = "vector";
       break;
+    case kAdaptiveSkipList:
+      memtablerep = "adaptive_skip_list";
+      break;
   }
 
   fprintf(stdout, "Memtablerep               : %s\n", memtablerep);
@@ -3268,6 +3277,9 @@ void StressTest::PrintEnv() const {
     case kRoundRobin:
       compaction_pri = "kRoundRobin";
       break;
+    case kReadHotRangesFirst:
+      compaction_pri = "kReadHotRangesFirst";
+      break;
   }
   fprintf(stdout, "Compaction Pri            : %s\n", compaction_pri);
   fprintf(stdout, "Background Purge          : %d\n",
@@ -3938,6 +3950,10 @@ void InitializeOptionsFromFlags(
   block_based_options.data_block_index_type =
       static_cast<BlockBasedTableOptions::DataBlockIndexType>(
           FLAGS_data_block_index_type);
+  block_based_options.data_block_restart_key_prefixes =
+      FLAGS_data_block_restart_key_prefixes;
+  block_based_options.piecewise_linear_index = FLAGS_piecewise_linear_index;
+  block_based_options.range_filter_prefix_len = FLAGS_range_filter_prefix_len;
   block_based_options.prepopulate_block_cache =
       static_cast<BlockBasedTableOptions::PrepopulateBlockCache>(
           FLAGS_prepopulate_block_cache);
@@ -4051,8 +4067,13 @@ void InitializeOptionsFromFlags(
       static_cast<unsigned int>(FLAGS_stats_dump_period_sec);
   options.ttl = FLAGS_compaction_ttl;
   options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+  options.enable_pipelined_wal_sync = FLAGS_enable_pipelined_wal_sync;
   options.enable_write_thread_adaptive_yield =
       FLAGS_enable_write_thread_adaptive_yield;
+  options.large_batch_memtable_insert_threads =
+      FLAGS_large_batch_memtable_insert_threads;
+  options.large_batch_memtable_insert_min_entries =
+      FLAGS_large_batch_memtable_insert_min_entries;
   options.compaction_options_universal.size_ratio = FLAGS_universal_size_ratio;
   options.compaction_options_universal.min_merge_width =
       FLAGS_universal_min_merge_width;
@@ -4068,6 +4089,7 @@ void InitializeOptionsFromFlags(
   options.write_dbid_to_manifest = FLAGS_write_dbid_to_manifest;
   options.write_identity_file = FLAGS_write_identity_file;
   options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
+  options.enable_pipelined_wal_recovery = FLAGS_enable_pipelined_wal_recovery;
   options.max_write_batch_group_size_bytes =
       FLAGS_max_write_batch_group_size_bytes;
   options.level_compaction_dynamic_level_bytes =
@@ -4075,6 +4097,7 @@ void InitializeOptionsFromFlags(
   options.track_and_verify_wals_in_manifest = true;
   options.verify_sst_unique_id_in_manifest =
       FLAGS_verify_sst_unique_id_in_manifest;
+  options.use_table_tail_snapshot = FLAGS_use_table_tail_snapshot;
   options.memtable_protection_bytes_per_key =
       FLAGS_memtable_protection_bytes_per_key;
   options.block_protection_bytes_per_key = FLAGS_block_protection_bytes_per_key;
@@ -4147,6 +4170,9 @@ void InitializeOptionsFromFlags(
     case kVectorRep:
       options.memtable_factory.reset(new VectorRepFactory());
       break;
+    case kAdaptiveSkipList:
+      options.memtable_factory.reset(new AdaptiveSkipListFactory());
+      break;
   }
 
   InitializeMergeOperator(options);
@@ -4158,6 +4184,7 @@ void InitializeOptionsFromFlags(
 
   options.best_efforts_recovery = FLAGS_best_efforts_recovery;
   options.paranoid_file_checks = FLAGS_paranoid_file_checks;
+  options.merge_with_tournament_tree = FLAGS_merge_with_tournament_tree;
   options.fail_if_options_file_error = FLAGS_fail_if_options_file_error;
 
   if (FLAGS_user_timestamp_size > 0) {
@@ -379,6 +379,11 @@ class CompositeEnvWrapper : public CompositeEnv {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  void SetThreadPoolWorkStealing(Priority thief, Priority victim,
+                                 int max_threads) override {
+    target_.env->SetThreadPoolWorkStealing(thief, victim, max_threads);
+  }
+
   Status GetThreadList(std::vector<ThreadStatus>* thread_list) override {
     return target_.env->GetThreadList(thread_list);
   }
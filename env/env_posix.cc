@@ -395,6 +395,14 @@ class PosixEnv : public CompositeEnv {
     return Status::OK();
   }
 
+  void SetThreadPoolWorkStealing(Priority thief, Priority victim,
+                                 int max_threads) override {
+    assert(thief >= Priority::BOTTOM && thief <= Priority::HIGH);
+    assert(victim >= Priority::BOTTOM && victim <= Priority::HIGH);
+    assert(thief != victim);
+    thread_pools_[thief].SetWorkStealing(&thread_pools_[victim], max_threads);
+  }
+
  private:
   friend Env* Env::Default();
   // Constructs the default Env, a singleton
@@ -64,6 +64,7 @@
 #include "util/mutexlock.h"
 #include "util/random.h"
 #include "util/string_util.h"
+#include "util/threadpool_imp.h"
 #include "utilities/counted_fs.h"
 #include "utilities/env_timed.h"
 #include "utilities/fault_injection_env.h"
@@ -88,6 +89,10 @@ struct Deleter {
 };
 
 extern "C" bool RocksDbIOUringEnable() { return true; }
+// io_uring writes are only enabled by the tests that exercise them, see
+// ScopedIOUringWrites.
+static bool io_uring_writes_enabled = false;
+extern "C" bool RocksDbIOUringWriteEnable() { return io_uring_writes_enabled; }
 
 std::unique_ptr<char, Deleter> NewAligned(const size_t size, const char ch) {
   char* ptr = nullptr;
@@ -967,6 +972,101 @@ TEST_P(EnvPosixTestWithParam, ReserveThreads) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(EnvPosixTest, ThreadPoolWorkStealing) {
+  constexpr int kWaitMicros = 10000000;  // 10seconds
+  ThreadPoolImpl low_pool;
+  ThreadPoolImpl high_pool;
+  low_pool.SetHostEnv(env_);
+  low_pool.SetThreadPriority(Env::Priority::LOW);
+  high_pool.SetHostEnv(env_);
+  high_pool.SetThreadPriority(Env::Priority::HIGH);
+  low_pool.SetBackgroundThreads(1);
+  high_pool.SetBackgroundThreads(2);
+  // Only one of the two threads may steal, the other is left for the pool's
+  // own jobs
+  high_pool.SetWorkStealing(&low_pool, 2);
+
+  std::vector<test::SleepingBackgroundTask> tasks(4);
+  // Task 0 takes the only thread of the low pool, and task 1 is stolen
+  for (size_t i = 0; i < 2; i++) {
+    low_pool.Schedule(&test::SleepingBackgroundTask::DoSleepTask, &tasks[i],
+                      nullptr, nullptr);
+    ASSERT_FALSE(tasks[i].TimedWaitUntilSleeping(kWaitMicros));
+  }
+  // Task 2 waits, as no more threads of the high pool may steal
+  low_pool.Schedule(&test::SleepingBackgroundTask::DoSleepTask, &tasks[2],
+                    nullptr, nullptr);
+  Env::Default()->SleepForMicroseconds(kDelayMicros);
+  ASSERT_FALSE(tasks[2].IsSleeping());
+  ASSERT_EQ(1U, low_pool.GetQueueLen());
+  // The high pool still runs its own job
+  high_pool.Schedule(&test::SleepingBackgroundTask::DoSleepTask, &tasks[3],
+                     nullptr, nullptr);
+  ASSERT_FALSE(tasks[3].TimedWaitUntilSleeping(kWaitMicros));
+
+  // Task 2 is stolen once both task 1 and task 3 are done
+  tasks[3].WakeUp();
+  ASSERT_FALSE(tasks[3].TimedWaitUntilDone(kWaitMicros));
+  Env::Default()->SleepForMicroseconds(kDelayMicros);
+  ASSERT_FALSE(tasks[2].IsSleeping());
+  tasks[1].WakeUp();
+  ASSERT_FALSE(tasks[1].TimedWaitUntilDone(kWaitMicros));
+  ASSERT_FALSE(tasks[2].TimedWaitUntilSleeping(kWaitMicros));
+  ASSERT_EQ(0U, low_pool.GetQueueLen());
+
+  for (auto& task : tasks) {
+    task.WakeUp();
+    ASSERT_FALSE(task.TimedWaitUntilDone(kWaitMicros));
+  }
+  high_pool.SetWorkStealing(nullptr, 0);
+  high_pool.JoinAllThreads();
+  low_pool.JoinAllThreads();
+}
+
+TEST_F(EnvPosixTest, ThreadPoolWorkStealingKeepsOwnThread) {
+  constexpr int kWaitMicros = 10000000;  // 10seconds
+  ThreadPoolImpl low_pool;
+  ThreadPoolImpl high_pool;
+  low_pool.SetHostEnv(env_);
+  low_pool.SetThreadPriority(Env::Priority::LOW);
+  high_pool.SetHostEnv(env_);
+  high_pool.SetThreadPriority(Env::Priority::HIGH);
+  low_pool.SetBackgroundThreads(1);
+  high_pool.SetBackgroundThreads(2);
+  high_pool.SetWorkStealing(&low_pool, 2);
+
+  std::vector<test::SleepingBackgroundTask> tasks(3);
+  // Task 0 takes one thread of the high pool, and task 1 the only thread of
+  // the low pool
+  high_pool.Schedule(&test::SleepingBackgroundTask::DoSleepTask, &tasks[0],
+                     nullptr, nullptr);
+  ASSERT_FALSE(tasks[0].TimedWaitUntilSleeping(kWaitMicros));
+  low_pool.Schedule(&test::SleepingBackgroundTask::DoSleepTask, &tasks[1],
+                    nullptr, nullptr);
+  ASSERT_FALSE(tasks[1].TimedWaitUntilSleeping(kWaitMicros));
+  // Task 2 is not stolen, as the other thread of the high pool is the last
+  // one left for its own jobs
+  low_pool.Schedule(&test::SleepingBackgroundTask::DoSleepTask, &tasks[2],
+                    nullptr, nullptr);
+  Env::Default()->SleepForMicroseconds(kDelayMicros);
+  ASSERT_FALSE(tasks[2].IsSleeping());
+  ASSERT_EQ(1U, low_pool.GetQueueLen());
+
+  // Task 2 is stolen once task 0 is done
+  tasks[0].WakeUp();
+  ASSERT_FALSE(tasks[0].TimedWaitUntilDone(kWaitMicros));
+  ASSERT_FALSE(tasks[2].TimedWaitUntilSleeping(kWaitMicros));
+  ASSERT_EQ(0U, low_pool.GetQueueLen());
+
+  for (auto& task : tasks) {
+    task.WakeUp();
+    ASSERT_FALSE(task.TimedWaitUntilDone(kWaitMicros));
+  }
+  high_pool.SetWorkStealing(nullptr, 0);
+  high_pool.JoinAllThreads();
+  low_pool.JoinAllThreads();
+}
+
 #if (defined OS_LINUX || defined OS_WIN)
 namespace {
 bool IsSingleVarint(const std::string& s) {
@@ -1732,6 +1832,204 @@ TEST_F(EnvPosixTest, MultiReadIOUringError2) {
   SyncPoint::GetInstance()->DisableProcessing();
   SyncPoint::GetInstance()->ClearAllCallBacks();
 }
+
+// Enables io_uring writes for the files opened during its lifetime
+class ScopedIOUringWrites {
+ public:
+  ScopedIOUringWrites() { io_uring_writes_enabled = true; }
+  ~ScopedIOUringWrites() { io_uring_writes_enabled = false; }
+};
+
+TEST_F(EnvPosixTest, IOUringWrite) {
+  ScopedIOUringWrites io_uring_writes;
+  EnvOptions soptions;
+  soptions.use_direct_reads = soptions.use_direct_writes = false;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  Random rnd(301);
+  std::string expected = rnd.RandomString(40000);
+
+  // Force a short write on the positioned append to exercise resubmission.
+  bool short_write = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::IOUringWrite:res", [&](void* arg) {
+        int32_t* res = static_cast<int32_t*>(arg);
+        if (short_write && *res > 1) {
+          short_write = false;
+          *res /= 2;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  {
+    std::unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    ASSERT_OK(wfile->Append(Slice(expected.data(), 10000)));
+    ASSERT_OK(wfile->Append(Slice(expected.data() + 10000, 10000)));
+    ASSERT_OK(wfile->Sync());
+    short_write = true;
+    ASSERT_OK(wfile->PositionedAppend(
+        Slice(expected.data() + 20000, 20000), 20000));
+    ASSERT_FALSE(short_write);
+    ASSERT_OK(wfile->Fsync());
+    ASSERT_EQ(expected.size(), wfile->GetFileSize());
+    ASSERT_OK(wfile->Close());
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(env_, fname, &actual));
+  ASSERT_EQ(expected, actual);
+}
+
+TEST_F(EnvPosixTest, IOUringWriteError) {
+  ScopedIOUringWrites io_uring_writes;
+  EnvOptions soptions;
+  soptions.use_direct_reads = soptions.use_direct_writes = false;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::IOUringWrite:res", [&](void* arg) {
+        int32_t* res = static_cast<int32_t*>(arg);
+        *res = -EIO;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::unique_ptr<WritableFile> wfile;
+  ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+  Status s = wfile->PositionedAppend("foo", 0);
+  ASSERT_TRUE(s.IsIOError());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_OK(wfile->Close());
+}
+
+TEST_F(EnvPosixTest, IOUringWriteSubmitError) {
+  ScopedIOUringWrites io_uring_writes;
+  EnvOptions soptions;
+  soptions.use_direct_reads = soptions.use_direct_writes = false;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  Random rnd(301);
+  // Several chunks, submitted together
+  std::string expected = rnd.RandomString(1 << 20);
+
+  bool fail_submit = true;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::IOUringWrite:io_uring_submit_and_wait:return",
+      [&](void* arg) {
+        ssize_t* ret = static_cast<ssize_t*>(arg);
+        if (fail_submit) {
+          fail_submit = false;
+          *ret = -EBUSY;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::unique_ptr<WritableFile> wfile;
+  ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+  Status s = wfile->Append(expected);
+  ASSERT_TRUE(s.IsIOError());
+  ASSERT_FALSE(fail_submit);
+  // The failed ring was replaced, so nothing left over from the failed
+  // write is reaped or submitted by the next one.
+  ASSERT_OK(wfile->Append(expected));
+  ASSERT_OK(wfile->Sync());
+  ASSERT_EQ(expected.size(), wfile->GetFileSize());
+  ASSERT_OK(wfile->Close());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(env_, fname, &actual));
+  ASSERT_EQ(expected, actual);
+}
+
+TEST_F(EnvPosixTest, IOUringWriteWaitError) {
+  ScopedIOUringWrites io_uring_writes;
+  EnvOptions soptions;
+  soptions.use_direct_reads = soptions.use_direct_writes = false;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  Random rnd(301);
+  // Several chunks, submitted together
+  std::string expected = rnd.RandomString(1 << 20);
+
+  // Fail the first wait while all chunks are in flight
+  bool fail_wait = true;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::IOUringWrite:io_uring_wait_cqe:return",
+      [&](void* arg) {
+        int* ret = static_cast<int*>(arg);
+        if (fail_wait) {
+          fail_wait = false;
+          *ret = -EIO;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::unique_ptr<WritableFile> wfile;
+  ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+  Status s = wfile->Append(expected);
+  ASSERT_TRUE(s.IsIOError());
+  ASSERT_FALSE(fail_wait);
+  // The chunks of the failed write were cancelled or completed, and their
+  // completions reaped, before the ring was replaced.
+  ASSERT_OK(wfile->PositionedAppend(expected, 0));
+  ASSERT_OK(wfile->Sync());
+  ASSERT_OK(wfile->Close());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::string actual;
+  ASSERT_OK(ReadFileToString(env_, fname, &actual));
+  ASSERT_EQ(expected, actual);
+}
+
+TEST_F(EnvPosixTest, IOUringWriteDirectShortWrite) {
+  ScopedIOUringWrites io_uring_writes;
+  EnvOptions soptions;
+  soptions.use_direct_writes = true;
+  std::string fname = test::PerThreadDBPath(env_, "testfile");
+
+  std::unique_ptr<WritableFile> wfile;
+  if (!env_->NewWritableFile(fname, &wfile, soptions).ok()) {
+    ROCKSDB_GTEST_BYPASS("Direct IO not supported");
+    return;
+  }
+  const size_t kSectorSize = 4096;
+  auto data = NewAligned(2 * kSectorSize, 'a');
+
+  int32_t short_res = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PosixWritableFile::IOUringWrite:res", [&](void* arg) {
+        int32_t* res = static_cast<int32_t*>(arg);
+        if (short_res > 0) {
+          *res = short_res;
+          short_res = 0;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // An aligned short write is completed by resubmitting the rest
+  short_res = static_cast<int32_t>(kSectorSize);
+  ASSERT_OK(wfile->PositionedAppend(Slice(data.get(), 2 * kSectorSize), 0));
+  ASSERT_EQ(0, short_res);
+  // The rest of an unaligned one could not be written with direct IO
+  short_res = 100;
+  Status s = wfile->PositionedAppend(Slice(data.get(), 2 * kSectorSize),
+                                     2 * kSectorSize);
+  ASSERT_TRUE(s.IsIOError());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_OK(wfile->Close());
+}
 #endif  // ROCKSDB_IOURING_PRESENT
 
 // Only works in linux platforms
@@ -75,6 +75,10 @@
 #endif
 
 extern "C" bool RocksDbIOUringEnable() __attribute__((__weak__));
+// Opt-in for issuing PosixWritableFile writes and syncs (WAL, flush and
+// compaction outputs, ...) through io_uring. Independent of
+// RocksDbIOUringEnable(), which only covers reads.
+extern "C" bool RocksDbIOUringWriteEnable() __attribute__((__weak__));
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -342,7 +346,12 @@ class PosixFileSystem : public FileSystem {
 #endif
       result->reset(new PosixWritableFile(
           fname, fd, GetLogicalBlockSizeForWriteIfNeeded(options, fname, fd),
-          options));
+          options
+#if defined(ROCKSDB_IOURING_PRESENT)
+          ,
+          GetWriteIOUrings()
+#endif
+              ));
     } else {
       // disable mmap writes
       EnvOptions no_mmap_writes_options = options;
@@ -351,7 +360,12 @@ class PosixFileSystem : public FileSystem {
           new PosixWritableFile(fname, fd,
                                 GetLogicalBlockSizeForWriteIfNeeded(
                                     no_mmap_writes_options, fname, fd),
-                                no_mmap_writes_options));
+                                no_mmap_writes_options
+#if defined(ROCKSDB_IOURING_PRESENT)
+                                ,
+                                GetWriteIOUrings()
+#endif
+                                    ));
     }
     return s;
   }
@@ -437,7 +451,12 @@ class PosixFileSystem : public FileSystem {
 #endif
       result->reset(new PosixWritableFile(
           fname, fd, GetLogicalBlockSizeForWriteIfNeeded(options, fname, fd),
-          options));
+          options
+#if defined(ROCKSDB_IOURING_PRESENT)
+          ,
+          GetWriteIOUrings()
+#endif
+              ));
     } else {
       // disable mmap writes
       FileOptions no_mmap_writes_options = options;
@@ -446,7 +465,12 @@ class PosixFileSystem : public FileSystem {
           new PosixWritableFile(fname, fd,
                                 GetLogicalBlockSizeForWriteIfNeeded(
                                     no_mmap_writes_options, fname, fd),
-                                no_mmap_writes_options));
+                                no_mmap_writes_options
+#if defined(ROCKSDB_IOURING_PRESENT)
+                                ,
+                                GetWriteIOUrings()
+#endif
+                                    ));
     }
     return s;
   }
@@ -996,6 +1020,19 @@ class PosixFileSystem : public FileSystem {
       return false;
     }
   }
+
+  bool IsIOUringWriteEnabled() {
+    if (RocksDbIOUringWriteEnable && RocksDbIOUringWriteEnable()) {
+      return true;
+    } else {
+      return false;
+    }
+  }
+
+  ThreadLocalPtr* GetWriteIOUrings() {
+    return !IsIOUringWriteEnabled() ? nullptr
+                                    : thread_local_io_urings_for_writes_.get();
+  }
 #endif  // ROCKSDB_IOURING_PRESENT
 
   // TODO:
@@ -1195,6 +1232,9 @@ class PosixFileSystem : public FileSystem {
 #if defined(ROCKSDB_IOURING_PRESENT)
   // io_uring instance
   std::unique_ptr<ThreadLocalPtr> thread_local_io_urings_;
+  // Separate rings for writes, so that a blocking write never reaps the
+  // completion of an outstanding ReadAsync() on the same thread.
+  std::unique_ptr<ThreadLocalPtr> thread_local_io_urings_for_writes_;
 #endif
 
   size_t page_size_;
@@ -1255,6 +1295,8 @@ PosixFileSystem::PosixFileSystem()
   struct io_uring* new_io_uring = CreateIOUring();
   if (new_io_uring != nullptr) {
     thread_local_io_urings_.reset(new ThreadLocalPtr(DeleteIOUring));
+    thread_local_io_urings_for_writes_.reset(
+        new ThreadLocalPtr(DeleteIOUring));
     delete new_io_uring;
   }
 #endif
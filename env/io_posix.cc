@@ -1272,13 +1272,23 @@ IOStatus PosixMmapFile::Allocate(uint64_t offset, uint64_t len,
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
                                      size_t logical_block_size,
-                                     const EnvOptions& options)
+                                     const EnvOptions& options
+#if defined(ROCKSDB_IOURING_PRESENT)
+                                     ,
+                                     ThreadLocalPtr* thread_local_io_urings
+#endif
+                                     )
     : FSWritableFile(options),
       filename_(fname),
       use_direct_io_(options.use_direct_writes),
       fd_(fd),
       filesize_(0),
-      logical_sector_size_(logical_block_size) {
+      logical_sector_size_(logical_block_size)
+#if defined(ROCKSDB_IOURING_PRESENT)
+      ,
+      thread_local_io_urings_(thread_local_io_urings)
+#endif
+{
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -1286,6 +1296,13 @@ PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
 #ifdef ROCKSDB_RANGESYNC_PRESENT
   sync_file_range_supported_ = IsSyncFileRangeSupported(fd_);
 #endif  // ROCKSDB_RANGESYNC_PRESENT
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // io_uring writes are issued at explicit offsets, which Linux ignores for
+  // files opened with O_APPEND.
+  if (thread_local_io_urings_ != nullptr && (fcntl(fd_, F_GETFL) & O_APPEND)) {
+    thread_local_io_urings_ = nullptr;
+  }
+#endif
   assert(!options.use_mmap_writes);
 }
 
@@ -1305,6 +1322,15 @@ IOStatus PosixWritableFile::Append(const Slice& data, const IOOptions& /*opts*/,
   const char* src = data.data();
   size_t nbytes = data.size();
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // With io_uring writes, appends go to explicit offsets so that a large
+  // one can be split into writes that proceed in parallel. The file
+  // position is then never used, including when this thread has no ring.
+  if (thread_local_io_urings_ != nullptr) {
+    return PositionedAppend(data, filesize_, IOOptions(), nullptr);
+  }
+#endif
+
   if (!PosixWrite(fd_, src, nbytes)) {
     return IOError("While appending to file", filename_, errno);
   }
@@ -1324,6 +1350,16 @@ IOStatus PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset,
   assert(offset <= static_cast<uint64_t>(std::numeric_limits<off_t>::max()));
   const char* src = data.data();
   size_t nbytes = data.size();
+#if defined(ROCKSDB_IOURING_PRESENT)
+  struct io_uring* iu = GetThreadLocalIOUring();
+  if (iu != nullptr) {
+    IOStatus s = IOUringWrite(iu, src, nbytes, offset);
+    if (s.ok()) {
+      filesize_ = offset + nbytes;
+    }
+    return s;
+  }
+#endif
   if (!PosixPositionedWrite(fd_, src, nbytes, static_cast<off_t>(offset))) {
     return IOError("While pwrite to file at offset " + std::to_string(offset),
                    filename_, errno);
@@ -1408,6 +1444,12 @@ IOStatus PosixWritableFile::Sync(const IOOptions& /*opts*/,
     return IOError("while fcntl(F_FULLFSYNC)", filename_, errno);
   }
 #else   // HAVE_FULLFSYNC
+#if defined(ROCKSDB_IOURING_PRESENT)
+  struct io_uring* iu = GetThreadLocalIOUring();
+  if (iu != nullptr) {
+    return IOUringSync(iu, true /* datasync */);
+  }
+#endif
   if (fdatasync(fd_) < 0) {
     return IOError("While fdatasync", filename_, errno);
   }
@@ -1422,6 +1464,12 @@ IOStatus PosixWritableFile::Fsync(const IOOptions& /*opts*/,
     return IOError("while fcntl(F_FULLFSYNC)", filename_, errno);
   }
 #else   // HAVE_FULLFSYNC
+#if defined(ROCKSDB_IOURING_PRESENT)
+  struct io_uring* iu = GetThreadLocalIOUring();
+  if (iu != nullptr) {
+    return IOUringSync(iu, false /* datasync */);
+  }
+#endif
   if (fsync(fd_) < 0) {
     return IOError("While fsync", filename_, errno);
   }
@@ -1431,6 +1479,220 @@ IOStatus PosixWritableFile::Fsync(const IOOptions& /*opts*/,
 
 bool PosixWritableFile::IsSyncThreadSafe() const { return true; }
 
+#if defined(ROCKSDB_IOURING_PRESENT)
+struct io_uring* PosixWritableFile::GetThreadLocalIOUring() {
+  struct io_uring* iu = nullptr;
+  if (thread_local_io_urings_) {
+    iu = static_cast<struct io_uring*>(thread_local_io_urings_->Get());
+    if (iu == nullptr) {
+      iu = CreateIOUring();
+      if (iu != nullptr) {
+        thread_local_io_urings_->Reset(iu);
+      }
+    }
+  }
+  return iu;
+}
+
+void PosixWritableFile::ResetThreadLocalIOUring(
+    struct io_uring* iu, const std::vector<void*>& in_flight) {
+  // The requests point into the caller's buffer, so they must be done before
+  // the caller returns. Cancel them, which completes them early unless the
+  // kernel already started them, and wait for all their completions and those
+  // of the cancel requests.
+  // Requests the ring still holds unsubmitted would be submitted along with
+  // the cancel requests, so only wait then.
+  size_t num_to_reap = in_flight.size();
+  if (io_uring_sq_ready(iu) == 0) {
+    for (void* data : in_flight) {
+      struct io_uring_sqe* sqe = io_uring_get_sqe(iu);
+      if (sqe == nullptr) {
+        break;
+      }
+      io_uring_prep_cancel(sqe, data, 0);
+      io_uring_sqe_set_data(sqe, nullptr);
+    }
+    int ret = io_uring_submit(iu);
+    if (ret > 0) {
+      num_to_reap += static_cast<size_t>(ret);
+    }
+  }
+  while (num_to_reap > 0) {
+    struct io_uring_cqe* cqe = nullptr;
+    int ret = io_uring_wait_cqe(iu, &cqe);
+    if (ret == -EINTR || ret == -EAGAIN) {
+      continue;
+    }
+    if (ret != 0 || cqe == nullptr) {
+      // Nothing more can be reaped from this ring
+      break;
+    }
+    io_uring_cqe_seen(iu, cqe);
+    num_to_reap--;
+  }
+  void* old = thread_local_io_urings_->Swap(nullptr);
+  assert(old == iu);
+  DeleteIOUring(old);
+}
+
+IOStatus PosixWritableFile::IOUringWrite(struct io_uring* iu, const char* src,
+                                         size_t nbytes, uint64_t offset) {
+  struct WriteRequest {
+    struct iovec iov;
+    uint64_t offset;
+  };
+  // Split the write into chunks that are submitted together, so that the
+  // kernel can work on them in parallel. The chunk size is a multiple of
+  // any logical block size, for direct I/O.
+  std::vector<WriteRequest> reqs((nbytes + kIOUringWriteChunkSize - 1) /
+                                 kIOUringWriteChunkSize);
+  std::vector<WriteRequest*> incomplete_reqs;
+  for (size_t i = 0; i < reqs.size(); i++) {
+    size_t chunk_offset = i * kIOUringWriteChunkSize;
+    reqs[i].iov.iov_base = const_cast<char*>(src + chunk_offset);
+    reqs[i].iov.iov_len =
+        std::min(nbytes - chunk_offset, kIOUringWriteChunkSize);
+    reqs[i].offset = offset + chunk_offset;
+    incomplete_reqs.push_back(&reqs[i]);
+  }
+
+  const size_t alignment = GetRequiredBufferAlignment();
+  IOStatus s;
+  std::vector<WriteRequest*> retry_reqs;
+  std::vector<void*> in_flight;
+  while (!incomplete_reqs.empty() && s.ok()) {
+    size_t this_reqs = std::min(incomplete_reqs.size(), size_t{kIoUringDepth});
+    for (size_t i = 0; i < this_reqs; i++) {
+      WriteRequest* req = incomplete_reqs[i];
+      // The ring is empty between rounds, so there is room for this_reqs
+      struct io_uring_sqe* sqe = io_uring_get_sqe(iu);
+      assert(sqe != nullptr);
+      io_uring_prep_writev(sqe, fd_, &req->iov, 1, req->offset);
+      io_uring_sqe_set_data(sqe, req);
+    }
+
+    ssize_t ret =
+        io_uring_submit_and_wait(iu, static_cast<unsigned int>(this_reqs));
+    TEST_SYNC_POINT_CALLBACK(
+        "PosixWritableFile::IOUringWrite:io_uring_submit_and_wait:return",
+        &ret);
+    // The SQEs are submitted in order
+    size_t num_submitted =
+        ret > 0 ? std::min(static_cast<size_t>(ret), this_reqs) : 0;
+    in_flight.assign(incomplete_reqs.begin(),
+                     incomplete_reqs.begin() + num_submitted);
+    if (static_cast<size_t>(ret) != this_reqs) {
+      // Requests left in the ring must never be submitted by a later call,
+      // as they point into the caller's buffer.
+      ResetThreadLocalIOUring(iu, in_flight);
+      return IOStatus::IOError("io_uring_submit_and_wait() requested " +
+                               std::to_string(this_reqs) + " but returned " +
+                               std::to_string(ret));
+    }
+
+    while (!in_flight.empty()) {
+      struct io_uring_cqe* cqe = nullptr;
+      int wait_ret = io_uring_wait_cqe(iu, &cqe);
+      TEST_SYNC_POINT_CALLBACK(
+          "PosixWritableFile::IOUringWrite:io_uring_wait_cqe:return",
+          &wait_ret);
+      if (wait_ret == -EINTR || wait_ret == -EAGAIN) {
+        continue;
+      }
+      if (wait_ret != 0) {
+        ResetThreadLocalIOUring(iu, in_flight);
+        return IOStatus::IOError("io_uring_wait_cqe() returns " +
+                                 std::to_string(wait_ret));
+      }
+      WriteRequest* req = static_cast<WriteRequest*>(io_uring_cqe_get_data(cqe));
+      int32_t res = cqe->res;
+      io_uring_cqe_seen(iu, cqe);
+      auto it = std::find(in_flight.begin(), in_flight.end(), req);
+      assert(it != in_flight.end());
+      in_flight.erase(it);
+      TEST_SYNC_POINT_CALLBACK("PosixWritableFile::IOUringWrite:res", &res);
+
+      if (res < 0) {
+        if (res == -EINTR || res == -EAGAIN) {
+          retry_reqs.push_back(req);
+        } else if (s.ok()) {
+          s = IOError("While io_uring write to file at offset " +
+                          std::to_string(req->offset),
+                      filename_, -res);
+        }
+        continue;
+      }
+      if (res == 0) {
+        if (s.ok()) {
+          s = IOStatus::IOError("io_uring write made no progress", filename_);
+        }
+        continue;
+      }
+      if (use_direct_io() &&
+          !IsSectorAligned(static_cast<size_t>(res), alignment)) {
+        // The rest would have to be written at an unaligned offset
+        if (s.ok()) {
+          s = IOStatus::IOError("Unaligned short io_uring direct write to file "
+                                "at offset " +
+                                    std::to_string(req->offset),
+                                filename_);
+        }
+        continue;
+      }
+      // Resubmit the rest of a short write
+      req->iov.iov_base = static_cast<char*>(req->iov.iov_base) + res;
+      req->iov.iov_len -= static_cast<size_t>(res);
+      req->offset += static_cast<uint64_t>(res);
+      if (req->iov.iov_len > 0) {
+        retry_reqs.push_back(req);
+      }
+    }
+
+    incomplete_reqs.erase(incomplete_reqs.begin(),
+                          incomplete_reqs.begin() + this_reqs);
+    incomplete_reqs.insert(incomplete_reqs.end(), retry_reqs.begin(),
+                           retry_reqs.end());
+    retry_reqs.clear();
+  }
+  return s;
+}
+
+IOStatus PosixWritableFile::IOUringSync(struct io_uring* iu, bool datasync) {
+  struct io_uring_sqe* sqe = io_uring_get_sqe(iu);
+  if (sqe == nullptr) {
+    return IOStatus::IOError("io_uring_get_sqe() returned nullptr");
+  }
+  io_uring_prep_fsync(sqe, fd_, datasync ? IORING_FSYNC_DATASYNC : 0);
+  io_uring_sqe_set_data(sqe, this);
+
+  ssize_t ret = io_uring_submit_and_wait(iu, 1);
+  if (ret != 1) {
+    ResetThreadLocalIOUring(iu, {});
+    return IOStatus::IOError(
+        "io_uring_submit_and_wait() requested 1 but returned " +
+        std::to_string(ret));
+  }
+  struct io_uring_cqe* cqe = nullptr;
+  do {
+    ret = io_uring_wait_cqe(iu, &cqe);
+  } while (ret == -EINTR || ret == -EAGAIN);
+  if (ret) {
+    ResetThreadLocalIOUring(iu, {this});
+    return IOStatus::IOError("io_uring_wait_cqe() returns " +
+                             std::to_string(ret));
+  }
+  assert(io_uring_cqe_get_data(cqe) == this);
+  int32_t res = cqe->res;
+  io_uring_cqe_seen(iu, cqe);
+  if (res < 0) {
+    return IOError(datasync ? "While fdatasync via io_uring"
+                            : "While fsync via io_uring",
+                   filename_, -res);
+  }
+  return IOStatus::OK();
+}
+#endif  // ROCKSDB_IOURING_PRESENT
+
 uint64_t PosixWritableFile::GetFileSize(const IOOptions& /*opts*/,
                                         IODebugContext* /*dbg*/) {
   return filesize_;
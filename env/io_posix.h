@@ -341,11 +341,37 @@ class PosixWritableFile : public FSWritableFile {
   // support it, so we need to do a dynamic check too.
   bool sync_file_range_supported_;
 #endif  // ROCKSDB_RANGESYNC_PRESENT
+#if defined(ROCKSDB_IOURING_PRESENT)
+  // Per-thread rings used for writes and syncs. nullptr if io_uring writes
+  // are not enabled, in which case the blocking syscalls are used.
+  ThreadLocalPtr* thread_local_io_urings_;
+
+  // Size of the writes that a large write is split into
+  static constexpr size_t kIOUringWriteChunkSize = 256 << 10;
+
+  struct io_uring* GetThreadLocalIOUring();
+  // After an error that may have left requests in `iu`, cancels and reaps
+  // the submitted requests that have not completed, identified by their user
+  // data in `in_flight`, and destroys `iu`. The thread gets a new ring on its
+  // next write.
+  void ResetThreadLocalIOUring(struct io_uring* iu,
+                               const std::vector<void*>& in_flight);
+  // Write `nbytes` from `src` at `offset` through `iu`, retrying on short
+  // writes. Under direct I/O, a short write that is not aligned fails.
+  IOStatus IOUringWrite(struct io_uring* iu, const char* src, size_t nbytes,
+                        uint64_t offset);
+  IOStatus IOUringSync(struct io_uring* iu, bool datasync);
+#endif
 
  public:
   explicit PosixWritableFile(const std::string& fname, int fd,
                              size_t logical_block_size,
-                             const EnvOptions& options);
+                             const EnvOptions& options
+#if defined(ROCKSDB_IOURING_PRESENT)
+                             ,
+                             ThreadLocalPtr* thread_local_io_urings = nullptr
+#endif
+  );
   virtual ~PosixWritableFile();
 
   // Need to implement this so the file is truncated correctly
@@ -253,6 +253,10 @@ std::string IdentityFileName(const std::string& dbname) {
   return dbname + "/IDENTITY";
 }
 
+std::string TableTailSnapshotFileName(const std::string& dbname) {
+  return dbname + "/TABLE_TAILS";
+}
+
 // Owned filenames have the form:
 //    dbname/IDENTITY
 //    dbname/CURRENT
@@ -2134,14 +2134,11 @@ TEST_P(PrefetchTest1, SeekWithExtraPrefetchAsyncIO) {
           0));  // Prefetch data on seek because of seek parallelization.
       ASSERT_TRUE(iter->Valid());
 
-      // Do extra prefetching in Seek only if
+      // The index partition is read asynchronously too, so both it and the
+      // data block are prefetched. Do extra prefetching in Seek only if
       // num_file_reads_for_auto_readahead = 0.
-      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 1 : 0));
-      // buff_prefetch_count is 2 because of index block when
-      // num_file_reads_for_auto_readahead = 0.
-      // If num_file_reads_for_auto_readahead > 0, index block isn't
-      // prefetched.
-      ASSERT_EQ(buff_prefetch_count, i == 0 ? 2 : 1);
+      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 2 : 0));
+      ASSERT_EQ(buff_prefetch_count, 2);
 
       extra_prefetch_buff_cnt = 0;
       buff_prefetch_count = 0;
@@ -2149,10 +2146,12 @@ TEST_P(PrefetchTest1, SeekWithExtraPrefetchAsyncIO) {
       iter->Seek(
           BuildKey(22));  // Prefetch data because of seek parallelization.
       ASSERT_TRUE(iter->Valid());
-      // Do extra prefetching in Seek only if
-      // num_file_reads_for_auto_readahead = 0.
-      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 1 : 0));
-      ASSERT_EQ(buff_prefetch_count, 1);
+      // Key 22 is in the next index partition. Do extra prefetching in Seek
+      // only if num_file_reads_for_auto_readahead = 0.
+      ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 2 : 0));
+      // With direct IO, the aligned extra prefetching for the previous
+      // partition already covers this one.
+      ASSERT_EQ(buff_prefetch_count, (i == 0 && GetParam()) ? 1 : 2);
 
       extra_prefetch_buff_cnt = 0;
       buff_prefetch_count = 0;
@@ -2160,7 +2159,7 @@ TEST_P(PrefetchTest1, SeekWithExtraPrefetchAsyncIO) {
       iter->Seek(
           BuildKey(33));  // Prefetch data because of seek parallelization.
       ASSERT_TRUE(iter->Valid());
-      // Do extra prefetching in Seek only if
+      // Same index partition as key 22. Do extra prefetching in Seek only if
       // num_file_reads_for_auto_readahead = 0.
       ASSERT_EQ(extra_prefetch_buff_cnt, (i == 0 ? 1 : 0));
       ASSERT_EQ(buff_prefetch_count, 1);
@@ -2494,6 +2493,84 @@ TEST_P(PrefetchTest1, SeekParallelizationTest) {
   Close();
 }
 
+// Seeks with async_io across several levels with partitioned indexes, where
+// each child iterator needs a round of reads for the index partition and one
+// for the data block.
+TEST_P(PrefetchTest1, SeekParallelizationAcrossLevels) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_BYPASS("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+  const int kNumKeys = 1500;
+  const int kNumLevels = 3;
+  std::shared_ptr<MockFS> fs = std::make_shared<MockFS>(
+      FileSystem::Default(), /*support_prefetch=*/false);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  Options options;
+  SetGenericOptions(env.get(), GetParam(), options);
+  options.write_buffer_size = 1 << 20;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  table_options.metadata_block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  Status s = TryReopen(options);
+  if (GetParam() && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  // Every level covers the whole key range
+  Random rnd(309);
+  for (int level = kNumLevels - 1; level >= 0; --level) {
+    for (int i = level; i < kNumKeys; i += kNumLevels) {
+      ASSERT_OK(Put(BuildKey(i), rnd.RandomString(100)));
+    }
+    ASSERT_OK(Flush());
+    if (level > 0) {
+      MoveFilesToLevel(level);
+    }
+  }
+
+  bool read_async_called = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "UpdateResults::io_uring_result",
+      [&](void* /*arg*/) { read_async_called = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ReadOptions ro;
+  ro.async_io = true;
+  ReadOptions cmp_ro;
+  cmp_ro.async_io = false;
+  get_perf_context()->Reset();
+  for (int i : {0, 1, 299, 700, 1001, kNumKeys - 2}) {
+    auto iter = std::unique_ptr<Iterator>(db_->NewIterator(ro));
+    auto cmp_iter = std::unique_ptr<Iterator>(db_->NewIterator(cmp_ro));
+    iter->Seek(BuildKey(i));
+    cmp_iter->Seek(BuildKey(i));
+    for (int j = 0; j < 5 && cmp_iter->Valid(); ++j) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), cmp_iter->key());
+      ASSERT_EQ(iter->value(), cmp_iter->value());
+      iter->Next();
+      cmp_iter->Next();
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_OK(cmp_iter->status());
+  }
+  // Not all platforms support io_uring. In that case reads are synchronous.
+  if (read_async_called) {
+    ASSERT_GT(get_perf_context()->number_async_seek, 0);
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+
 namespace {
 #ifdef GFLAGS
 const int kMaxArgCount = 100;
@@ -59,6 +59,15 @@ enum CompactionPri : char {
   // level. The file picking process will cycle through all the files in a
   // round-robin manner.
   kRoundRobin = 0x4,
+  // Like kMinOverlappingRatio, but the ratio of each file is divided by a
+  // boost derived from how often its key range is read, as estimated from
+  // sampled per-file reads. Read-hot key ranges are compacted first to
+  // reduce the number of sorted runs their reads have to check, while key
+  // ranges that are written but rarely read are deferred so that more of
+  // their updates are merged by each compaction. Useful for workloads whose
+  // reads are concentrated on a small part of the key space.
+  // Read statistics are sampled in memory only and are lost on reopen.
+  kReadHotRangesFirst = 0x5,
 };
 
 struct FileTemperatureAge {
@@ -705,6 +714,19 @@ struct AdvancedColumnFamilyOptions {
   // Default: true
   bool force_consistency_checks = true;
 
+  // EXPERIMENTAL
+  //
+  // If true, iterators and compactions of this column family merge their
+  // sorted inputs (memtables, L0 files, levels) with a tournament tree
+  // instead of a binary heap. Advancing the merge then takes about log2(n)
+  // key comparisons for n inputs, rather than up to 2*log2(n), which helps
+  // merges with many inputs, such as universal compaction or many L0 files.
+  // Both take a single comparison while the same input keeps supplying the
+  // smallest key. Reverse iteration always uses a binary heap.
+  //
+  // Default: false
+  bool merge_with_tournament_tree = false;
+
   // Measure IO stats in compactions and flushes, if true.
   //
   // Default: false
@@ -24,6 +24,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class FileSystem;
 class SecondaryCache;
 
 // These definitions begin source compatibility for a future change in which
@@ -243,6 +244,26 @@ struct LRUCacheOptions : public ShardedCacheOptions {
   // -DROCKSDB_DEFAULT_TO_ADAPTIVE_MUTEX, false otherwise.
   bool use_adaptive_mutex = kDefaultToAdaptiveMutex;
 
+  // EXPERIMENTAL
+  // If true, and the process can run on more than one NUMA node, the cache
+  // keeps a separate group of 2^num_shard_bits shards for each NUMA node, with
+  // capacity split evenly across all shards. Inserts and lookups use the
+  // shards of the calling thread's node, so that shard metadata and entries
+  // (which are allocated by the inserting thread) are normally node-local.
+  // Each node's shards are constructed by a thread running on that node.
+  // Requires building with NUMA support (e.g. CMake WITH_NUMA=ON); otherwise
+  // there is only one shard group and this option has no effect.
+  bool numa_aware = false;
+
+  // Only used with numa_aware. If true, an entry used from more than one NUMA
+  // node is cached separately for each node, trading capacity for locality.
+  // If false, a lookup that misses on the calling thread's node also checks
+  // the shards of the other nodes before reporting a miss. Every miss then
+  // costs one shard lookup (a shard mutex and a hash table probe, in remote
+  // memory) per NUMA node instead of one in total, which can matter for
+  // workloads with a low hit rate on hosts with many nodes.
+  bool numa_replicate_entries = true;
+
   LRUCacheOptions() {}
   LRUCacheOptions(size_t _capacity, int _num_shard_bits,
                   bool _strict_capacity_limit, double _high_pri_pool_ratio,
@@ -576,4 +597,49 @@ Status UpdateTieredCache(
     const std::shared_ptr<Cache>& cache, int64_t total_capacity = -1,
     double compressed_secondary_ratio = std::numeric_limits<double>::max(),
     TieredAdmissionPolicy adm_policy = TieredAdmissionPolicy::kAdmPolicyMax);
+
+// EXPERIMENTAL
+// Options for a SecondaryCache on local flash, meant to serve as the
+// TieredCacheOptions::nvm_sec_cache tier when the working set is much larger
+// than memory but fits on a local SSD, and the SST files are on slower
+// storage. It can also be used directly as LRUCacheOptions::secondary_cache.
+//
+// Entries are appended to log-structured segment files of segment_size
+// bytes, and the oldest segment is dropped as a whole once the segments would
+// take more than capacity bytes. An in-memory hash index maps each key to
+// its location, so a lookup takes at most one read from flash. The index is
+// not persisted: segment files left over from a previous instance in the
+// directory are deleted when the cache is created.
+struct FlashSecondaryCacheOptions {
+  // Directory for the segment files. Created if missing. Must not be shared
+  // with other cache instances.
+  std::string path;
+
+  // Maximum total size of the segment files, in bytes.
+  size_t capacity = 0;
+
+  // Size of each segment file, in bytes. The segment being filled is kept
+  // in memory, and full segments are written to flash by a background thread
+  // so that insertions do not wait for I/O. Up to 8 full segments can wait
+  // for that thread, so write buffering uses up to 9 times this much memory;
+  // beyond that, entries are not cached until flash catches up. Entries
+  // larger than this are not cached.
+  size_t segment_size = 16 << 20;
+
+  // The file system to put the segment files on. If nullptr,
+  // FileSystem::Default() is used.
+  std::shared_ptr<FileSystem> fs;
+
+  // If true, lookups with wait=false read from flash with
+  // FSRandomAccessFile::ReadAsync (io_uring on Posix, where available) and
+  // complete in SecondaryCache::WaitAll(), so that the reads of a MultiGet
+  // batch overlap. Otherwise, or if the file system does not support it,
+  // lookups read synchronously.
+  bool use_async_io = true;
+};
+
+// Creates a FlashSecondaryCache. Fails if the directory cannot be created or
+// cleaned up.
+Status NewFlashSecondaryCache(const FlashSecondaryCacheOptions& opts,
+                              std::shared_ptr<SecondaryCache>* cache);
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,120 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/compression_type.h"
+#include "rocksdb/customizable.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/types.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct ConfigOptions;
+
+// EXPERIMENTAL
+// Per-file state of a Compressor. A BlockCompressor is created for each block
+// based table file that is built, and is asked for the compression type of
+// each block written to that file.
+//
+// When CompressionOptions::parallel_threads > 1, the methods are called
+// concurrently from several compression threads, so implementations must be
+// thread-safe.
+//
+// Exceptions MUST NOT propagate out of overridden functions into RocksDB,
+// because RocksDB is not exception-safe. This could cause undefined behavior
+// including data loss, unreported corruption, deadlocks, and more.
+class BlockCompressor {
+ public:
+  virtual ~BlockCompressor() {}
+
+  // Returns the compression type to use for `uncompressed_block`, or
+  // kNoCompression to store it uncompressed. Any compression type supported
+  // by this build can be returned; the type is recorded in the block trailer
+  // so that readers decompress each block with the codec that wrote it. When
+  // dictionary compression is in use for the file, data blocks can only use
+  // the file's configured compression type (or kNoCompression); any other
+  // type is overridden with the configured one.
+  virtual CompressionType SelectCompressionType(
+      const Slice& uncompressed_block, bool is_data_block) = 0;
+
+  // Called after compressing a block for which SelectCompressionType()
+  // returned a compression type other than kNoCompression. `type` is the
+  // compression type the block was stored with and `compressed_size` its
+  // size in the file, without the block trailer. `type` is kNoCompression if
+  // compression was rejected, e.g. because the compression ratio did not meet
+  // CompressionOptions::max_compressed_bytes_per_kb.
+  virtual void OnBlockCompressed(const Slice& /*uncompressed_block*/,
+                                 bool /*is_data_block*/,
+                                 CompressionType /*type*/,
+                                 size_t /*compressed_size*/) {}
+};
+
+// EXPERIMENTAL
+// A Compressor lets users choose the compression algorithm of block based
+// table blocks one block at a time, for example to skip compression of
+// incompressible data or to use a faster codec for hot levels. Set it in
+// BlockBasedTableOptions::compressor. The name of the Compressor is recorded
+// in the "rocksdb.compressor" table property. When blocks use compression
+// types other than the configured one, they are appended to the
+// "rocksdb.compression" table property, e.g. "ZSTD,LZ4".
+class Compressor : public Customizable {
+ public:
+  // Information about the table file being built
+  struct Context {
+    // The compression type configured for the file, from
+    // ColumnFamilyOptions::compression, compression_per_level or
+    // bottommost_compression.
+    CompressionType compression_type = kNoCompression;
+    // The level the file is written to, or -1 if unknown.
+    int level = -1;
+    bool is_bottommost = false;
+    TableFileCreationReason reason = TableFileCreationReason::kMisc;
+    uint32_t column_family_id = 0;
+  };
+
+  ~Compressor() override {}
+
+  static const char* Type() { return "Compressor"; }
+
+  // Creates a Compressor based on the input value. By default, this method
+  // can create an AutoSkipCompressor.
+  static Status CreateFromString(const ConfigOptions& config_options,
+                                 const std::string& value,
+                                 std::shared_ptr<Compressor>* result);
+
+  // Returns a new BlockCompressor for a file described by `context`. Can
+  // return nullptr to compress every block of the file with
+  // `context.compression_type`.
+  virtual std::unique_ptr<BlockCompressor> NewBlockCompressor(
+      const Context& context) const = 0;
+};
+
+// A Compressor that stops compressing data blocks for a while after their
+// compression gets rejected because of a poor compression ratio. After each
+// rejection it skips compression of the next data blocks of the file,
+// doubling the number of skipped blocks with each consecutive rejection up to
+// `max_skipped_blocks`, and then tries compression again. This saves the CPU
+// spent on compressing data that is incompressible, such as already
+// compressed or encrypted values, at the cost of occasionally storing a
+// compressible block uncompressed.
+class AutoSkipCompressor : public Compressor {
+ public:
+  explicit AutoSkipCompressor(uint32_t max_skipped_blocks = 64);
+
+  static const char* kClassName() { return "AutoSkipCompressor"; }
+  const char* Name() const override { return kClassName(); }
+
+  std::unique_ptr<BlockCompressor> NewBlockCompressor(
+      const Context& context) const override;
+
+ private:
+  uint32_t max_skipped_blocks_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -592,6 +592,21 @@ class Env : public Customizable {
   // Lower CPU priority for threads from the specified pool.
   virtual void LowerThreadPoolCPUPriority(Priority /*pool*/ = LOW) {}
 
+  // EXPERIMENTAL
+  // Let idle threads of the `thief` pool run jobs queued in the `victim`
+  // pool, e.g. HIGH (flush) threads run LOW (compaction) jobs that are
+  // waiting for a thread during write bursts. A thread only steals when its
+  // own pool has no queued jobs and another of its idle threads is left
+  // for the pool's own jobs, and at most `max_threads` threads of the pool
+  // run stolen jobs at a time. By design, a pool with a single thread, e.g.
+  // HIGH by default, never steals, so that its own jobs never wait behind
+  // stolen ones; increase its size with SetBackgroundThreads() to enable
+  // stealing. Stolen jobs run with the IO and CPU priority of the `thief`
+  // pool. Non-positive `max_threads` disables stealing.
+  virtual void SetThreadPoolWorkStealing(Priority /*thief*/,
+                                         Priority /*victim*/,
+                                         int /*max_threads*/) {}
+
   // Converts seconds-since-Jan-01-1970 to a printable string
   virtual std::string TimeToString(uint64_t time) = 0;
 
@@ -1637,6 +1652,11 @@ class EnvWrapper : public Env {
     return target_.env->LowerThreadPoolCPUPriority(pool, pri);
   }
 
+  void SetThreadPoolWorkStealing(Priority thief, Priority victim,
+                                 int max_threads) override {
+    target_.env->SetThreadPoolWorkStealing(thief, victim, max_threads);
+  }
+
   std::string TimeToString(uint64_t time) override {
     return target_.env->TimeToString(time);
   }
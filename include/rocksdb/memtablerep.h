@@ -347,6 +347,18 @@ class MemTableRepFactory : public Customizable {
       uint32_t /* column_family_id */) {
     return CreateMemTableRep(key_cmp, allocator, slice_transform, logger);
   }
+  // Creates the rep of a memtable that is to replace the mutable memtable of
+  // its column family, whose rep is `predecessor`. `predecessor` was created
+  // by this factory and stays valid for the duration of the call. It is
+  // nullptr when there is no such memtable, e.g. for the first memtable of a
+  // column family in a DB.
+  virtual MemTableRep* CreateMemTableRep(
+      const MemTableRep::KeyComparator& key_cmp, Allocator* allocator,
+      const SliceTransform* slice_transform, Logger* logger,
+      uint32_t column_family_id, const MemTableRep* /* predecessor */) {
+    return CreateMemTableRep(key_cmp, allocator, slice_transform, logger,
+                             column_family_id);
+  }
 
   const char* Name() const override = 0;
 
@@ -389,10 +401,54 @@ class SkipListFactory : public MemTableRepFactory {
 
   bool CanHandleDuplicatedKey() const override { return true; }
 
- private:
+ protected:
   size_t lookahead_;
 };
 
+// EXPERIMENTAL
+// A SkipListFactory whose memtables can defer building the skip list while
+// they are only written to, as in a bulk load. In deferred mode, inserts
+// just push the entry onto a lock-free list, and the first read of the
+// memtable (a point lookup, an iterator, or its flush) sorts the entries and
+// links them into the skip list in one pass. From then on the memtable
+// behaves like a regular skip list memtable.
+//
+// A new memtable starts in deferred mode iff the memtable it replaces in its
+// column family was not read while it was mutable, so the factory switches
+// between the two modes as a workload moves between write-only and serving
+// phases without reopening the DB. Only reads of the data count, not
+// internal calls such as ApproximateNumEntries(). Point lookups that the
+// memtable answers without reaching the skip list, because it is empty or
+// its bloom filter rules the key out, do not count either, as they would not
+// benefit from the skip list being built. A memtable that is read
+// unexpectedly only pays for one sort. The factory keeps no state of its
+// own and can be shared by several DBs.
+//
+// Unlike SkipListFactory, duplicate <key, seq> are not detected at insertion
+// time, so this factory cannot be used with WritePrepared transactions.
+class AdaptiveSkipListFactory : public SkipListFactory {
+ public:
+  explicit AdaptiveSkipListFactory(size_t lookahead = 0);
+
+  // Methods for Configurable/Customizable class overrides
+  static const char* kClassName() { return "AdaptiveSkipListFactory"; }
+  static const char* kNickName() { return "adaptive_skip_list"; }
+  const char* Name() const override { return kClassName(); }
+  const char* NickName() const override { return kNickName(); }
+
+  // Methods for MemTableRepFactory class overrides
+  using SkipListFactory::CreateMemTableRep;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&, Allocator*,
+                                 const SliceTransform*,
+                                 Logger* logger) override;
+  MemTableRep* CreateMemTableRep(const MemTableRep::KeyComparator&, Allocator*,
+                                 const SliceTransform*, Logger* logger,
+                                 uint32_t column_family_id,
+                                 const MemTableRep* predecessor) override;
+
+  bool CanHandleDuplicatedKey() const override { return false; }
+};
+
 // This creates MemTableReps that are backed by an std::vector. On iteration,
 // the vector is sorted. This is useful for workloads where iteration is very
 // rare and writes are generally not issued after reads begin.
@@ -1190,6 +1190,23 @@ struct DBOptions {
   // Default: false
   bool enable_pipelined_write = false;
 
+  // Only takes effect together with enable_pipelined_write. If true, the
+  // WAL sync requested by `WriteOptions::sync` is moved out of the WAL writer
+  // stage into the memtable writer stage: a write group appends to the WAL
+  // and immediately hands the WAL over to the next group, then syncs the WAL
+  // before inserting into the memtable. While one group's sync is in flight,
+  // the following groups keep appending, and a single sync covers every group
+  // appended before it started, so sync writers queued behind it do not have
+  // to issue their own.
+  //
+  // Durability guarantees are unchanged: a sync write is not acknowledged,
+  // nor made visible to readers, until a sync covering it has completed.
+  // Not supported with manual_wal_flush, in which case syncs stay in the WAL
+  // writer stage.
+  //
+  // Default: false
+  bool enable_pipelined_wal_sync = false;
+
   // Setting unordered_write to true trades higher write throughput with
   // relaxing the immutability guarantee of snapshots. This violates the
   // repeatability one expects from ::Get from a snapshot, as well as
@@ -1234,6 +1251,28 @@ struct DBOptions {
   // Default: true
   bool enable_write_thread_adaptive_yield = true;
 
+  // EXPERIMENTAL
+  //
+  // If greater than 1 and allow_concurrent_memtable_write is true, a write
+  // batch group consisting of a single WriteBatch with at least
+  // large_batch_memtable_insert_min_entries entries is inserted into the
+  // memtables by up to this many threads: the writing thread and the threads
+  // of a pool owned by the DB, each inserting a contiguous part of the batch.
+  // The pool has this many threads less one. This cuts the latency of very
+  // large batches and thereby the wait of the writers queued behind them.
+  // Batches with Merge operations, transactions using one sequence number
+  // per batch (WritePrepared, WriteUnprepared), and the pipelined and
+  // unordered write modes always insert with one thread.
+  //
+  // Default: 1
+  int large_batch_memtable_insert_threads = 1;
+
+  // The minimum number of entries of a WriteBatch for it to be inserted by
+  // multiple threads. See large_batch_memtable_insert_threads.
+  //
+  // Default: 65536
+  uint64_t large_batch_memtable_insert_min_entries = 65536;
+
   // The maximum limit of number of bytes that are written in a single batch
   // of WAL or memtable write. It is followed when the leader write size
   // is larger than 1/8 of this limit.
@@ -1278,6 +1317,37 @@ struct DBOptions {
   // Default: false
   bool skip_checking_sst_file_sizes_on_db_open = false;
 
+  // EXPERIMENTAL
+  // If true, the tails of the live table files, from their first metadata
+  // block (index, filter, properties, etc.) to their end, are persisted in a
+  // snapshot file next to the MANIFEST, when the DB is closed and every
+  // `table_tail_snapshot_period_sec`. DB::Open() then opens the table readers
+  // from the snapshot, and each table file is only opened on the first read
+  // of its data blocks, or of a metadata block that is not cached. This
+  // speeds up DB::Open() with max_open_files == -1 on storage with expensive
+  // file opens and reads, e.g. remote storage, especially along with
+  // skip_checking_sst_file_sizes_on_db_open.
+  //
+  // DB::Open() holds the tails in memory until the table readers are opened,
+  // which costs about the size of the index and filter blocks of all live
+  // files. The snapshot is written by a LOW priority background job, one
+  // tail at a time, copying the tails of unchanged files from the previous
+  // snapshot. Only files whose tail size and unique id are recorded in the
+  // MANIFEST are covered, and the snapshot is not used with
+  // use_direct_reads. Entries for files that have changed since the snapshot
+  // was written are ignored. Note that a missing table file is only detected
+  // on the first read of its data, unless paranoid_checks is set.
+  //
+  // Default: false
+  bool use_table_tail_snapshot = false;
+
+  // With use_table_tail_snapshot, the period in seconds to write the table
+  // tail snapshot at, in addition to when the DB is closed. 0 means to only
+  // write it when the DB is closed.
+  //
+  // Default: 3600 (1 hour)
+  uint64_t table_tail_snapshot_period_sec = 3600;
+
   // Recovery mode to control the consistency while replaying WAL
   // Default: kPointInTimeRecovery
   WALRecoveryMode wal_recovery_mode = WALRecoveryMode::kPointInTimeRecovery;
@@ -1321,6 +1391,28 @@ struct DBOptions {
   // DEFAULT: false
   bool avoid_flush_during_recovery = false;
 
+  // If true, WAL records are read, checksummed and decoded into write batches
+  // on a separate thread during recovery, ahead of inserting them into the
+  // memtables, so that reading the WAL overlaps with memtable insertion.
+  // Corrupted records are handled according to wal_recovery_mode as without
+  // this option. Up to a few MB of decoded write batches per WAL file are
+  // buffered.
+  //
+  // Unless allow_2pc is set or the DB is used by a WritePreparedTxnDB or a
+  // WriteUnpreparedTxnDB, the recovered write batches are also inserted in
+  // groups of about 1MB, with the updates to different column families
+  // inserted on different threads, up to one per column family and CPU. And
+  // memtables filled up during recovery are flushed on the HIGH priority
+  // thread pool while recovery goes on. A memtable can then exceed its
+  // write_buffer_size by up to a group before it is flushed. A write batch
+  // that is read fine but fails to be inserted, e.g. a merge without a merge
+  // operator, fails DB open in every wal_recovery_mode except
+  // kSkipAnyCorruptedRecords, since the later updates to other column
+  // families may already be inserted.
+  //
+  // DEFAULT: false
+  bool enable_pipelined_wal_recovery = false;
+
   // By default RocksDB will flush all memtables on DB close if there are
   // unpersisted data (i.e. with WAL disabled) The flush can be skip to speedup
   // DB close. Unpersisted data WILL BE LOST.
@@ -1789,6 +1881,49 @@ struct ReadOptions {
   // comes at the expense of slightly higher CPU overhead.
   bool optimize_multiget_for_io = true;
 
+  // EXPERIMENTAL
+  //
+  // When set, a synchronous MultiGet() first walks all the SST files that may
+  // contain the keys in the batch, level by level, and probes their filters.
+  // Each key is assumed to be found in the newest file whose filter it passes,
+  // and a readahead hint (FSRandomAccessFile::Prefetch()) is issued for the
+  // data blocks of that file that hold the key and are not in the block
+  // cache. The normal level by level lookup then follows, so that the reads
+  // for keys in different files and levels are in flight at the same time
+  // rather than being issued one level at a time. This helps MultiGet on cold
+  // data with buffered IO, at the cost of probing filters and indexes twice.
+  // It has no effect with direct IO, mmap reads, or when async_io and
+  // optimize_multiget_for_io already read levels in parallel.
+  bool prefetch_multiget_across_levels = false;
+
+  // EXPERIMENTAL
+  //
+  // When non-zero, DB::Get() into a PinnableSlice returns values of at least
+  // this many bytes found in a memtable without copying them, like values
+  // found in the block cache. The PinnableSlice then holds a reference to the
+  // memtables and SST files current at the time of the read (as an iterator
+  // does) until it is reset or destroyed, so callers should release such
+  // values promptly. Values are still copied when they are the result of a
+  // merge or when inplace_update_support is enabled. Setting this to the
+  // typical size of large values avoids a memcpy and an allocation per read
+  // for memtable hits, at the cost of a reference count update.
+  size_t min_memtable_value_size_to_pin = 0;
+
+  // EXPERIMENTAL
+  //
+  // If non-nullptr, the wide-column read APIs (GetEntity, MultiGetEntity,
+  // their attribute group variants, and Iterator::columns()) only return the
+  // columns named here, and the values of other columns are not materialized.
+  // The names have to be sorted bytewise and free of duplicates, or the read
+  // fails with InvalidArgument, and have to stay valid for the duration of
+  // the read or the lifetime of the iterator.
+  // Requested columns missing from an entity are omitted, and a plain
+  // key-value is treated as an entity with only the default column.
+  // Get(), MultiGet() and Iterator::value() are not affected. Currently only
+  // honored by DB reads, not by reads through transactions or
+  // WriteBatchWithIndex.
+  const std::vector<Slice>* projected_columns = nullptr;
+
   // *** END options relevant to point lookups (as well as scans) ***
   // *** BEGIN options only relevant to iterators or scans ***
 
@@ -1903,6 +2038,26 @@ struct ReadOptions {
   // in background.
   bool background_purge_on_iterator_cleanup = false;
 
+  // EXPERIMENTAL
+  //
+  // If true, deleting an iterator returned by DB::NewIterator() keeps its
+  // internal iterator tree (memory, child iterators, and the reference to the
+  // current memtables and SST files) in a per-thread cache, one per column
+  // family. The next DB::NewIterator() on the same thread and column family
+  // with equivalent ReadOptions (other than `snapshot`) reuses the tree,
+  // provided no flush or compaction has changed the set of memtables and
+  // files since, instead of building a new one. This makes creating
+  // iterators for short scans much cheaper.
+  //
+  // A cached tree keeps its memtables and SST files alive, like an open
+  // iterator, until the column family's set of memtables and files changes,
+  // at which point it is freed in the background. It is also freed when the
+  // thread creates another iterator on the column family with this option,
+  // or when the DB is closed. The tree of an exited thread is freed on the
+  // next such change. Not supported, and ignored, with `tailing`,
+  // `timestamp`, a `table_filter`, or `projected_columns`.
+  bool recycle_iterator = false;
+
   // A callback to determine whether relevant keys for this scan exist in a
   // given table based on the table's properties. The callback is passed the
   // properties of each table during iteration. If the callback returns false,
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "advanced_options.h"
 #include "rocksdb/env.h"
@@ -203,4 +204,63 @@ class SstFileWriter {
   struct Rep;
   std::unique_ptr<Rep> rep_;
 };
+
+// EXPERIMENTAL
+struct SstFileBulkLoaderOptions {
+  // Directory to create the output files in. Required, and must exist. The
+  // file names start with "bulk_load_" and an id unique to the loader, so
+  // loaders may share the directory.
+  std::string output_dir;
+
+  // Directory to spill sorted runs to while entries are added, which must
+  // exist. Empty means output_dir. The runs are deleted by Finish().
+  std::string spill_dir;
+
+  // Memory to buffer added entries in, in bytes. Whenever the buffer is
+  // full, its entries are sorted and spilled as a run.
+  size_t sort_buffer_size = 64 << 20;
+
+  // Approximate size of each output file, in bytes of keys and values
+  // before compression.
+  uint64_t target_file_size = 64 << 20;
+
+  // Number of threads building output files in Finish().
+  int num_threads = 4;
+};
+
+// EXPERIMENTAL
+// SstFileBulkLoader creates sst files from entries added in any order, for
+// loading large amounts of data with IngestExternalFiles(). Entries are
+// sorted externally: they are buffered in memory and spilled to sorted runs,
+// which Finish() merges into output files built in parallel over disjoint key
+// ranges. The output files do not overlap each other, so they can be
+// ingested into the bottommost level together.
+//
+// Output files are cut at `target_file_size`, and wherever the
+// `sst_partitioner_factory` of `options` requires. Otherwise they are like
+// the files of an SstFileWriter with the same `options`.
+//
+// This class is NOT thread-safe.
+class SstFileBulkLoader {
+ public:
+  SstFileBulkLoader(const EnvOptions& env_options, const Options& options,
+                    const SstFileBulkLoaderOptions& loader_options);
+
+  // Deletes any runs that were spilled but not merged by Finish().
+  ~SstFileBulkLoader();
+
+  // Add a Put key with value. Keys may be added in any order. If a key is
+  // added more than once, the value added last is kept.
+  // REQUIRES: comparator is *not* timestamp-aware.
+  Status Put(const Slice& user_key, const Slice& value);
+
+  // Creates the output files, and returns their information in key order.
+  // No files are created if no entries were added. No more entries can be
+  // added afterwards.
+  Status Finish(std::vector<ExternalSstFileInfo>* files);
+
+ private:
+  struct Rep;
+  std::unique_ptr<Rep> rep_;
+};
 }  // namespace ROCKSDB_NAMESPACE
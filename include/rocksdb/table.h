@@ -32,6 +32,7 @@ namespace ROCKSDB_NAMESPACE {
 
 // -- Block-based Table
 class Cache;
+class Compressor;
 class FilterPolicy;
 class FlushBlockPolicyFactory;
 class PersistentCache;
@@ -254,6 +255,19 @@ struct BlockBasedTableOptions {
 
   IndexType index_type = kBinarySearch;
 
+  // If true and index_type is kBinarySearch, the table also stores a small
+  // piecewise-linear model fitted over the first 8 bytes (as a big-endian
+  // number) of the index keys, in a separate meta block. Index lookups use it
+  // to predict where the key falls in the index block and only binary search
+  // the few restart points around the prediction. Works best with keys whose
+  // leading bytes are distributed smoothly, such as big-endian encoded
+  // increasing integer IDs; the model is not written when it would not narrow
+  // the search enough. The index block itself is unchanged, so the index does
+  // not get smaller, and versions of RocksDB that do not know about the model
+  // ignore it and read the table as a plain kBinarySearch table. Only takes
+  // effect with the BytewiseComparator (no user-defined timestamps).
+  bool piecewise_linear_index = false;
+
   // The index type that will be used for the data block.
   enum DataBlockIndexType : char {
     kDataBlockBinarySearch = 0,   // traditional block type
@@ -266,6 +280,17 @@ struct BlockBasedTableOptions {
   // kDataBlockBinaryAndHash.
   double data_block_hash_table_util_ratio = 0.75;
 
+  // If true, when a data block is loaded into memory, an array of the first
+  // 8 bytes of the user key at each of its restart points is built next to
+  // it. Seeks within the block then binary search that compact array
+  // (vectorized where the CPU supports it) and only decode and compare full
+  // keys among restart points whose prefixes tie with the target's. This
+  // mostly helps point lookups on cached blocks with short keys. It costs 8
+  // bytes of memory per restart point, charged with the block, and does not
+  // affect the SST file format. Only takes effect with the
+  // BytewiseComparator (no user-defined timestamps).
+  bool data_block_restart_key_prefixes = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
@@ -486,6 +511,24 @@ struct BlockBasedTableOptions {
   // This must generally be true for gets to be efficient.
   bool whole_key_filtering = true;
 
+  // EXPERIMENTAL
+  //
+  // If non-zero, each table stores a range filter made of the distinct
+  // prefixes of this many bytes of its user keys. On Seek with
+  // ReadOptions::iterate_upper_bound set, a table whose range filter shows
+  // that it has no key in [target, iterate_upper_bound) is skipped without
+  // reading any index or data block. This helps short range scans that
+  // mostly find nothing, and works without a prefix_extractor. The filter is
+  // loaded into memory (charged to the table reader) when the table is
+  // opened. Shorter prefixes give smaller and less selective filters; with
+  // prefixes that are unique per key, the filter is about as large as the
+  // keys themselves. Only takes effect with the BytewiseComparator (no
+  // user-defined timestamps). Tables with a range filter can be read by
+  // older versions of RocksDB, which ignore it.
+  //
+  // Default: 0 (disabled)
+  uint32_t range_filter_prefix_len = 0;
+
   // If true, detect corruption during Bloom Filter (format_version >= 5)
   // and Ribbon Filter construction.
   //
@@ -685,6 +728,14 @@ struct BlockBasedTableOptions {
   //
   // Default: 2
   uint64_t num_file_reads_for_auto_readahead = 2;
+
+  // EXPERIMENTAL
+  // If set, chooses the compression type of each block written to new table
+  // files, instead of compressing every block with the compression type
+  // configured for the file. See rocksdb/compressor.h.
+  //
+  // Default: nullptr
+  std::shared_ptr<Compressor> compressor;
 };
 
 // Table Properties that are specific to block-based table properties.
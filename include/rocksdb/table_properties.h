@@ -66,6 +66,7 @@ struct TablePropertiesNames {
   static const std::string kPropertyCollectors;
   static const std::string kCompression;
   static const std::string kCompressionOptions;
+  static const std::string kCompressor;
   static const std::string kCreationTime;
   static const std::string kOldestKeyTime;
   static const std::string kNewestKeyTime;
@@ -350,6 +351,10 @@ struct TableProperties {
   // Compression options used to compress the SST files.
   std::string compression_options;
 
+  // The name of the Compressor that chose the compression type of each block,
+  // if any. See BlockBasedTableOptions::compressor.
+  std::string compressor_name;
+
   // Sequence number to time mapping, delta encoded.
   std::string seqno_to_time_mapping;
 
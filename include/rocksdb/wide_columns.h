@@ -131,6 +131,18 @@ class PinnableWideColumns {
   void Reset();
 
  private:
+  friend class DBImpl;
+
+  // Restricts the columns of the values set after this call to the ones named
+  // in `column_names`, which has to be sorted and free of duplicates, and has
+  // to outlive the restriction. A plain value is treated as an entity with
+  // only the default column. Passing nullptr lifts the restriction. Reset()
+  // does not affect it. Used by DBImpl to implement
+  // ReadOptions::projected_columns for the duration of a read.
+  void SetProjection(const std::vector<Slice>* column_names) {
+    projection_ = column_names;
+  }
+
   void Move(PinnableWideColumns&& other);
   void CopyValue(const Slice& value);
   void PinOrCopyValue(const Slice& value, Cleanable* cleanable);
@@ -142,6 +154,7 @@ class PinnableWideColumns {
 
   PinnableSlice value_;
   WideColumns columns_;
+  const std::vector<Slice>* projection_ = nullptr;
 };
 
 inline void PinnableWideColumns::Reset() {
@@ -157,23 +170,25 @@ inline void PinnableWideColumns::Move(PinnableWideColumns&& other) {
   }
 
   const char* const data = other.value_.data();
-  const bool is_plain_value =
-      other.columns_.size() == 1 &&
-      other.columns_.front().name() == kDefaultWideColumnName &&
-      other.columns_.front().value() == other.value_;
 
   MoveValue(std::move(other.value_));
 
-  if (value_.data() == data) {
-    columns_ = std::move(other.columns_);
-  } else {
-    if (is_plain_value) {
-      CreateIndexForPlainValue();
-    } else {
-      const Status s = CreateIndexForWideColumns();
-      assert(s.ok());
-
-      s.PermitUncheckedError();
+  columns_ = std::move(other.columns_);
+
+  if (value_.data() != data) {
+    // The value was copied to a new buffer (e.g. because it was short enough
+    // to be stored inline). All non-empty column names and values point into
+    // the value, so rebase them instead of recreating the index, which might
+    // have been built with a projection.
+    auto rebase = [&](Slice& slice) {
+      if (!slice.empty()) {
+        slice = Slice(value_.data() + (slice.data() - data), slice.size());
+      }
+    };
+
+    for (auto& column : columns_) {
+      rebase(column.name());
+      rebase(column.value());
     }
   }
 
@@ -207,6 +222,12 @@ inline void PinnableWideColumns::MoveValue(std::string&& value) {
 }
 
 inline void PinnableWideColumns::CreateIndexForPlainValue() {
+  if (projection_ && (projection_->empty() ||
+                      projection_->front() != kDefaultWideColumnName)) {
+    columns_.clear();
+    return;
+  }
+
   columns_ = WideColumns{{kDefaultWideColumnName, value_}};
 }
 
@@ -41,7 +41,14 @@ public enum CompactionPriority {
    * level. The file picking process will cycle through all the files in a
    * round-robin manner.
    */
-  RoundRobin((byte)0x4);
+  RoundRobin((byte)0x4),
+
+  /**
+   * Like {@link #MinOverlappingRatio}, but files whose key range is read
+   * more often than the rest of the level, as estimated from sampled reads,
+   * are compacted first.
+   */
+  ReadHotRangesFirst((byte)0x5);
 
 
   private final byte value;
@@ -3,13 +3,21 @@
 //  COPYING file in the root directory) and Apache 2.0 License
 //  (found in the LICENSE.Apache file in the root directory).
 //
+#include <algorithm>
+#include <mutex>
 #include <random>
+#include <unordered_map>
+#include <vector>
 
 #include "db/memtable.h"
+#include "logging/logging.h"
 #include "memory/arena.h"
 #include "memtable/inlineskiplist.h"
 #include "rocksdb/memtablerep.h"
 #include "rocksdb/utilities/options_type.h"
+#include "test_util/sync_point.h"
+#include "util/atomic.h"
+#include "util/cast_util.h"
 #include "util/string_util.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -20,17 +28,44 @@ class SkipListRep : public MemTableRep {
   const SliceTransform* transform_;
   const size_t lookahead_;
 
+  // The members below are used by AdaptiveSkipListFactory.
+  const bool adaptive_;
+  const bool deferred_;
+  // Cleared by MarkReadOnly()
+  RelaxedAtomic<bool> mutable_{true};
+  // Set by reads of the data while the memtable is mutable
+  RelaxedAtomic<bool> read_while_mutable_{false};
+
+  // In deferred mode, keys are allocated as skip list nodes but only pushed
+  // onto `deferred_entries_` with a CAS until the first read, which takes
+  // the entries, sorts them and links them into the skip list. Inserts that
+  // come after the entries were taken go to the skip list directly, and only
+  // readers wait on `index_mutex_` for the indexing to finish. `indexed_` is
+  // true once the skip list holds all keys, after which the rep behaves as
+  // in regular mode.
+  struct DeferredEntry {
+    const char* key;
+    DeferredEntry* next;
+  };
+  std::atomic<bool> indexed_;
+  std::atomic<DeferredEntry*> deferred_entries_{nullptr};
+  mutable std::mutex index_mutex_;
+
   friend class LookaheadIterator;
 
  public:
   explicit SkipListRep(const MemTableRep::KeyComparator& compare,
                        Allocator* allocator, const SliceTransform* transform,
-                       const size_t lookahead)
+                       const size_t lookahead, bool adaptive = false,
+                       bool deferred = false)
       : MemTableRep(allocator),
         skip_list_(compare, allocator),
         cmp_(compare),
         transform_(transform),
-        lookahead_(lookahead) {}
+        lookahead_(lookahead),
+        adaptive_(adaptive),
+        deferred_(deferred),
+        indexed_(!deferred) {}
 
   KeyHandle Allocate(const size_t len, char** buf) override {
     *buf = skip_list_.AllocateKey(len);
@@ -40,43 +75,105 @@ class SkipListRep : public MemTableRep {
   // Insert key into the list.
   // REQUIRES: nothing that compares equal to key is currently in the list.
   void Insert(KeyHandle handle) override {
-    skip_list_.Insert(static_cast<char*>(handle));
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return;
+    }
+    if (concurrent) {
+      skip_list_.InsertConcurrently(static_cast<char*>(handle));
+    } else {
+      skip_list_.Insert(static_cast<char*>(handle));
+    }
   }
 
   bool InsertKey(KeyHandle handle) override {
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return true;
+    }
+    if (concurrent) {
+      return skip_list_.InsertConcurrently(static_cast<char*>(handle));
+    }
     return skip_list_.Insert(static_cast<char*>(handle));
   }
 
   void InsertWithHint(KeyHandle handle, void** hint) override {
-    skip_list_.InsertWithHint(static_cast<char*>(handle), hint);
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return;
+    }
+    if (concurrent) {
+      skip_list_.InsertConcurrently(static_cast<char*>(handle));
+    } else {
+      skip_list_.InsertWithHint(static_cast<char*>(handle), hint);
+    }
   }
 
   bool InsertKeyWithHint(KeyHandle handle, void** hint) override {
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return true;
+    }
+    if (concurrent) {
+      return skip_list_.InsertConcurrently(static_cast<char*>(handle));
+    }
     return skip_list_.InsertWithHint(static_cast<char*>(handle), hint);
   }
 
   void InsertWithHintConcurrently(KeyHandle handle, void** hint) override {
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return;
+    }
     skip_list_.InsertWithHintConcurrently(static_cast<char*>(handle), hint);
   }
 
   bool InsertKeyWithHintConcurrently(KeyHandle handle, void** hint) override {
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return true;
+    }
     return skip_list_.InsertWithHintConcurrently(static_cast<char*>(handle),
                                                  hint);
   }
 
   void InsertConcurrently(KeyHandle handle) override {
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return;
+    }
     skip_list_.InsertConcurrently(static_cast<char*>(handle));
   }
 
   bool InsertKeyConcurrently(KeyHandle handle) override {
+    bool concurrent;
+    if (InsertDeferred(handle, &concurrent)) {
+      return true;
+    }
     return skip_list_.InsertConcurrently(static_cast<char*>(handle));
   }
 
   // Returns true iff an entry that compares equal to key is in the list.
   bool Contains(const char* key) const override {
+    if (!indexed_.load(std::memory_order_acquire)) {
+      const DeferredEntry* entry =
+          deferred_entries_.load(std::memory_order_acquire);
+      if (entry != IndexingMarker()) {
+        for (; entry != nullptr; entry = entry->next) {
+          if (cmp_(entry->key, key) == 0) {
+            return true;
+          }
+        }
+        return false;
+      }
+      // Wait for the deferred entries to be linked into the skip list
+      std::lock_guard<std::mutex> lock(index_mutex_);
+    }
     return skip_list_.Contains(key);
   }
 
+  void MarkReadOnly() override { mutable_.StoreRelaxed(false); }
+
   size_t ApproximateMemoryUsage() override {
     // All memory is allocated through allocator; nothing to report here
     return 0;
@@ -84,6 +181,8 @@ class SkipListRep : public MemTableRep {
 
   void Get(const LookupKey& k, void* callback_args,
            bool (*callback_func)(void* arg, const char* entry)) override {
+    NoteRead();
+    IndexDeferredEntries();
     SkipListRep::Iterator iter(&skip_list_);
     Slice dummy_slice;
     for (iter.Seek(dummy_slice, k.memtable_key().data());
@@ -95,6 +194,8 @@ class SkipListRep : public MemTableRep {
   Status GetAndValidate(const LookupKey& k, void* callback_args,
                         bool (*callback_func)(void* arg, const char* entry),
                         bool allow_data_in_errors) override {
+    NoteRead();
+    IndexDeferredEntries();
     SkipListRep::Iterator iter(&skip_list_);
     Slice dummy_slice;
     Status status = iter.SeekAndValidate(dummy_slice, k.memtable_key().data(),
@@ -108,12 +209,15 @@ class SkipListRep : public MemTableRep {
 
   uint64_t ApproximateNumEntries(const Slice& start_ikey,
                                  const Slice& end_ikey) override {
+    // Not a read of the data, so the read tracking is left alone
+    IndexDeferredEntries();
     return skip_list_.ApproximateNumEntries(start_ikey, end_ikey);
   }
 
   void UniqueRandomSample(const uint64_t num_entries,
                           const uint64_t target_sample_size,
                           std::unordered_set<const char*>* entries) override {
+    IndexDeferredEntries();
     entries->clear();
     // Avoid divide-by-0.
     assert(target_sample_size > 0);
@@ -363,6 +467,8 @@ class SkipListRep : public MemTableRep {
   };
 
   MemTableRep::Iterator* GetIterator(Arena* arena = nullptr) override {
+    NoteRead();
+    IndexDeferredEntries();
     if (lookahead_ > 0) {
       void* mem =
           arena ? arena->AllocateAligned(sizeof(SkipListRep::LookaheadIterator))
@@ -376,6 +482,79 @@ class SkipListRep : public MemTableRep {
       return new (mem) SkipListRep::Iterator(&skip_list_);
     }
   }
+
+  // Used by AdaptiveSkipListFactory
+  bool deferred() const { return deferred_; }
+  bool read_while_mutable() const { return read_while_mutable_.LoadRelaxed(); }
+
+ private:
+  // Replaces `deferred_entries_` once the entries are taken for indexing
+  static DeferredEntry* IndexingMarker() {
+    static DeferredEntry marker{nullptr, nullptr};
+    return &marker;
+  }
+
+  // Returns true if `handle` was pushed onto the deferred entries. Otherwise
+  // sets `*concurrent` if the skip list may be written concurrently by the
+  // reader indexing the deferred entries.
+  bool InsertDeferred(KeyHandle handle, bool* concurrent) {
+    *concurrent = false;
+    if (indexed_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    DeferredEntry* head = deferred_entries_.load(std::memory_order_relaxed);
+    if (head != IndexingMarker()) {
+      auto* entry = new (allocator_->AllocateAligned(sizeof(DeferredEntry)))
+          DeferredEntry{static_cast<const char*>(handle), head};
+      while (!deferred_entries_.compare_exchange_weak(
+          entry->next, entry, std::memory_order_release,
+          std::memory_order_relaxed)) {
+        if (entry->next == IndexingMarker()) {
+          break;
+        }
+      }
+      if (entry->next != IndexingMarker()) {
+        return true;
+      }
+    }
+    *concurrent = true;
+    return false;
+  }
+
+  void NoteRead() {
+    if (adaptive_ && mutable_.LoadRelaxed() &&
+        !read_while_mutable_.LoadRelaxed()) {
+      read_while_mutable_.StoreRelaxed(true);
+    }
+  }
+
+  void IndexDeferredEntries() {
+    if (indexed_.load(std::memory_order_acquire)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    if (indexed_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    std::vector<const char*> keys;
+    for (const DeferredEntry* entry = deferred_entries_.exchange(
+             IndexingMarker(), std::memory_order_acquire);
+         entry != nullptr; entry = entry->next) {
+      keys.push_back(entry->key);
+    }
+    std::sort(keys.begin(), keys.end(),
+              [this](const char* a, const char* b) { return cmp_(a, b) < 0; });
+    // Sorted insertion only takes a few steps per key thanks to the splice
+    // carried over in `hint`. Writers may be inserting concurrently.
+    void* hint = nullptr;
+    for (const char* key : keys) {
+      bool inserted = skip_list_.InsertWithHintConcurrently(key, &hint);
+      assert(inserted);
+      (void)inserted;
+    }
+    delete[] static_cast<char*>(hint);
+    indexed_.store(true, std::memory_order_release);
+  }
 };
 }  // namespace
 
@@ -404,4 +583,36 @@ MemTableRep* SkipListFactory::CreateMemTableRep(
   return new SkipListRep(compare, allocator, transform, lookahead_);
 }
 
+AdaptiveSkipListFactory::AdaptiveSkipListFactory(size_t lookahead)
+    : SkipListFactory(lookahead) {}
+
+MemTableRep* AdaptiveSkipListFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* transform, Logger* logger) {
+  return CreateMemTableRep(compare, allocator, transform, logger,
+                           /*column_family_id=*/0, /*predecessor=*/nullptr);
+}
+
+MemTableRep* AdaptiveSkipListFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, Allocator* allocator,
+    const SliceTransform* transform, Logger* logger, uint32_t column_family_id,
+    const MemTableRep* predecessor) {
+  const SkipListRep* prev =
+      static_cast_with_check<const SkipListRep>(predecessor);
+  // The predecessor is still mutable, so whether it was read while mutable
+  // is final enough. The first memtable of a column family starts in regular
+  // mode.
+  bool deferred = prev != nullptr && !prev->read_while_mutable();
+  TEST_SYNC_POINT_CALLBACK("AdaptiveSkipListFactory::CreateMemTableRep",
+                           &deferred);
+  if (prev != nullptr && prev->deferred() != deferred) {
+    ROCKS_LOG_INFO(logger,
+                   "[column family %" PRIu32
+                   "] %s skip list indexing of new memtables",
+                   column_family_id, deferred ? "Deferring" : "Resuming");
+  }
+  return new SkipListRep(compare, allocator, transform, lookahead_,
+                         /*adaptive=*/true, deferred);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -68,6 +68,8 @@ struct ImmutableCFOptions {
 
   bool force_consistency_checks;
 
+  bool merge_with_tournament_tree;
+
   Temperature default_temperature;
 
   std::shared_ptr<const SliceTransform>
@@ -66,13 +66,18 @@ struct ImmutableDBOptions {
   std::vector<std::shared_ptr<EventListener>> listeners;
   bool enable_thread_tracking;
   bool enable_pipelined_write;
+  bool enable_pipelined_wal_sync;
   bool unordered_write;
   bool allow_concurrent_memtable_write;
   bool enable_write_thread_adaptive_yield;
+  int large_batch_memtable_insert_threads;
+  uint64_t large_batch_memtable_insert_min_entries;
   uint64_t write_thread_max_yield_usec;
   uint64_t write_thread_slow_yield_usec;
   bool skip_stats_update_on_db_open;
   bool skip_checking_sst_file_sizes_on_db_open;
+  bool use_table_tail_snapshot;
+  uint64_t table_tail_snapshot_period_sec;
   WALRecoveryMode wal_recovery_mode;
   bool allow_2pc;
   std::shared_ptr<Cache> row_cache;
@@ -80,6 +85,7 @@ struct ImmutableDBOptions {
   bool fail_if_options_file_error;
   bool dump_malloc_stats;
   bool avoid_flush_during_recovery;
+  bool enable_pipelined_wal_recovery;
   bool allow_ingest_behind;
   bool two_write_queues;
   bool manual_wal_flush;
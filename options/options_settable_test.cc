@@ -129,6 +129,8 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
        sizeof(CacheUsageOptions)},
       {offsetof(struct BlockBasedTableOptions, filter_policy),
        sizeof(std::shared_ptr<const FilterPolicy>)},
+      {offsetof(struct BlockBasedTableOptions, compressor),
+       sizeof(std::shared_ptr<Compressor>)},
   };
 
   // In this test, we catch a new option of BlockBasedTableOptions that is not
@@ -180,9 +182,11 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "pin_l0_filter_and_index_blocks_in_cache=1;"
       "pin_top_level_index_and_filter=1;"
       "index_type=kHashSearch;"
+      "piecewise_linear_index=true;"
       "data_block_index_type=kDataBlockBinaryAndHash;"
       "index_shortening=kNoShortening;"
       "data_block_hash_table_util_ratio=0.75;"
+      "data_block_restart_key_prefixes=true;"
       "checksum=kxxHash;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
       "block_size_deviation=8;block_restart_interval=4; "
@@ -194,6 +198,7 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "index_block_restart_interval=4;"
       "filter_policy=bloomfilter:4:true;whole_key_filtering=1;detect_filter_"
       "construct_corruption=false;"
+      "range_filter_prefix_len=8;"
       "format_version=1;"
       "verify_compression=true;read_amp_bytes_per_bit=0;"
       "enable_index_compression=false;"
@@ -237,6 +242,7 @@ TEST_F(OptionsSettableTest, TablePropertiesAllFieldsSettable) {
       {offsetof(struct TableProperties, compression_name), sizeof(std::string)},
       {offsetof(struct TableProperties, compression_options),
        sizeof(std::string)},
+      {offsetof(struct TableProperties, compressor_name), sizeof(std::string)},
       {offsetof(struct TableProperties, seqno_to_time_mapping),
        sizeof(std::string)},
       {offsetof(struct TableProperties, user_collected_properties),
@@ -269,6 +275,7 @@ TEST_F(OptionsSettableTest, TablePropertiesAllFieldsSettable) {
       config_options,
       "readable_properties={7265616461626C655F6B6579="
       "7265616461626C655F76616C7565;};compression_options=;compression_name=;"
+      "compressor_name=;"
       "property_collectors_names=;prefix_extractor_name=;db_host_id="
       "64625F686F73745F6964;db_session_id=64625F73657373696F6E5F6964;creation_"
       "time=0;num_data_blocks=123;index_value_is_delta_encoded=0;top_level_"
@@ -399,6 +406,8 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "keep_log_file_num=4890;"
                              "skip_stats_update_on_db_open=false;"
                              "skip_checking_sst_file_sizes_on_db_open=false;"
+                             "use_table_tail_snapshot=false;"
+                             "table_tail_snapshot_period_sec=3600;"
                              "max_manifest_file_size=4295009941;"
                              "db_log_dir=path/to/db_log_dir;"
                              "writable_file_max_buffer_size=1048576;"
@@ -433,16 +442,20 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "advise_random_on_open=true;"
                              "fail_if_options_file_error=false;"
                              "enable_pipelined_write=false;"
+                             "enable_pipelined_wal_sync=false;"
                              "unordered_write=false;"
                              "allow_concurrent_memtable_write=true;"
                              "wal_recovery_mode=kPointInTimeRecovery;"
                              "enable_write_thread_adaptive_yield=true;"
+                             "large_batch_memtable_insert_threads=1;"
+                             "large_batch_memtable_insert_min_entries=65536;"
                              "write_thread_slow_yield_usec=5;"
                              "write_thread_max_yield_usec=1000;"
                              "info_log_level=DEBUG_LEVEL;"
                              "dump_malloc_stats=false;"
                              "allow_2pc=false;"
                              "avoid_flush_during_recovery=false;"
+                             "enable_pipelined_wal_recovery=false;"
                              "avoid_flush_during_shutdown=false;"
                              "allow_ingest_behind=false;"
                              "concurrent_prepare=false;"
@@ -633,6 +646,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "check_flush_compaction_key_order=false;"
       "paranoid_file_checks=true;"
       "force_consistency_checks=true;"
+      "merge_with_tournament_tree=true;"
       "inplace_update_num_locks=7429;"
       "experimental_mempurge_threshold=0.0001;"
       "optimize_filters_for_hits=false;"
@@ -9,6 +9,7 @@ LIB_SOURCES =                                                   \
   cache/clock_cache.cc                                          \
   cache/lru_cache.cc                                            \
   cache/compressed_secondary_cache.cc                           \
+  cache/flash_secondary_cache.cc                                \
   cache/secondary_cache.cc                                      \
   cache/secondary_cache_adapter.cc                              \
   cache/sharded_cache.cc                                        \
@@ -88,6 +89,7 @@ LIB_SOURCES =                                                   \
   db/snapshot_impl.cc                                           \
   db/table_cache.cc                                             \
   db/table_properties_collector.cc                              \
+  db/table_tail_snapshot.cc                                     \
   db/transaction_log_impl.cc                                    \
   db/trim_history_scheduler.cc                                  \
   db/version_builder.cc                                         \
@@ -197,6 +199,9 @@ LIB_SOURCES =                                                   \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
   table/block_based/partitioned_index_reader.cc                 \
+  table/block_based/piecewise_linear_index.cc                   \
+  table/block_based/piecewise_linear_index_reader.cc            \
+  table/block_based/range_filter_block.cc                       \
   table/block_based/reader_common.cc                            \
   table/block_based/uncompression_dict_reader.cc                \
   table/block_fetcher.cc                                        \
@@ -216,6 +221,7 @@ LIB_SOURCES =                                                   \
   table/plain/plain_table_index.cc                              \
   table/plain/plain_table_key_coding.cc                         \
   table/plain/plain_table_reader.cc                             \
+  table/sst_file_bulk_loader.cc                                 \
   table/sst_file_dumper.cc                                      \
   table/sst_file_reader.cc                                      \
   table/sst_file_writer.cc                                      \
@@ -241,6 +247,7 @@ LIB_SOURCES =                                                   \
   util/comparator.cc                                            \
   util/compression.cc                                           \
   util/compression_context_cache.cc                             \
+  util/compressor.cc                                            \
   util/concurrent_task_limiter_impl.cc                          \
   util/crc32c.cc                                                \
   util/crc32c_arm64.cc                                          \
@@ -444,6 +451,7 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_test.cc                                                   \
   cache/cache_reservation_manager_test.cc                               \
   cache/compressed_secondary_cache_test.cc                              \
+  cache/flash_secondary_cache_test.cc                                   \
   cache/lru_cache_test.cc                                               \
   cache/tiered_secondary_cache_test.cc					\
   db/blob/blob_counting_iterator_test.cc                                \
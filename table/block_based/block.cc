@@ -11,6 +11,12 @@
 
 #include "table/block_based/block.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
 #include <algorithm>
 #include <string>
 #include <unordered_map>
@@ -22,8 +28,10 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_prefix_index.h"
 #include "table/block_based/data_block_footer.h"
+#include "table/block_based/piecewise_linear_index.h"
 #include "table/format.h"
 #include "util/coding.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -307,7 +315,7 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = BinarySeekRestartPoints(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -494,6 +502,8 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (index_model_) {
+    ok = ModelSeek(seek_key, &index, &skip_linear_scan);
   } else if (value_delta_encoded_) {
     ok = BinarySeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -514,7 +524,7 @@ void DataBlockIter::SeekForPrevImpl(const Slice& target) {
   }
   uint32_t index = 0;
   bool skip_linear_scan = false;
-  bool ok = BinarySeek<DecodeKey>(seek_key, &index, &skip_linear_scan);
+  bool ok = BinarySeekRestartPoints(seek_key, &index, &skip_linear_scan);
 
   if (!ok) {
     return;
@@ -826,7 +836,8 @@ void BlockIter<TValue>::FindKeyAfterBinarySeek(const Slice& target,
 // compared again later.
 template <class TValue>
 template <typename DecodeKeyFunc>
-bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
+bool BlockIter<TValue>::BinarySeek(const Slice& target, int64_t left,
+                                   int64_t right, uint32_t* index,
                                    bool* skip_linear_scan) {
   if (restarts_ == 0) {
     // SST files dedicated to range tombstones are written with index blocks
@@ -845,7 +856,8 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
+  assert(left >= -1 && left <= right &&
+         right < static_cast<int64_t>(num_restarts_));
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -885,6 +897,88 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   return true;
 }
 
+namespace {
+// Loads the first 8 bytes of `user_key` as a big-endian integer, padding with
+// zeros if the key is shorter. For bytewise ordering, a < b implies
+// prefix(a) <= prefix(b), and prefix(a) < prefix(b) implies a < b.
+inline uint64_t RestartKeyPrefix(const Slice& user_key) {
+  char buf[sizeof(uint64_t)] = {};
+  memcpy(buf, user_key.data(), std::min(user_key.size(), sizeof(buf)));
+  return EndianSwapValue(DecodeFixed64(buf));
+}
+
+// RestartKeyPrefixLowerBound() narrows the candidates down to this many
+// before counting them linearly (two 256-bit vectors).
+constexpr uint32_t kRestartKeyPrefixScanWidth = 8;
+}  // namespace
+
+uint32_t Block::RestartKeyPrefixLowerBound(const uint64_t* prefixes,
+                                           uint32_t n, uint64_t target) {
+  // Branch-free lower bound. Invariant: every element before `base` is less
+  // than `target` and every element from `base + len` on is not.
+  const uint64_t* base = prefixes;
+  uint32_t len = n;
+  while (len > kRestartKeyPrefixScanWidth) {
+    uint32_t half = len / 2;
+    base = base[half] < target ? base + half : base;
+    len -= half;
+  }
+  uint32_t count = static_cast<uint32_t>(base - prefixes);
+  uint32_t i = 0;
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  // There is no unsigned 64-bit compare, so flip the sign bits and compare
+  // signed.
+  constexpr int64_t kSignBit = std::numeric_limits<int64_t>::min();
+#endif
+#ifdef __AVX2__
+  const __m256i sign = _mm256_set1_epi64x(kSignBit);
+  const __m256i t =
+      _mm256_set1_epi64x(static_cast<int64_t>(target) ^ kSignBit);
+  for (; i + 4 <= len; i += 4) {
+    __m256i v = _mm256_xor_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + i)), sign);
+    int mask =
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(t, v)));
+    count += static_cast<uint32_t>(BitsSetToOne(static_cast<uint32_t>(mask)));
+  }
+#elif defined(__SSE4_2__)
+  const __m128i sign = _mm_set1_epi64x(kSignBit);
+  const __m128i t = _mm_set1_epi64x(static_cast<int64_t>(target) ^ kSignBit);
+  for (; i + 2 <= len; i += 2) {
+    __m128i v = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + i)), sign);
+    int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(t, v)));
+    count += static_cast<uint32_t>(BitsSetToOne(static_cast<uint32_t>(mask)));
+  }
+#endif
+  for (; i < len; ++i) {
+    count += base[i] < target ? 1 : 0;
+  }
+  return count;
+}
+
+bool DataBlockIter::BinarySeekRestartPoints(const Slice& target,
+                                            uint32_t* index,
+                                            bool* skip_linear_scan) {
+  if (restart_key_prefixes_ == nullptr || target.size() < kNumInternalBytes) {
+    return BinarySeek<DecodeKey>(target, index, skip_linear_scan);
+  }
+  // Restart points in [lo, hi) share the target's prefix. Those before `lo`
+  // are strictly less than the target and those from `hi` on are strictly
+  // greater, so only the ties need full key comparisons.
+  uint64_t prefix = RestartKeyPrefix(ExtractUserKey(target));
+  uint32_t lo = Block::RestartKeyPrefixLowerBound(restart_key_prefixes_,
+                                                  num_restarts_, prefix);
+  uint32_t hi = num_restarts_;
+  if (prefix != std::numeric_limits<uint64_t>::max()) {
+    hi = lo + Block::RestartKeyPrefixLowerBound(restart_key_prefixes_ + lo,
+                                                num_restarts_ - lo, prefix + 1);
+  }
+  return BinarySeek<DecodeKey>(target, static_cast<int64_t>(lo) - 1,
+                               static_cast<int64_t>(hi) - 1, index,
+                               skip_linear_scan);
+}
+
 // Compare target key and the block key of the block of `block_index`.
 // Return -1 if error.
 int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
@@ -905,6 +999,33 @@ int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   return CompareCurrentKey(target);
 }
 
+bool IndexBlockIter::ModelSeek(const Slice& target, uint32_t* index,
+                               bool* skip_linear_scan) {
+  const int64_t num_restarts = static_cast<int64_t>(num_restarts_);
+  if (index_model_->num_keys() != num_restarts_) {
+    // Not trained on this block's restart keys.
+    return value_delta_encoded_
+               ? BinarySeek<DecodeKeyV4>(target, index, skip_linear_scan)
+               : BinarySeek<DecodeKey>(target, index, skip_linear_scan);
+  }
+  // The model bounds the number of restart keys not greater than `target`,
+  // and the restart interval to search starts at the last of them.
+  const Slice user_key = raw_key_.IsUserKey() ? target : ExtractUserKey(target);
+  const int64_t predicted = index_model_->Predict(
+      PiecewiseLinearIndexModel::KeyToNumber(user_key));
+  const int64_t right = std::min<int64_t>(
+      predicted + index_model_->max_undershoot() - 1, num_restarts - 1);
+  const int64_t left = std::min<int64_t>(
+      std::max<int64_t>(predicted - index_model_->max_overshoot() - 1, -1),
+      right);
+  if (value_delta_encoded_) {
+    return BinarySeek<DecodeKeyV4>(target, left, right, index,
+                                   skip_linear_scan);
+  } else {
+    return BinarySeek<DecodeKey>(target, left, right, index, skip_linear_scan);
+  }
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
@@ -1155,6 +1276,33 @@ void Block::InitializeDataBlockProtectionInfo(uint8_t protection_bytes_per_key,
   }
 }
 
+void Block::InitializeDataBlockRestartKeyPrefixes(const Comparator* raw_ucmp) {
+  if (raw_ucmp != BytewiseComparator() || num_restarts_ == 0 || size_ == 0) {
+    return;
+  }
+  std::unique_ptr<uint64_t[]> prefixes(new uint64_t[num_restarts_]);
+  const char* limit = data_ + restart_offset_;
+  for (uint32_t i = 0; i < num_restarts_; ++i) {
+    uint32_t offset =
+        DecodeFixed32(data_ + restart_offset_ + i * sizeof(uint32_t));
+    uint32_t shared, non_shared;
+    const char* key_ptr =
+        offset < restart_offset_
+            ? DecodeKey()(data_ + offset, limit, &shared, &non_shared)
+            : nullptr;
+    if (key_ptr == nullptr || shared != 0 || non_shared < kNumInternalBytes) {
+      // Leave corruption to be reported by the iterators.
+      return;
+    }
+    prefixes[i] = RestartKeyPrefix(
+        ExtractUserKey(Slice(key_ptr, static_cast<size_t>(non_shared))));
+    if (i > 0 && prefixes[i] < prefixes[i - 1]) {
+      return;
+    }
+  }
+  restart_key_prefixes_ = std::move(prefixes);
+}
+
 void Block::InitializeIndexBlockProtectionInfo(uint8_t protection_bytes_per_key,
                                                const Comparator* raw_ucmp,
                                                bool value_is_full,
@@ -1279,7 +1427,8 @@ DataBlockIter* Block::NewDataIterator(const Comparator* raw_ucmp,
         read_amp_bitmap_.get(), block_contents_pinned,
         user_defined_timestamps_persisted,
         data_block_hash_index_.Valid() ? &data_block_hash_index_ : nullptr,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        restart_key_prefixes_.get());
     if (read_amp_bitmap_) {
       if (read_amp_bitmap_->GetStatistics() != stats) {
         // DB changed the Statistics pointer, we need to notify read_amp_bitmap_
@@ -1296,7 +1445,8 @@ IndexBlockIter* Block::NewIndexIterator(
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
     bool block_contents_pinned, bool user_defined_timestamps_persisted,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index,
+    const PiecewiseLinearIndexModel* index_model) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1318,7 +1468,8 @@ IndexBlockIter* Block::NewIndexIterator(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         prefix_index_ptr, have_first_key, key_includes_seq, value_is_full,
         block_contents_pinned, user_defined_timestamps_persisted,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        index_model);
   }
 
   return ret_iter;
@@ -1335,6 +1486,9 @@ size_t Block::ApproximateMemoryUsage() const {
     usage += read_amp_bitmap_->ApproximateMemoryUsage();
   }
   usage += checksum_size_;
+  if (restart_key_prefixes_) {
+    usage += num_restarts_ * sizeof(uint64_t);
+  }
   return usage;
 }
 
@@ -39,6 +39,7 @@ class DataBlockIter;
 class IndexBlockIter;
 class MetaBlockIter;
 class BlockPrefixIndex;
+class PiecewiseLinearIndexModel;
 
 // BlockReadAmpBitmap is a bitmap that map the ROCKSDB_NAMESPACE::Block data
 // bytes to a bitmap with ratio bytes_per_bit. Whenever we access a range of
@@ -233,13 +234,17 @@ class Block {
   // It is determined by IndexType property of the table.
   // `user_defined_timestamps_persisted` controls whether a min timestamp is
   // padded while key is being parsed from the block.
+  // If `index_model` is not nullptr, seeks use it to narrow the binary search
+  // over restart points. It must have been trained on this block's restart
+  // keys.
   IndexBlockIter* NewIndexIterator(
       const Comparator* raw_ucmp, SequenceNumber global_seqno,
       IndexBlockIter* iter, Statistics* stats, bool total_order_seek,
       bool have_first_key, bool key_includes_seq, bool value_is_full,
       bool block_contents_pinned = false,
       bool user_defined_timestamps_persisted = true,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      const PiecewiseLinearIndexModel* index_model = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -268,6 +273,20 @@ class Block {
   // by NewMetaIterator will verify per key-value checksum for any key it read.
   void InitializeMetaIndexBlockProtectionInfo(uint8_t protection_bytes_per_key);
 
+  // Builds an in-memory array holding the first 8 bytes (big-endian, zero
+  // padded) of the user key at each restart point. After this method is
+  // called, each DataBlockIter returned by NewDataIterator will narrow its
+  // restart point binary search using this array and only compare full keys
+  // among restart points whose prefix ties with the target's. This is a no-op
+  // unless `raw_ucmp` is the BytewiseComparator, since the prefixes are only
+  // order-preserving for bytewise ordering without timestamps.
+  void InitializeDataBlockRestartKeyPrefixes(const Comparator* raw_ucmp);
+
+  // Returns the number of elements in sorted `prefixes[0, n)` that are
+  // strictly less than `target`, i.e., the lower bound position of `target`.
+  static uint32_t RestartKeyPrefixLowerBound(const uint64_t* prefixes,
+                                             uint32_t n, uint64_t target);
+
   static void GenerateKVChecksum(char* checksum_ptr, uint8_t checksum_len,
                                  const Slice& key, const Slice& value) {
     ProtectionInfo64().ProtectKV(key, value).Encode(checksum_len, checksum_ptr);
@@ -275,6 +294,10 @@ class Block {
 
   const char* TEST_GetKVChecksum() const { return kv_checksum_; }
 
+  const uint64_t* TEST_GetRestartKeyPrefixes() const {
+    return restart_key_prefixes_.get();
+  }
+
  private:
   BlockContents contents_;
   const char* data_;         // contents_.data.data()
@@ -288,6 +311,9 @@ class Block {
   uint32_t block_restart_interval_{0};
   uint8_t protection_bytes_per_key_{0};
   DataBlockHashIndex data_block_hash_index_;
+  // See InitializeDataBlockRestartKeyPrefixes(). One entry per restart point
+  // when non-null.
+  std::unique_ptr<uint64_t[]> restart_key_prefixes_;
 };
 
 // A `BlockIter` iterates over the entries in a `Block`'s data buffer. The
@@ -667,7 +693,19 @@ class BlockIter : public InternalIteratorBase<TValue> {
  protected:
   template <typename DecodeKeyFunc>
   inline bool BinarySeek(const Slice& target, uint32_t* index,
-                         bool* is_index_key_result);
+                         bool* is_index_key_result) {
+    return BinarySeek<DecodeKeyFunc>(target, -1,
+                                     static_cast<int64_t>(num_restarts_) - 1,
+                                     index, is_index_key_result);
+  }
+
+  // Same as above, but only searches restart points in (`left`, `right`].
+  // The caller guarantees that the restart key at `left` (unless `left` is
+  // -1) is less than or equal to `target`, and that any restart keys after
+  // `right` are strictly greater than `target`.
+  template <typename DecodeKeyFunc>
+  inline bool BinarySeek(const Slice& target, int64_t left, int64_t right,
+                         uint32_t* index, bool* is_index_key_result);
 
   // Find the first key in restart interval `index` that is >= `target`.
   // If there is no such key, iterator is positioned at the first key in
@@ -694,7 +732,8 @@ class DataBlockIter final : public BlockIter<Slice> {
                   bool user_defined_timestamps_persisted,
                   DataBlockHashIndex* data_block_hash_index,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const uint64_t* restart_key_prefixes = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts, global_seqno,
                    block_contents_pinned, user_defined_timestamps_persisted,
                    protection_bytes_per_key, kv_checksum,
@@ -703,6 +742,7 @@ class DataBlockIter final : public BlockIter<Slice> {
     read_amp_bitmap_ = read_amp_bitmap;
     last_bitmap_offset_ = current_ + 1;
     data_block_hash_index_ = data_block_hash_index;
+    restart_key_prefixes_ = restart_key_prefixes;
   }
 
   Slice value() const override {
@@ -780,7 +820,14 @@ class DataBlockIter final : public BlockIter<Slice> {
 
   DataBlockHashIndex* data_block_hash_index_;
 
+  // Borrowed from Block::restart_key_prefixes_; may be nullptr.
+  const uint64_t* restart_key_prefixes_ = nullptr;
+
   bool SeekForGetImpl(const Slice& target);
+  // Locates the restart interval for `target`, using restart_key_prefixes_
+  // when available. Same contract as BinarySeek().
+  inline bool BinarySeekRestartPoints(const Slice& target, uint32_t* index,
+                                      bool* skip_linear_scan);
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -838,13 +885,15 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                   bool value_is_full, bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const PiecewiseLinearIndexModel* index_model = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
                    kDisableGlobalSequenceNumber, block_contents_pinned,
                    user_defined_timestamps_persisted, protection_bytes_per_key,
                    kv_checksum, block_restart_interval);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    index_model_ = index_model;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -914,6 +963,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const PiecewiseLinearIndexModel* index_model_ = nullptr;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -952,6 +1002,9 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                             uint32_t left, uint32_t right, uint32_t* index,
                             bool* prefix_may_exist);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
+  // Like BinarySeek(), but only searches the restart points around the
+  // position predicted by index_model_, within the model's error bounds.
+  bool ModelSeek(const Slice& target, uint32_t* index, bool* skip_linear_scan);
 
   inline bool ParseNextIndexKey();
 
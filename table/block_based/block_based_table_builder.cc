@@ -9,6 +9,7 @@
 
 #include "table/block_based/block_based_table_builder.h"
 
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <cstdio>
@@ -31,6 +32,7 @@
 #include "memory/memory_allocator_impl.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/comparator.h"
+#include "rocksdb/compressor.h"
 #include "rocksdb/env.h"
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/flush_block_policy.h"
@@ -45,6 +47,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/range_filter_block.h"
 #include "table/format.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
@@ -317,7 +320,19 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<CompressionDict> compression_dict;
   std::vector<std::unique_ptr<CompressionContext>> compression_ctxs;
   std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
+  // Contexts for the other compression types that `block_compressor` picks,
+  // per parallel compression thread, created on first use
+  std::vector<std::map<CompressionType, std::unique_ptr<CompressionContext>>>
+      other_compression_ctxs;
+  std::vector<std::map<CompressionType, std::unique_ptr<UncompressionContext>>>
+      other_verify_ctxs;
   std::unique_ptr<UncompressionDict> verify_dict;
+  // Chooses the compression type of each block, see
+  // BlockBasedTableOptions::compressor
+  std::unique_ptr<BlockCompressor> block_compressor;
+  // Entry `t` is set once a block has been written with CompressionType `t`
+  // other than `compression_type` and kNoCompression
+  std::array<std::atomic<bool>, 256> other_compression_types_used{};
 
   size_t data_begin_offset = 0;
 
@@ -354,6 +369,7 @@ struct BlockBasedTableBuilder::Rep {
       compression_dict_buffer_cache_res_mgr;
   const bool use_delta_encoding_for_index_values;
   std::unique_ptr<FilterBlockBuilder> filter_builder;
+  std::unique_ptr<RangeFilterBlockBuilder> range_filter_builder;
   OffsetableCacheKey base_cache_key;
   const TableFileCreationReason reason;
 
@@ -381,6 +397,35 @@ struct BlockBasedTableBuilder::Rep {
     return compression_opts.parallel_threads > 1;
   }
 
+  // Compression and verification contexts of parallel compression thread
+  // `thread_idx` (0 without parallel compression) for compression `type`.
+  // Only that thread may call these for its `thread_idx`.
+  const CompressionContext& GetCompressionContext(uint32_t thread_idx,
+                                                  CompressionType type) {
+    if (type == compression_type) {
+      return *compression_ctxs[thread_idx];
+    }
+    std::unique_ptr<CompressionContext>& ctx =
+        other_compression_ctxs[thread_idx][type];
+    if (!ctx) {
+      ctx.reset(new CompressionContext(type, compression_opts));
+    }
+    return *ctx;
+  }
+
+  UncompressionContext& GetVerifyContext(uint32_t thread_idx,
+                                         CompressionType type) {
+    if (type == compression_type) {
+      return *verify_ctxs[thread_idx];
+    }
+    std::unique_ptr<UncompressionContext>& ctx =
+        other_verify_ctxs[thread_idx][type];
+    if (!ctx) {
+      ctx.reset(new UncompressionContext(type));
+    }
+    return *ctx;
+  }
+
   Status GetStatus() {
     // We need to make modifications of status visible when status_ok is set
     // to false, and this is ensured by status_mutex, so no special memory
@@ -488,6 +533,8 @@ struct BlockBasedTableBuilder::Rep {
         compression_dict(),
         compression_ctxs(tbo.compression_opts.parallel_threads),
         verify_ctxs(tbo.compression_opts.parallel_threads),
+        other_compression_ctxs(tbo.compression_opts.parallel_threads),
+        other_verify_ctxs(tbo.compression_opts.parallel_threads),
         verify_dict(),
         state((tbo.compression_opts.max_dict_bytes > 0 &&
                tbo.compression_type != kNoCompression)
@@ -541,6 +588,16 @@ struct BlockBasedTableBuilder::Rep {
       compression_ctxs[i].reset(
           new CompressionContext(compression_type, compression_opts));
     }
+    if (table_options.compressor) {
+      Compressor::Context compressor_context;
+      compressor_context.compression_type = compression_type;
+      compressor_context.level = tbo.level_at_creation;
+      compressor_context.is_bottommost = tbo.is_bottommost;
+      compressor_context.reason = tbo.reason;
+      compressor_context.column_family_id = tbo.column_family_id;
+      block_compressor =
+          table_options.compressor->NewBlockCompressor(compressor_context);
+    }
     if (table_options.index_type ==
         BlockBasedTableOptions::kTwoLevelIndexSearch) {
       p_index_builder_ = PartitionedIndexBuilder::CreateIndexBuilder(
@@ -585,6 +642,11 @@ struct BlockBasedTableBuilder::Rep {
           use_delta_encoding_for_index_values, p_index_builder_, ts_sz,
           persist_user_defined_timestamps));
     }
+    if (table_options.range_filter_prefix_len > 0 && !tbo.skip_filters &&
+        internal_comparator.user_comparator() == BytewiseComparator()) {
+      range_filter_builder.reset(
+          new RangeFilterBlockBuilder(table_options.range_filter_prefix_len));
+    }
 
     assert(tbo.internal_tbl_prop_coll_factories);
     for (auto& factory : *tbo.internal_tbl_prop_coll_factories) {
@@ -1091,6 +1153,9 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
       }
     }
 
+    if (r->range_filter_builder != nullptr) {
+      r->range_filter_builder->Add(ExtractUserKey(ikey));
+    }
     r->data_block.AddWithLastKey(ikey, value, r->last_ikey);
     r->last_ikey.assign(ikey.data(), ikey.size());
     assert(!r->last_ikey.empty());
@@ -1196,9 +1261,8 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& uncompressed_block_data,
   Status compress_status;
   bool is_data_block = block_type == BlockType::kData;
   CompressAndVerifyBlock(uncompressed_block_data, is_data_block,
-                         *(r->compression_ctxs[0]), r->verify_ctxs[0].get(),
-                         &(r->compressed_output), &(block_contents), &type,
-                         &compress_status);
+                         /*thread_idx=*/0, &(r->compressed_output),
+                         &(block_contents), &type, &compress_status);
   r->SetStatus(compress_status);
   if (!ok()) {
     return;
@@ -1216,15 +1280,12 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& uncompressed_block_data,
   }
 }
 
-void BlockBasedTableBuilder::BGWorkCompression(
-    const CompressionContext& compression_ctx,
-    UncompressionContext* verify_ctx) {
+void BlockBasedTableBuilder::BGWorkCompression(uint32_t thread_idx) {
   ParallelCompressionRep::BlockRep* block_rep = nullptr;
   while (rep_->pc_rep->compress_queue.pop(block_rep)) {
     assert(block_rep != nullptr);
     CompressAndVerifyBlock(block_rep->contents, true, /* is_data_block*/
-                           compression_ctx, verify_ctx,
-                           block_rep->compressed_data.get(),
+                           thread_idx, block_rep->compressed_data.get(),
                            &block_rep->compressed_contents,
                            &(block_rep->compression_type), &block_rep->status);
     block_rep->slot->Fill(block_rep);
@@ -1233,14 +1294,14 @@ void BlockBasedTableBuilder::BGWorkCompression(
 
 void BlockBasedTableBuilder::CompressAndVerifyBlock(
     const Slice& uncompressed_block_data, bool is_data_block,
-    const CompressionContext& compression_ctx, UncompressionContext* verify_ctx,
-    std::string* compressed_output, Slice* block_contents,
+    uint32_t thread_idx, std::string* compressed_output, Slice* block_contents,
     CompressionType* type, Status* out_status) {
   Rep* r = rep_;
   bool is_status_ok = ok();
   if (!r->IsParallelCompressionEnabled()) {
     assert(is_status_ok);
   }
+  CompressionType selected_type = kNoCompression;
 
   if (is_status_ok && uncompressed_block_data.size() < kCompressionSizeLimit) {
     StopWatchNano timer(
@@ -1258,9 +1319,23 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
       compression_dict = r->compression_dict.get();
     }
     assert(compression_dict != nullptr);
-    CompressionInfo compression_info(r->compression_opts, compression_ctx,
-                                     *compression_dict, r->compression_type,
-                                     r->sample_for_compression);
+
+    selected_type = r->compression_type;
+    if (r->block_compressor) {
+      selected_type = r->block_compressor->SelectCompressionType(
+          uncompressed_block_data, is_data_block);
+      // Readers use the file's dictionary for every data block, so blocks
+      // compressed with it cannot switch to another compression type.
+      if (selected_type == kDisableCompressionOption ||
+          (selected_type != kNoCompression &&
+           compression_dict != &CompressionDict::GetEmptyDict())) {
+        selected_type = r->compression_type;
+      }
+    }
+    CompressionInfo compression_info(
+        r->compression_opts,
+        r->GetCompressionContext(thread_idx, selected_type), *compression_dict,
+        selected_type, r->sample_for_compression);
 
     std::string sampled_output_fast;
     std::string sampled_output_slow;
@@ -1297,8 +1372,8 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
       }
       assert(verify_dict != nullptr);
       BlockContents contents;
-      UncompressionInfo uncompression_info(*verify_ctx, *verify_dict,
-                                           r->compression_type);
+      UncompressionInfo uncompression_info(
+          r->GetVerifyContext(thread_idx, *type), *verify_dict, *type);
       Status uncompress_status = UncompressBlockData(
           uncompression_info, block_contents->data(), block_contents->size(),
           &contents, r->table_options.format_version, r->ioptions);
@@ -1355,6 +1430,15 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
                uncompressed_block_data.size());
     RecordTick(r->ioptions.stats, BYTES_COMPRESSED_TO,
                compressed_output->size());
+    if (*type != r->compression_type) {
+      r->other_compression_types_used[*type].store(true,
+                                                   std::memory_order_relaxed);
+    }
+  }
+  if (r->block_compressor && selected_type != kNoCompression) {
+    r->block_compressor->OnBlockCompressed(uncompressed_block_data,
+                                           is_data_block, *type,
+                                           block_contents->size());
   }
 }
 
@@ -1540,8 +1624,7 @@ void BlockBasedTableBuilder::StartParallelCompression() {
       rep_->compression_opts.parallel_threads);
   for (uint32_t i = 0; i < rep_->compression_opts.parallel_threads; i++) {
     rep_->pc_rep->compress_thread_pool.emplace_back([this, i] {
-      BGWorkCompression(*(rep_->compression_ctxs[i]),
-                        rep_->verify_ctxs[i].get());
+      BGWorkCompression(i);
     });
   }
   rep_->pc_rep->write_thread.reset(
@@ -1739,6 +1822,20 @@ void BlockBasedTableBuilder::WritePropertiesBlock(
             : "nullptr";
     rep_->props.compression_name =
         CompressionTypeToString(rep_->compression_type);
+    if (rep_->block_compressor) {
+      // List every compression type used by the blocks, so that readers
+      // don't assume they all use the configured one.
+      for (size_t t = 0; t < rep_->other_compression_types_used.size(); ++t) {
+        if (rep_->other_compression_types_used[t].load(
+                std::memory_order_relaxed)) {
+          rep_->props.compression_name +=
+              "," + CompressionTypeToString(static_cast<CompressionType>(t));
+        }
+      }
+    }
+    if (rep_->table_options.compressor) {
+      rep_->props.compressor_name = rep_->table_options.compressor->Name();
+    }
     rep_->props.compression_options =
         CompressionOptionsToString(rep_->compression_opts);
     rep_->props.prefix_extractor_name =
@@ -1861,6 +1958,18 @@ void BlockBasedTableBuilder::WriteRangeDelBlock(
   }
 }
 
+void BlockBasedTableBuilder::WriteRangeFilterBlock(
+    MetaIndexBuilder* meta_index_builder) {
+  if (ok() && rep_->range_filter_builder != nullptr &&
+      !rep_->range_filter_builder->empty()) {
+    BlockHandle range_filter_block_handle;
+    WriteMaybeCompressedBlock(rep_->range_filter_builder->Finish(),
+                              kNoCompression, &range_filter_block_handle,
+                              BlockType::kRangeFilter);
+    meta_index_builder->Add(kRangeFilterBlockName, range_filter_block_handle);
+  }
+}
+
 void BlockBasedTableBuilder::WriteFooter(BlockHandle& metaindex_block_handle,
                                          BlockHandle& index_block_handle) {
   assert(ok());
@@ -2085,15 +2194,17 @@ Status BlockBasedTableBuilder::Finish() {
   //    2. [meta block: index]
   //    3. [meta block: compression dictionary]
   //    4. [meta block: range deletion tombstone]
-  //    5. [meta block: properties]
-  //    6. [metaindex block]
-  //    7. Footer
+  //    5. [meta block: range filter]
+  //    6. [meta block: properties]
+  //    7. [metaindex block]
+  //    8. Footer
   BlockHandle metaindex_block_handle, index_block_handle;
   MetaIndexBuilder meta_index_builder;
   WriteFilterBlock(&meta_index_builder);
   WriteIndexBlock(&meta_index_builder, &index_block_handle);
   WriteCompressionDictBlock(&meta_index_builder);
   WriteRangeDelBlock(&meta_index_builder);
+  WriteRangeFilterBlock(&meta_index_builder);
   WritePropertiesBlock(&meta_index_builder);
   if (ok()) {
     // flush the meta index block
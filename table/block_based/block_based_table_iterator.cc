@@ -53,35 +53,45 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
     return;
   }
 
-  ResetBlockCacheLookupVar();
-
-  bool autotune_readaheadsize =
-      is_first_pass && read_options_.auto_readahead_size &&
-      (read_options_.iterate_upper_bound || read_options_.prefix_same_as_start);
-
-  if (autotune_readaheadsize &&
-      table_->get_rep()->table_options.block_cache.get() &&
-      direction_ == IterDirection::kForward) {
-    readahead_cache_lookup_ = true;
-  }
+  // If the index iterator submitted the read of an index partition in the
+  // previous call, the filter has been checked and only the index seek, which
+  // waits for that read, and the rest of the seek are left.
+  const bool resume_index_seek = async_index_read_in_progress_ && target;
+  async_index_read_in_progress_ = false;
+
+  if (!resume_index_seek) {
+    ResetBlockCacheLookupVar();
+
+    bool autotune_readaheadsize = is_first_pass &&
+                                  read_options_.auto_readahead_size &&
+                                  (read_options_.iterate_upper_bound ||
+                                   read_options_.prefix_same_as_start);
+
+    if (autotune_readaheadsize &&
+        table_->get_rep()->table_options.block_cache.get() &&
+        direction_ == IterDirection::kForward) {
+      readahead_cache_lookup_ = true;
+    }
 
-  is_out_of_bound_ = false;
-  is_at_first_key_from_index_ = false;
-  seek_stat_state_ = kNone;
-  bool filter_checked = false;
-  if (target &&
-      !CheckPrefixMayMatch(*target, IterDirection::kForward, &filter_checked)) {
-    ResetDataIter();
-    RecordTick(table_->GetStatistics(), is_last_level_
-                                            ? LAST_LEVEL_SEEK_FILTERED
-                                            : NON_LAST_LEVEL_SEEK_FILTERED);
-    return;
-  }
-  if (filter_checked) {
-    seek_stat_state_ = kFilterUsed;
-    RecordTick(table_->GetStatistics(), is_last_level_
-                                            ? LAST_LEVEL_SEEK_FILTER_MATCH
-                                            : NON_LAST_LEVEL_SEEK_FILTER_MATCH);
+    is_out_of_bound_ = false;
+    is_at_first_key_from_index_ = false;
+    seek_stat_state_ = kNone;
+    bool filter_checked = false;
+    if (target && (!CheckPrefixMayMatch(*target, IterDirection::kForward,
+                                        &filter_checked) ||
+                   !CheckRangeFilterMayMatch(*target, &filter_checked))) {
+      ResetDataIter();
+      RecordTick(table_->GetStatistics(), is_last_level_
+                                              ? LAST_LEVEL_SEEK_FILTERED
+                                              : NON_LAST_LEVEL_SEEK_FILTERED);
+      return;
+    }
+    if (filter_checked) {
+      seek_stat_state_ = kFilterUsed;
+      RecordTick(table_->GetStatistics(),
+                 is_last_level_ ? LAST_LEVEL_SEEK_FILTER_MATCH
+                                : NON_LAST_LEVEL_SEEK_FILTER_MATCH);
+    }
   }
 
   bool need_seek_index = true;
@@ -120,6 +130,10 @@ void BlockBasedTableIterator::SeekImpl(const Slice* target,
     }
     is_index_at_curr_block_ = true;
     if (!index_iter_->Valid()) {
+      // Status::TryAgain indicates the index iterator submitted the read of
+      // an index partition asynchronously. Seek() will be called again to
+      // complete it.
+      async_index_read_in_progress_ = index_iter_->status().IsTryAgain();
       ResetDataIter();
       return;
     }
@@ -218,7 +232,7 @@ void BlockBasedTableIterator::SeekForPrev(const Slice& target) {
   // first block, rather than the second. However, we don't have the information
   // to distinguish the two unless we read the second block. In this case, we'll
   // end up with reading two blocks.
-  index_iter_->Seek(target);
+  SeekIndexAndWait(target);
   is_index_at_curr_block_ = true;
 
   if (!index_iter_->Valid()) {
@@ -308,7 +322,7 @@ void BlockBasedTableIterator::Prev() {
       direction_ = IterDirection::kBackward;
       Slice last_key = key();
 
-      index_iter_->Seek(last_key);
+      SeekIndexAndWait(last_key);
       is_index_at_curr_block_ = true;
 
       // Check for IO error.
@@ -26,7 +26,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
       const BlockBasedTable* table, const ReadOptions& read_options,
       const InternalKeyComparator& icomp,
       std::unique_ptr<InternalIteratorBase<IndexValue>>&& index_iter,
-      bool check_filter, bool need_upper_bound_check,
+      bool check_filter, bool check_range_filter, bool need_upper_bound_check,
       const SliceTransform* prefix_extractor, TableReaderCaller caller,
       size_t compaction_readahead_size = 0, bool allow_unprepared_value = false)
       : index_iter_(std::move(index_iter)),
@@ -43,6 +43,7 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
         allow_unprepared_value_(allow_unprepared_value),
         block_iter_points_to_real_block_(false),
         check_filter_(check_filter),
+        check_range_filter_(check_range_filter),
         need_upper_bound_check_(need_upper_bound_check),
         async_read_in_progress_(false),
         is_last_level_(table->IsLastLevel()) {}
@@ -193,6 +194,15 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     block_upper_bound_check_ = BlockUpperBound::kUnknown;
   }
 
+  // For seeks that don't support asynchronous reads: if the index iterator
+  // submitted the read of an index partition asynchronously, waits for it.
+  void SeekIndexAndWait(const Slice& target) {
+    index_iter_->Seek(target);
+    if (!index_iter_->Valid() && index_iter_->status().IsTryAgain()) {
+      index_iter_->Seek(target);
+    }
+  }
+
   void SavePrevIndexValue() {
     if (block_iter_points_to_real_block_ && IsIndexAtCurr()) {
       // Reseek. If they end up with the same data block, we shouldn't re-fetch
@@ -321,10 +331,15 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   // that block yet. A call to PrepareValue() will trigger loading the block.
   bool is_at_first_key_from_index_ = false;
   bool check_filter_;
+  // Unlike check_filter_, independent of the prefix extractor
+  bool check_range_filter_;
   // TODO(Zhongyi): pick a better name
   bool need_upper_bound_check_;
 
   bool async_read_in_progress_;
+  // True if the last Seek() returned because the index iterator submitted
+  // the read of an index partition asynchronously.
+  bool async_index_read_in_progress_ = false;
 
   mutable SeekStatState seek_stat_state_ = SeekStatState::kNone;
   bool is_last_level_;
@@ -399,6 +414,24 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
     return true;
   }
 
+  // Returns false, after invalidating the iterator, if the table's range
+  // filter shows that it has no key in [target, iterate_upper_bound).
+  bool CheckRangeFilterMayMatch(const Slice& ikey, bool* filter_checked) {
+    const RangeFilterBlockReader* const range_filter =
+        table_->get_rep()->range_filter.get();
+    if (!check_range_filter_ || range_filter == nullptr ||
+        read_options_.iterate_upper_bound == nullptr) {
+      return true;
+    }
+    *filter_checked = true;
+    if (!range_filter->RangeMayMatch(ExtractUserKey(ikey),
+                                     read_options_.iterate_upper_bound)) {
+      ResetDataIter();
+      return false;
+    }
+    return true;
+  }
+
   // *** BEGIN APIs relevant to auto tuning of readahead_size ***
 
   // This API is called to lookup the data blocks ahead in the cache to tune
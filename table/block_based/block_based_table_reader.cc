@@ -58,6 +58,7 @@
 #include "table/block_based/hash_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
+#include "table/block_based/piecewise_linear_index_reader.h"
 #include "table/block_fetcher.h"
 #include "table/format.h"
 #include "table/get_context.h"
@@ -840,6 +841,8 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  new_table->ReadRangeFilterBlock(ro, prefetch_buffer.get(),
+                                  metaindex_iter.get());
   rep->verify_checksum_set_on_open = ro.verify_checksums;
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
@@ -1097,6 +1100,37 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+void BlockBasedTable::ReadRangeFilterBlock(const ReadOptions& read_options,
+                                           FilePrefetchBuffer* prefetch_buffer,
+                                           InternalIterator* meta_iter) {
+  // The filter relies on the order of truncated keys, which is only known for
+  // the BytewiseComparator
+  if (rep_->internal_comparator.user_comparator() != BytewiseComparator()) {
+    return;
+  }
+  BlockHandle range_filter_handle;
+  Status s = FindOptionalMetaBlock(meta_iter, kRangeFilterBlockName,
+                                   &range_filter_handle);
+  if (s.ok() && !range_filter_handle.IsNull()) {
+    BlockContents contents;
+    BlockFetcher block_fetcher(
+        rep_->file.get(), prefetch_buffer, rep_->footer, read_options,
+        range_filter_handle, &contents, rep_->ioptions, true /* decompress */,
+        true /* maybe_compressed */, BlockType::kRangeFilter,
+        UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options,
+        GetMemoryAllocator(rep_->table_options));
+    s = block_fetcher.ReadBlockContents();
+    if (s.ok()) {
+      rep_->range_filter.reset(new RangeFilterBlockReader(std::move(contents)));
+    }
+  }
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Failed to read range filter block, ignoring it: %s",
+                   s.ToString().c_str());
+  }
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1330,6 +1364,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->uncompression_dict_reader) {
     usage += rep_->uncompression_dict_reader->ApproximateMemoryUsage();
   }
+  if (rep_->range_filter) {
+    usage += rep_->range_filter->ApproximateMemoryUsage();
+  }
   if (rep_->table_properties) {
     usage += rep_->table_properties->ApproximateMemoryUsage();
   }
@@ -2074,6 +2111,7 @@ InternalIterator* BlockBasedTable::NewIterator(
             (!read_options.total_order_seek || read_options.auto_prefix_mode ||
              read_options.prefix_same_as_start) &&
             prefix_extractor != nullptr,
+        !skip_filters && read_options.iterate_upper_bound != nullptr,
         need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   } else {
@@ -2084,6 +2122,7 @@ InternalIterator* BlockBasedTable::NewIterator(
             (!read_options.total_order_seek || read_options.auto_prefix_mode ||
              read_options.prefix_same_as_start) &&
             prefix_extractor != nullptr,
+        !skip_filters && read_options.iterate_upper_bound != nullptr,
         need_upper_bound_check, prefix_extractor, caller,
         compaction_readahead_size, allow_unprepared_value);
   }
@@ -2483,6 +2522,121 @@ Status BlockBasedTable::MultiGetFilter(const ReadOptions& read_options,
   return Status::OK();
 }
 
+Status BlockBasedTable::MultiGetPrefetch(const ReadOptions& read_options,
+                                         const SliceTransform* prefix_extractor,
+                                         MultiGetRange* mget_range) {
+  if (mget_range->empty()) {
+    assert(false);
+    return Status::OK();
+  }
+
+  uint64_t tracing_mget_id = BlockCacheTraceHelper::kReservedGetId;
+  if (mget_range->begin()->get_context) {
+    tracing_mget_id = mget_range->begin()->get_context->get_tracing_get_id();
+  }
+  BlockCacheLookupContext lookup_context{
+      TableReaderCaller::kUserMultiGet, tracing_mget_id,
+      /*_get_from_user_specified_snapshot=*/read_options.snapshot != nullptr};
+
+  // Probe the filter directly rather than through FullFilterKeysMayMatch(),
+  // and leave the bloom_sst PerfContext counters as they were, since the
+  // subsequent MultiGet() probes it again and would otherwise double count
+  // the filter statistics.
+  FilterBlockReader* const filter = rep_->filter.get();
+  if (filter != nullptr) {
+    PerfContext* const perf_ctx = get_perf_context();
+    const uint64_t bloom_sst_hit_count = perf_ctx->bloom_sst_hit_count;
+    const uint64_t bloom_sst_miss_count = perf_ctx->bloom_sst_miss_count;
+    if (rep_->whole_key_filtering) {
+      filter->KeysMayMatch(mget_range, &lookup_context, read_options);
+    } else if (!PrefixExtractorChanged(prefix_extractor)) {
+      filter->PrefixesMayMatch(mget_range, prefix_extractor, &lookup_context,
+                               read_options);
+    }
+    perf_ctx->bloom_sst_hit_count = bloom_sst_hit_count;
+    perf_ctx->bloom_sst_miss_count = bloom_sst_miss_count;
+  }
+  if (mget_range->empty() || rep_->ioptions.allow_mmap_reads) {
+    return Status::OK();
+  }
+
+  IndexBlockIter iiter_on_stack;
+  bool need_upper_bound_check = false;
+  if (rep_->index_type == BlockBasedTableOptions::kHashSearch) {
+    need_upper_bound_check = PrefixExtractorChanged(prefix_extractor);
+  }
+  auto iiter =
+      NewIndexIterator(read_options, need_upper_bound_check, &iiter_on_stack,
+                       /*get_context=*/nullptr, &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr.reset(iiter);
+  }
+
+  // Collect the handles of the data blocks not already in the block cache.
+  // Keys are sorted, so duplicate handles are adjacent.
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  autovector<BlockHandle, MultiGetContext::MAX_BATCH_SIZE> block_handles;
+  uint64_t prev_offset = std::numeric_limits<uint64_t>::max();
+  for (auto miter = mget_range->begin(); miter != mget_range->end(); ++miter) {
+    iiter->Seek(miter->ikey);
+    if (!iiter->Valid()) {
+      if (!iiter->status().ok() && !iiter->status().IsNotFound()) {
+        return iiter->status();
+      }
+      continue;
+    }
+    const BlockHandle handle = iiter->value().handle;
+    if (handle.offset() == prev_offset) {
+      continue;
+    }
+    prev_offset = handle.offset();
+    if (block_cache != nullptr) {
+      // Only checks whether the block is cached: records no statistics, and
+      // releases the handle as not useful so that the cache does not count
+      // the lookup as a use of the block, which MultiGet() does next.
+      CacheKey key = GetCacheKey(rep_->base_cache_key, handle);
+      Cache::Handle* const cache_handle = block_cache->Lookup(
+          key.AsSlice(), /*helper=*/nullptr, /*create_context=*/nullptr,
+          Cache::Priority::LOW, /*stats=*/nullptr);
+      if (cache_handle != nullptr) {
+        block_cache->Release(cache_handle, /*useful=*/false,
+                             /*erase_if_last_ref=*/false);
+        continue;
+      }
+    }
+    block_handles.emplace_back(handle);
+  }
+  size_t num_blocks = block_handles.size();
+  TEST_SYNC_POINT_CALLBACK("BlockBasedTable::MultiGetPrefetch:NumBlocks",
+                           &num_blocks);
+  if (block_handles.empty()) {
+    return Status::OK();
+  }
+
+  IOOptions opts;
+  IOStatus io_s = rep_->file->PrepareIOOptions(read_options, opts);
+  // Coalesce adjacent blocks into one readahead request, as
+  // RetrieveMultipleBlocks() does for the reads themselves.
+  size_t idx = 0;
+  while (io_s.ok() && idx < block_handles.size()) {
+    const uint64_t offset = block_handles[idx].offset();
+    uint64_t end = offset + BlockSizeWithTrailer(block_handles[idx]);
+    for (++idx; idx < block_handles.size() &&
+                block_handles[idx].offset() == end;
+         ++idx) {
+      end += BlockSizeWithTrailer(block_handles[idx]);
+    }
+    io_s =
+        rep_->file->Prefetch(opts, offset, static_cast<size_t>(end - offset));
+  }
+  if (io_s.IsNotSupported()) {
+    // The readahead hint is only an optimization
+    return Status::OK();
+  }
+  return io_s;
+}
+
 Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
                                  const Slice* const begin,
                                  const Slice* const end) {
@@ -2656,6 +2810,14 @@ BlockType BlockBasedTable::GetBlockTypeForMetaBlockByName(
     return BlockType::kIndex;
   }
 
+  if (meta_block_name == kPiecewiseLinearIndexBlock) {
+    return BlockType::kPiecewiseLinearIndex;
+  }
+
+  if (meta_block_name == kRangeFilterBlockName) {
+    return BlockType::kRangeFilter;
+  }
+
   if (meta_block_name.starts_with(kObsoleteFilterBlockPrefix)) {
     // Obsolete but possible in old files
     return BlockType::kInvalid;
@@ -2798,8 +2960,20 @@ Status BlockBasedTable::CreateIndexReader(
                                           prefetch, pin, lookup_context,
                                           index_reader);
     }
-    case BlockBasedTableOptions::kBinarySearch:
-      FALLTHROUGH_INTENDED;
+    case BlockBasedTableOptions::kBinarySearch: {
+      // Tables built with `piecewise_linear_index` may also store a model
+      // that narrows the binary search.
+      BlockHandle model_handle;
+      if (FindMetaBlock(meta_iter, kPiecewiseLinearIndexBlock, &model_handle)
+              .ok()) {
+        return PiecewiseLinearIndexReader::Create(
+            this, ro, prefetch_buffer, model_handle, use_cache, prefetch, pin,
+            lookup_context, index_reader);
+      }
+      return BinarySearchIndexReader::Create(this, ro, prefetch_buffer,
+                                             use_cache, prefetch, pin,
+                                             lookup_context, index_reader);
+    }
     case BlockBasedTableOptions::kBinarySearchWithFirstKey: {
       return BinarySearchIndexReader::Create(this, ro, prefetch_buffer,
                                              use_cache, prefetch, pin,
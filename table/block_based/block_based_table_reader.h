@@ -26,6 +26,7 @@
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/range_filter_block.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/format.h"
 #include "table/persistent_cache_options.h"
@@ -152,6 +153,10 @@ class BlockBasedTable : public TableReader {
                         const SliceTransform* prefix_extractor,
                         MultiGetRange* mget_range) override;
 
+  Status MultiGetPrefetch(const ReadOptions& read_options,
+                          const SliceTransform* prefix_extractor,
+                          MultiGetRange* mget_range) override;
+
   DECLARE_SYNC_AND_ASYNC_OVERRIDE(void, MultiGet,
                                   const ReadOptions& readOptions,
                                   const MultiGetContext::Range* mget_range,
@@ -500,6 +505,11 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  // Loads the range filter, if any, into memory. Failures are only logged as
+  // the filter is optional.
+  void ReadRangeFilterBlock(const ReadOptions& ro,
+                            FilePrefetchBuffer* prefetch_buffer,
+                            InternalIterator* meta_iter);
   // If index and filter blocks do not need to be pinned, `prefetch_all`
   // determines whether they will be read and add to cache.
   Status PrefetchIndexAndFilterBlocks(
@@ -626,6 +636,10 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels;
 
+  // Only present for tables built with
+  // BlockBasedTableOptions::range_filter_prefix_len > 0
+  std::unique_ptr<RangeFilterBlockReader> range_filter;
+
   // Context for block cache CreateCallback
   BlockCreateContext create_context;
 
@@ -15,6 +15,9 @@ void BlockCreateContext::Create(std::unique_ptr<Block_kData>* parsed_out,
       std::move(block), table_options->read_amp_bytes_per_bit, statistics));
   parsed_out->get()->InitializeDataBlockProtectionInfo(protection_bytes_per_key,
                                                        raw_ucmp);
+  if (table_options->data_block_restart_key_prefixes) {
+    parsed_out->get()->InitializeDataBlockRestartKeyPrefixes(raw_ucmp);
+  }
 }
 void BlockCreateContext::Create(std::unique_ptr<Block_kIndex>* parsed_out,
                                 BlockContents&& block) {
@@ -75,6 +78,8 @@ const std::array<const Cache::CacheItemHelper*,
         nullptr,  // kHashIndexMetadata
         nullptr,  // kMetaIndex (not yet stored in block cache)
         BlockCacheInterface<Block_kIndex>::GetFullHelper(),
+        nullptr,  // kPiecewiseLinearIndex
+        nullptr,  // kRangeFilter
         nullptr,  // kInvalid
     }};
 
@@ -92,6 +97,8 @@ const std::array<const Cache::CacheItemHelper*,
         nullptr,  // kHashIndexMetadata
         nullptr,  // kMetaIndex (not yet stored in block cache)
         BlockCacheInterface<Block_kIndex>::GetBasicHelper(),
+        nullptr,  // kPiecewiseLinearIndex
+        nullptr,  // kRangeFilter
         nullptr,  // kInvalid
     }};
 }  // namespace
@@ -286,6 +286,125 @@ TEST_P(BlockTest, IndexHashWithSharedPrefix) {
                      shouldPersistUDT());
 }
 
+TEST_P(BlockTest, RestartKeyPrefixes) {
+  if (isUDTEnabled()) {
+    // Restart key prefixes are only built for the BytewiseComparator.
+    BlockBuilder builder(4 /* restart interval */, keyUseDeltaEncoding());
+    std::string key = "key";
+    AppendInternalKeyFooter(&key, 0 /* seqno */, kTypeValue);
+    builder.Add(key, "value");
+    BlockContents contents;
+    contents.data = builder.Finish();
+    Block reader(std::move(contents));
+    reader.InitializeDataBlockRestartKeyPrefixes(
+        test::BytewiseComparatorWithU64TsWrapper());
+    ASSERT_EQ(reader.TEST_GetRestartKeyPrefixes(), nullptr);
+    return;
+  }
+
+  Random rnd(301);
+  // Mix 8-byte keys (including ones with the high bit set), keys sharing a
+  // common prefix longer than 8 bytes so that prefixes tie, and keys shorter
+  // than 8 bytes whose zero padding ties with longer keys.
+  std::set<std::string> user_keys;
+  for (int i = 0; i < 2000; ++i) {
+    std::string k;
+    PutFixed64(&k, EndianSwapValue(rnd.Next64()));
+    user_keys.insert(k);
+    user_keys.insert("commonprefix" + std::to_string(rnd.Uniform(5000)));
+    user_keys.insert(rnd.RandomString(1 + rnd.Uniform(9)));
+  }
+  user_keys.insert(std::string("a"));
+  user_keys.insert(std::string("a\0", 2));
+  user_keys.insert(std::string("a\0\0\0\0\0\0\0\0", 9));
+
+  BlockBuilder builder(4 /* restart interval */, keyUseDeltaEncoding(),
+                       false /* use_value_delta_encoding */,
+                       dataBlockIndexType());
+  std::vector<std::string> keys;
+  for (const auto &user_key : user_keys) {
+    std::string key = user_key;
+    AppendInternalKeyFooter(&key, 0 /* seqno */, kTypeValue);
+    builder.Add(key, user_key);
+    keys.push_back(std::move(key));
+  }
+  Slice rawblock = builder.Finish();
+
+  // Heap allocated, as ApproximateMemoryUsage() may ask malloc for the size
+  // of the Block itself.
+  auto with_prefixes = std::make_unique<Block>(BlockContents(rawblock));
+  auto without_prefixes = std::make_unique<Block>(BlockContents(rawblock));
+  size_t usage = with_prefixes->ApproximateMemoryUsage();
+  with_prefixes->InitializeDataBlockRestartKeyPrefixes(BytewiseComparator());
+  ASSERT_NE(with_prefixes->TEST_GetRestartKeyPrefixes(), nullptr);
+  ASSERT_GT(with_prefixes->ApproximateMemoryUsage(), usage);
+
+  std::unique_ptr<DataBlockIter> iter(with_prefixes->NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+  std::unique_ptr<DataBlockIter> expected(without_prefixes->NewDataIterator(
+      BytewiseComparator(), kDisableGlobalSequenceNumber));
+
+  auto check_seek = [&](const std::string &target) {
+    iter->Seek(target);
+    expected->Seek(target);
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected->Valid(), iter->Valid());
+    if (expected->Valid()) {
+      ASSERT_EQ(expected->key(), iter->key());
+    }
+    iter->SeekForPrev(target);
+    expected->SeekForPrev(target);
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(expected->Valid(), iter->Valid());
+    if (expected->Valid()) {
+      ASSERT_EQ(expected->key(), iter->key());
+    }
+  };
+
+  for (const auto &key : keys) {
+    iter->Seek(key);
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key, iter->key());
+    check_seek(key);
+  }
+  for (int i = 0; i < 10000; ++i) {
+    std::string target = i % 2 == 0 ? rnd.RandomString(rnd.Uniform(10))
+                                    : ExtractUserKey(keys[rnd.Uniform(
+                                                         static_cast<int>(
+                                                             keys.size()))])
+                                          .ToString();
+    if (i % 4 == 1) {
+      target.push_back('\0');
+    }
+    AppendInternalKeyFooter(&target, kMaxSequenceNumber, kValueTypeForSeek);
+    check_seek(target);
+  }
+  std::string last(16, '\xff');
+  AppendInternalKeyFooter(&last, kMaxSequenceNumber, kValueTypeForSeek);
+  check_seek(last);
+}
+
+TEST_F(BlockTest, RestartKeyPrefixLowerBound) {
+  Random rnd(301);
+  for (uint32_t n = 0; n < 100; ++n) {
+    std::vector<uint64_t> prefixes(n);
+    for (auto &prefix : prefixes) {
+      // Few distinct values, so that there are runs of ties, spread over the
+      // full range to exercise the unsigned comparison.
+      prefix = static_cast<uint64_t>(rnd.Uniform(8)) << 61;
+    }
+    std::sort(prefixes.begin(), prefixes.end());
+    for (uint64_t target :
+         {uint64_t{0}, uint64_t{1}, uint64_t{1} << 61, uint64_t{1} << 63,
+          (uint64_t{1} << 63) + 1, uint64_t{7} << 61,
+          std::numeric_limits<uint64_t>::max(), rnd.Next64()}) {
+      ASSERT_EQ(std::lower_bound(prefixes.begin(), prefixes.end(), target) -
+                    prefixes.begin(),
+                Block::RestartKeyPrefixLowerBound(prefixes.data(), n, target));
+    }
+  }
+}
+
 // Param 0: key use delta encoding
 // Param 1: user-defined timestamp test mode
 // Param 2: data block index type. User-defined timestamp feature is not
@@ -27,6 +27,8 @@ enum class BlockType : uint8_t {
   kHashIndexMetadata,
   kMetaIndex,
   kIndex,
+  kPiecewiseLinearIndex,
+  kRangeFilter,
   // Note: keep kInvalid the last value when adding new enum values.
   kInvalid
 };
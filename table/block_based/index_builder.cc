@@ -33,6 +33,16 @@ IndexBuilder* IndexBuilder::CreateIndexBuilder(
   IndexBuilder* result = nullptr;
   switch (index_type) {
     case BlockBasedTableOptions::kBinarySearch: {
+      if (table_opt.piecewise_linear_index &&
+          comparator->user_comparator() == BytewiseComparator() &&
+          ts_sz == 0) {
+        result = new PiecewiseLinearIndexBuilder(
+            comparator, table_opt.index_block_restart_interval,
+            table_opt.format_version, use_value_delta_encoding,
+            table_opt.index_shortening, ts_sz,
+            persist_user_defined_timestamps);
+        break;
+      }
       result = new ShortenedIndexBuilder(
           comparator, table_opt.index_block_restart_interval,
           table_opt.format_version, use_value_delta_encoding,
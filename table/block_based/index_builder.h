@@ -18,6 +18,7 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/piecewise_linear_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -436,6 +437,87 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// PiecewiseLinearIndexBuilder builds the same binary-searchable primary
+// index as ShortenedIndexBuilder, plus a metablock holding a
+// PiecewiseLinearIndexModel fitted over the restart keys of that index. The
+// reader uses the model to predict where a key falls in the index block and
+// only binary searches a small window around the prediction. This only
+// speeds up index lookups: the primary index is written in full, so the
+// index does not get smaller. The table stays a kBinarySearch table, and
+// readers that don't know the metablock simply ignore it. REQUIRES: the
+// BytewiseComparator without timestamps.
+class PiecewiseLinearIndexBuilder : public IndexBuilder {
+ public:
+  // Maximum distance, in restart points, between the model's prediction and
+  // the actual position of a restart key that the fitting aims for.
+  static constexpr uint32_t kMaxError = 4;
+
+  PiecewiseLinearIndexBuilder(
+      const InternalKeyComparator* comparator,
+      int index_block_restart_interval, int format_version,
+      bool use_value_delta_encoding,
+      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps),
+        index_block_restart_interval_(index_block_restart_interval),
+        model_builder_(kMaxError) {
+    assert(comparator->user_comparator() == BytewiseComparator());
+    assert(ts_sz == 0);
+  }
+
+  Slice AddIndexEntry(const Slice& last_key_in_current_block,
+                      const Slice* first_key_in_next_block,
+                      const BlockHandle& block_handle,
+                      std::string* separator_scratch) override {
+    Slice separator = primary_index_builder_.AddIndexEntry(
+        last_key_in_current_block, first_key_in_next_block, block_handle,
+        separator_scratch);
+    // Index block entries at multiples of the restart interval are restart
+    // points, mirroring BlockBuilder.
+    if (num_entries_ % index_block_restart_interval_ == 0) {
+      model_builder_.Add(
+          PiecewiseLinearIndexModel::KeyToNumber(ExtractUserKey(separator)));
+    }
+    ++num_entries_;
+    return separator;
+  }
+
+  void OnKeyAdded(const Slice& key) override {
+    primary_index_builder_.OnKeyAdded(key);
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    // The model is left out when it would not narrow the search enough.
+    if (s.ok() && model_builder_.Finish(&model_block_)) {
+      index_blocks->meta_blocks.insert(
+          {kPiecewiseLinearIndexBlock.c_str(), model_block_});
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  const uint64_t index_block_restart_interval_;
+  PiecewiseLinearIndexModelBuilder model_builder_;
+  uint64_t num_entries_ = 0;
+  std::string model_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -14,20 +14,35 @@ void PartitionedIndexIterator::Seek(const Slice& target) { SeekImpl(&target); }
 void PartitionedIndexIterator::SeekToFirst() { SeekImpl(nullptr); }
 
 void PartitionedIndexIterator::SeekImpl(const Slice* target) {
-  SavePrevIndexValue();
-
-  if (target) {
-    index_iter_->Seek(*target);
+  if (async_read_in_progress_ && target) {
+    // Second pass of a seek whose partition read was submitted
+    // asynchronously. index_iter_ still points to the partition.
+    AsyncInitPartitionedIndexBlock(/*is_first_pass=*/false);
   } else {
-    index_iter_->SeekToFirst();
-  }
+    // The prefetch buffer takes care of an abandoned asynchronous read.
+    async_read_in_progress_ = false;
+    SavePrevIndexValue();
 
-  if (!index_iter_->Valid()) {
-    ResetPartitionedIndexIter();
-    return;
-  }
+    if (target) {
+      index_iter_->Seek(*target);
+    } else {
+      index_iter_->SeekToFirst();
+    }
 
-  InitPartitionedIndexBlock();
+    if (!index_iter_->Valid()) {
+      ResetPartitionedIndexIter();
+      return;
+    }
+
+    if (target && allow_async_seek_) {
+      AsyncInitPartitionedIndexBlock(/*is_first_pass=*/true);
+      if (async_read_in_progress_) {
+        return;
+      }
+    } else {
+      InitPartitionedIndexBlock();
+    }
+  }
 
   if (target) {
     block_iter_.Seek(*target);
@@ -109,6 +124,49 @@ void PartitionedIndexIterator::InitPartitionedIndexBlock() {
   }
 }
 
+void PartitionedIndexIterator::AsyncInitPartitionedIndexBlock(
+    bool is_first_pass) {
+  BlockHandle partitioned_index_handle = index_iter_->value().handle;
+  bool is_for_compaction =
+      lookup_context_.caller == TableReaderCaller::kCompaction;
+  Status s;
+  if (is_first_pass) {
+    if (block_iter_points_to_real_block_ &&
+        partitioned_index_handle.offset() == prev_block_offset_ &&
+        !block_iter_.status().IsIncomplete()) {
+      return;
+    }
+    ResetPartitionedIndexIter();
+    block_prefetcher_.PrefetchIfNeeded(
+        table_->get_rep(), partitioned_index_handle,
+        read_options_.readahead_size, is_for_compaction,
+        /*no_sequential_checking=*/true, read_options_,
+        /*readaheadsize_cb=*/nullptr, /*is_async_io_prefetch=*/true);
+    table_->NewDataBlockIterator<IndexBlockIter>(
+        read_options_, partitioned_index_handle, &block_iter_,
+        BlockType::kIndex,
+        /*get_context=*/nullptr, &lookup_context_,
+        block_prefetcher_.prefetch_buffer(),
+        /*for_compaction=*/is_for_compaction, /*async_read=*/true, s,
+        /*use_block_cache_for_lookup=*/true);
+    if (s.IsTryAgain()) {
+      async_read_in_progress_ = true;
+      return;
+    }
+  } else {
+    // Polls for the partition requested by the first pass.
+    table_->NewDataBlockIterator<IndexBlockIter>(
+        read_options_, partitioned_index_handle, &block_iter_,
+        BlockType::kIndex,
+        /*get_context=*/nullptr, &lookup_context_,
+        block_prefetcher_.prefetch_buffer(),
+        /*for_compaction=*/is_for_compaction, /*async_read=*/false, s,
+        /*use_block_cache_for_lookup=*/false);
+  }
+  block_iter_points_to_real_block_ = true;
+  async_read_in_progress_ = false;
+}
+
 void PartitionedIndexIterator::FindKeyForward() {
   // This method's code is kept short to make it likely to be inlined.
 
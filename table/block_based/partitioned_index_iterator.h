@@ -17,6 +17,11 @@ namespace ROCKSDB_NAMESPACE {
 // Some upper and lower bound tricks played in block based table iterators
 // could be played here, but it's too complicated to reason about index
 // keys with upper or lower bound, so we skip it for simplicity.
+//
+// With ReadOptions::async_io, and for user iterators only, Seek() can
+// submit the read of the index partition asynchronously and return with
+// status() Status::TryAgain(). Seek() must then be called again with the same
+// target to wait for the read and complete the seek.
 class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
   // compaction_readahead_size: its value will only be used if for_compaction =
   // true
@@ -37,8 +42,9 @@ class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
         lookup_context_(caller),
         block_prefetcher_(
             compaction_readahead_size,
-            table_->get_rep()->table_options.initial_auto_readahead_size) {
-  }
+            table_->get_rep()->table_options.initial_auto_readahead_size),
+        allow_async_seek_(read_options.async_io &&
+                          caller == TableReaderCaller::kUserIterator) {}
 
   ~PartitionedIndexIterator() override {}
 
@@ -76,6 +82,8 @@ class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
       return index_iter_->status();
     } else if (block_iter_points_to_real_block_) {
       return block_iter_.status();
+    } else if (async_read_in_progress_) {
+      return Status::TryAgain("Async read in progress");
     } else {
       return Status::OK();
     }
@@ -148,11 +156,14 @@ class PartitionedIndexIterator : public InternalIteratorBase<IndexValue> {
   uint64_t prev_block_offset_ = std::numeric_limits<uint64_t>::max();
   BlockCacheLookupContext lookup_context_;
   BlockPrefetcher block_prefetcher_;
+  const bool allow_async_seek_;
+  bool async_read_in_progress_ = false;
 
   // If `target` is null, seek to first.
   void SeekImpl(const Slice* target);
 
   void InitPartitionedIndexBlock();
+  void AsyncInitPartitionedIndexBlock(bool is_first_pass);
   void FindKeyForward();
   void FindBlockForward();
   void FindKeyBackward();
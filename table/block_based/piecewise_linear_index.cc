@@ -0,0 +1,171 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/piecewise_linear_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "util/coding.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+uint64_t PiecewiseLinearIndexModel::KeyToNumber(const Slice& user_key) {
+  char buf[sizeof(uint64_t)] = {};
+  memcpy(buf, user_key.data(), std::min(user_key.size(), sizeof(buf)));
+  return EndianSwapValue(DecodeFixed64(buf));
+}
+
+Status PiecewiseLinearIndexModel::Create(
+    const Slice& contents, std::unique_ptr<PiecewiseLinearIndexModel>* model) {
+  Slice input = contents;
+  std::unique_ptr<PiecewiseLinearIndexModel> result(
+      new PiecewiseLinearIndexModel());
+  uint32_t num_segments = 0;
+  if (!GetVarint32(&input, &result->max_overshoot_) ||
+      !GetVarint32(&input, &result->max_undershoot_) ||
+      !GetVarint32(&input, &result->num_keys_) ||
+      !GetVarint32(&input, &num_segments)) {
+    return Status::Corruption("Corrupted piecewise linear index header");
+  }
+  if (result->max_overshoot_ > result->num_keys_ ||
+      result->max_undershoot_ > result->num_keys_ + 1) {
+    return Status::Corruption("Invalid piecewise linear index error bounds");
+  }
+  if (num_segments > result->num_keys_) {
+    return Status::Corruption("Too many piecewise linear index segments");
+  }
+  result->segments_.reserve(num_segments);
+  for (uint32_t i = 0; i < num_segments; ++i) {
+    Segment segment;
+    uint64_t slope_bits = 0;
+    if (!GetFixed64(&input, &segment.first_key) ||
+        !GetVarint32(&input, &segment.first_pos) ||
+        !GetFixed64(&input, &slope_bits)) {
+      return Status::Corruption("Truncated piecewise linear index segment");
+    }
+    memcpy(&segment.slope, &slope_bits, sizeof(segment.slope));
+    if (!std::isfinite(segment.slope) || segment.slope < 0 ||
+        segment.first_pos >= result->num_keys_ ||
+        (i > 0 &&
+         (segment.first_key <= result->segments_.back().first_key ||
+          segment.first_pos <= result->segments_.back().first_pos))) {
+      return Status::Corruption("Invalid piecewise linear index segment");
+    }
+    result->segments_.push_back(segment);
+  }
+  if (!input.empty()) {
+    return Status::Corruption("Trailing data in piecewise linear index");
+  }
+  *model = std::move(result);
+  return Status::OK();
+}
+
+uint32_t PiecewiseLinearIndexModel::Predict(uint64_t key) const {
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), key,
+      [](uint64_t k, const Segment& segment) { return k < segment.first_key; });
+  if (it == segments_.begin()) {
+    return 0;
+  }
+  uint32_t limit = it == segments_.end() ? num_keys_ : it->first_pos;
+  --it;
+  double pos = static_cast<double>(it->first_pos) +
+               it->slope * static_cast<double>(key - it->first_key);
+  // A key past the segment's last trained key belongs right before the next
+  // segment's first key.
+  if (pos >= static_cast<double>(limit)) {
+    return limit;
+  }
+  return static_cast<uint32_t>(pos + 0.5);
+}
+
+void PiecewiseLinearIndexModelBuilder::Add(uint64_t key) {
+  uint32_t pos = static_cast<uint32_t>(keys_.size());
+  keys_.push_back(key);
+  if (!has_segment_) {
+    has_segment_ = true;
+  } else if (key == last_key_) {
+    // Predictions are for the first of equal keys.
+    return;
+  } else {
+    assert(key > last_key_);
+    double dx = static_cast<double>(key - first_key_);
+    double dy = static_cast<double>(pos - first_pos_);
+    double min_slope = std::max(min_slope_, (dy - max_error_) / dx);
+    double max_slope = std::min(max_slope_, (dy + max_error_) / dx);
+    if (min_slope <= max_slope) {
+      min_slope_ = min_slope;
+      max_slope_ = max_slope;
+      last_key_ = key;
+      return;
+    }
+    CloseSegment();
+  }
+  first_key_ = key;
+  first_pos_ = pos;
+  last_key_ = key;
+  min_slope_ = 0;
+  max_slope_ = std::numeric_limits<double>::infinity();
+}
+
+void PiecewiseLinearIndexModelBuilder::CloseSegment() {
+  assert(has_segment_);
+  PiecewiseLinearIndexModel::Segment segment;
+  segment.first_key = first_key_;
+  segment.first_pos = first_pos_;
+  segment.slope = std::isinf(max_slope_) ? min_slope_
+                                         : min_slope_ / 2 + max_slope_ / 2;
+  segments_.push_back(segment);
+}
+
+bool PiecewiseLinearIndexModelBuilder::Finish(std::string* dst) {
+  if (has_segment_) {
+    CloseSegment();
+    has_segment_ = false;
+  }
+  PiecewiseLinearIndexModel model;
+  model.num_keys_ = static_cast<uint32_t>(keys_.size());
+  model.segments_ = std::move(segments_);
+
+  // Predict() is non-decreasing, so a lookup key is predicted the same as
+  // the keys with the same value or, if there are none, between the
+  // predictions for its neighbors among the keys. Either way, the number of
+  // keys not greater than it is at least the position of a key predicted no
+  // lower, and at most one past the position of a key predicted no higher.
+  // So these bounds, measured over the keys, hold for every lookup key.
+  int64_t max_overshoot = 0;
+  int64_t max_undershoot = 0;
+  for (size_t pos = 0; pos < keys_.size(); ++pos) {
+    const int64_t predicted = model.Predict(keys_[pos]);
+    const int64_t actual = static_cast<int64_t>(pos);
+    max_overshoot = std::max(max_overshoot, predicted - actual);
+    max_undershoot = std::max(max_undershoot, actual + 1 - predicted);
+  }
+  // Binary searching the window around the prediction must save at least a
+  // couple of comparisons over binary searching all the keys.
+  if ((max_overshoot + max_undershoot + 1) * kMinNarrowing >
+      static_cast<int64_t>(keys_.size())) {
+    return false;
+  }
+
+  PutVarint32(dst, static_cast<uint32_t>(max_overshoot));
+  PutVarint32(dst, static_cast<uint32_t>(max_undershoot));
+  PutVarint32(dst, model.num_keys_);
+  PutVarint32(dst, static_cast<uint32_t>(model.segments_.size()));
+  for (const auto& segment : model.segments_) {
+    uint64_t slope_bits = 0;
+    memcpy(&slope_bits, &segment.slope, sizeof(slope_bits));
+    PutFixed64(dst, segment.first_key);
+    PutVarint32(dst, segment.first_pos);
+    PutFixed64(dst, slope_bits);
+  }
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,116 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A compact piecewise-linear model mapping the numeric value of an index
+// block's restart keys (the first 8 bytes of the user key, big-endian and
+// zero padded) to their restart index. It lets IndexBlockIter narrow the
+// binary search over restart points down to a window of a few entries around
+// the predicted position. Only meaningful for the BytewiseComparator without
+// timestamps, where the numeric value is monotonic in key order.
+//
+// Predict() is non-decreasing in the key, so the error bounds measured on the
+// restart keys at build time also bound the error for any other key, which
+// falls between two restart keys. No comparisons are needed to check the
+// prediction.
+//
+// Serialized format (the "rocksdb.index.piecewise_linear" meta block):
+//
+//   max_overshoot: varint32
+//   max_undershoot: varint32
+//   num_keys: varint32
+//   num_segments: varint32
+//   num_segments x {first_key: fixed64, first_pos: varint32,
+//                   slope: fixed64 (IEEE 754 double bits)}
+class PiecewiseLinearIndexModel {
+ public:
+  // Returns the model's numeric value for `user_key`.
+  static uint64_t KeyToNumber(const Slice& user_key);
+
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<PiecewiseLinearIndexModel>* model);
+
+  // Predicts the number of trained keys that are not greater than a key whose
+  // numeric value is `key`. The actual number is in
+  // [Predict(key) - max_overshoot(), Predict(key) + max_undershoot()].
+  uint32_t Predict(uint64_t key) const;
+
+  uint32_t max_overshoot() const { return max_overshoot_; }
+  uint32_t max_undershoot() const { return max_undershoot_; }
+  uint32_t num_keys() const { return num_keys_; }
+  size_t num_segments() const { return segments_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + segments_.capacity() * sizeof(Segment);
+  }
+
+ private:
+  friend class PiecewiseLinearIndexModelBuilder;
+
+  struct Segment {
+    uint64_t first_key;
+    uint32_t first_pos;
+    double slope;
+  };
+
+  PiecewiseLinearIndexModel() = default;
+
+  uint32_t max_overshoot_ = 0;
+  uint32_t max_undershoot_ = 0;
+  uint32_t num_keys_ = 0;
+  std::vector<Segment> segments_;
+};
+
+// Fits a PiecewiseLinearIndexModel over a non-decreasing sequence of keys
+// with a greedy "shrinking cone" pass: a segment is extended for as long as
+// some line through its first point stays within `max_error` positions of
+// every distinct key it covers. The error bounds stored in the model are then
+// measured over all the keys, including repeated ones.
+class PiecewiseLinearIndexModelBuilder {
+ public:
+  explicit PiecewiseLinearIndexModelBuilder(uint32_t max_error)
+      : max_error_(max_error) {}
+
+  // Adds the key at the next position. REQUIRES: `key` is not less than the
+  // previously added key.
+  void Add(uint64_t key);
+
+  // Appends the serialized model to `dst` and returns true, unless the model
+  // would narrow the search over the keys too little to be worth storing, in
+  // which case it returns false and leaves `dst` unchanged.
+  bool Finish(std::string* dst);
+
+ private:
+  // Finish() only keeps models whose search window spans at most this
+  // fraction of the keys.
+  static constexpr int64_t kMinNarrowing = 4;
+
+  void CloseSegment();
+
+  const uint32_t max_error_;
+  std::vector<uint64_t> keys_;
+  std::vector<PiecewiseLinearIndexModel::Segment> segments_;
+
+  // State of the segment being fitted.
+  bool has_segment_ = false;
+  uint64_t last_key_ = 0;
+  uint64_t first_key_ = 0;
+  uint32_t first_pos_ = 0;
+  double min_slope_ = 0;
+  double max_slope_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
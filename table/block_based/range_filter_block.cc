@@ -0,0 +1,54 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#include "table/block_based/range_filter_block.h"
+
+#include <algorithm>
+
+namespace ROCKSDB_NAMESPACE {
+
+RangeFilterBlockBuilder::RangeFilterBlockBuilder(size_t prefix_len)
+    : prefix_len_(prefix_len),
+      block_(16 /* block_restart_interval */, true /* use_delta_encoding */) {
+  assert(prefix_len_ > 0);
+}
+
+void RangeFilterBlockBuilder::Add(const Slice& user_key) {
+  const Slice prefix(user_key.data(), std::min(user_key.size(), prefix_len_));
+  if (!block_.empty() && prefix == Slice(last_prefix_)) {
+    return;
+  }
+  assert(block_.empty() || prefix.compare(Slice(last_prefix_)) > 0);
+  block_.AddWithLastKey(prefix, Slice(), last_prefix_);
+  last_prefix_.assign(prefix.data(), prefix.size());
+}
+
+bool RangeFilterBlockReader::RangeMayMatch(const Slice& begin,
+                                           const Slice* end) const {
+  if (end != nullptr && begin.compare(*end) >= 0) {
+    return false;
+  }
+  std::unique_ptr<MetaBlockIter> iter(block_->NewMetaIterator());
+
+  // The keys with the greatest prefix not after `begin` can only be in the
+  // range if that prefix is a prefix of `begin` as well. Otherwise they are
+  // less than `begin`.
+  iter->SeekForPrev(begin);
+  if (iter->Valid()) {
+    if (begin.starts_with(iter->key())) {
+      return true;
+    }
+    iter->Next();
+  } else if (iter->status().ok()) {
+    iter->SeekToFirst();
+  }
+  if (!iter->status().ok()) {
+    return true;
+  }
+
+  // The keys with any greater prefix are not less than that prefix.
+  return iter->Valid() && (end == nullptr || iter->key().compare(*end) < 0);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,60 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/slice.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A range filter answers whether a table might have a key in a range of user
+// keys [begin, end), without false negatives. It consists of the distinct
+// prefixes of up to `prefix_len` bytes of the table's user keys, in sorted
+// order, stored as the keys of the "rocksdb.range_filter" meta block (with
+// empty values). Because truncation preserves the order of keys under the
+// BytewiseComparator, the range has no key of the table if no prefix can
+// belong to a key in it. Shorter prefixes make the filter smaller and less
+// precise. Only built for the BytewiseComparator without timestamps.
+class RangeFilterBlockBuilder {
+ public:
+  explicit RangeFilterBlockBuilder(size_t prefix_len);
+
+  // Adds a user key of the table. Keys must be added in sorted order.
+  void Add(const Slice& user_key);
+
+  bool empty() const { return block_.empty(); }
+
+  // Returns the contents of the meta block. The builder must not be used
+  // afterwards.
+  Slice Finish() { return block_.Finish(); }
+
+ private:
+  const size_t prefix_len_;
+  BlockBuilder block_;
+  std::string last_prefix_;
+};
+
+class RangeFilterBlockReader {
+ public:
+  explicit RangeFilterBlockReader(BlockContents&& contents)
+      : block_(new Block(std::move(contents))) {}
+
+  // Returns false if the table certainly has no user key in [begin, end). A
+  // null `end` means no upper bound.
+  bool RangeMayMatch(const Slice& begin, const Slice* end) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + block_->ApproximateMemoryUsage();
+  }
+
+ private:
+  std::unique_ptr<Block> block_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
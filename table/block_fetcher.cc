@@ -29,6 +29,46 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// A buffer reused by the BlockFetchers of a thread to read compressed blocks
+// that are uncompressed right away. The compressed data is only needed until
+// the BlockFetcher is destroyed, so this saves allocating and freeing a heap
+// buffer for each block that is too large for the stack buffer.
+struct ScratchBuffer {
+  std::unique_ptr<char[]> buf;
+  size_t capacity = 0;
+  bool in_use = false;
+};
+thread_local ScratchBuffer tls_scratch_buffer;
+}  // namespace
+
+char* BlockFetcher::AcquireScratchBuffer() {
+  ScratchBuffer& scratch = tls_scratch_buffer;
+  if (scratch_buf_ != nullptr) {
+    // Re-read of the same block
+    assert(scratch.in_use && scratch.capacity >= block_size_with_trailer_);
+    return scratch_buf_;
+  }
+  if (scratch.in_use) {
+    return nullptr;
+  }
+  if (scratch.capacity < block_size_with_trailer_) {
+    scratch.buf.reset(new char[block_size_with_trailer_]);
+    scratch.capacity = block_size_with_trailer_;
+  }
+  scratch.in_use = true;
+  scratch_buf_ = scratch.buf.get();
+  return scratch_buf_;
+}
+
+void BlockFetcher::ReleaseScratchBuffer() {
+  if (scratch_buf_ != nullptr) {
+    assert(tls_scratch_buffer.in_use);
+    tls_scratch_buffer.in_use = false;
+    scratch_buf_ = nullptr;
+  }
+}
+
 inline void BlockFetcher::ProcessTrailerIfPresent() {
   if (footer_.GetBlockTrailerSize() > 0) {
     assert(footer_.GetBlockTrailerSize() == BlockBasedTable::kBlockTrailerSize);
@@ -146,6 +186,14 @@ inline void BlockFetcher::PrepareBufferForBlockFromFile() {
     // into the mapped memory. This expectation will be wrong when using a
     // file reader that does not implement mmap reads properly.
     used_buf_ = &stack_buf_[0];
+  } else if (maybe_compressed_ && do_uncompress_ &&
+             !ioptions_.allow_mmap_reads &&
+             block_size_with_trailer_ <= kMaxScratchBufferSize &&
+             AcquireScratchBuffer() != nullptr) {
+    // The block is expected to be compressed, so it is only read to be
+    // uncompressed into a heap buffer. Like with the stack buffer above,
+    // guessing wrong costs a memcpy in `GetBlockContents()`.
+    used_buf_ = scratch_buf_;
   } else if (maybe_compressed_ && !do_uncompress_) {
     compressed_buf_ =
         AllocateBlock(block_size_with_trailer_, memory_allocator_compressed_);
@@ -201,10 +249,11 @@ inline void BlockFetcher::CopyBufferToCompressedBuf() {
 // 1. prefetch buffer if prefetch is enabled and the block is prefetched before
 // 2. stack_buf_ if block size is smaller than the stack_buf_ size and block
 //    is not compressed
-// 3. heap_buf_ if the block is not compressed
-// 4. compressed_buf_ if the block is compressed
-// 5. direct_io_buf_ if direct IO is enabled or
-// 6. underlying file_system scratch is used (FSReadRequest.fs_scratch).
+// 3. scratch_buf_ if the block was expected to be compressed but is not
+// 4. heap_buf_ if the block is not compressed
+// 5. compressed_buf_ if the block is compressed
+// 6. direct_io_buf_ if direct IO is enabled or
+// 7. underlying file_system scratch is used (FSReadRequest.fs_scratch).
 //
 // After - After this method, if the block is compressed, it should be in
 // compressed_buf_ and heap_buf_ points to compressed_buf_, otherwise should be
@@ -216,7 +265,8 @@ inline void BlockFetcher::GetBlockContents() {
   } else {
     // page can be either uncompressed or compressed, the buffer either stack
     // or heap provided. Refer to https://github.com/facebook/rocksdb/pull/4096
-    if (got_from_prefetch_buffer_ || used_buf_ == &stack_buf_[0]) {
+    if (got_from_prefetch_buffer_ || used_buf_ == &stack_buf_[0] ||
+        (used_buf_ != nullptr && used_buf_ == scratch_buf_)) {
       CopyBufferToHeapBuf();
     } else if (used_buf_ == compressed_buf_.get()) {
       if (compression_type_ == kNoCompression &&
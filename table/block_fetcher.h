@@ -34,7 +34,10 @@ namespace ROCKSDB_NAMESPACE {
 //
 // Memory for uncompressed and compressed blocks is allocated as needed
 // using memory_allocator and memory_allocator_compressed, respectively
-// (if provided; otherwise, the default allocator is used).
+// (if provided; otherwise, the default allocator is used). Compressed blocks
+// that are uncompressed on fetching are read into a stack buffer or a
+// per-thread scratch buffer instead, as only the uncompressed block is
+// returned.
 
 class BlockFetcher {
  public:
@@ -77,6 +80,7 @@ class BlockFetcher {
       retry_corrupt_read_ = true;
     }
   }
+  ~BlockFetcher() { ReleaseScratchBuffer(); }
 
   IOStatus ReadBlockContents();
   IOStatus ReadAsyncBlockContents();
@@ -108,6 +112,9 @@ class BlockFetcher {
 
 #endif
   static const uint32_t kDefaultStackBufferSize = 5000;
+  // Largest block read into the per-thread scratch buffer, which bounds the
+  // memory the buffer retains on each thread
+  static const uint32_t kMaxScratchBufferSize = 256 * 1024;
 
   RandomAccessFileReader* file_;
   FilePrefetchBuffer* prefetch_buffer_;
@@ -132,6 +139,8 @@ class BlockFetcher {
   CacheAllocationPtr heap_buf_;
   CacheAllocationPtr compressed_buf_;
   char stack_buf_[kDefaultStackBufferSize];
+  // Per-thread buffer held by this BlockFetcher, if any
+  char* scratch_buf_ = nullptr;
   bool got_from_prefetch_buffer_ = false;
   CompressionType compression_type_;
   bool for_compaction_ = false;
@@ -145,6 +154,10 @@ class BlockFetcher {
   bool TryGetFromPrefetchBuffer();
   bool TryGetSerializedBlockFromPersistentCache();
   void PrepareBufferForBlockFromFile();
+  // Returns the per-thread scratch buffer, with room for the block, or
+  // nullptr if it is already held by another BlockFetcher on this thread.
+  char* AcquireScratchBuffer();
+  void ReleaseScratchBuffer();
   // Copy content from used_buf_ to new heap_buf_.
   void CopyBufferToHeapBuf();
   // Copy content from used_buf_ to new compressed_buf_.
@@ -18,6 +18,8 @@
 #include "table/block_based/block_based_table_reader.h"
 #include "table/format.h"
 #include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
 #include "utilities/memory_allocators.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -66,8 +68,12 @@ class BlockFetcherTest : public testing::Test {
   }
 
   // Creates a table with kv pairs (i, i) where i ranges from 0 to 9, inclusive.
+  // With `large_values`, values are 16KB of half compressible data instead, so
+  // that even compressed data blocks do not fit in the stack buffer of
+  // BlockFetcher.
   void CreateTable(const std::string& table_name,
-                   const CompressionType& compression_type) {
+                   const CompressionType& compression_type,
+                   bool large_values = false) {
     std::unique_ptr<WritableFileWriter> writer;
     NewFileWriter(table_name, &writer);
 
@@ -88,10 +94,14 @@ class BlockFetcherTest : public testing::Test {
         writer.get()));
 
     // Build table.
+    Random rnd(301);
     for (int i = 0; i < 9; i++) {
       std::string key = ToInternalKey(std::to_string(i));
       // Append "00000000" to string value to enhance compression ratio
       std::string value = "00000000" + std::to_string(i);
+      if (large_values) {
+        test::CompressibleString(&rnd, 0.5, 16 * 1024, &value);
+      }
       table_builder->Add(key, value);
     }
     ASSERT_OK(table_builder->Finish());
@@ -139,7 +149,8 @@ class BlockFetcherTest : public testing::Test {
   // Bufferr allocation and memory copy statistics are expected.
   void TestFetchDataBlock(
       const std::string& table_name_prefix, bool compressed, bool do_uncompress,
-      std::array<TestStats, NumModes> expected_stats_by_mode) {
+      std::array<TestStats, NumModes> expected_stats_by_mode,
+      bool large_values = false) {
     for (CompressionType compression_type : GetSupportedCompressions()) {
       bool do_compress = compression_type != kNoCompression;
       if (compressed != do_compress) {
@@ -149,7 +160,7 @@ class BlockFetcherTest : public testing::Test {
           CompressionTypeToString(compression_type);
 
       std::string table_name = table_name_prefix + compression_type_str;
-      CreateTable(table_name, compression_type);
+      CreateTable(table_name, compression_type, large_values);
 
       CompressionType expected_compression_type_after_fetch =
           (compressed && !do_uncompress) ? compression_type : kNoCompression;
@@ -530,6 +541,33 @@ TEST_F(BlockFetcherTest, FetchAndUncompressCompressedDataBlock) {
                      expected_stats_by_mode);
 }
 
+// Data blocks are compressed and too large for the stack buffer,
+// fetch and uncompress data block under both direct IO and non-direct IO.
+// Expects:
+// 1. in non-direct IO mode, the block is read into the per-thread scratch
+//    buffer, then a heap buffer is allocated and the block is uncompressed
+//    into the heap, so that only one heap buffer is allocated.
+// 2. in mmap and direct IO modes, allocate a heap buffer, then directly
+//    uncompress from the mapped or direct IO buffer to the heap buffer.
+TEST_F(BlockFetcherTest, FetchAndUncompressLargeCompressedDataBlock) {
+  TestStats expected_stats = {
+      {
+          0 /* num_stack_buf_memcpy */,
+          1 /* num_heap_buf_memcpy */,
+          0 /* num_compressed_buf_memcpy */,
+      },
+      {
+          1 /* num_heap_buf_allocations */,
+          0 /* num_compressed_buf_allocations */,
+      }};
+  std::array<TestStats, NumModes> expected_stats_by_mode{{
+      expected_stats /* kBufferedRead */,
+      expected_stats /* kBufferedMmap */,
+      expected_stats /* kDirectRead */,
+  }};
+  TestFetchDataBlock("FetchAndUncompressLargeCompressedDataBlock", true, true,
+                     expected_stats_by_mode, /*large_values=*/true);
+}
 
 }  // namespace
 }  // namespace ROCKSDB_NAMESPACE
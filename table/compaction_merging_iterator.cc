@@ -5,6 +5,8 @@
 //  (found in the LICENSE.Apache file in the root directory).
 #include "table/compaction_merging_iterator.h"
 
+#include "util/tournament_tree.h"
+
 namespace ROCKSDB_NAMESPACE {
 class CompactionMergingIterator : public InternalIterator {
  public:
@@ -13,11 +15,13 @@ class CompactionMergingIterator : public InternalIterator {
       int n, bool is_arena_mode,
       std::vector<std::pair<std::unique_ptr<TruncatedRangeDelIterator>,
                             std::unique_ptr<TruncatedRangeDelIterator>**>>&
-          range_tombstones)
+          range_tombstones,
+      bool use_tournament_tree)
       : is_arena_mode_(is_arena_mode),
         comparator_(comparator),
         current_(nullptr),
-        minHeap_(CompactionHeapItemComparator(comparator_)),
+        minHeap_(CompactionHeapItemComparator(comparator_), HeapItemSlot(),
+                 use_tournament_tree),
         pinned_iters_mgr_(nullptr) {
     children_.resize(n);
     for (int i = 0; i < n; i++) {
@@ -38,6 +42,7 @@ class CompactionMergingIterator : public InternalIterator {
       pinned_heap_item_[i].level = i;
       pinned_heap_item_[i].type = HeapItem::DELETE_RANGE_START;
     }
+    minHeap_.reserve(2 * children_.size());
   }
 
   void considerStatus(const Status& s) {
@@ -181,7 +186,16 @@ class CompactionMergingIterator : public InternalIterator {
     const InternalKeyComparator* comparator_;
   };
 
-  using CompactionMinHeap = BinaryHeap<HeapItem*, CompactionHeapItemComparator>;
+  // Leaf of a HeapItem in the tournament tree: children_[i] and
+  // pinned_heap_item_[i] are the only items of level i.
+  struct HeapItemSlot {
+    size_t operator()(HeapItem* item) const {
+      return 2 * item->level + (item->type == HeapItem::ITERATOR ? 0 : 1);
+    }
+  };
+
+  using CompactionMinHeap =
+      MergeHeap<HeapItem*, CompactionHeapItemComparator, HeapItemSlot>;
   bool is_arena_mode_;
   const InternalKeyComparator* comparator_;
   // HeapItem for all child point iterators.
@@ -350,20 +364,20 @@ InternalIterator* NewCompactionMergingIterator(
     std::vector<std::pair<std::unique_ptr<TruncatedRangeDelIterator>,
                           std::unique_ptr<TruncatedRangeDelIterator>**>>&
         range_tombstone_iters,
-    Arena* arena) {
+    Arena* arena, bool use_tournament_tree) {
   assert(n >= 0);
   if (n == 0) {
     return NewEmptyInternalIterator<Slice>(arena);
   } else {
     if (arena == nullptr) {
-      return new CompactionMergingIterator(comparator, children, n,
-                                           false /* is_arena_mode */,
-                                           range_tombstone_iters);
+      return new CompactionMergingIterator(
+          comparator, children, n, false /* is_arena_mode */,
+          range_tombstone_iters, use_tournament_tree);
     } else {
       auto mem = arena->AllocateAligned(sizeof(CompactionMergingIterator));
-      return new (mem) CompactionMergingIterator(comparator, children, n,
-                                                 true /* is_arena_mode */,
-                                                 range_tombstone_iters);
+      return new (mem) CompactionMergingIterator(
+          comparator, children, n, true /* is_arena_mode */,
+          range_tombstone_iters, use_tournament_tree);
     }
   }
 }
@@ -41,5 +41,5 @@ InternalIterator* NewCompactionMergingIterator(
     std::vector<std::pair<std::unique_ptr<TruncatedRangeDelIterator>,
                           std::unique_ptr<TruncatedRangeDelIterator>**>>&
         range_tombstone_iters,
-    Arena* arena = nullptr);
+    Arena* arena = nullptr, bool use_tournament_tree = false);
 }  // namespace ROCKSDB_NAMESPACE
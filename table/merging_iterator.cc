@@ -10,6 +10,7 @@
 #include "table/merging_iterator.h"
 
 #include "db/arena_wrapped_db_iter.h"
+#include "util/tournament_tree.h"
 
 namespace ROCKSDB_NAMESPACE {
 // MergingIterator uses a min/max heap to combine data from point iterators.
@@ -54,13 +55,15 @@ class MergingIterator : public InternalIterator {
   MergingIterator(const InternalKeyComparator* comparator,
                   InternalIterator** children, int n, bool is_arena_mode,
                   bool prefix_seek_mode,
-                  const Slice* iterate_upper_bound = nullptr)
+                  const Slice* iterate_upper_bound = nullptr,
+                  bool use_tournament_tree = false)
       : is_arena_mode_(is_arena_mode),
         prefix_seek_mode_(prefix_seek_mode),
         direction_(kForward),
         comparator_(comparator),
         current_(nullptr),
-        minHeap_(MinHeapItemComparator(comparator_)),
+        minHeap_(MinHeapItemComparator(comparator_), HeapItemSlot(),
+                 use_tournament_tree),
         pinned_iters_mgr_(nullptr),
         iterate_upper_bound_(iterate_upper_bound) {
     children_.resize(n);
@@ -562,7 +565,17 @@ class MergingIterator : public InternalIterator {
     const InternalKeyComparator* comparator_;
   };
 
-  using MergerMinIterHeap = BinaryHeap<HeapItem*, MinHeapItemComparator>;
+  // Leaf of a HeapItem in the tournament tree: children_[i] and
+  // pinned_heap_item_[i] are the only items of level i.
+  struct HeapItemSlot {
+    size_t operator()(HeapItem* item) const {
+      return 2 * item->level +
+             (item->type == HeapItem::Type::ITERATOR ? 0 : 1);
+    }
+  };
+
+  using MergerMinIterHeap =
+      MergeHeap<HeapItem*, MinHeapItemComparator, HeapItemSlot>;
   using MergerMaxIterHeap = BinaryHeap<HeapItem*, MaxHeapItemComparator>;
 
   friend class MergeIteratorBuilder;
@@ -646,7 +659,7 @@ class MergingIterator : public InternalIterator {
   // If any of the children have non-ok status, this is one of them.
   Status status_;
   // Invariant: min heap property is maintained (parent is always <= child).
-  // This holds by using only BinaryHeap APIs to modify heap. One
+  // This holds by using only MergeHeap APIs to modify heap. One
   // exception is to modify heap top item directly (by caller iter->Next()), and
   // it should be followed by a call to replace_top() or pop().
   MergerMinIterHeap minHeap_;
@@ -894,26 +907,48 @@ void MergingIterator::SeekImpl(const Slice& target, size_t starting_level,
     }
   }
 
+  // A child can return Status::TryAgain more than once, e.g. for the read of
+  // an index partition and then for the read of the data block. Each round
+  // waits for the reads submitted by the previous round, and submits the next
+  // reads of all children before waiting for any of them, so a seek costs
+  // about one read latency per round rather than one per level.
   if (range_tombstone_iters_.empty()) {
-    for (auto& child : children_) {
-      if (child.iter.status().IsTryAgain()) {
-        child.iter.Seek(target);
-        {
-          PERF_TIMER_GUARD(seek_min_heap_time);
-          AddToMinHeapOrCheckStatus(&child);
+    bool pending;
+    do {
+      pending = false;
+      for (auto& child : children_) {
+        if (child.iter.status().IsTryAgain()) {
+          child.iter.Seek(target);
+          PERF_COUNTER_ADD(number_async_seek, 1);
+          if (child.iter.status().IsTryAgain()) {
+            pending = true;
+            continue;
+          }
+          {
+            PERF_TIMER_GUARD(seek_min_heap_time);
+            AddToMinHeapOrCheckStatus(&child);
+          }
         }
-        PERF_COUNTER_ADD(number_async_seek, 1);
       }
-    }
+    } while (pending);
   } else {
-    for (auto& prefetch : prefetched_target) {
+    while (!prefetched_target.empty()) {
       // (level, target) pairs
-      children_[prefetch.first].iter.Seek(prefetch.second);
-      {
-        PERF_TIMER_GUARD(seek_min_heap_time);
-        AddToMinHeapOrCheckStatus(&children_[prefetch.first]);
+      autovector<std::pair<size_t, std::string>> still_pending;
+      for (auto& prefetch : prefetched_target) {
+        children_[prefetch.first].iter.Seek(prefetch.second);
+        PERF_COUNTER_ADD(number_async_seek, 1);
+        if (children_[prefetch.first].iter.status().IsTryAgain()) {
+          still_pending.emplace_back(std::move(prefetch));
+          continue;
+        }
+        {
+          PERF_TIMER_GUARD(seek_min_heap_time);
+          AddToMinHeapOrCheckStatus(&children_[prefetch.first]);
+        }
       }
-      PERF_COUNTER_ADD(number_async_seek, 1);
+      prefetched_target.clear();
+      prefetched_target = std::move(still_pending);
     }
   }
 }
@@ -1435,6 +1470,7 @@ void MergingIterator::SwitchToBackward() {
 
 void MergingIterator::ClearHeaps(bool clear_active) {
   minHeap_.clear();
+  minHeap_.reserve(2 * children_.size());
   if (maxHeap_) {
     maxHeap_->clear();
   }
@@ -1664,11 +1700,12 @@ InternalIterator* NewMergingIterator(const InternalKeyComparator* cmp,
 
 MergeIteratorBuilder::MergeIteratorBuilder(
     const InternalKeyComparator* comparator, Arena* a, bool prefix_seek_mode,
-    const Slice* iterate_upper_bound)
+    const Slice* iterate_upper_bound, bool use_tournament_tree)
     : first_iter(nullptr), use_merging_iter(false), arena(a) {
   auto mem = arena->AllocateAligned(sizeof(MergingIterator));
-  merge_iter = new (mem) MergingIterator(comparator, nullptr, 0, true,
-                                         prefix_seek_mode, iterate_upper_bound);
+  merge_iter = new (mem)
+      MergingIterator(comparator, nullptr, 0, true, prefix_seek_mode,
+                      iterate_upper_bound, use_tournament_tree);
 }
 
 MergeIteratorBuilder::~MergeIteratorBuilder() {
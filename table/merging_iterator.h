@@ -50,9 +50,12 @@ class MergeIteratorBuilder {
  public:
   // comparator: the comparator used in merging comparator
   // arena: where the merging iterator needs to be allocated from.
+  // use_tournament_tree: merge forward with a tournament tree instead of a
+  // binary heap (see ColumnFamilyOptions::merge_with_tournament_tree).
   explicit MergeIteratorBuilder(const InternalKeyComparator* comparator,
                                 Arena* arena, bool prefix_seek_mode = false,
-                                const Slice* iterate_upper_bound = nullptr);
+                                const Slice* iterate_upper_bound = nullptr,
+                                bool use_tournament_tree = false);
   ~MergeIteratorBuilder();
 
   // Add point key iterator `iter` to the merging iterator.
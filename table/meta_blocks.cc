@@ -160,6 +160,9 @@ void PropertyBlockBuilder::AddTableProperty(const TableProperties& props) {
   if (!props.compression_options.empty()) {
     Add(TablePropertiesNames::kCompressionOptions, props.compression_options);
   }
+  if (!props.compressor_name.empty()) {
+    Add(TablePropertiesNames::kCompressor, props.compressor_name);
+  }
   if (!props.seqno_to_time_mapping.empty()) {
     Add(TablePropertiesNames::kSequenceNumberTimeMapping,
         props.seqno_to_time_mapping);
@@ -450,6 +453,8 @@ Status ReadTablePropertiesHelper(
         new_table_properties->compression_name = raw_val.ToString();
       } else if (key == TablePropertiesNames::kCompressionOptions) {
         new_table_properties->compression_options = raw_val.ToString();
+      } else if (key == TablePropertiesNames::kCompressor) {
+        new_table_properties->compressor_name = raw_val.ToString();
       } else if (key == TablePropertiesNames::kSequenceNumberTimeMapping) {
         new_table_properties->seqno_to_time_mapping = raw_val.ToString();
       } else {
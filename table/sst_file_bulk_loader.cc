@@ -0,0 +1,464 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "file/random_access_file_reader.h"
+#include "file/writable_file_writer.h"
+#include "options/cf_options.h"
+#include "port/port.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/sst_partitioner.h"
+#include "rocksdb/table.h"
+#include "table/merging_iterator.h"
+#include "table/table_builder.h"
+#include "table/table_reader.h"
+#include "test_util/sync_point.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The entries added since the last spill are buffered in `buffer`. A spill
+// sorts them and writes them to a run, a plain table of internal keys with
+// the sequence number of the run, so that when the runs are merged, the
+// entry of a later run comes first among those with the same user key.
+//
+// While spilling, a user key is sampled after every `sample_interval` bytes.
+// The sorted samples divide the key space into ranges of about
+// `target_file_size` bytes, each of which is a task for the threads building
+// the output files.
+struct SstFileBulkLoader::Rep {
+  Rep(const EnvOptions& _env_options, const Options& _options,
+      const SstFileBulkLoaderOptions& _loader_options)
+      : env_options(_env_options),
+        options(_options),
+        loader_options(_loader_options),
+        user_comparator(_options.comparator),
+        internal_comparator(_options.comparator),
+        fs(_options.env->GetFileSystem()),
+        file_prefix("/bulk_load_" + _options.env->GenerateUniqueId()),
+        sample_interval(std::max<uint64_t>(
+            _loader_options.target_file_size / kSamplesPerTask, 1)) {
+    if (loader_options.spill_dir.empty()) {
+      loader_options.spill_dir = loader_options.output_dir;
+    }
+    // Runs are read once, sequentially, so they need no compression, filters
+    // or caching.
+    Options run_options = options;
+    BlockBasedTableOptions table_options;
+    table_options.no_block_cache = true;
+    run_options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    run_options.compression = kNoCompression;
+    run_options.bottommost_compression = kDisableCompressionOption;
+    run_options.compression_per_level.clear();
+    run_options.prefix_extractor = nullptr;
+    run_options.table_properties_collector_factories.clear();
+    run_options.file_checksum_gen_factory = nullptr;
+    run_ioptions.reset(new ImmutableOptions(run_options));
+    run_moptions.reset(new MutableCFOptions(run_options));
+  }
+
+  struct Entry {
+    size_t offset;
+    size_t key_size;
+    size_t value_size;
+  };
+
+  struct Run {
+    std::string path;
+    std::unique_ptr<TableReader> reader;
+  };
+
+  static constexpr uint64_t kSamplesPerTask = 16;
+
+  std::string RunFileName(size_t run) const;
+  std::string OutputFileName(size_t task, size_t file) const;
+
+  Slice KeyOf(const Entry& entry) const {
+    return Slice(buffer.data() + entry.offset, entry.key_size);
+  }
+  Slice ValueOf(const Entry& entry) const {
+    return Slice(buffer.data() + entry.offset + entry.key_size,
+                 entry.value_size);
+  }
+
+  // Sorts the buffered entries and writes them to a new run.
+  Status SpillRun();
+
+  Status OpenRun(Run* run);
+
+  // Returns the user keys dividing the key space into tasks, in order.
+  std::vector<std::string> PickBoundaries();
+
+  // Writes the entries with user keys in [begin, end) to output files. Null
+  // `begin` or `end` means the range is unbounded on that side.
+  Status BuildRange(size_t task, const std::string* begin,
+                    const std::string* end,
+                    std::vector<ExternalSstFileInfo>* files);
+
+  static Status FinishFile(SstFileWriter* writer,
+                           std::vector<ExternalSstFileInfo>* files);
+
+  void DeleteRuns();
+
+  const EnvOptions env_options;
+  const Options options;
+  SstFileBulkLoaderOptions loader_options;
+  const Comparator* const user_comparator;
+  const InternalKeyComparator internal_comparator;
+  const std::shared_ptr<FileSystem> fs;
+  // Unique to this loader, so that loaders can share directories
+  const std::string file_prefix;
+  const uint64_t sample_interval;
+  std::unique_ptr<ImmutableOptions> run_ioptions;
+  std::unique_ptr<MutableCFOptions> run_moptions;
+
+  std::string buffer;
+  std::vector<Entry> entries;
+  std::vector<Run> runs;
+  std::vector<std::string> samples;
+  uint64_t bytes_since_sample = 0;
+  bool finished = false;
+};
+
+std::string SstFileBulkLoader::Rep::RunFileName(size_t run) const {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "_run_%06zu.sst", run);
+  return loader_options.spill_dir + file_prefix + buf;
+}
+
+std::string SstFileBulkLoader::Rep::OutputFileName(size_t task,
+                                                   size_t file) const {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "_%06zu_%04zu.sst", task, file);
+  return loader_options.output_dir + file_prefix + buf;
+}
+
+Status SstFileBulkLoader::Rep::SpillRun() {
+  if (entries.empty()) {
+    return Status::OK();
+  }
+  // Among entries with the same key, the one added last comes first, and the
+  // others are skipped below.
+  std::sort(entries.begin(), entries.end(),
+            [this](const Entry& a, const Entry& b) {
+              int cmp = user_comparator->Compare(KeyOf(a), KeyOf(b));
+              return cmp < 0 || (cmp == 0 && a.offset > b.offset);
+            });
+
+  runs.emplace_back();
+  Run* run = &runs.back();
+  run->path = RunFileName(runs.size() - 1);
+  const SequenceNumber seq = runs.size();
+
+  FileOptions file_options(env_options);
+  std::unique_ptr<FSWritableFile> file;
+  Status s = fs->NewWritableFile(run->path, file_options, &file, nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  WritableFileWriter file_writer(std::move(file), run->path, file_options);
+
+  InternalTblPropCollFactories internal_tbl_prop_coll_factories;
+  TableBuilderOptions table_builder_options(
+      *run_ioptions, *run_moptions, ReadOptions(), WriteOptions(),
+      internal_comparator, &internal_tbl_prop_coll_factories, kNoCompression,
+      CompressionOptions(),
+      TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
+      "" /* column_family_name */, -1 /* level */, kUnknownNewestKeyTime,
+      false /* is_bottommost */, TableFileCreationReason::kMisc);
+  table_builder_options.skip_filters = true;
+  std::unique_ptr<TableBuilder> builder(
+      run_moptions->table_factory->NewTableBuilder(table_builder_options,
+                                                   &file_writer));
+
+  InternalKey ikey;
+  const Entry* prev = nullptr;
+  for (const Entry& entry : entries) {
+    const Slice key = KeyOf(entry);
+    if (prev != nullptr && user_comparator->Equal(key, KeyOf(*prev))) {
+      continue;
+    }
+    prev = &entry;
+    ikey.Set(key, seq, kTypeValue);
+    builder->Add(ikey.Encode(), ValueOf(entry));
+    if (!builder->status().ok()) {
+      break;
+    }
+    bytes_since_sample += entry.key_size + entry.value_size;
+    if (bytes_since_sample >= sample_interval) {
+      samples.emplace_back(key.data(), key.size());
+      bytes_since_sample = 0;
+    }
+  }
+  s = builder->status();
+  if (s.ok()) {
+    s = builder->Finish();
+  } else {
+    builder->Abandon();
+  }
+  if (s.ok()) {
+    s = file_writer.Close(IOOptions());
+  }
+
+  buffer.clear();
+  entries.clear();
+  return s;
+}
+
+Status SstFileBulkLoader::Rep::OpenRun(Run* run) {
+  FileOptions file_options(env_options);
+  uint64_t file_size = 0;
+  Status s = fs->GetFileSize(run->path, file_options.io_options, &file_size,
+                             nullptr);
+  std::unique_ptr<FSRandomAccessFile> file;
+  if (s.ok()) {
+    s = fs->NewRandomAccessFile(run->path, file_options, &file, nullptr);
+  }
+  if (s.ok()) {
+    std::unique_ptr<RandomAccessFileReader> file_reader(
+        new RandomAccessFileReader(std::move(file), run->path));
+    TableReaderOptions table_reader_options(
+        *run_ioptions, nullptr /* prefix_extractor */, env_options,
+        internal_comparator, run_moptions->block_protection_bytes_per_key,
+        true /* skip_filters */);
+    table_reader_options.largest_seqno = runs.size();
+    s = run_moptions->table_factory->NewTableReader(
+        table_reader_options, std::move(file_reader), file_size,
+        &run->reader);
+  }
+  return s;
+}
+
+std::vector<std::string> SstFileBulkLoader::Rep::PickBoundaries() {
+  std::sort(samples.begin(), samples.end(),
+            [this](const std::string& a, const std::string& b) {
+              return user_comparator->Compare(a, b) < 0;
+            });
+  std::vector<std::string> boundaries;
+  for (size_t i = kSamplesPerTask; i < samples.size(); i += kSamplesPerTask) {
+    if (boundaries.empty() ||
+        user_comparator->Compare(samples[i], boundaries.back()) > 0) {
+      boundaries.push_back(std::move(samples[i]));
+    }
+  }
+  samples.clear();
+  return boundaries;
+}
+
+Status SstFileBulkLoader::Rep::BuildRange(
+    size_t task, const std::string* begin, const std::string* end,
+    std::vector<ExternalSstFileInfo>* files) {
+  ReadOptions read_options;
+  read_options.fill_cache = false;
+  read_options.verify_checksums = true;
+  std::vector<InternalIterator*> children;
+  children.reserve(runs.size());
+  for (const Run& run : runs) {
+    children.push_back(run.reader->NewIterator(
+        read_options, nullptr /* prefix_extractor */, nullptr /* arena */,
+        true /* skip_filters */, TableReaderCaller::kSSTFileReader,
+        options.compaction_readahead_size));
+  }
+  std::unique_ptr<InternalIterator> iter(
+      NewMergingIterator(&internal_comparator, children.data(),
+                         static_cast<int>(children.size())));
+
+  std::unique_ptr<SstPartitioner> partitioner;
+  if (options.sst_partitioner_factory != nullptr) {
+    SstPartitioner::Context context;
+    context.is_full_compaction = true;
+    context.is_manual_compaction = true;
+    context.output_level = options.num_levels - 1;
+    context.smallest_user_key = begin != nullptr ? Slice(*begin) : Slice();
+    context.largest_user_key = end != nullptr ? Slice(*end) : Slice();
+    partitioner = options.sst_partitioner_factory->CreatePartitioner(context);
+  }
+
+  if (begin != nullptr) {
+    InternalKey seek_key(*begin, kMaxSequenceNumber, kValueTypeForSeek);
+    iter->Seek(seek_key.Encode());
+  } else {
+    iter->SeekToFirst();
+  }
+
+  Status s;
+  std::unique_ptr<SstFileWriter> writer;
+  std::string path;
+  uint64_t file_bytes = 0;
+  std::string prev_key;
+  bool has_prev_key = false;
+  for (; iter->Valid(); iter->Next()) {
+    const Slice key = ExtractUserKey(iter->key());
+    if (end != nullptr && user_comparator->Compare(key, *end) >= 0) {
+      break;
+    }
+    if (has_prev_key && user_comparator->Equal(key, prev_key)) {
+      // Added to an earlier run, and overwritten by a later one
+      continue;
+    }
+    if (writer != nullptr &&
+        (file_bytes >= loader_options.target_file_size ||
+         (partitioner != nullptr &&
+          partitioner->ShouldPartition(PartitionerRequest(
+              prev_key, key, writer->FileSize())) == kRequired))) {
+      s = FinishFile(writer.get(), files);
+      if (!s.ok()) {
+        break;
+      }
+      writer.reset();
+    }
+    if (writer == nullptr) {
+      writer.reset(new SstFileWriter(env_options, options));
+      path = OutputFileName(task, files->size());
+      s = writer->Open(path);
+      if (!s.ok()) {
+        break;
+      }
+      file_bytes = 0;
+    }
+    s = writer->Put(key, iter->value());
+    TEST_SYNC_POINT_CALLBACK("SstFileBulkLoader::BuildRange:Put", &s);
+    if (!s.ok()) {
+      break;
+    }
+    file_bytes += key.size() + iter->value().size();
+    prev_key.assign(key.data(), key.size());
+    has_prev_key = true;
+  }
+  if (s.ok()) {
+    s = iter->status();
+  }
+  if (s.ok() && writer != nullptr) {
+    s = FinishFile(writer.get(), files);
+  }
+  if (!s.ok() && writer != nullptr) {
+    // The file being written is not in `files`, which Finish() deletes
+    writer.reset();
+    fs->DeleteFile(path, IOOptions(), nullptr).PermitUncheckedError();
+  }
+  return s;
+}
+
+Status SstFileBulkLoader::Rep::FinishFile(
+    SstFileWriter* writer, std::vector<ExternalSstFileInfo>* files) {
+  ExternalSstFileInfo file_info;
+  Status s = writer->Finish(&file_info);
+  if (s.ok()) {
+    files->push_back(std::move(file_info));
+  }
+  return s;
+}
+
+void SstFileBulkLoader::Rep::DeleteRuns() {
+  for (Run& run : runs) {
+    run.reader.reset();
+    fs->DeleteFile(run.path, IOOptions(), nullptr).PermitUncheckedError();
+  }
+  runs.clear();
+}
+
+SstFileBulkLoader::SstFileBulkLoader(
+    const EnvOptions& env_options, const Options& options,
+    const SstFileBulkLoaderOptions& loader_options)
+    : rep_(new Rep(env_options, options, loader_options)) {}
+
+SstFileBulkLoader::~SstFileBulkLoader() { rep_->DeleteRuns(); }
+
+Status SstFileBulkLoader::Put(const Slice& user_key, const Slice& value) {
+  Rep* r = rep_.get();
+  if (r->finished) {
+    return Status::InvalidArgument("SstFileBulkLoader is finished");
+  }
+  if (r->user_comparator->timestamp_size() > 0) {
+    return Status::NotSupported(
+        "SstFileBulkLoader does not support user-defined timestamps");
+  }
+  if (!r->entries.empty() &&
+      r->buffer.size() + user_key.size() + value.size() >
+          r->loader_options.sort_buffer_size) {
+    Status s = r->SpillRun();
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  r->entries.push_back({r->buffer.size(), user_key.size(), value.size()});
+  r->buffer.append(user_key.data(), user_key.size());
+  r->buffer.append(value.data(), value.size());
+  return Status::OK();
+}
+
+Status SstFileBulkLoader::Finish(std::vector<ExternalSstFileInfo>* files) {
+  Rep* r = rep_.get();
+  files->clear();
+  if (r->finished) {
+    return Status::InvalidArgument("SstFileBulkLoader is finished");
+  }
+  r->finished = true;
+
+  Status s = r->SpillRun();
+  for (size_t i = 0; s.ok() && i < r->runs.size(); ++i) {
+    s = r->OpenRun(&r->runs[i]);
+  }
+  if (s.ok() && !r->runs.empty()) {
+    const std::vector<std::string> boundaries = r->PickBoundaries();
+    const size_t num_tasks = boundaries.size() + 1;
+    std::vector<std::vector<ExternalSstFileInfo>> task_files(num_tasks);
+    std::vector<Status> task_status(num_tasks);
+    std::atomic<size_t> next_task{0};
+    auto work = [&]() {
+      for (;;) {
+        const size_t task = next_task.fetch_add(1);
+        if (task >= num_tasks) {
+          break;
+        }
+        task_status[task] = r->BuildRange(
+            task, task > 0 ? &boundaries[task - 1] : nullptr,
+            task < boundaries.size() ? &boundaries[task] : nullptr,
+            &task_files[task]);
+        if (!task_status[task].ok()) {
+          // Skip the remaining tasks
+          next_task.store(num_tasks);
+        }
+      }
+    };
+    const size_t num_threads = std::min(
+        num_tasks,
+        static_cast<size_t>(std::max(r->loader_options.num_threads, 1)));
+    std::vector<port::Thread> threads;
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (size_t task = 0; task < num_tasks; ++task) {
+      if (s.ok()) {
+        s = task_status[task];
+      } else {
+        task_status[task].PermitUncheckedError();
+      }
+      for (auto& file : task_files[task]) {
+        files->push_back(std::move(file));
+      }
+    }
+    if (!s.ok()) {
+      for (const auto& file : *files) {
+        r->fs->DeleteFile(file.file_path, IOOptions(), nullptr)
+            .PermitUncheckedError();
+      }
+      files->clear();
+    }
+  }
+  r->DeleteRuns();
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -137,6 +137,10 @@ std::string TableProperties::ToString(const std::string& prop_delim,
       compression_options.empty() ? std::string("N/A") : compression_options,
       prop_delim, kv_delim);
 
+  AppendProperty(result, "SST file compressor",
+                 compressor_name.empty() ? std::string("N/A") : compressor_name,
+                 prop_delim, kv_delim);
+
   AppendProperty(result, "creation time", creation_time, prop_delim, kv_delim);
 
   AppendProperty(result, "time stamp of earliest key", oldest_key_time,
@@ -240,7 +244,8 @@ std::size_t TableProperties::ApproximateMemoryUsage() const {
       column_family_name.size() + filter_policy_name.size() +
       comparator_name.size() + merge_operator_name.size() +
       prefix_extractor_name.size() + property_collectors_names.size() +
-      compression_name.size() + compression_options.size();
+      compression_name.size() + compression_options.size() +
+      compressor_name.size();
   usage += string_props_mem_usage;
 
   for (auto iter = user_collected_properties.begin();
@@ -301,6 +306,7 @@ const std::string TablePropertiesNames::kPropertyCollectors =
 const std::string TablePropertiesNames::kCompression = "rocksdb.compression";
 const std::string TablePropertiesNames::kCompressionOptions =
     "rocksdb.compression_options";
+const std::string TablePropertiesNames::kCompressor = "rocksdb.compressor";
 const std::string TablePropertiesNames::kCreationTime = "rocksdb.creation.time";
 const std::string TablePropertiesNames::kOldestKeyTime =
     "rocksdb.oldest.key.time";
@@ -466,6 +472,9 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"compression_options",
          {offsetof(struct TableProperties, compression_options),
           OptionType::kEncodedString}},
+        {"compressor_name",
+         {offsetof(struct TableProperties, compressor_name),
+          OptionType::kEncodedString}},
         {"seqno_to_time_mapping",
          {offsetof(struct TableProperties, seqno_to_time_mapping),
           OptionType::kEncodedString}},
@@ -510,7 +519,7 @@ bool TableProperties::AreEqual(const ConfigOptions& opts,
 //    ...
 //    ... std::string properties only
 //    ...
-//    std::string compression_options;
+//    std::string compressor_name;
 //    UserCollectedProperties user_collected_properties;
 //    ...
 //    ... Other extra properties: non-int64_t/non-std::string properties only
@@ -527,7 +536,7 @@ void TEST_SetRandomTableProperties(TableProperties* props) {
   // in the for-loop to avoid advancing pointer to pointing to
   // potential non-zero padding bytes between these two addresses due to
   // user_collected_properties's alignment requirement
-  const std::string* const ps_end_inclusive = &props->compression_options;
+  const std::string* const ps_end_inclusive = &props->compressor_name;
 
   for (; pu < pu_end; ++pu) {
     *pu = r->Next64();
@@ -146,6 +146,17 @@ class TableReader {
     return Status::NotSupported();
   }
 
+  // Issue readahead hints for the data blocks that may contain the keys in
+  // mget_range, so that a later MultiGet() finds them in the OS page cache.
+  // Like MultiGetFilter(), mget_range is updated to skip keys that get a
+  // negative filter result, leaving only the keys likely to be found in this
+  // file. No data blocks are read or added to the block cache.
+  virtual Status MultiGetPrefetch(const ReadOptions& /*readOptions*/,
+                                  const SliceTransform* /*prefix_extractor*/,
+                                  MultiGetContext::Range* /*mget_range*/) {
+    return Status::NotSupported();
+  }
+
   virtual void MultiGet(const ReadOptions& readOptions,
                         const MultiGetContext::Range* mget_range,
                         const SliceTransform* prefix_extractor,
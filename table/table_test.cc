@@ -17,6 +17,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -57,6 +58,7 @@
 #include "table/block_based/block_builder.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/flush_block_policy_impl.h"
+#include "table/block_based/piecewise_linear_index.h"
 #include "table/block_fetcher.h"
 #include "table/format.h"
 #include "table/get_context.h"
@@ -2660,6 +2662,229 @@ TEST_P(BlockBasedTableTest, HashIndexTest) {
   IndexTest(table_options);
 }
 
+TEST_P(BlockBasedTableTest, PiecewiseLinearIndexTest) {
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.piecewise_linear_index = true;
+  IndexTest(table_options);
+}
+
+TEST_P(BlockBasedTableTest, PiecewiseLinearIndexSeek) {
+  Random rnd(301);
+  std::set<std::string> user_keys;
+  // Increasing big-endian IDs that the model fits well, ...
+  for (uint64_t i = 0; i < 3000; ++i) {
+    std::string key;
+    PutFixed64(&key, EndianSwapValue(i * 1000 + rnd.Uniform(1000)));
+    user_keys.insert(key);
+  }
+  // ... a jump, keys too short for the model to distinguish, ...
+  for (uint64_t i = 0; i < 500; ++i) {
+    std::string key;
+    PutFixed64(&key, EndianSwapValue((uint64_t{1} << 62) + i * i * i));
+    user_keys.insert(key);
+    user_keys.insert(std::string(2, '\x7f') + std::to_string(i));
+  }
+  // ... and keys whose first 8 bytes all tie.
+  for (uint64_t i = 0; i < 500; ++i) {
+    user_keys.insert(std::string(8, '\xff') + std::to_string(i));
+  }
+
+  for (int restart_interval : {1, 3}) {
+    SCOPED_TRACE("index_block_restart_interval=" +
+                 std::to_string(restart_interval));
+    TableConstructor c(BytewiseComparator());
+    for (const auto& user_key : user_keys) {
+      c.Add(InternalKey(user_key, 0, kTypeValue).Encode().ToString(),
+            rnd.RandomString(100));
+    }
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.piecewise_linear_index = true;
+    table_options.index_block_restart_interval = restart_interval;
+    table_options.block_size = 256;
+    Options options;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+    size_t num_segments = 0;
+    SyncPoint::GetInstance()->SetCallBack(
+        "PiecewiseLinearIndexReader::Create:Model", [&](void* arg) {
+          num_segments =
+              static_cast<PiecewiseLinearIndexModel*>(arg)->num_segments();
+        });
+    SyncPoint::GetInstance()->EnableProcessing();
+
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    const InternalKeyComparator ikc(BytewiseComparator());
+    c.Finish(options, ioptions, moptions, table_options, ikc, &keys, &kvmap);
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    ASSERT_GT(num_segments, 0);
+
+    std::unique_ptr<InternalIterator> iter(c.GetTableReader()->NewIterator(
+        ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+        /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    auto check_seek = [&](const std::string& target) {
+      iter->Seek(InternalKey(target, kMaxSequenceNumber, kValueTypeForSeek)
+                     .Encode());
+      ASSERT_OK(iter->status());
+      auto expected = user_keys.lower_bound(target);
+      if (expected == user_keys.end()) {
+        ASSERT_FALSE(iter->Valid());
+      } else {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*expected, ExtractUserKey(iter->key()).ToString());
+      }
+    };
+    for (const auto& user_key : user_keys) {
+      check_seek(user_key);
+      check_seek(user_key + '\0');
+    }
+    for (int i = 0; i < 10000; ++i) {
+      std::string target;
+      PutFixed64(&target, rnd.Next64());
+      target.resize(rnd.Uniform(10));
+      check_seek(target);
+    }
+  }
+}
+
+TEST_P(BlockBasedTableTest, PiecewiseLinearIndexNotWorthStoring) {
+  // Keys whose first 8 bytes all tie give the model nothing to go on, so the
+  // table is written without it.
+  TableConstructor c(BytewiseComparator());
+  for (int i = 0; i < 1000; ++i) {
+    c.Add(InternalKey("prefix__" + std::to_string(10000 + i), 0, kTypeValue)
+              .Encode()
+              .ToString(),
+          "value");
+  }
+  BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+  table_options.piecewise_linear_index = true;
+  table_options.block_size = 64;
+  Options options;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  bool model_loaded = false;
+  SyncPoint::GetInstance()->SetCallBack(
+      "PiecewiseLinearIndexReader::Create:Model",
+      [&](void* /*arg*/) { model_loaded = true; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  const InternalKeyComparator ikc(BytewiseComparator());
+  c.Finish(options, ioptions, moptions, table_options, ikc, &keys, &kvmap);
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_FALSE(model_loaded);
+
+  std::unique_ptr<InternalIterator> iter(c.GetTableReader()->NewIterator(
+      ReadOptions(), moptions.prefix_extractor.get(), /*arena=*/nullptr,
+      /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+  iter->Seek(InternalKey("prefix__10500", kMaxSequenceNumber, kValueTypeForSeek)
+                 .Encode());
+  ASSERT_OK(iter->status());
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("prefix__10500", ExtractUserKey(iter->key()).ToString());
+}
+
+TEST_P(BlockBasedTableTest, RangeFilter) {
+  Random rnd(301);
+  // Clusters of keys sharing 5-byte prefixes, with gaps between them
+  std::set<std::string> user_keys;
+  for (int i = 0; i < 100; ++i) {
+    const std::string cluster = "k" + std::to_string(1000 + i * 7);
+    for (int j = 0; j < 20; ++j) {
+      user_keys.insert(cluster + rnd.RandomString(rnd.Uniform(12)));
+    }
+  }
+  // Keys shorter than the prefixes
+  user_keys.insert("k1");
+  user_keys.insert("k2");
+
+  for (uint32_t prefix_len : {3, 5, 8}) {
+    SCOPED_TRACE("range_filter_prefix_len=" + std::to_string(prefix_len));
+    TableConstructor c(BytewiseComparator());
+    for (const auto& user_key : user_keys) {
+      c.Add(InternalKey(user_key, 0, kTypeValue).Encode().ToString(),
+            rnd.RandomString(100));
+    }
+    BlockBasedTableOptions table_options = GetBlockBasedTableOptions();
+    table_options.range_filter_prefix_len = prefix_len;
+    table_options.block_size = 256;
+    Options options;
+    options.statistics = CreateDBStatistics();
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableOptions ioptions(options);
+    const MutableCFOptions moptions(options);
+    const InternalKeyComparator ikc(BytewiseComparator());
+    c.Finish(options, ioptions, moptions, table_options, ikc, &keys, &kvmap);
+    ASSERT_NE(static_cast<BlockBasedTable*>(c.GetTableReader())
+                  ->get_rep()
+                  ->range_filter,
+              nullptr);
+
+    // The range filter does not depend on a prefix extractor, nor on prefix
+    // seek
+    ASSERT_EQ(moptions.prefix_extractor, nullptr);
+    Slice upper_bound;
+    ReadOptions read_options;
+    read_options.iterate_upper_bound = &upper_bound;
+    read_options.total_order_seek = true;
+    std::unique_ptr<InternalIterator> iter(c.GetTableReader()->NewIterator(
+        read_options, /*prefix_extractor=*/nullptr, /*arena=*/nullptr,
+        /*skip_filters=*/false, TableReaderCaller::kUncategorized));
+    auto num_filtered = [&]() {
+      return options.statistics->getTickerCount(LAST_LEVEL_SEEK_FILTERED) +
+             options.statistics->getTickerCount(NON_LAST_LEVEL_SEEK_FILTERED);
+    };
+    auto check_seek = [&](const std::string& begin, const std::string& end) {
+      upper_bound = end;
+      iter->Seek(
+          InternalKey(begin, kMaxSequenceNumber, kValueTypeForSeek).Encode());
+      ASSERT_OK(iter->status());
+      auto expected = user_keys.lower_bound(begin);
+      if (expected != user_keys.end() && *expected < end) {
+        ASSERT_TRUE(iter->Valid());
+        ASSERT_EQ(*expected, ExtractUserKey(iter->key()).ToString());
+      } else if (iter->Valid()) {
+        // Not filtered out, but the key is out of bound
+        ASSERT_EQ(*expected, ExtractUserKey(iter->key()).ToString());
+      }
+    };
+
+    // An empty range within a gap between clusters
+    const uint64_t filtered_before = num_filtered();
+    check_seek("k1003", "k1005");
+    ASSERT_EQ(num_filtered(), filtered_before + (prefix_len >= 5 ? 1 : 0));
+    // Non-empty ranges are never filtered out
+    check_seek("k1000", "k1001");
+    check_seek("k1", "k1000");
+    check_seek("k1", "k1\xff");
+    check_seek("k0", "k10");
+    ASSERT_EQ(num_filtered(), filtered_before + (prefix_len >= 5 ? 1 : 0));
+
+    for (const auto& user_key : user_keys) {
+      check_seek(user_key, user_key + '\0');
+      check_seek(user_key + '\0', user_key + "\xff");
+    }
+    for (int i = 0; i < 10000; ++i) {
+      std::string begin = "k" + std::to_string(rnd.Uniform(2000));
+      begin += rnd.RandomString(rnd.Uniform(4));
+      std::string end = begin;
+      end.back() = static_cast<char>(end.back() + 1 + rnd.Uniform(3));
+      check_seek(begin, end);
+    }
+  }
+}
+
 TEST_P(BlockBasedTableTest, PartitionIndexTest) {
   const int max_index_keys = 5;
   const int est_max_index_key_value_size = 32;
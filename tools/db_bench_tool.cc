@@ -27,6 +27,7 @@
 #ifdef __FreeBSD__
 #include <sys/sysctl.h>
 #endif
+#include <array>
 #include <atomic>
 #include <cinttypes>
 #include <condition_variable>
@@ -48,6 +49,7 @@
 #include "port/port.h"
 #include "port/stack_trace.h"
 #include "rocksdb/cache.h"
+#include "rocksdb/compressor.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
@@ -503,6 +505,13 @@ DEFINE_int32(num_low_pri_threads, 0,
              "The maximum number of concurrent background compactions"
              " that can occur in parallel.");
 
+DEFINE_int32(high_pri_threads_stealing_low_pri_jobs, 0,
+             "The maximum number of high-priority threads that may run jobs "
+             "queued in the low-priority thread pool while they are idle. "
+             "One high-priority thread never steals, so this has no effect "
+             "unless the high-priority pool has at least 2 threads, see "
+             "-num_high_pri_threads. See Env::SetThreadPoolWorkStealing().");
+
 DEFINE_int32(max_background_compactions,
              ROCKSDB_NAMESPACE::Options().max_background_compactions,
              "The maximum number of concurrent background compactions"
@@ -582,6 +591,14 @@ DEFINE_double(cache_low_pri_pool_ratio, 0.0,
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_bool(cache_numa_aware, false,
+            "Use a separate group of LRU cache shards for each NUMA node. "
+            "Requires building with NUMA support.");
+
+DEFINE_bool(cache_numa_replicate_entries, true,
+            "With cache_numa_aware, cache entries used from more than one "
+            "NUMA node separately for each node.");
+
 DEFINE_bool(use_compressed_secondary_cache, false,
             "Use the CompressedSecondaryCache as the secondary cache.");
 
@@ -659,6 +676,11 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(piecewise_linear_index,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions().piecewise_linear_index,
+            "Store a piecewise-linear model of the index keys to narrow index "
+            "lookups (see BlockBasedTableOptions)");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -715,6 +737,10 @@ DEFINE_bool(
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().enable_index_compression,
     "Compress the index block");
 
+DEFINE_string(compressor, "",
+              "If set, the BlockBasedTableOptions::compressor choosing the "
+              "compression type of each block, e.g. AutoSkipCompressor");
+
 DEFINE_bool(block_align,
             ROCKSDB_NAMESPACE::BlockBasedTableOptions().block_align,
             "Align data blocks on page size");
@@ -739,6 +765,12 @@ DEFINE_double(data_block_hash_table_util_ratio, 0.75,
               "This is only valid if use_data_block_hash_index is "
               "set to true");
 
+DEFINE_bool(data_block_restart_key_prefixes,
+            ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                .data_block_restart_key_prefixes,
+            "Build restart key prefix arrays for data blocks loaded into "
+            "memory to speed up seeks within cached blocks");
+
 DEFINE_int64(compressed_cache_size, -1,
              "Number of bytes to use as a cache of compressed data.");
 
@@ -755,6 +787,16 @@ DEFINE_int32(file_opening_threads,
              "If open_files is set to -1, this option set the number of "
              "threads that will be used to open files during DB::Open()");
 
+DEFINE_bool(use_table_tail_snapshot,
+            ROCKSDB_NAMESPACE::Options().use_table_tail_snapshot,
+            "Persist the tails of the table files in a snapshot to open the "
+            "table readers from during DB::Open()");
+
+DEFINE_uint64(table_tail_snapshot_period_sec,
+              ROCKSDB_NAMESPACE::Options().table_tail_snapshot_period_sec,
+              "Period in seconds to write the table tail snapshot at, "
+              "0 to only write it when the DB is closed");
+
 DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
@@ -785,6 +827,12 @@ DEFINE_bool(whole_key_filtering,
             ROCKSDB_NAMESPACE::BlockBasedTableOptions().whole_key_filtering,
             "Use whole keys (in addition to prefixes) in SST bloom filter.");
 
+DEFINE_uint32(
+    range_filter_prefix_len,
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions().range_filter_prefix_len,
+    "If non-zero, build SST range filters from key prefixes of this many "
+    "bytes, consulted by Seek with an upper bound");
+
 DEFINE_bool(use_existing_db, false,
             "If true, do not destroy the existing database.  If you set this "
             "flag and also specify a benchmark that wants a fresh database, "
@@ -955,6 +1003,11 @@ DEFINE_bool(force_consistency_checks,
             "Runs consistency checks on the LSM every time a change is "
             "applied.");
 
+DEFINE_bool(merge_with_tournament_tree,
+            ROCKSDB_NAMESPACE::Options().merge_with_tournament_tree,
+            "Merge iterator and compaction inputs with a tournament tree "
+            "instead of a binary heap.");
+
 DEFINE_uint64(delete_obsolete_files_period_micros, 0,
               "Ignored. Left here for backward compatibility");
 
@@ -1219,6 +1272,17 @@ DEFINE_bool(optimize_multiget_for_io, true,
             "When set true, RocksDB does asynchronous reads for SST files in "
             "multiple levels for MultiGet.");
 
+DEFINE_bool(prefetch_multiget_across_levels,
+            ROCKSDB_NAMESPACE::ReadOptions().prefetch_multiget_across_levels,
+            "When set true, MultiGet issues readahead hints for the data "
+            "blocks of all levels likely to hold each key before reading "
+            "them level by level.");
+
+DEFINE_uint64(min_memtable_value_size_to_pin,
+              ROCKSDB_NAMESPACE::ReadOptions().min_memtable_value_size_to_pin,
+              "Values of at least this size read from memtables by Get() are "
+              "pinned instead of copied. 0 disables pinning.");
+
 DEFINE_bool(charge_compression_dictionary_building_buffer, false,
             "Setting for "
             "CacheEntryRoleOptions::charged of "
@@ -1453,6 +1517,14 @@ DEFINE_int32(thread_status_per_interval, 0,
 DEFINE_int32(perf_level, ROCKSDB_NAMESPACE::PerfLevel::kDisable,
              "Level of perf collection");
 
+DEFINE_uint32(perf_stage_sample_rate, 0,
+              "If > 0, break down one in this many read or seek operations "
+              "into per-stage read path latencies (memtable, filter, index, "
+              "block cache, block read, decompression, merge) using "
+              "PerfContext timers, and report P50/P99/P99.9 of each stage for "
+              "benchmarks that read. Timing is only enabled for the sampled "
+              "operations unless --perf_level already enables it.");
+
 DEFINE_uint64(soft_pending_compaction_bytes_limit, 64ull * 1024 * 1024 * 1024,
               "Slowdown writes if pending compaction bytes exceed this number");
 
@@ -1466,6 +1538,11 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(enable_pipelined_write, true,
             "Allow WAL and memtable writes to be pipelined");
 
+DEFINE_bool(enable_pipelined_wal_sync,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_wal_sync,
+            "With enable_pipelined_write, sync the WAL in the memtable writer "
+            "stage so that the next write group can append meanwhile");
+
 DEFINE_bool(
     unordered_write, false,
     "Enable the unordered write feature, which provides higher throughput but "
@@ -1489,6 +1566,17 @@ DEFINE_uint64(inplace_update_num_locks,
 DEFINE_bool(enable_write_thread_adaptive_yield, true,
             "Use a yielding spin loop for brief writer thread waits.");
 
+DEFINE_int32(large_batch_memtable_insert_threads,
+             ROCKSDB_NAMESPACE::Options().large_batch_memtable_insert_threads,
+             "Maximum number of threads inserting a single large write batch "
+             "into the memtables.");
+
+DEFINE_uint64(
+    large_batch_memtable_insert_min_entries,
+    ROCKSDB_NAMESPACE::Options().large_batch_memtable_insert_min_entries,
+    "Minimum number of entries of a write batch for it to be inserted into "
+    "the memtables by multiple threads.");
+
 DEFINE_uint64(
     write_thread_max_yield_usec, 100,
     "Maximum microseconds for enable_write_thread_adaptive_yield operation.");
@@ -1633,6 +1721,11 @@ DEFINE_bool(advise_random_on_open,
 DEFINE_bool(use_tailing_iterator, false,
             "Use tailing iterator to access a series of keys instead of get");
 
+DEFINE_bool(recycle_iterator, ROCKSDB_NAMESPACE::ReadOptions().recycle_iterator,
+            "Reuse the iterator tree of the previous iterator created by the "
+            "same thread, when still current. See "
+            "ReadOptions::recycle_iterator.");
+
 DEFINE_bool(use_adaptive_mutex, ROCKSDB_NAMESPACE::Options().use_adaptive_mutex,
             "Use adaptive mutex");
 
@@ -1729,6 +1822,12 @@ DEFINE_uint64(stats_history_buffer_size,
 DEFINE_bool(avoid_flush_during_recovery,
             ROCKSDB_NAMESPACE::Options().avoid_flush_during_recovery,
             "If true, avoids flushing the recovered WAL data where possible.");
+DEFINE_bool(enable_pipelined_wal_recovery,
+            ROCKSDB_NAMESPACE::Options().enable_pipelined_wal_recovery,
+            "If true, reads and decodes WAL records on a separate thread "
+            "during recovery, ahead of memtable insertion, inserts the "
+            "updates to different column families in parallel and flushes "
+            "full memtables in the background.");
 DEFINE_int64(multiread_stride, 0,
              "Stride length for the keys in a MultiGet batch");
 DEFINE_bool(multiread_batched, false, "Use the new MultiGet API");
@@ -1824,6 +1923,9 @@ static Status CreateMemTableRepFactory(
   } else if (!strcasecmp(FLAGS_memtablerep.c_str(),
                          VectorRepFactory::kNickName())) {
     factory->reset(new VectorRepFactory());
+  } else if (!strcasecmp(FLAGS_memtablerep.c_str(),
+                         AdaptiveSkipListFactory::kNickName())) {
+    factory->reset(new AdaptiveSkipListFactory(FLAGS_skip_list_lookahead));
   } else if (!strcasecmp(FLAGS_memtablerep.c_str(), "hash_linkedlist")) {
     factory->reset(NewHashLinkListRepFactory(FLAGS_hash_bucket_count));
   } else {
@@ -2186,6 +2288,44 @@ static std::unordered_map<OperationType, std::string, std::hash<unsigned char>>
                            {kCrc, "crc"},           {kHash, "hash"},
                            {kOthers, "op"}};
 
+// Stages of the read path broken down by --perf_stage_sample_rate.
+enum ReadStage : unsigned char {
+  kStageMemtable = 0,
+  kStageFilter,
+  kStageIndex,
+  kStageBlockCache,
+  kStageBlockRead,
+  kStageDecompress,
+  kStageMerge,
+  kNumReadStages
+};
+
+static const std::array<const char*, kNumReadStages> ReadStageString = {
+    {"memtable", "filter", "index", "block_cache", "block_read", "decompress",
+     "merge"}};
+
+// Returns the thread's cumulative PerfContext nanos attributed to each
+// ReadStage. PerfContext has no timer dedicated to block cache lookups, so
+// that stage is whatever part of the SST lookup time is not covered by the
+// other SST stages (cache lookups, block seeks, table cache, etc.).
+static std::array<uint64_t, kNumReadStages> GetReadStageNanos() {
+  const PerfContext* ctx = get_perf_context();
+  std::array<uint64_t, kNumReadStages> nanos;
+  nanos[kStageMemtable] =
+      ctx->get_from_memtable_time + ctx->seek_on_memtable_time;
+  nanos[kStageFilter] = ctx->read_filter_block_nanos;
+  nanos[kStageIndex] = ctx->read_index_block_nanos;
+  nanos[kStageBlockRead] = ctx->block_read_time;
+  nanos[kStageDecompress] = ctx->block_decompress_time;
+  nanos[kStageMerge] = ctx->merge_operator_time_nanos;
+  uint64_t accounted = nanos[kStageFilter] + nanos[kStageIndex] +
+                       nanos[kStageBlockRead] + nanos[kStageDecompress];
+  nanos[kStageBlockCache] = ctx->get_from_output_files_time > accounted
+                                ? ctx->get_from_output_files_time - accounted
+                                : 0;
+  return nanos;
+}
+
 class CombinedStats;
 class Stats {
  private:
@@ -2204,6 +2344,11 @@ class Stats {
   std::unordered_map<OperationType, std::shared_ptr<HistogramImpl>,
                      std::hash<unsigned char>>
       hist_;
+  // Per-stage read path latencies, see --perf_stage_sample_rate
+  std::array<std::shared_ptr<HistogramImpl>, kNumReadStages> stage_hist_;
+  std::array<uint64_t, kNumReadStages> last_stage_nanos_;
+  uint64_t ops_since_stage_sample_;
+  bool stage_sampling_;
   std::string message_;
   bool exclude_from_merge_;
   ReporterAgent* reporter_agent_;  // does not own
@@ -2221,6 +2366,12 @@ class Stats {
     next_report_ = FLAGS_stats_interval ? FLAGS_stats_interval : 100;
     last_op_finish_ = start_;
     hist_.clear();
+    for (auto& h : stage_hist_) {
+      h = std::make_shared<HistogramImpl>();
+    }
+    last_stage_nanos_.fill(0);
+    ops_since_stage_sample_ = 0;
+    stage_sampling_ = false;
     done_ = 0;
     last_report_done_ = 0;
     bytes_ = 0;
@@ -2247,6 +2398,9 @@ class Stats {
         hist_.insert({it->first, it->second});
       }
     }
+    for (size_t i = 0; i < kNumReadStages; ++i) {
+      stage_hist_[i]->Merge(*other.stage_hist_[i]);
+    }
 
     done_ += other.done_;
     bytes_ += other.bytes_;
@@ -2310,6 +2464,43 @@ class Stats {
 
   uint64_t GetStart() { return start_; }
 
+  // Called after every FinishedOps() when --perf_stage_sample_rate is set.
+  // Only read and seek operations are broken down. If the one that just
+  // finished was sampled, records its per-stage breakdown, averaged over the
+  // `num_ops` operations of a batch, then decides whether to sample the next
+  // one. Other operations only move the baseline, so that their time is never
+  // attributed to a read. Unless --perf_level already enables timing,
+  // PerfContext timers are only turned on while a read is to be sampled so
+  // the rest run at full speed.
+  void SampleReadStages(int64_t num_ops, enum OperationType op_type) {
+    std::array<uint64_t, kNumReadStages> nanos = GetReadStageNanos();
+    const bool is_read = op_type == kRead || op_type == kSeek;
+    if (stage_sampling_ && is_read && num_ops > 0) {
+      for (size_t i = 0; i < kNumReadStages; ++i) {
+        // The benchmark may have reset the PerfContext in between.
+        uint64_t delta = nanos[i] >= last_stage_nanos_[i]
+                             ? nanos[i] - last_stage_nanos_[i]
+                             : nanos[i];
+        stage_hist_[i]->Add(delta / static_cast<uint64_t>(num_ops));
+      }
+    }
+    last_stage_nanos_ = nanos;
+    if (!is_read) {
+      return;
+    }
+
+    ops_since_stage_sample_ += static_cast<uint64_t>(std::max<int64_t>(
+        num_ops, 1));
+    stage_sampling_ = ops_since_stage_sample_ >= FLAGS_perf_stage_sample_rate;
+    if (stage_sampling_) {
+      ops_since_stage_sample_ = 0;
+    }
+    if (FLAGS_perf_level < PerfLevel::kEnableTimeExceptForMutex) {
+      SetPerfLevel(stage_sampling_ ? PerfLevel::kEnableTimeExceptForMutex
+                                   : static_cast<PerfLevel>(FLAGS_perf_level));
+    }
+  }
+
   void ResetLastOpTime() {
     // Set to now to avoid latency from calls to SleepForMicroseconds.
     last_op_finish_ = clock_->NowMicros();
@@ -2320,6 +2511,9 @@ class Stats {
     if (reporter_agent_) {
       reporter_agent_->ReportFinishedOps(num_ops);
     }
+    if (FLAGS_perf_stage_sample_rate > 0) {
+      SampleReadStages(num_ops, op_type);
+    }
     if (FLAGS_histogram) {
       uint64_t now = clock_->NowMicros();
       uint64_t micros = now - last_op_finish_;
@@ -2475,6 +2669,22 @@ class Stats {
                 it->second->ToString().c_str());
       }
     }
+    // Only benchmarks that read have samples
+    if (FLAGS_perf_stage_sample_rate > 0 &&
+        stage_hist_[kStageMemtable]->num() > 0) {
+      fprintf(stdout,
+              "Read path stage nanos (%" PRIu64 " sampled ops, 1 in %" PRIu32
+              "):\n",
+              stage_hist_[kStageMemtable]->num(),
+              FLAGS_perf_stage_sample_rate);
+      for (size_t i = 0; i < kNumReadStages; ++i) {
+        fprintf(stdout,
+                "%-12s : P50: %.2f P99: %.2f P99.9: %.2f Average: %.2f\n",
+                ReadStageString[i], stage_hist_[i]->Median(),
+                stage_hist_[i]->Percentile(99.0),
+                stage_hist_[i]->Percentile(99.9), stage_hist_[i]->Average());
+      }
+    }
     if (FLAGS_report_file_operations) {
       auto* counted_fs =
           FLAGS_env->GetFileSystem()->CheckedCast<CountedFileSystem>();
@@ -3198,6 +3408,8 @@ class Benchmark {
           GetCacheAllocator(), kDefaultToAdaptiveMutex,
           kDefaultCacheMetadataChargePolicy, FLAGS_cache_low_pri_pool_ratio);
       opts.hash_seed = GetCacheHashSeed();
+      opts.numa_aware = FLAGS_cache_numa_aware;
+      opts.numa_replicate_entries = FLAGS_cache_numa_replicate_entries;
       if (use_tiered_cache) {
         TieredCacheOptions tiered_opts;
         tiered_opts.cache_type = PrimaryCacheType::kCacheTypeLRU;
@@ -3497,7 +3709,12 @@ class Benchmark {
       read_options_.adaptive_readahead = FLAGS_adaptive_readahead;
       read_options_.async_io = FLAGS_async_io;
       read_options_.optimize_multiget_for_io = FLAGS_optimize_multiget_for_io;
+      read_options_.prefetch_multiget_across_levels =
+          FLAGS_prefetch_multiget_across_levels;
+      read_options_.min_memtable_value_size_to_pin =
+          FLAGS_min_memtable_value_size_to_pin;
       read_options_.auto_readahead_size = FLAGS_auto_readahead_size;
+      read_options_.recycle_iterator = FLAGS_recycle_iterator;
 
       void (Benchmark::*method)(ThreadState*) = nullptr;
       void (Benchmark::*post_process_method)() = nullptr;
@@ -4246,6 +4463,8 @@ class Benchmark {
     options.stats_history_buffer_size =
         static_cast<size_t>(FLAGS_stats_history_buffer_size);
     options.avoid_flush_during_recovery = FLAGS_avoid_flush_during_recovery;
+    options.enable_pipelined_wal_recovery =
+        FLAGS_enable_pipelined_wal_recovery;
 
     options.compression_opts.level = FLAGS_compression_level;
     options.compression_opts.max_dict_bytes = FLAGS_compression_max_dict_bytes;
@@ -4311,6 +4530,9 @@ class Benchmark {
     }
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
+    options.use_table_tail_snapshot = FLAGS_use_table_tail_snapshot;
+    options.table_tail_snapshot_period_sec =
+        FLAGS_table_tail_snapshot_period_sec;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
@@ -4410,6 +4632,7 @@ class Benchmark {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
       }
+      block_based_options.piecewise_linear_index = FLAGS_piecewise_linear_index;
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
       switch (FLAGS_index_shortening_mode) {
@@ -4487,12 +4710,23 @@ class Benchmark {
           FLAGS_enable_index_compression;
       block_based_options.block_align = FLAGS_block_align;
       block_based_options.whole_key_filtering = FLAGS_whole_key_filtering;
+      block_based_options.range_filter_prefix_len =
+          FLAGS_range_filter_prefix_len;
       block_based_options.max_auto_readahead_size =
           FLAGS_max_auto_readahead_size;
       block_based_options.initial_auto_readahead_size =
           FLAGS_initial_auto_readahead_size;
       block_based_options.num_file_reads_for_auto_readahead =
           FLAGS_num_file_reads_for_auto_readahead;
+      if (!FLAGS_compressor.empty()) {
+        s = Compressor::CreateFromString(config_options, FLAGS_compressor,
+                                         &block_based_options.compressor);
+        if (!s.ok()) {
+          fprintf(stderr, "invalid compressor[%s]: %s\n",
+                  FLAGS_compressor.c_str(), s.ToString().c_str());
+          exit(1);
+        }
+      }
       BlockBasedTableOptions::PrepopulateBlockCache prepopulate_block_cache =
           block_based_options.prepopulate_block_cache;
       switch (FLAGS_prepopulate_block_cache) {
@@ -4517,6 +4751,8 @@ class Benchmark {
       }
       block_based_options.data_block_hash_table_util_ratio =
           FLAGS_data_block_hash_table_util_ratio;
+      block_based_options.data_block_restart_key_prefixes =
+          FLAGS_data_block_restart_key_prefixes;
       if (FLAGS_read_cache_path != "") {
         Status rc_status;
 
@@ -4653,7 +4889,12 @@ class Benchmark {
     options.inplace_update_num_locks = FLAGS_inplace_update_num_locks;
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
+    options.large_batch_memtable_insert_threads =
+        FLAGS_large_batch_memtable_insert_threads;
+    options.large_batch_memtable_insert_min_entries =
+        FLAGS_large_batch_memtable_insert_min_entries;
     options.enable_pipelined_write = FLAGS_enable_pipelined_write;
+    options.enable_pipelined_wal_sync = FLAGS_enable_pipelined_wal_sync;
     options.unordered_write = FLAGS_unordered_write;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
@@ -4663,6 +4904,7 @@ class Benchmark {
     options.optimize_filters_for_hits = FLAGS_optimize_filters_for_hits;
     options.paranoid_checks = FLAGS_paranoid_checks;
     options.force_consistency_checks = FLAGS_force_consistency_checks;
+    options.merge_with_tournament_tree = FLAGS_merge_with_tournament_tree;
     options.periodic_compaction_seconds = FLAGS_periodic_compaction_seconds;
     options.ttl = FLAGS_ttl_seconds;
     // fill storage options
@@ -8757,6 +8999,10 @@ int db_bench_tool(int argc, char** argv) {
                                   ROCKSDB_NAMESPACE::Env::Priority::BOTTOM);
   FLAGS_env->SetBackgroundThreads(FLAGS_num_low_pri_threads,
                                   ROCKSDB_NAMESPACE::Env::Priority::LOW);
+  FLAGS_env->SetThreadPoolWorkStealing(
+      ROCKSDB_NAMESPACE::Env::Priority::HIGH,
+      ROCKSDB_NAMESPACE::Env::Priority::LOW,
+      FLAGS_high_pri_threads_stealing_low_pri_jobs);
 
   // Choose a location for the test database if none given with --db=<path>
   if (FLAGS_db.empty()) {
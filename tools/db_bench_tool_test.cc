@@ -325,6 +325,29 @@ TEST_F(DBBenchTest, OptionsFileFromFile) {
   VerifyOptions(SanitizeOptions(db_path_, opt));
 }
 
+TEST_F(DBBenchTest, PerfStageSampleRate) {
+  AppendArgs({"./db_bench", "--benchmarks=fillseq,readrandom",
+              "--use_existing_db=0", "--num=1000", "--threads=1",
+              "--compression_type=none", "--perf_stage_sample_rate=10",
+              std::string(std::string("--db=") + db_path_).c_str(),
+              std::string(std::string("--wal_dir=") + wal_path_).c_str()});
+  testing::internal::CaptureStdout();
+  int ret = db_bench_tool(argc(), argv());
+  std::string output = testing::internal::GetCapturedStdout();
+  GFLAGS_NAMESPACE::SetCommandLineOption("perf_stage_sample_rate", "0");
+  ASSERT_EQ(0, ret);
+
+  // Only readrandom reports stages. Each of its 1000 reads is one op, and the
+  // first sample is taken after 10 reads.
+  const std::string kHeader = "Read path stage nanos";
+  size_t pos = output.find(kHeader);
+  ASSERT_NE(std::string::npos, pos);
+  ASSERT_EQ(std::string::npos, output.find(kHeader, pos + 1));
+  ASSERT_LT(output.find("readrandom"), pos);
+  ASSERT_NE(std::string::npos,
+            output.find(kHeader + " (99 sampled ops, 1 in 10)"));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
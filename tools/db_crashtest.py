@@ -71,14 +71,18 @@ default_params = {
     # Disabled because of various likely related failures with
     # "Cannot delete table file #N from level 0 since it is on level X"
     "promote_l0_one_in": 0,
-    "compaction_pri": random.randint(0, 4),
+    "compaction_pri": random.randint(0, 5),
     "key_may_exist_one_in": lambda: random.choice([100, 100000]),
     "data_block_index_type": lambda: random.choice([0, 1]),
+    "data_block_restart_key_prefixes": lambda: random.choice([0, 1]),
+    "piecewise_linear_index": lambda: random.choice([0, 1]),
+    "range_filter_prefix_len": lambda: random.choice([0, 0, 4, 8]),
     "decouple_partitioned_filters": lambda: random.choice([0, 1, 1]),
     "delpercent": 4,
     "delrangepercent": 1,
     "destroy_db_initially": 0,
     "enable_pipelined_write": lambda: random.randint(0, 1),
+    "enable_pipelined_wal_sync": lambda: random.randint(0, 1),
     "enable_compaction_filter": lambda: random.choice([0, 0, 0, 1]),
     # `inplace_update_support` is incompatible with DB that has delete
     # range data in memtables.
@@ -213,6 +217,7 @@ default_params = {
     "avoid_flush_during_recovery": lambda: random.choice(
         [1 if t == 0 else 0 for t in range(0, 8)]
     ),
+    "enable_pipelined_wal_recovery": lambda: random.randint(0, 1),
     "max_write_batch_group_size_bytes": lambda: random.choice(
         [16, 64, 1024 * 1024, 16 * 1024 * 1024]
     ),
@@ -237,6 +242,7 @@ default_params = {
     "get_property_one_in": lambda: random.choice([100000, 1000000]),
     "get_properties_of_all_tables_one_in": lambda: random.choice([100000, 1000000]),
     "paranoid_file_checks": lambda: random.choice([0, 1, 1, 1]),
+    "merge_with_tournament_tree": lambda: random.choice([0, 1]),
     "max_write_buffer_size_to_maintain": lambda: random.choice(
         [0, 1024 * 1024, 2 * 1024 * 1024, 4 * 1024 * 1024, 8 * 1024 * 1024]
     ),
@@ -251,6 +257,7 @@ default_params = {
     "async_io": lambda: random.choice([0, 1]),
     "wal_compression": lambda: random.choice(["none", "zstd"]),
     "verify_sst_unique_id_in_manifest": 1,  # always do unique_id verification
+    "use_table_tail_snapshot": lambda: random.randint(0, 1),
     "secondary_cache_uri": lambda: random.choice(
         [
             "",
@@ -277,6 +284,10 @@ default_params = {
     "allow_fallocate": lambda: random.choice([0, 1]),
     "table_cache_numshardbits": lambda: random.choice([6] * 3 + [-1] * 2 + [0]),
     "enable_write_thread_adaptive_yield": lambda: random.choice([0, 1]),
+    "large_batch_memtable_insert_threads": lambda: random.choice([1, 1, 2, 4]),
+    "large_batch_memtable_insert_min_entries": lambda: random.choice(
+        [2, 16, 65536]
+    ),
     "log_readahead_size": lambda: random.choice([0, 16 * 1024 * 1024]),
     "bgerror_resume_retry_interval": lambda: random.choice([100, 1000000]),
     "delete_obsolete_files_period_micros": lambda: random.choice(
@@ -292,6 +303,8 @@ default_params = {
     "avoid_flush_during_shutdown": lambda: random.choice([0, 1]),
     "fill_cache": lambda: random.choice([0, 1]),
     "optimize_multiget_for_io": lambda: random.choice([0, 1]),
+    "prefetch_multiget_across_levels": lambda: random.choice([0, 1]),
+    "min_memtable_value_size_to_pin": lambda: random.choice([0, 0, 1, 100]),
     "memtable_insert_hint_per_batch": lambda: random.choice([0, 1]),
     "dump_malloc_stats": lambda: random.choice([0, 1]),
     "stats_history_buffer_size": lambda: random.choice([0, 1024 * 1024]),
@@ -476,7 +489,9 @@ simple_default_params = {
     # "experimental_mempurge_threshold": lambda: 10.0*random.random(),
     "max_background_compactions": 1,
     "max_bytes_for_level_base": 67108864,
-    "memtablerep": "skip_list",
+    "memtablerep": lambda: random.choice(
+        ["skip_list"] * 3 + ["adaptive_skip_list"]
+    ),
     "target_file_size_base": 16777216,
     "target_file_size_multiplier": 1,
     "test_batches_snapshots": 0,
@@ -844,6 +859,8 @@ def finalize_and_sanitize(src_params):
         dest_params["use_put_entity_one_in"] = 0
         # MultiCfIterator is currently only compatible with write committed policy
         dest_params["use_multi_cf_iterator"] = 0
+        # WritePrepared and WriteUnprepared need duplicate key detection
+        dest_params["memtablerep"] = "skip_list"
     # TODO(hx235): enable test_multi_ops_txns with fault injection after stabilizing the CI
     if dest_params.get("test_multi_ops_txns") == 1:
         dest_params["write_fault_one_in"] = 0
@@ -907,7 +924,10 @@ def finalize_and_sanitize(src_params):
         # disable atomic flush.
         if dest_params["test_best_efforts_recovery"] == 0:
             dest_params["disable_wal"] = 0
-    if dest_params.get("allow_concurrent_memtable_write", 1) == 1:
+    # Only the skip list based memtables support concurrent inserts
+    if dest_params.get("allow_concurrent_memtable_write", 1) == 1 and dest_params.get(
+        "memtablerep"
+    ) not in ["skip_list", "adaptive_skip_list"]:
         dest_params["memtablerep"] = "skip_list"
     if (
         dest_params.get("enable_compaction_filter", 0) == 1
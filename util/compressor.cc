@@ -0,0 +1,109 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/compressor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "rocksdb/utilities/customizable_util.h"
+#include "rocksdb/utilities/options_type.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+class AutoSkipBlockCompressor : public BlockCompressor {
+ public:
+  AutoSkipBlockCompressor(CompressionType compression_type,
+                          uint32_t max_skipped_blocks)
+      : compression_type_(compression_type),
+        max_skipped_blocks_(max_skipped_blocks) {}
+
+  CompressionType SelectCompressionType(const Slice& /*uncompressed_block*/,
+                                        bool is_data_block) override {
+    if (!is_data_block) {
+      return compression_type_;
+    }
+    // With parallel compression, races between the compression threads only
+    // make the number of skipped blocks approximate.
+    uint32_t to_skip = blocks_to_skip_.load(std::memory_order_relaxed);
+    if (to_skip > 0) {
+      blocks_to_skip_.store(to_skip - 1, std::memory_order_relaxed);
+      return kNoCompression;
+    }
+    return compression_type_;
+  }
+
+  void OnBlockCompressed(const Slice& /*uncompressed_block*/,
+                         bool is_data_block, CompressionType type,
+                         size_t /*compressed_size*/) override {
+    if (!is_data_block) {
+      return;
+    }
+    if (type == kNoCompression) {
+      uint32_t skip = std::min(
+          std::max(last_skipped_.load(std::memory_order_relaxed) * 2, 1U),
+          max_skipped_blocks_);
+      last_skipped_.store(skip, std::memory_order_relaxed);
+      blocks_to_skip_.store(skip, std::memory_order_relaxed);
+    } else {
+      last_skipped_.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  const CompressionType compression_type_;
+  const uint32_t max_skipped_blocks_;
+  // Number of upcoming data blocks to store uncompressed
+  std::atomic<uint32_t> blocks_to_skip_{0};
+  // Length of the latest skip window, reset when compression succeeds
+  std::atomic<uint32_t> last_skipped_{0};
+};
+
+static std::unordered_map<std::string, OptionTypeInfo>
+    auto_skip_compressor_type_info = {
+        {"max_skipped_blocks", {0, OptionType::kUInt32T}},
+};
+}  // namespace
+
+AutoSkipCompressor::AutoSkipCompressor(uint32_t max_skipped_blocks)
+    : max_skipped_blocks_(max_skipped_blocks) {
+  RegisterOptions("AutoSkipCompressorOptions", &max_skipped_blocks_,
+                  &auto_skip_compressor_type_info);
+}
+
+std::unique_ptr<BlockCompressor> AutoSkipCompressor::NewBlockCompressor(
+    const Context& context) const {
+  if (context.compression_type == kNoCompression || max_skipped_blocks_ == 0) {
+    return nullptr;
+  }
+  return std::make_unique<AutoSkipBlockCompressor>(context.compression_type,
+                                                   max_skipped_blocks_);
+}
+
+static int RegisterBuiltinCompressors(ObjectLibrary& library,
+                                      const std::string& /*arg*/) {
+  library.AddFactory<Compressor>(
+      AutoSkipCompressor::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<Compressor>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(new AutoSkipCompressor());
+        return guard->get();
+      });
+  return 1;
+}
+
+Status Compressor::CreateFromString(const ConfigOptions& config_options,
+                                    const std::string& value,
+                                    std::shared_ptr<Compressor>* result) {
+  static std::once_flag once;
+  std::call_once(once, [&]() {
+    RegisterBuiltinCompressors(*(ObjectLibrary::Default().get()), "");
+  });
+  return LoadSharedObject<Compressor>(config_options, value, result);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
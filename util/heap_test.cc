@@ -10,9 +10,12 @@
 #include <climits>
 #include <queue>
 #include <random>
+#include <set>
 #include <utility>
+#include <vector>
 
 #include "port/stack_trace.h"
+#include "util/tournament_tree.h"
 
 #ifndef GFLAGS
 const int64_t FLAGS_iters = 100000;
@@ -22,8 +25,9 @@ DEFINE_int64(iters, 100000, "number of pseudo-random operations in each test");
 #endif  // GFLAGS
 
 /*
- * Compares the custom heap implementation in util/heap.h against
- * std::priority_queue on a pseudo-random sequence of operations.
+ * Compares the custom heap implementation in util/heap.h and the tournament
+ * tree in util/tournament_tree.h against std::priority_queue and std::multiset
+ * on a pseudo-random sequence of operations.
  */
 
 namespace ROCKSDB_NAMESPACE {
@@ -101,6 +105,84 @@ TEST_P(HeapTest, Test) {
   ASSERT_TRUE(heap.empty());
 }
 
+class TournamentTreeTest : public ::testing::TestWithParam<Params> {};
+
+TEST_P(TournamentTreeTest, Test) {
+  // Like HeapTest, but each value is stored with a distinct slot, chosen at
+  // random among the free ones, and replace top keeps the slot of the top.
+  // The tree is not reserved up front so that it grows along the way.
+  const auto MAX_HEAP_SIZE = std::get<0>(GetParam());
+  const auto MAX_VALUE = std::get<1>(GetParam());
+  const auto RNG_SEED = std::get<2>(GetParam());
+
+  using Item = std::pair<HeapTestValue, size_t>;
+  struct ItemLess {
+    bool operator()(const Item& a, const Item& b) const {
+      return a.first < b.first;
+    }
+  };
+  struct ItemSlot {
+    size_t operator()(const Item& item) const { return item.second; }
+  };
+
+  TournamentTree<Item, ItemLess, ItemSlot> tree{ItemLess(), ItemSlot()};
+  std::multiset<HeapTestValue> ref;
+  std::vector<size_t> free_slots;
+  for (size_t slot = 0; slot < MAX_HEAP_SIZE; ++slot) {
+    free_slots.push_back(slot);
+  }
+
+  std::mt19937 rng(static_cast<unsigned int>(RNG_SEED));
+  std::uniform_int_distribution<HeapTestValue> value_dist(0, MAX_VALUE);
+  int ndrains = 0;
+  bool draining = false;
+  for (int64_t i = 0; i < FLAGS_iters; ++i) {
+    if (ref.empty()) {
+      draining = false;
+    }
+
+    if (!draining && (ref.empty() || std::bernoulli_distribution(0.4)(rng))) {
+      // insert
+      size_t pos = std::uniform_int_distribution<size_t>(
+          0, free_slots.size() - 1)(rng);
+      size_t slot = free_slots[pos];
+      free_slots[pos] = free_slots.back();
+      free_slots.pop_back();
+      HeapTestValue val = value_dist(rng);
+      tree.push(Item(val, slot));
+      ref.insert(val);
+      if (ref.size() == MAX_HEAP_SIZE) {
+        draining = true;
+        ++ndrains;
+      }
+    } else if (std::bernoulli_distribution(0.5)(rng)) {
+      // replace top, half of the time with a value that stays on top
+      HeapTestValue val = std::bernoulli_distribution(0.5)(rng)
+                              ? value_dist(rng)
+                              : *ref.rbegin();
+      tree.replace_top(Item(val, tree.top().second));
+      ref.erase(std::prev(ref.end()));
+      ref.insert(val);
+    } else {
+      // pop
+      free_slots.push_back(tree.top().second);
+      tree.pop();
+      ref.erase(std::prev(ref.end()));
+    }
+
+    ASSERT_EQ(ref.size(), tree.size());
+    ASSERT_EQ(ref.empty(), tree.empty());
+    if (!ref.empty()) {
+      ASSERT_EQ(*ref.rbegin(), tree.top().first);
+    }
+  }
+
+  assert(ndrains > 0);
+
+  tree.clear();
+  ASSERT_TRUE(tree.empty());
+}
+
 // Basic test, MAX_VALUE = 3*MAX_HEAP_SIZE (occasional duplicates)
 INSTANTIATE_TEST_CASE_P(Basic, HeapTest,
                         ::testing::Values(Params(1000, 3000,
@@ -119,6 +201,17 @@ INSTANTIATE_TEST_CASE_P(TwoElementHeap, HeapTest,
 INSTANTIATE_TEST_CASE_P(OneElementHeap, HeapTest,
                         ::testing::Values(Params(1, 3, 0x176a1019ab0b612e)));
 
+INSTANTIATE_TEST_CASE_P(
+    Basic, TournamentTreeTest,
+    ::testing::Values(Params(1000, 3000, 0x1b575cf05b708945)));
+INSTANTIATE_TEST_CASE_P(SmallValues, TournamentTreeTest,
+                        ::testing::Values(Params(100, 10, 0x5ae213f7bd5dccd0)));
+INSTANTIATE_TEST_CASE_P(SmallHeap, TournamentTreeTest,
+                        ::testing::Values(Params(10, ULLONG_MAX,
+                                                 0x3e1fa8f4d01707cf)));
+INSTANTIATE_TEST_CASE_P(OneElementHeap, TournamentTreeTest,
+                        ::testing::Values(Params(1, 3, 0x176a1019ab0b612e)));
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -55,6 +55,12 @@ struct ThreadPoolImpl::Impl {
     return queue_len_.load(std::memory_order_relaxed);
   }
 
+  // Whether other pools may steal jobs from this pool, i.e. it has queued
+  // jobs and running threads.
+  bool HasJobsToSteal() const {
+    return running_.load(std::memory_order_relaxed) && GetQueueLen() > 0;
+  }
+
   void LowerIOPriority();
 
   void LowerCPUPriority(CpuPriority pri);
@@ -89,6 +95,19 @@ struct ThreadPoolImpl::Impl {
     return static_cast<int>(thread_id) >= total_threads_limit_;
   }
 
+  // Return true iff the current thread, which has nothing of its own to run,
+  // may run a job queued in steal_from_. Another unreserved thread must keep
+  // waiting for this pool's own jobs, so by design a pool with a single
+  // thread never steals.
+  bool CanSteal(size_t thread_id) const {
+    return steal_from_ != nullptr && queue_.empty() &&
+           !IsExcessiveThread(thread_id) &&
+           num_waiting_threads_ > reserved_threads_ + 1 &&
+           num_stealing_threads_ < max_stealing_threads_ &&
+           num_stealing_threads_ < total_threads_limit_ - 1 &&
+           steal_from_->HasJobsToSteal();
+  }
+
   // Return the thread priority.
   // This would allow its member-thread to know its priority.
   Env::Priority GetThreadPriority() const { return priority_; }
@@ -120,6 +139,22 @@ struct ThreadPoolImpl::Impl {
     return released_threads_in_success;
   }
 
+  void SetWorkStealing(Impl* victim, int max_threads);
+
+  // Removes the job at the front of the queue for a thread of another pool
+  // to run. Returns false if there is none, or if this pool is shutting down.
+  bool StealJob(std::function<void()>* function);
+
+  void AddThief(Impl* thief);
+  void RemoveThief(Impl* thief);
+
+  // Wakes up an idle thread that may steal a job that was just queued in
+  // steal_from_.
+  void WakeUpThief() {
+    std::lock_guard<std::mutex> lock(mu_);
+    bgsignal_.notify_one();
+  }
+
  private:
   static void BGThreadWrapper(void* arg);
 
@@ -130,6 +165,8 @@ struct ThreadPoolImpl::Impl {
 
   int total_threads_limit_;
   std::atomic_uint queue_len_;  // Queue length. Used for stats reporting
+  // Whether the pool has threads and is not shutting down
+  std::atomic<bool> running_;
   // Number of reserved threads, managed by ReserveThreads(..) and
   // ReleaseThreads(..), if num_waiting_threads_ is no larger than
   // reserved_threads_, its thread will be blocked to ensure the reservation
@@ -143,6 +180,16 @@ struct ThreadPoolImpl::Impl {
   bool exit_all_threads_;
   bool wait_for_jobs_to_complete_;
 
+  // The pool whose queued jobs idle threads may run, and the number of
+  // threads that may do so at a time. The stealing threads do not lock the
+  // two pools together, so pools may steal from each other.
+  Impl* steal_from_;
+  int max_stealing_threads_;
+  int num_stealing_threads_;
+  // The pools that may steal from this pool, to wake up when a job is queued
+  // and no thread of this pool is available
+  std::vector<Impl*> thieves_;
+
   // Entry per Schedule()/Submit() call
   struct BGItem {
     void* tag = nullptr;
@@ -165,16 +212,27 @@ inline ThreadPoolImpl::Impl::Impl()
       env_(nullptr),
       total_threads_limit_(0),
       queue_len_(),
+      running_(false),
       reserved_threads_(0),
       num_waiting_threads_(0),
       exit_all_threads_(false),
       wait_for_jobs_to_complete_(false),
+      steal_from_(nullptr),
+      max_stealing_threads_(0),
+      num_stealing_threads_(0),
       queue_(),
       mu_(),
       bgsignal_(),
       bgthreads_() {}
 
-inline ThreadPoolImpl::Impl::~Impl() { assert(bgthreads_.size() == 0U); }
+inline ThreadPoolImpl::Impl::~Impl() {
+  assert(bgthreads_.size() == 0U);
+  SetWorkStealing(nullptr, 0);
+  const std::vector<Impl*> thieves = thieves_;
+  for (Impl* thief : thieves) {
+    thief->SetWorkStealing(nullptr, 0);
+  }
+}
 
 void ThreadPoolImpl::Impl::JoinThreads(bool wait_for_jobs_to_complete) {
   std::unique_lock<std::mutex> lock(mu_);
@@ -182,6 +240,7 @@ void ThreadPoolImpl::Impl::JoinThreads(bool wait_for_jobs_to_complete) {
 
   wait_for_jobs_to_complete_ = wait_for_jobs_to_complete;
   exit_all_threads_ = true;
+  running_.store(false, std::memory_order_relaxed);
   // prevent threads from being recreated right after they're joined, in case
   // the user is concurrently submitting jobs.
   total_threads_limit_ = 0;
@@ -230,9 +289,11 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
     // 2) it is the excessive thread (not the last one)
     // 3) the number of waiting threads is not greater than reserved threads
     // (i.e, no available threads due to full reservation")
+    // Even then, it stops waiting to run a job of another pool if CanSteal().
     while (!exit_all_threads_ && !IsLastExcessiveThread(thread_id) &&
            (queue_.empty() || IsExcessiveThread(thread_id) ||
-            num_waiting_threads_ <= reserved_threads_)) {
+            num_waiting_threads_ <= reserved_threads_) &&
+           !CanSteal(thread_id)) {
       bgsignal_.wait(lock);
     }
     // Decrease num_waiting_threads_ once the thread is not waiting
@@ -252,6 +313,7 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
       auto& terminating_thread = bgthreads_.back();
       terminating_thread.detach();
       bgthreads_.pop_back();
+      running_.store(!bgthreads_.empty(), std::memory_order_relaxed);
       if (HasExcessiveThread()) {
         // There is still at least more excessive thread to terminate.
         WakeUpAllThreads();
@@ -262,11 +324,28 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
       break;
     }
 
-    auto func = std::move(queue_.front().function);
-    queue_.pop_front();
+    std::function<void()> func;
+    const bool stolen = queue_.empty();
+    if (stolen) {
+      // Woken up to run a job of steal_from_. Its lock is taken without
+      // holding ours.
+      Impl* victim = steal_from_;
+      num_stealing_threads_++;
+      lock.unlock();
+      const bool got_job = victim->StealJob(&func);
+      lock.lock();
+      if (!got_job) {
+        num_stealing_threads_--;
+        continue;
+      }
+      TEST_SYNC_POINT("ThreadPoolImpl::BGThread::Steal");
+    } else {
+      func = std::move(queue_.front().function);
+      queue_.pop_front();
 
-    queue_len_.store(static_cast<unsigned int>(queue_.size()),
-                     std::memory_order_relaxed);
+      queue_len_.store(static_cast<unsigned int>(queue_.size()),
+                       std::memory_order_relaxed);
+    }
 
     bool decrease_io_priority = (low_io_priority != low_io_priority_);
     CpuPriority cpu_priority = cpu_priority_;
@@ -309,9 +388,67 @@ void ThreadPoolImpl::Impl::BGThread(size_t thread_id) {
                              &priority_);
 
     func();
+
+    if (stolen) {
+      lock.lock();
+      num_stealing_threads_--;
+      if (steal_from_ != nullptr && steal_from_->HasJobsToSteal()) {
+        // Another idle thread may take over the stealing slot
+        WakeUpAllThreads();
+      }
+    }
   }
 }
 
+void ThreadPoolImpl::Impl::SetWorkStealing(Impl* victim, int max_threads) {
+  if (victim == nullptr || max_threads <= 0) {
+    victim = nullptr;
+    max_threads = 0;
+  }
+  assert(victim != this);
+  Impl* old_victim;
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    old_victim = steal_from_;
+    steal_from_ = victim;
+    max_stealing_threads_ = max_threads;
+    WakeUpAllThreads();
+  }
+  if (old_victim != victim) {
+    if (old_victim != nullptr) {
+      old_victim->RemoveThief(this);
+    }
+    if (victim != nullptr) {
+      victim->AddThief(this);
+    }
+  }
+}
+
+bool ThreadPoolImpl::Impl::StealJob(std::function<void()>* function) {
+  std::lock_guard<std::mutex> lock(mu_);
+  // Once the threads of this pool are joined, its queued jobs are discarded
+  if (!running_.load(std::memory_order_relaxed) || queue_.empty()) {
+    return false;
+  }
+  *function = std::move(queue_.front().function);
+  queue_.pop_front();
+
+  queue_len_.store(static_cast<unsigned int>(queue_.size()),
+                   std::memory_order_relaxed);
+  return true;
+}
+
+void ThreadPoolImpl::Impl::AddThief(Impl* thief) {
+  std::lock_guard<std::mutex> lock(mu_);
+  thieves_.push_back(thief);
+}
+
+void ThreadPoolImpl::Impl::RemoveThief(Impl* thief) {
+  std::lock_guard<std::mutex> lock(mu_);
+  thieves_.erase(std::remove(thieves_.begin(), thieves_.end(), thief),
+                 thieves_.end());
+}
+
 // Helper struct for passing arguments when creating threads.
 struct BGThreadMetadata {
   ThreadPoolImpl::Impl* thread_pool_;
@@ -395,13 +532,14 @@ void ThreadPoolImpl::Impl::StartBGThreads() {
 #endif
 #endif
     bgthreads_.push_back(std::move(p_t));
+    running_.store(true, std::memory_order_relaxed);
   }
 }
 
 void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
                                   std::function<void()>&& unschedule,
                                   void* tag) {
-  std::lock_guard<std::mutex> lock(mu_);
+  std::unique_lock<std::mutex> lock(mu_);
 
   if (exit_all_threads_) {
     return;
@@ -428,6 +566,17 @@ void ThreadPoolImpl::Impl::Submit(std::function<void()>&& schedule,
     // up is not the one to terminate.
     WakeUpAllThreads();
   }
+
+  if (!thieves_.empty() && num_waiting_threads_ <= reserved_threads_) {
+    // No thread of this pool is available, so let a thief take the job.
+    // The thieves are woken up without holding our lock, as they take it to
+    // steal.
+    std::vector<Impl*> thieves = thieves_;
+    lock.unlock();
+    for (Impl* thief : thieves) {
+      thief->WakeUpThief();
+    }
+  }
 }
 
 int ThreadPoolImpl::Impl::UnSchedule(void* arg) {
@@ -541,6 +690,12 @@ int ThreadPoolImpl::ReleaseThreads(int threads_to_be_released) {
   return impl_->ReleaseThreads(threads_to_be_released);
 }
 
+void ThreadPoolImpl::SetWorkStealing(ThreadPoolImpl* victim,
+                                     int max_threads) {
+  impl_->SetWorkStealing(victim != nullptr ? victim->impl_.get() : nullptr,
+                         max_threads);
+}
+
 ThreadPool* NewThreadPool(int num_threads) {
   ThreadPoolImpl* thread_pool = new ThreadPoolImpl();
   thread_pool->SetBackgroundThreads(num_threads);
@@ -96,6 +96,12 @@ class ThreadPoolImpl : public ThreadPool {
   // Release a specific number of threads
   int ReleaseThreads(int threads_to_be_released) override;
 
+  // Let up to `max_threads` threads of this pool run jobs queued in `victim`
+  // while this pool has no queued jobs. At least one thread is left for this
+  // pool's own jobs. Null `victim` or non-positive `max_threads` disables
+  // stealing.
+  void SetWorkStealing(ThreadPoolImpl* victim, int max_threads);
+
   static void PthreadCall(const char* label, int result);
 
   struct Impl;
@@ -0,0 +1,248 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "port/likely.h"
+#include "util/heap.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Tournament tree for multi-way merge sort, an alternative to BinaryHeap with
+// the same interface and the same counterintuitive ordering: the comparison
+// operator provides the less-than relation, and top() returns the maximum.
+//
+// Every value has a fixed leaf, given by `SlotOf`, and no two values in the
+// tree may have the same slot. Each inner node of the complete binary tree
+// stores the slot of the winner among the leaves below it, in a flat array.
+// Compared to BinaryHeap:
+// - replace_top(), pop() and push() take one comparison per level of the tree
+//   on the path from the value's leaf to the root, about logN, while
+//   BinaryHeap's pop() and replace_top() take up to ~2logN comparisons.
+// - When the same input stream keeps supplying the maximum, replace_top()
+//   takes one comparison against the runner-up, like BinaryHeap. The
+//   runner-up is only looked up after a replace_top() that kept the same top,
+//   which suggests such a streak.
+// - Memory and clear() are proportional to the number of slots rather than
+//   the number of values.
+//
+// This pays off for merges with many inputs, where keys of the inputs
+// interleave.
+template <typename T, typename Compare, typename SlotOf>
+class TournamentTree {
+ public:
+  TournamentTree(Compare cmp, SlotOf slot_of)
+      : cmp_(std::move(cmp)), slot_of_(std::move(slot_of)) {}
+
+  // Makes room for values with slots less than `num_slots`. Optional, push()
+  // grows the tree as needed, but this avoids rebuilding it later.
+  void reserve(size_t num_slots) {
+    if (num_slots > num_leaves_) {
+      Grow(num_slots);
+    }
+  }
+
+  void push(const T& value) {
+    const size_t slot = slot_of_(value);
+    if (slot >= num_leaves_) {
+      Grow(slot + 1);
+    }
+    const size_t leaf = num_leaves_ + slot;
+    assert(nodes_[leaf] == kEmpty);
+    values_[slot] = value;
+    nodes_[leaf] = static_cast<uint32_t>(slot);
+    ++size_;
+    runner_up_valid_ = false;
+    UpdatePath(leaf);
+  }
+
+  const T& top() const {
+    assert(!empty());
+    return values_[nodes_[1]];
+  }
+
+  void replace_top(const T& value) {
+    assert(!empty());
+    const size_t slot = slot_of_(value);
+    if (UNLIKELY(slot != nodes_[1])) {
+      pop();
+      push(value);
+      return;
+    }
+    values_[slot] = value;
+    // The top is still the maximum if it is not less than the maximum of the
+    // other values. The winners stored along its path stay the same then.
+    if (runner_up_valid_ &&
+        (runner_up_ == kEmpty || !cmp_(values_[slot], values_[runner_up_]))) {
+      return;
+    }
+    UpdatePath(num_leaves_ + slot);
+    if (nodes_[1] == slot) {
+      // Each value that the top beats on its path is the maximum below the
+      // sibling on that level, so the runner-up is the maximum of those.
+      uint32_t runner_up = kEmpty;
+      for (size_t node = num_leaves_ + slot; node > 1; node >>= 1) {
+        runner_up = Winner(runner_up, nodes_[node ^ 1]);
+      }
+      runner_up_ = runner_up;
+      runner_up_valid_ = true;
+    } else {
+      runner_up_valid_ = false;
+    }
+  }
+
+  void pop() {
+    assert(!empty());
+    const size_t leaf = num_leaves_ + nodes_[1];
+    nodes_[leaf] = kEmpty;
+    --size_;
+    runner_up_valid_ = false;
+    UpdatePath(leaf);
+  }
+
+  void clear() {
+    std::fill(nodes_.begin(), nodes_.end(), kEmpty);
+    size_ = 0;
+    runner_up_valid_ = false;
+  }
+
+  bool empty() const { return size_ == 0; }
+
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr uint32_t kEmpty = UINT32_MAX;
+
+  uint32_t Winner(uint32_t a, uint32_t b) const {
+    if (a == kEmpty) {
+      return b;
+    }
+    if (b == kEmpty) {
+      return a;
+    }
+    return cmp_(values_[a], values_[b]) ? b : a;
+  }
+
+  // Recomputes the winners on the path from `leaf` to the root, after the
+  // value at `leaf` changed. Stops early once a node's winner is a different,
+  // unchanged leaf, as the nodes above it are unaffected.
+  void UpdatePath(size_t leaf) {
+    const uint32_t changed = static_cast<uint32_t>(leaf - num_leaves_);
+    for (size_t node = leaf >> 1; node > 0; node >>= 1) {
+      const uint32_t winner = Winner(nodes_[2 * node], nodes_[2 * node + 1]);
+      if (winner == nodes_[node] && winner != changed) {
+        break;
+      }
+      nodes_[node] = winner;
+    }
+  }
+
+  void Grow(size_t num_slots) {
+    size_t num_leaves = std::max<size_t>(num_leaves_, 1);
+    while (num_leaves < num_slots) {
+      num_leaves *= 2;
+    }
+    assert(num_leaves < kEmpty);
+    std::vector<uint32_t> nodes(2 * num_leaves, kEmpty);
+    std::copy(nodes_.begin() + num_leaves_, nodes_.end(),
+              nodes.begin() + num_leaves);
+    nodes_.swap(nodes);
+    num_leaves_ = num_leaves;
+    values_.resize(num_leaves_);
+    for (size_t node = num_leaves_ - 1; node > 0; --node) {
+      nodes_[node] = Winner(nodes_[2 * node], nodes_[2 * node + 1]);
+    }
+    runner_up_valid_ = false;
+  }
+
+  Compare cmp_;
+  SlotOf slot_of_;
+  // Value of each slot, only meaningful for the slots in the tree
+  std::vector<T> values_;
+  // nodes_[1] is the root, the children of node i are nodes 2i and 2i+1, and
+  // the leaf of slot s is node num_leaves_ + s. Each node holds the slot of
+  // the maximum value below it, or kEmpty.
+  std::vector<uint32_t> nodes_;
+  size_t num_leaves_ = 0;
+  size_t size_ = 0;
+  // Slot of the maximum value other than top(), or kEmpty if there is none.
+  // Only maintained while the same slot stays on top.
+  uint32_t runner_up_ = kEmpty;
+  bool runner_up_valid_ = false;
+};
+
+// A BinaryHeap or a TournamentTree, chosen at construction, behind their
+// common interface. Used by the merging iterators, which make the choice
+// based on the column family's `merge_with_tournament_tree` option.
+template <typename T, typename Compare, typename SlotOf>
+class MergeHeap {
+ public:
+  MergeHeap(Compare cmp, SlotOf slot_of, bool use_tournament_tree)
+      : use_tournament_tree_(use_tournament_tree),
+        heap_(cmp),
+        tree_(cmp, std::move(slot_of)) {}
+
+  void reserve(size_t num_slots) {
+    if (use_tournament_tree_) {
+      tree_.reserve(num_slots);
+    }
+  }
+
+  void push(const T& value) {
+    if (use_tournament_tree_) {
+      tree_.push(value);
+    } else {
+      heap_.push(value);
+    }
+  }
+
+  const T& top() const {
+    return use_tournament_tree_ ? tree_.top() : heap_.top();
+  }
+
+  void replace_top(const T& value) {
+    if (use_tournament_tree_) {
+      tree_.replace_top(value);
+    } else {
+      heap_.replace_top(value);
+    }
+  }
+
+  void pop() {
+    if (use_tournament_tree_) {
+      tree_.pop();
+    } else {
+      heap_.pop();
+    }
+  }
+
+  void clear() {
+    if (use_tournament_tree_) {
+      tree_.clear();
+    } else {
+      heap_.clear();
+    }
+  }
+
+  bool empty() const {
+    return use_tournament_tree_ ? tree_.empty() : heap_.empty();
+  }
+
+  size_t size() const {
+    return use_tournament_tree_ ? tree_.size() : heap_.size();
+  }
+
+ private:
+  const bool use_tournament_tree_;
+  BinaryHeap<T, Compare> heap_;
+  TournamentTree<T, Compare, SlotOf> tree_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
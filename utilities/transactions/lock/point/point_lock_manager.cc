@@ -58,9 +58,50 @@ struct LockMapStripe {
   // Condition Variable per stripe for waiting on a lock
   std::shared_ptr<TransactionDBCondVar> stripe_cv;
 
+  // Number of threads waiting on stripe_cv. Unlocking only signals the
+  // condition variable when there is a waiter, which saves a futex wake-up
+  // per unlock in the common uncontended case.
+  // Must be accessed with stripe_mutex held.
+  size_t num_waiters = 0;
+
   // Locked keys mapped to the info about the transactions that locked them.
   // TODO(agiardullo): Explore performance of other data structures.
   UnorderedMap<std::string, LockInfo> keys;
+
+  // Adds a newly locked key to `keys`.
+  // REQUIRED: stripe_mutex must be held.
+  void AddKey(const std::string& key, const LockInfo& lock_info) {
+#ifndef USE_FOLLY
+    if (!free_nodes.empty()) {
+      auto node = std::move(free_nodes.back());
+      free_nodes.pop_back();
+      node.key() = key;
+      node.mapped() = lock_info;
+      keys.insert(std::move(node));
+      return;
+    }
+#endif  // !USE_FOLLY
+    keys.emplace(key, lock_info);
+  }
+
+  // Removes an unlocked key from `keys`.
+  // REQUIRED: stripe_mutex must be held.
+  void RemoveKey(UnorderedMap<std::string, LockInfo>::iterator iter) {
+#ifndef USE_FOLLY
+    if (free_nodes.size() < kMaxFreeNodes) {
+      free_nodes.push_back(keys.extract(iter));
+      return;
+    }
+#endif  // !USE_FOLLY
+    keys.erase(iter);
+  }
+
+#ifndef USE_FOLLY
+  // Map nodes of recently unlocked keys, kept to avoid a heap allocation (and
+  // usually the key copy's allocation too) for every new lock of this stripe.
+  static constexpr size_t kMaxFreeNodes = 16;
+  std::vector<UnorderedMap<std::string, LockInfo>::node_type> free_nodes;
+#endif  // !USE_FOLLY
 };
 
 // Map of #num_stripes LockMapStripes
@@ -313,6 +354,7 @@ Status PointLockManager::AcquireWithTimeout(
       }
 
       TEST_SYNC_POINT("PointLockManager::AcquireWithTimeout:WaitingTxn");
+      stripe->num_waiters++;
       if (cv_end_time < 0) {
         // Wait indefinitely
         result = stripe->stripe_cv->Wait(stripe->stripe_mutex);
@@ -323,6 +365,8 @@ Status PointLockManager::AcquireWithTimeout(
                                               cv_end_time - now);
         }
       }
+      assert(stripe->num_waiters > 0);
+      stripe->num_waiters--;
 
       if (wait_ids.size() != 0) {
         txn->ClearWaitingTxn();
@@ -525,7 +569,7 @@ Status PointLockManager::AcquireLocked(LockMap* lock_map, LockMapStripe* stripe,
       result = Status::Busy(Status::SubCode::kLockLimit);
     } else {
       // acquire lock
-      stripe->keys.emplace(key, txn_lock_info);
+      stripe->AddKey(key, txn_lock_info);
 
       // Maintain lock count if there is a limit on the number of locks
       if (max_num_locks_) {
@@ -552,7 +596,7 @@ void PointLockManager::UnLockKey(PessimisticTransaction* txn,
     // Found the key we locked.  unlock it.
     if (txn_it != txns.end()) {
       if (txns.size() == 1) {
-        stripe->keys.erase(stripe_iter);
+        stripe->RemoveKey(stripe_iter);
       } else {
         auto last_it = txns.end() - 1;
         if (txn_it != last_it) {
@@ -592,10 +636,13 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
 
   stripe->stripe_mutex->Lock().PermitUncheckedError();
   UnLockKey(txn, key, stripe, lock_map, env);
+  bool has_waiters = stripe->num_waiters > 0;
   stripe->stripe_mutex->UnLock();
 
-  // Signal waiting threads to retry locking
-  stripe->stripe_cv->NotifyAll();
+  if (has_waiters) {
+    // Signal waiting threads to retry locking
+    stripe->stripe_cv->NotifyAll();
+  }
 }
 
 void PointLockManager::UnLock(PessimisticTransaction* txn,
@@ -637,11 +684,14 @@ void PointLockManager::UnLock(PessimisticTransaction* txn,
       for (const std::string* key : stripe_keys) {
         UnLockKey(txn, *key, stripe, lock_map, env);
       }
+      bool has_waiters = stripe->num_waiters > 0;
 
       stripe->stripe_mutex->UnLock();
 
-      // Signal waiting threads to retry locking
-      stripe->stripe_cv->NotifyAll();
+      if (has_waiters) {
+        // Signal waiting threads to retry locking
+        stripe->stripe_cv->NotifyAll();
+      }
     }
   }
 }
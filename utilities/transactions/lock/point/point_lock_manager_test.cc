@@ -157,6 +157,91 @@ TEST_F(PointLockManagerTest, DeadlockDepthExceeded) {
   delete txn1;
 }
 
+namespace {
+// Wraps the default condition variable to count notifications
+class NotifyCountingCondVar : public TransactionDBCondVar {
+ public:
+  NotifyCountingCondVar(std::shared_ptr<TransactionDBCondVar> target,
+                        std::atomic<int>* notify_count)
+      : target_(std::move(target)), notify_count_(notify_count) {}
+
+  Status Wait(std::shared_ptr<TransactionDBMutex> mutex) override {
+    return target_->Wait(mutex);
+  }
+
+  Status WaitFor(std::shared_ptr<TransactionDBMutex> mutex,
+                 int64_t timeout_time) override {
+    return target_->WaitFor(mutex, timeout_time);
+  }
+
+  void Notify() override {
+    notify_count_->fetch_add(1);
+    target_->Notify();
+  }
+
+  void NotifyAll() override {
+    notify_count_->fetch_add(1);
+    target_->NotifyAll();
+  }
+
+ private:
+  std::shared_ptr<TransactionDBCondVar> target_;
+  std::atomic<int>* notify_count_;
+};
+
+class NotifyCountingMutexFactory : public TransactionDBMutexFactoryImpl {
+ public:
+  std::shared_ptr<TransactionDBCondVar> AllocateCondVar() override {
+    return std::make_shared<NotifyCountingCondVar>(
+        TransactionDBMutexFactoryImpl::AllocateCondVar(), &notify_count);
+  }
+
+  std::atomic<int> notify_count{0};
+};
+}  // namespace
+
+TEST_F(PointLockManagerTest, UnlockNotifiesOnlyWaiters) {
+  auto factory = std::make_shared<NotifyCountingMutexFactory>();
+  TransactionDBOptions txn_db_opt;
+  txn_db_opt.custom_mutex_factory = factory;
+  locker_.reset(new PointLockManager(
+      static_cast<PessimisticTransactionDB*>(db_), txn_db_opt));
+
+  MockColumnFamilyHandle cf(1);
+  locker_->AddColumnFamily(&cf);
+  TransactionOptions txn_opt;
+  txn_opt.lock_timeout = 1000000;
+  auto txn1 = NewTxn(txn_opt);
+  auto txn2 = NewTxn(txn_opt);
+
+  // Uncontended locks are released without signaling the condition variable.
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k1", env_, true));
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k2", env_, false));
+  ASSERT_OK(locker_->TryLock(txn2, 1, "k2", env_, false));
+  locker_->UnLock(txn1, 1, "k2", env_);
+  locker_->UnLock(txn2, 1, "k2", env_);
+  ASSERT_EQ(factory->notify_count.load(), 0);
+
+  // A waiter gets woken up when the lock it waits for is released.
+  port::Thread t = BlockUntilWaitingTxn(wait_sync_point_name_, [&]() {
+    // block because txn1 is holding a lock on k1.
+    ASSERT_OK(locker_->TryLock(txn2, 1, "k1", env_, true));
+  });
+  locker_->UnLock(txn1, 1, "k1", env_);
+  t.join();
+  ASSERT_GE(factory->notify_count.load(), 1);
+
+  // Without waiters, unlocking doesn't signal the condition variable.
+  int notify_count = factory->notify_count.load();
+  locker_->UnLock(txn2, 1, "k1", env_);
+  ASSERT_OK(locker_->TryLock(txn1, 1, "k1", env_, true));
+  locker_->UnLock(txn1, 1, "k1", env_);
+  ASSERT_EQ(factory->notify_count.load(), notify_count);
+
+  delete txn2;
+  delete txn1;
+}
+
 INSTANTIATE_TEST_CASE_P(PointLockManager, AnyLockManagerTest,
                         ::testing::Values(nullptr));
 
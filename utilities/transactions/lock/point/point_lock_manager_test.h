@@ -74,13 +74,13 @@ class PointLockManagerTest : public testing::Test {
 
  protected:
   Env* env_;
+  TransactionDB* db_;
   std::shared_ptr<LockManager> locker_;
   const char* wait_sync_point_name_;
   friend void PointLockManagerTestExternalSetup(PointLockManagerTest*);
 
  private:
   std::string db_dir_;
-  TransactionDB* db_;
 };
 
 using init_func_t = void (*)(PointLockManagerTest*);